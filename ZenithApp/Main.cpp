@@ -1,7 +1,27 @@
 #include "ZenithEngine.h"
 
-int main()
+#include <string_view>
+
+int main(int argc, char** argv)
 {
-	ZE::RunEngineScoped scopedEngine;
+	ZE::Core::Engine::Settings settings;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view argument = argv[i];
+		if (argument == "--offscreen")
+		{
+			settings.m_Render.m_Offscreen = true;
+		}
+		else if (argument == "--gpu-profiler")
+		{
+			settings.m_Render.m_EnableGpuProfiler = true;
+		}
+		else if (argument == "--bindless")
+		{
+			settings.m_Render.m_EnableBindless = true;
+		}
+	}
+
+	ZE::RunEngineScoped scopedEngine(settings);
 	scopedEngine.Run();
 }
@@ -12,6 +12,7 @@
 #include <memory>
 #include <vector>
 #include <type_traits>
+#include <utility>
 
 namespace ZE::Asset
 {
@@ -33,6 +34,9 @@ namespace ZE::Asset
 		virtual ~Asset() = default;
 
 		ZE_NON_COPYABLE_CLASS(Asset);
+
+		/* CPU memory held by the asset, charged against the residency budget of the asset manager. */
+		virtual uint64_t GetMemorySizeInByte() const { return 0; }
 	};
 	
 	class AssetPtrBase
@@ -45,13 +49,44 @@ namespace ZE::Asset
 		AssetPtrBase(AssetId assetId)
 			: m_Id{ std::move(assetId) }
 		{}
-		AssetPtrBase(const AssetPtrBase& other) { operator=(other); }
-		AssetPtrBase(AssetPtrBase&& other) noexcept { operator=(std::move(other)); }
+		AssetPtrBase(const AssetPtrBase& other)
+			: m_Id{ other.m_Id }, m_AssetRequest{ other.m_AssetRequest }
+		{
+			if (m_AssetRequest)
+			{
+				m_AssetRequest->AddRef();
+			}
+		}
+		AssetPtrBase(AssetPtrBase&& other) noexcept
+			: m_Id{ std::move(other.m_Id) }, m_AssetRequest{ std::exchange(other.m_AssetRequest, nullptr) }
+		{
+			other.m_Id = {};
+		}
+		~AssetPtrBase() { Reset(); }
 		
-		void SetPath(const Core::FilePath& filePath) { m_Id.SetPath(filePath); }
+		void SetPath(const Core::FilePath& filePath)
+		{
+			if (m_Id.GetPath() != filePath)
+			{
+				Reset();
+			}
+			m_Id.SetPath(filePath);
+		}
+
+		/* Drops the reference to the asset but keeps the path, so it can be requested again.
+		 * The asset stays resident until the asset manager runs out of its budget, or UnloadUnreferencedAssets() is called.
+		 */
+		void Reset()
+		{
+			if (m_AssetRequest)
+			{
+				m_AssetRequest->Release();
+				m_AssetRequest = nullptr;
+			}
+		}
 
 		bool HasSetPath() const { return m_Id.IsValid(); }
-		void WaitUntilLoaded() const { m_AssetRequest->WaitUntilLoaded(); }
+		void WaitUntilLoaded() const { if (m_AssetRequest) { m_AssetRequest->WaitUntilLoaded(); } }
 
 		std::string GetAssetTypeName() const { return m_Id.GetAssetTypeName(); }
 
@@ -59,14 +94,21 @@ namespace ZE::Asset
 		bool IsUnloaded() const { return GetLoadPhase() == EAssetLoadPhase::Unloaded; }
 		bool IsLoading() const { return GetLoadPhase() == EAssetLoadPhase::Loading; }
 		bool IsLoaded() const { return GetLoadPhase() == EAssetLoadPhase::Loaded; }
+		bool IsFailed() const { return GetLoadPhase() == EAssetLoadPhase::Failed; }
 
 		AssetPtrBase& operator=(const AssetPtrBase& other)
 		{
-			ZE_ASSERT(!m_AssetRequest || m_AssetRequest->IsUnloaded());
 			if (&other == this)
 			{
 				return *this;
 			}
+
+			// referenced first, assigning a ptr to the same asset must not drop it in between
+			if (other.m_AssetRequest)
+			{
+				other.m_AssetRequest->AddRef();
+			}
+			Reset();
 			
 			m_Id = other.m_Id;
 			m_AssetRequest = other.m_AssetRequest;
@@ -75,16 +117,16 @@ namespace ZE::Asset
 
 		AssetPtrBase& operator=(AssetPtrBase&& other) noexcept
 		{
-			ZE_ASSERT(!m_AssetRequest || m_AssetRequest->IsUnloaded());
 			if (&other == this)
 			{
 				return *this;
 			}
+
+			Reset();
 			
-			m_Id = other.m_Id;
-			m_AssetRequest = other.m_AssetRequest;
+			m_Id = std::move(other.m_Id);
+			m_AssetRequest = std::exchange(other.m_AssetRequest, nullptr);
 			other.m_Id = {};
-			other.m_AssetRequest = nullptr;
 			return *this;
 		}
 		
@@ -115,7 +157,7 @@ namespace ZE::Asset
 			: AssetPtrBase{ std::move(id) }
 		{}
 		AssetPtr(const AssetPtrBase& other) { operator=(other); }
-		AssetPtr(AssetPtrBase&& other) noexcept { operator=(other); other.m_Id = {}; other.m_AssetRequest = nullptr; }
+		AssetPtr(AssetPtrBase&& other) noexcept { operator=(std::move(other)); }
 		
 		const T* operator->() const { ZE_ASSERT(m_AssetRequest); return reinterpret_cast<const T*>(m_AssetRequest->GetAsset()); }
 		const T* GetAsset() const { ZE_ASSERT(m_AssetRequest); return reinterpret_cast<const T*>(m_AssetRequest->GetAsset()); }
@@ -132,16 +174,22 @@ namespace ZE::Asset
 
 		AssetPtr& operator=(const AssetPtrBase& other)
 		{
-			// TODO: asset is now loaded once and never get released during runtime. Unload mechanism is needed
-			ZE_ASSERT(!m_AssetRequest || m_AssetRequest->IsUnloaded());
-			if (&other == this)
+			if (Core::GetTypeName_Direct<T>() == other.GetAssetTypeName())
 			{
-				return *this;
+				AssetPtrBase::operator=(other);
+			}
+			else
+			{
+				ZE_LOG_FATAL("Try to assign a different type of asset ptr!");	
 			}
+			return *this;
+		}
 
+		AssetPtr& operator=(AssetPtrBase&& other) noexcept
+		{
 			if (Core::GetTypeName_Direct<T>() == other.GetAssetTypeName())
 			{
-				AssetPtrBase::operator=(*this, other);
+				AssetPtrBase::operator=(std::move(other));
 			}
 			else
 			{
@@ -2,14 +2,21 @@
 
 #include "Asset.h"
 #include "Core/Assertion.h"
+#include "Core/Hash.h"
 #include "Log/Log.h"
 
 #include <assimp/IOStream.hpp>
 #include <assimp/IOSystem.hpp>
 #include <assimp/scene.h>
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
 namespace ZE::Asset
 {
+	// Files opened for read are loaded through the file system, so they are served from mounted archives or mappings,
+	// only files opened for write go through a file stream.
 	class AssimpIOStream final : public Assimp::IOStream
 	{
 		friend class AssimpIOSystem;
@@ -20,6 +27,21 @@ namespace ZE::Asset
 		
 		size_t Read(void* pvBuffer, size_t pSize, size_t pCount) override
 		{
+			if (m_File.IsValid())
+			{
+				const auto data = m_File.GetData();
+				if (pSize == 0 || m_Position >= data.size())
+				{
+					return 0;
+				}
+
+				// only whole elements are read, as fread() does
+				const size_t count = std::min(pCount, (data.size() - m_Position) / pSize);
+				std::memcpy(pvBuffer, data.data() + m_Position, count * pSize);
+				m_Position += count * pSize;
+				return count;
+			}
+
 			if (!m_Stream.read(static_cast<char*>(pvBuffer), static_cast<long long>(pSize * pCount)))
 			{
 				return 0;
@@ -38,7 +60,29 @@ namespace ZE::Asset
 		
 		aiReturn Seek(size_t pOffset, aiOrigin pOrigin) override
 		{
-			auto pos = 0;
+			if (m_File.IsValid())
+			{
+				const size_t fileSize = m_File.GetData().size();
+				size_t position = pOffset;
+				if (pOrigin == aiOrigin_CUR)
+				{
+					position = m_Position + pOffset;
+				}
+				else if (pOrigin == aiOrigin_END)
+				{
+					// the offset is unsigned, so seeking from the end only goes backward
+					position = fileSize - pOffset;
+				}
+
+				if (position > fileSize)
+				{
+					return aiReturn_FAILURE;
+				}
+				m_Position = position;
+				return aiReturn_SUCCESS;
+			}
+
+			std::ios_base::seekdir pos = std::fstream::beg;
 			if (pOrigin == aiOrigin_SET)
 			{
 				pos = std::fstream::beg;
@@ -61,11 +105,19 @@ namespace ZE::Asset
 
 		size_t Tell() const override
 		{
+			if (m_File.IsValid())
+			{
+				return m_Position;
+			}
 			return m_Stream.tellg();
 		}
 		
 		size_t FileSize() const override
 		{
+			if (m_File.IsValid())
+			{
+				return m_File.GetData().size();
+			}
 			return m_FilePath.GetFileSize();
 		}
 		
@@ -78,14 +130,19 @@ namespace ZE::Asset
 
 		Core::FilePath						m_FilePath;
 		mutable std::fstream				m_Stream;
+
+		Core::FileHandle					m_File;
+		size_t								m_Position = 0;
 	};
 
+	AssimpIOSystem::AssimpIOSystem(std::vector<ImportedFile>* pOutReadFiles)
+		: m_pReadFiles(pOutReadFiles)
+	{
+	}
+
 	bool AssimpIOSystem::Exists(const char* pFile) const
 	{
-		auto path = Core::FilePath(pFile);
-		Core::FileSystem::Sanitize(path);
-		path = Core::FileSystem::ToAbsoluteEnginePath(path);
-		return path.IsExist();
+		return Core::FileSystem::Exists(Core::FilePath(pFile));
 	}
 		
 	char AssimpIOSystem::getOsSeparator() const
@@ -95,13 +152,32 @@ namespace ZE::Asset
 		
 	Assimp::IOStream* AssimpIOSystem::Open(const char* pFile, const char* pMode)
 	{
-		AssimpIOStream* pStream = new AssimpIOStream;
-			
 		auto path = Core::FilePath(pFile);
 		Core::FileSystem::Sanitize(path);
+
+		if (!strchr(pMode, 'w'))
+		{
+			auto file = Core::FileSystem::Load(path);
+			if (!file.IsValid())
+			{
+				return nullptr;
+			}
+
+			if (m_pReadFiles)
+			{
+				m_pReadFiles->emplace_back(path, Core::StableHash(file.GetData()));
+			}
+
+			AssimpIOStream* pStream = new AssimpIOStream;
+			pStream->m_File = std::move(file);
+			pStream->m_FilePath = path;
+			return pStream;
+		}
+
+		AssimpIOStream* pStream = new AssimpIOStream;
 		path = Core::FileSystem::ToAbsoluteEnginePath(path);
 			
-		int modeFlag = 0;
+		std::ios_base::openmode modeFlag = {};
 		for (auto i = 0ull; i < strlen(pMode); ++i)
 		{
 			const char c = pMode[i];
@@ -1,10 +1,13 @@
 ﻿#pragma once
 
 #include "Core/FileSystem.h"
+#include "AssetUrl.h"
 
 #include <assimp/IOStream.hpp>
 #include <assimp/IOSystem.hpp>
 
+#include <vector>
+
 namespace ZE::Asset
 {
 	class AssetRequest;
@@ -17,17 +20,36 @@ namespace ZE::Asset
 		virtual ~IAssetLoader() = default;
 
 		virtual bool Load(const Core::FilePath& filePath, AssetRequest& pAssetRequest) = 0;
+
+		/* Assets which are loaded before this one, e.g. the textures of a mesh or the shaders of a material.
+		 * Called on a worker thread before Load(), the loaded dependencies can be found through AssetRequest::GetDependencies().
+		 * A loader which has to read the asset to know them may set it on the request already, Load() then finds it there.
+		 */
+		virtual bool GatherDependencies(const Core::FilePath& filePath, AssetRequest& request, std::vector<AssetId>& outDependencies) { return true; }
 	};
 	
+	/* A file read by an import, hashed from the data the importer actually read. */
+	struct ImportedFile
+	{
+		Core::FilePath						m_Path;
+		uint64_t							m_ContentHash = 0;
+	};
+
 	class AssimpIOSystem final : public Assimp::IOSystem
 	{
 	public:
 
+		/* Files opened for read are recorded into the list if there is one, e.g. the buffers and textures referenced by a glTF. */
+		explicit AssimpIOSystem(std::vector<ImportedFile>* pOutReadFiles = nullptr);
 		virtual ~AssimpIOSystem() override = default;
 		
 		bool Exists(const char* pFile) const override;
 		char getOsSeparator() const override;
 		Assimp::IOStream* Open(const char* pFile, const char* pMode) override;
 		void Close(Assimp::IOStream* pFile) override;
+
+	private:
+
+		std::vector<ImportedFile>*			m_pReadFiles = nullptr;
 	};
 }
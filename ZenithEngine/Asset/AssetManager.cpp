@@ -1,10 +1,18 @@
 ﻿#include "AssetManager.h"
 
+#include "Asset.h"
+
 #include "Render/Shader.h"
 #include "Render/StaticMesh.h"
 #include "Render/Loader/ShaderLoader.h"
 #include "Render/Loader/StaticMeshLoader.h"
 
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <map>
+#include <ranges>
+
 namespace ZE::Asset
 {
 	void AssetRequest::AsyncLoad()
@@ -12,33 +20,75 @@ namespace ZE::Asset
 		SetLoadPhase(EAssetLoadPhase::Loading);
 				
 		auto& taskSystem = TaskSystem::TaskManager::Get();
-		m_AsyncLoadTaskHandle = taskSystem.RunTask([this]
+		taskSystem.RunTask([this]
 		{
+			if (!m_bDependenciesGathered)
+			{
+				m_bDependenciesGathered = true;
+				if (!m_Loader->GatherDependencies(m_Id.GetPath(), *this, m_DependencyIds))
+				{
+					m_FailureReason = "Failed to gather its dependencies";
+					SetLoadPhase(EAssetLoadPhase::Failed);
+					AssetManager::Get().OnRequestFinished(*this);
+					return;
+				}
+
+				if (!m_DependencyIds.empty())
+				{
+					// stays loading, the manager dispatches it again once the dependencies are finished
+					AssetManager::Get().OnRequestFinished(*this);
+					return;
+				}
+			}
+
 			if (!m_Loader->Load(m_Id.GetPath(), *this))
 			{
+				m_FailureReason = "The loader failed to load it";
 				SetLoadPhase(EAssetLoadPhase::Failed);
-				ZE_LOG_ERROR("Failed to load asset: {}", m_Id.GetPath().ToString().c_str());
 			}
 			else
 			{
+				// charged before the phase is published, so the eviction never sees a loaded request without its size
+				AssetManager::Get().OnRequestLoaded(*this);
 				SetLoadPhase(EAssetLoadPhase::Loaded);
 			}
+			AssetManager::Get().OnRequestFinished(*this);
 		});
 	}
 	
 	void AssetRequest::WaitUntilLoaded() const
 	{
-		m_AsyncLoadTaskHandle.Wait();
+		for (auto loadPhase = GetLoadPhase(); loadPhase == EAssetLoadPhase::Loading; loadPhase = GetLoadPhase())
+		{
+			m_LoadPhase.wait(loadPhase, std::memory_order::acquire);
+		}
+	}
+
+	void AssetRequest::AddRef() const
+	{
+		m_RefCount.fetch_add(1, std::memory_order::relaxed);
+		m_LastAccess.store(AssetManager::Get().GetAccessClock(), std::memory_order::relaxed);
+	}
+
+	void AssetRequest::Release() const
+	{
+		// recency of an unreferenced asset is the time it was last referenced
+		m_LastAccess.store(AssetManager::Get().GetAccessClock(), std::memory_order::relaxed);
+		const auto oldRefCount = m_RefCount.fetch_sub(1, std::memory_order::acq_rel);
+		ZE_ASSERT_LOG(oldRefCount > 0, "Asset request {} is released more than referenced!", m_Id.GetPath().ToString());
 	}
 
 	AssetManager::~AssetManager()
 	{
-		for (AssetRequest* pRequest : std::views::values(m_RequestedAssetMap))
+		for (auto& shard : m_RequestMapShards)
 		{
-			delete pRequest->m_Asset;
-			delete pRequest;
+			for (AssetRequest* pRequest : std::views::values(shard.m_RequestMap))
+			{
+				delete pRequest->m_Asset;
+				delete pRequest;
+			}
+			shard.m_RequestMap.clear();
 		}
-		m_AssetLoaderMap.clear();
 		
 		for (auto& pLoader : std::views::values(m_AssetLoaderMap))
 		{
@@ -55,56 +105,325 @@ namespace ZE::Asset
 	
 	void AssetManager::Update()
 	{
-		// TODO: [optimize] minimize critical section
-		std::lock_guard guard(m_Mutex);
-		
-		UpdateLoadingRequests();
-		
-		for (auto& pendingRequest : m_PendingRequests)
+		m_AccessClock.fetch_add(1, std::memory_order::relaxed);
+
+		// callbacks may drop their references, so before cancelling and evicting
+		ProcessCompletedRequests();
+
 		{
-			pendingRequest->AsyncLoad();
+			std::scoped_lock lock(m_PendingRequestMutex);
+			m_ReadyRequests.insert(m_ReadyRequests.end(), m_PendingRequests.begin(), m_PendingRequests.end());
+			m_PendingRequests.clear();
 		}
-		m_LoadingRequests[m_CurrentLoadingRequestIndex] = std::move(m_PendingRequests);
+
+		CancelUnreferencedRequests();
+		EvictUnreferencedAssets(GetResidencyBudget());
+		DispatchReadyRequests();
 	}
 	
 	void AssetManager::WaitUntilAllRequestsFinished()
 	{
-		// TODO: [optimize] minimize critical section
-		std::lock_guard guard(m_Mutex);
-
 		// call update to immediately dispatch new requests
 		Update();
 		
-		for (const auto* pLoadingRequest : std::move(m_LoadingRequests[m_CurrentLoadingRequestIndex]))
+		// requested from other threads after the last update, or callbacks added to finished requests, both wait for an update too
+		const auto HasQueuedWork = [this]
+		{
+			{
+				std::scoped_lock lock(m_PendingRequestMutex);
+				if (!m_PendingRequests.empty())
+				{
+					return true;
+				}
+			}
+			std::scoped_lock lock(m_ReadyCallbackMutex);
+			return !m_ReadyCallbacks.empty();
+		};
+
+		// dependencies and queued requests are only dispatched by updates, so update whenever a load is finished
+		for (;;)
 		{
-			pLoadingRequest->WaitUntilLoaded();
+			const auto inFlightCount = m_InFlightRequestCount.load(std::memory_order::acquire);
+			if (inFlightCount != 0)
+			{
+				m_InFlightRequestCount.wait(inFlightCount, std::memory_order::acquire);
+			}
+			else if (!m_CompletedHead.load(std::memory_order::acquire) && m_ReadyRequests.empty() && !HasQueuedWork())
+			{
+				break;
+			}
+			Update();
 		}
 	}
 
-	void AssetManager::UpdateLoadingRequests()
+	void AssetManager::ProcessCompletedRequests()
 	{
-		const uint8_t localIndex = m_CurrentLoadingRequestIndex;
-		const uint8_t localNextIndex = (m_CurrentLoadingRequestIndex + 1) % 2;
-		
-		for (auto* pLoadingRequest : m_LoadingRequests[localIndex])
+		// nodes are pushed in LIFO order, reverse them to process in the order they are finished
+		AssetRequest* pNode = m_CompletedHead.exchange(nullptr, std::memory_order::acquire);
+		AssetRequest* pReversed = nullptr;
+		while (pNode)
+		{
+			AssetRequest* pNext = pNode->m_pNextCompleted;
+			pNode->m_pNextCompleted = pReversed;
+			pReversed = pNode;
+			pNode = pNext;
+		}
+
+		for (AssetRequest* pRequest = pReversed; pRequest;)
 		{
-			if (const auto result = pLoadingRequest->GetLoadPhase(); result == EAssetLoadPhase::Loading)
+			// read before the callbacks, which may drop the last reference
+			AssetRequest* pNext = pRequest->m_pNextCompleted;
+			pRequest->m_pNextCompleted = nullptr;
+
+			if (pRequest->IsLoading())
 			{
-				m_LoadingRequests[localNextIndex].push_back(pLoadingRequest);
+				ResolveDependencies(pRequest);
 			}
-			else if (result == EAssetLoadPhase::Failed)
+			else
 			{
-				// TODO: failure fallback
-				ZE_ASSERT(false);
+				FinishRequest(pRequest);
 			}
-			else if (result == EAssetLoadPhase::Unloaded)
+
+			pRequest = pNext;
+		}
+
+		std::vector<std::pair<const AssetRequest*, AssetLoadCallback>> readyCallbacks;
+		{
+			std::scoped_lock lock(m_ReadyCallbackMutex);
+			readyCallbacks.swap(m_ReadyCallbacks);
+		}
+		for (auto& [pRequest, callback] : readyCallbacks)
+		{
+			callback(*pRequest);
+			pRequest->Release();
+		}
+	}
+
+	void AssetManager::OnRequestFinished(AssetRequest& request)
+	{
+		AssetRequest* pHead = m_CompletedHead.load(std::memory_order::relaxed);
+		do
+		{
+			request.m_pNextCompleted = pHead;
+		} while (!m_CompletedHead.compare_exchange_weak(pHead, &request, std::memory_order::release, std::memory_order::relaxed));
+
+		// every finished load lets the waiting main thread dispatch more
+		m_InFlightRequestCount.fetch_sub(1, std::memory_order::acq_rel);
+		m_InFlightRequestCount.notify_all();
+	}
+
+	void AssetManager::ResolveDependencies(AssetRequest* pRequest)
+	{
+		const auto dependencyIds = std::move(pRequest->m_DependencyIds);
+		std::unordered_set<AssetId> resolvedIds;
+		for (const auto& dependencyId : dependencyIds)
+		{
+			// a dependency listed twice is waited for once, otherwise its failure would fail the request twice
+			if (!resolvedIds.insert(dependencyId).second)
 			{
-				ZE_LOG_FATAL("Unexcepted load phase when updating loading requests.");
-				ZE_UNREACHABLE();
+				continue;
+			}
+
+			auto& shard = GetShard(dependencyId);
+			bool bCreated = false;
+			AssetRequest* pDependency = nullptr;
+			{
+				std::unique_lock lock(shard.m_Mutex);
+				pDependency = FindOrCreateRequestLocked(shard, dependencyId, bCreated);
+			}
+			pRequest->m_Dependencies.push_back(pDependency);
+
+			if (bCreated)
+			{
+				m_ReadyRequests.push_back(pDependency);
+			}
+
+			std::unordered_set<const AssetRequest*> visitedRequests;
+			if (pDependency == pRequest || DependsOn(pDependency, pRequest, visitedRequests))
+			{
+				FailRequest(pRequest, std::format("It depends on itself through {}", dependencyId.GetPath().ToString()));
+				return;
+			}
+
+			// only written by the main thread, no need to lock
+			if (!pDependency->m_bFinished)
+			{
+				pDependency->m_WaitingDependents.push_back(pRequest);
+				++pRequest->m_UnfinishedDependencyCount;
+			}
+			else if (pDependency->IsFailed())
+			{
+				FailRequest(pRequest, std::format("Its dependency {} failed", dependencyId.GetPath().ToString()));
+				return;
 			}
 		}
 
-		m_CurrentLoadingRequestIndex = localNextIndex;
+		if (pRequest->m_UnfinishedDependencyCount == 0)
+		{
+			m_ReadyRequests.push_back(pRequest);
+		}
+		else
+		{
+			m_WaitingRequests.insert(pRequest);
+		}
+	}
+
+	bool AssetManager::DependsOn(const AssetRequest* pRequest, const AssetRequest* pDependency, std::unordered_set<const AssetRequest*>& visitedRequests) const
+	{
+		return std::ranges::any_of(pRequest->m_Dependencies, [this, pDependency, &visitedRequests](const AssetRequest* pChild)
+		{
+			return pChild == pDependency || (visitedRequests.insert(pChild).second && DependsOn(pChild, pDependency, visitedRequests));
+		});
+	}
+
+	void AssetManager::FinishRequest(AssetRequest* pRequest)
+	{
+		const bool bFailed = pRequest->IsFailed();
+		if (bFailed)
+		{
+			ZE_LOG_ERROR("Failed to load asset {}: {}", pRequest->m_Id.GetPath().ToString(), pRequest->m_FailureReason);
+		}
+
+		std::vector<AssetLoadCallback> callbacks;
+		{
+			auto& shard = GetShard(pRequest->m_Id);
+			std::unique_lock lock(shard.m_Mutex);
+			pRequest->m_bFinished = true;
+			callbacks.swap(pRequest->m_Callbacks);
+		}
+
+		// before the callbacks, which may drop the last reference
+		for (AssetRequest* pDependent : std::exchange(pRequest->m_WaitingDependents, {}))
+		{
+			if (bFailed)
+			{
+				FailRequest(pDependent, std::format("Its dependency {} failed", pRequest->m_Id.GetPath().ToString()));
+			}
+			else if (--pDependent->m_UnfinishedDependencyCount == 0)
+			{
+				m_WaitingRequests.erase(pDependent);
+				m_ReadyRequests.push_back(pDependent);
+			}
+		}
+
+		for (auto& callback : callbacks)
+		{
+			callback(*pRequest);
+			pRequest->Release();
+		}
+	}
+
+	void AssetManager::FailRequest(AssetRequest* pRequest, std::string reason)
+	{
+		// a failed request never loads, so it doesn't need its dependencies anymore, nor what its loader had read ahead
+		ReleaseDependencies(pRequest);
+		delete std::exchange(pRequest->m_Asset, nullptr);
+		m_WaitingRequests.erase(pRequest);
+		pRequest->m_UnfinishedDependencyCount = 0;
+
+		pRequest->m_FailureReason = std::move(reason);
+		pRequest->SetLoadPhase(EAssetLoadPhase::Failed);
+		FinishRequest(pRequest);
+	}
+
+	void AssetManager::ReleaseDependencies(AssetRequest* pRequest)
+	{
+		for (AssetRequest* pDependency : std::exchange(pRequest->m_Dependencies, {}))
+		{
+			std::erase(pDependency->m_WaitingDependents, pRequest);
+			pDependency->Release();
+		}
+	}
+
+	void AssetManager::CancelUnreferencedRequests()
+	{
+		// dependents first, cancelling them may leave their queued dependencies unreferenced
+		std::erase_if(m_WaitingRequests, [this](AssetRequest* pRequest) { return pRequest->GetRefCount() == 0 && TryCancelRequest(pRequest); });
+		std::erase_if(m_ReadyRequests, [this](AssetRequest* pRequest) { return pRequest->GetRefCount() == 0 && TryCancelRequest(pRequest); });
+	}
+
+	bool AssetManager::TryCancelRequest(AssetRequest* pRequest)
+	{
+		{
+			auto& shard = GetShard(pRequest->m_Id);
+			std::unique_lock lock(shard.m_Mutex);
+			// may be requested again in between
+			if (pRequest->GetRefCount() != 0)
+			{
+				return false;
+			}
+			shard.m_RequestMap.erase(pRequest->m_Id);
+		}
+
+		// never dispatched, or waiting for its dependencies, so no task touches it
+		ReleaseDependencies(pRequest);
+		delete pRequest->m_Asset;
+		delete pRequest;
+		return true;
+	}
+
+	int32_t AssetManager::GetEffectivePriority(const AssetRequest* pRequest, std::unordered_map<const AssetRequest*, int32_t>& priorityCache) const
+	{
+		if (const auto iter = priorityCache.find(pRequest); iter != priorityCache.end())
+		{
+			return iter->second;
+		}
+
+		int32_t priority = pRequest->m_Priority.load(std::memory_order::relaxed);
+		for (const AssetRequest* pDependent : pRequest->m_WaitingDependents)
+		{
+			priority = std::max(priority, GetEffectivePriority(pDependent, priorityCache));
+		}
+		priorityCache.emplace(pRequest, priority);
+		return priority;
+	}
+
+	void AssetManager::DispatchReadyRequests()
+	{
+		const auto inFlightCount = m_InFlightRequestCount.load(std::memory_order::acquire);
+		if (m_ReadyRequests.empty() || inFlightCount >= m_MaxInFlightRequestCount)
+		{
+			return;
+		}
+
+		const auto dispatchCount = std::min<size_t>(m_MaxInFlightRequestCount - inFlightCount, m_ReadyRequests.size());
+		if (dispatchCount < m_ReadyRequests.size())
+		{
+			// priorities may change any time, so they are read again on every update. Stable, so equal priorities stay FIFO
+			std::vector<std::pair<int32_t, AssetRequest*>> prioritizedRequests;
+			prioritizedRequests.reserve(m_ReadyRequests.size());
+			std::unordered_map<const AssetRequest*, int32_t> priorityCache;
+			for (AssetRequest* pRequest : m_ReadyRequests)
+			{
+				prioritizedRequests.emplace_back(GetEffectivePriority(pRequest, priorityCache), pRequest);
+			}
+			std::ranges::stable_sort(prioritizedRequests, std::greater{}, &std::pair<int32_t, AssetRequest*>::first);
+			std::ranges::copy(std::views::values(prioritizedRequests), m_ReadyRequests.begin());
+		}
+
+		std::vector<AssetRequest*> dispatchedRequests(m_ReadyRequests.begin(), m_ReadyRequests.begin() + dispatchCount);
+		m_ReadyRequests.erase(m_ReadyRequests.begin(), m_ReadyRequests.begin() + dispatchCount);
+
+		for (AssetRequest* pRequest : dispatchedRequests)
+		{
+			if (!pRequest->m_Loader)
+			{
+				FailRequest(pRequest, std::format("No loader is registered for {}", pRequest->m_Id.GetAssetTypeName()));
+				continue;
+			}
+
+			// counted before dispatching, so no task can finish before it is counted
+			m_InFlightRequestCount.fetch_add(1, std::memory_order::relaxed);
+			pRequest->AsyncLoad();
+		}
+	}
+
+	void AssetManager::SetLoadPriority(const AssetPtrBase& assetPtr, int32_t priority)
+	{
+		if (assetPtr.m_AssetRequest)
+		{
+			assetPtr.m_AssetRequest->m_Priority.store(priority, std::memory_order::relaxed);
+		}
 	}
 	
 	void AssetManager::RequestLoad(AssetPtrBase& assetPtr)
@@ -115,27 +434,312 @@ namespace ZE::Asset
 			return;
 		}
 		
-		std::lock_guard guard(m_Mutex);
-		if (!m_RequestedAssetMap.contains(assetPtr.m_Id))
+		// a ptr keeps its request referenced, so it can't be unloaded in between
+		if (assetPtr.m_AssetRequest)
+		{
+			return;
+		}
+
+		auto& shard = GetShard(assetPtr.m_Id);
 		{
-			auto* pLoader = FindAssetLoader(assetPtr.GetAssetTypeName());
+			std::shared_lock lock(shard.m_Mutex);
+			if (const auto iter = shard.m_RequestMap.find(assetPtr.m_Id); iter != shard.m_RequestMap.end())
+			{
+				// ptrs of an already requested asset share its request
+				iter->second->AddRef();
+				assetPtr.m_AssetRequest = iter->second;
+				return;
+			}
+		}
+
+		std::vector<AssetRequest*> newRequests;
+		{
+			std::unique_lock lock(shard.m_Mutex);
+			AttachRequestLocked(shard, assetPtr, newRequests);
+		}
+
+		if (!newRequests.empty())
+		{
+			std::scoped_lock lock(m_PendingRequestMutex);
+			m_PendingRequests.insert(m_PendingRequests.end(), newRequests.begin(), newRequests.end());
+		}
+	}
+
+	void AssetManager::RequestLoad(AssetPtrBase& assetPtr, AssetLoadCallback callback)
+	{
+		RequestLoad(assetPtr);
+		if (assetPtr.m_AssetRequest)
+		{
+			AddLoadCallback(*assetPtr.m_AssetRequest, std::move(callback));
+		}
+	}
+
+	void AssetManager::RequestLoadBatch(std::span<AssetPtrBase* const> assetPtrs)
+	{
+		std::vector<std::pair<uint32_t, AssetPtrBase*>> shardedPtrs;
+		shardedPtrs.reserve(assetPtrs.size());
+		for (auto* pAssetPtr : assetPtrs)
+		{
+			if (!pAssetPtr || !pAssetPtr->HasSetPath())
+			{
+				ZE_LOG_WARNING("Request to load empty path asset.");
+				continue;
+			}
+
+			if (!pAssetPtr->m_AssetRequest)
+			{
+				shardedPtrs.emplace_back(static_cast<uint32_t>(pAssetPtr->m_Id.GetHash() % kRequestMapShardCount), pAssetPtr);
+			}
+		}
+		std::ranges::sort(shardedPtrs, {}, &std::pair<uint32_t, AssetPtrBase*>::first);
+
+		std::vector<AssetRequest*> newRequests;
+		for (auto iter = shardedPtrs.begin(); iter != shardedPtrs.end();)
+		{
+			auto& shard = m_RequestMapShards[iter->first];
+			std::unique_lock lock(shard.m_Mutex);
+			for (const auto shardIndex = iter->first; iter != shardedPtrs.end() && iter->first == shardIndex; ++iter)
+			{
+				AttachRequestLocked(shard, *iter->second, newRequests);
+			}
+		}
+
+		if (!newRequests.empty())
+		{
+			std::scoped_lock lock(m_PendingRequestMutex);
+			m_PendingRequests.insert(m_PendingRequests.end(), newRequests.begin(), newRequests.end());
+		}
+	}
+
+	void AssetManager::AttachRequestLocked(RequestMapShard& shard, AssetPtrBase& assetPtr, std::vector<AssetRequest*>& newRequests)
+	{
+		// the same ptr may be passed twice within a batch
+		if (assetPtr.m_AssetRequest)
+		{
+			return;
+		}
+
+		bool bCreated = false;
+		AssetRequest* pRequest = FindOrCreateRequestLocked(shard, assetPtr.m_Id, bCreated);
+		if (bCreated)
+		{
+			newRequests.push_back(pRequest);
+		}
+		assetPtr.m_AssetRequest = pRequest;
+	}
+
+	AssetRequest* AssetManager::FindOrCreateRequestLocked(RequestMapShard& shard, const AssetId& assetId, bool& bCreated)
+	{
+		auto iter = shard.m_RequestMap.find(assetId);
+		if (iter == shard.m_RequestMap.end())
+		{
+			auto* pLoader = FindAssetLoader(assetId.GetAssetTypeName());
 			if (!pLoader)
 			{
-				ZE_LOG_WARNING("Unknown resource type: {}. Can't find a valid loader for it.", assetPtr.GetAssetTypeName());
+				ZE_LOG_WARNING("Unknown resource type: {}. Can't find a valid loader for it.", assetId.GetAssetTypeName());
 			}
 			
 			AssetRequest* pRequest = new AssetRequest;
-			pRequest->m_Id = assetPtr.m_Id;
+			pRequest->m_Id = assetId;
 			pRequest->m_Loader = pLoader;
 
-			assetPtr.m_AssetRequest = pRequest;
-			m_RequestedAssetMap.emplace(assetPtr.m_Id, pRequest);
-			m_PendingRequests.push_back(pRequest);
+			iter = shard.m_RequestMap.emplace(assetId, pRequest).first;
+			bCreated = true;
+		}
+
+		iter->second->AddRef();
+		return iter->second;
+	}
+
+	void AssetManager::AddLoadCallback(const AssetRequest& request, AssetLoadCallback callback)
+	{
+		// the callback keeps the request alive until it is fired
+		request.AddRef();
+
+		{
+			auto& shard = GetShard(request.m_Id);
+			std::unique_lock lock(shard.m_Mutex);
+			if (!request.m_bFinished)
+			{
+				request.m_Callbacks.push_back(std::move(callback));
+				return;
+			}
+		}
+
+		std::scoped_lock lock(m_ReadyCallbackMutex);
+		m_ReadyCallbacks.emplace_back(&request, std::move(callback));
+	}
+
+	void AssetManager::UnloadUnreferencedAssets()
+	{
+		std::vector<AssetRequest*> unloadableRequests;
+		for (auto& shard : m_RequestMapShards)
+		{
+			std::shared_lock lock(shard.m_Mutex);
+			for (auto* pRequest : std::views::values(shard.m_RequestMap))
+			{
+				if (IsUnloadable(*pRequest))
+				{
+					unloadableRequests.push_back(pRequest);
+				}
+			}
+		}
+
+		// dependencies left unreferenced are appended as they are released, whichever shards they are in
+		size_t unloadedCount = 0;
+		for (size_t i = 0; i < unloadableRequests.size(); ++i)
+		{
+			AssetRequest* pRequest = unloadableRequests[i];
+			unloadedCount += TryUnloadRequest(pRequest, unloadableRequests) ? 1 : 0;
+		}
+		ZE_LOG_INFO("Unloaded {} unreferenced assets, {} bytes stay resident", unloadedCount, GetResidentSizeInByte());
+	}
+
+	std::vector<AssetTypeResidency> AssetManager::GetResidencyReport()
+	{
+		std::map<std::string, AssetTypeResidency> residencyMap;
+		for (auto& shard : m_RequestMapShards)
+		{
+			std::shared_lock lock(shard.m_Mutex);
+			for (const auto* pRequest : std::views::values(shard.m_RequestMap))
+			{
+				if (!pRequest->IsLoaded())
+				{
+					continue;
+				}
+
+				auto typeName = pRequest->m_Id.GetAssetTypeName();
+				auto& residency = residencyMap[typeName];
+				if (residency.m_AssetTypeName.empty())
+				{
+					residency.m_AssetTypeName = std::move(typeName);
+				}
+				++residency.m_ResidentCount;
+				residency.m_ReferencedCount += pRequest->GetRefCount() > 0 ? 1 : 0;
+				residency.m_MemorySizeInByte += pRequest->m_MemorySizeInByte;
+			}
+		}
+
+		std::vector<AssetTypeResidency> report;
+		report.reserve(residencyMap.size());
+		for (auto& residency : std::views::values(residencyMap))
+		{
+			report.emplace_back(std::move(residency));
+		}
+		std::ranges::sort(report, std::greater{}, &AssetTypeResidency::m_MemorySizeInByte);
+		return report;
+	}
+
+	void AssetManager::LogResidency()
+	{
+		ZE_LOG_INFO("Resident assets: {} / {} bytes", GetResidentSizeInByte(), GetResidencyBudget());
+		for (const auto& residency : GetResidencyReport())
+		{
+			ZE_LOG_INFO("\t{}: {} resident, {} referenced, {} bytes", residency.m_AssetTypeName, residency.m_ResidentCount, residency.m_ReferencedCount, residency.m_MemorySizeInByte);
+		}
+	}
+
+	void AssetManager::EvictUnreferencedAssets(uint64_t budgetInByte)
+	{
+		if (GetResidentSizeInByte() <= budgetInByte)
+		{
+			return;
+		}
+
+		std::vector<std::pair<uint64_t, AssetRequest*>> candidates;
+		for (auto& shard : m_RequestMapShards)
+		{
+			std::shared_lock lock(shard.m_Mutex);
+			for (auto* pRequest : std::views::values(shard.m_RequestMap))
+			{
+				if (IsUnloadable(*pRequest))
+				{
+					candidates.emplace_back(pRequest->m_LastAccess.load(std::memory_order::relaxed), pRequest);
+				}
+			}
 		}
+		std::ranges::sort(candidates, {}, &std::pair<uint64_t, AssetRequest*>::first);
+
+		std::vector<AssetRequest*> evictionOrder;
+		evictionOrder.reserve(candidates.size());
+		std::ranges::copy(std::views::values(candidates), std::back_inserter(evictionOrder));
+
+		// only the main thread deletes requests, so the candidates stay valid after the shared locks are dropped.
+		// Dependencies left unreferenced are appended, their last access is their release, so they are the most recent ones
+		for (size_t i = 0; i < evictionOrder.size(); ++i)
+		{
+			if (GetResidentSizeInByte() <= budgetInByte)
+			{
+				break;
+			}
+
+			AssetRequest* pRequest = evictionOrder[i];
+			TryUnloadRequest(pRequest, evictionOrder);
+		}
+
+		if (GetResidentSizeInByte() > budgetInByte)
+		{
+			ZE_LOG_WARNING("Referenced assets of {} bytes exceed the residency budget of {} bytes!", GetResidentSizeInByte(), budgetInByte);
+		}
+	}
+
+	bool AssetManager::IsUnloadable(const AssetRequest& request)
+	{
+		// requests not taken out of the completion queue yet are still linked in it
+		return request.GetRefCount() == 0 && request.m_bFinished;
+	}
+
+	bool AssetManager::TryUnloadRequest(AssetRequest* pRequest, std::vector<AssetRequest*>& outUnloadableDependencies)
+	{
+		// read before the request is deleted, a dependency declared twice is released twice but must be appended once
+		std::vector<AssetRequest*> dependencies = pRequest->m_Dependencies;
+		std::ranges::sort(dependencies);
+		const auto duplicates = std::ranges::unique(dependencies);
+		dependencies.erase(duplicates.begin(), duplicates.end());
+
+		{
+			auto& shard = GetShard(pRequest->m_Id);
+			std::unique_lock lock(shard.m_Mutex);
+			// may be requested again in between
+			if (!IsUnloadable(*pRequest))
+			{
+				return false;
+			}
+			shard.m_RequestMap.erase(pRequest->m_Id);
+			DeleteRequest(pRequest);
+		}
+
+		// a dependency referenced by this request is not in the candidates yet, it is appended by its last dependent only
+		for (AssetRequest* pDependency : dependencies)
+		{
+			if (IsUnloadable(*pDependency))
+			{
+				outUnloadableDependencies.push_back(pDependency);
+			}
+		}
+		return true;
+	}
+
+	void AssetManager::DeleteRequest(AssetRequest* pRequest)
+	{
+		if (pRequest->IsLoaded())
+		{
+			m_ResidentSizeInByte.fetch_sub(pRequest->m_MemorySizeInByte, std::memory_order::relaxed);
+		}
+		ReleaseDependencies(pRequest);
+		delete pRequest->m_Asset;
+		delete pRequest;
+	}
+
+	void AssetManager::OnRequestLoaded(AssetRequest& request)
+	{
+		request.m_MemorySizeInByte = request.m_Asset ? request.m_Asset->GetMemorySizeInByte() : 0;
+		m_ResidentSizeInByte.fetch_add(request.m_MemorySizeInByte, std::memory_order::relaxed);
 	}
 	
 	IAssetLoader* AssetManager::FindAssetLoader(const std::string& assetTypeName)
 	{
+		std::shared_lock lock(m_AssetLoaderMutex);
 		if (auto iter = m_AssetLoaderMap.find(assetTypeName); iter != m_AssetLoaderMap.end())
 		{
 			return iter->second;
@@ -145,7 +749,7 @@ namespace ZE::Asset
 	
 	void AssetManager::RegisterAssetLoader(std::string_view assetTypeName, IAssetLoader* pLoader)
 	{
-		std::lock_guard guard(m_Mutex);
+		std::unique_lock lock(m_AssetLoaderMutex);
 		if (auto iter = m_AssetLoaderMap.find(std::string(assetTypeName)); iter != m_AssetLoaderMap.end())
 		{
 			const auto* pOldLoader = iter->second;
@@ -4,13 +4,27 @@
 #include "AssetUrl.h"
 #include "TaskSystem/TaskManager.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
 #include <shared_mutex>
+#include <span>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace ZE::Asset
 {
 	class Asset;
+	class AssetRequest;
 	class IAssetLoader;
+
+	/* Called on the main thread once the request is finished, loaded or failed. */
+	using AssetLoadCallback = std::function<void(const AssetRequest& request)>;
 	
 	enum class EAssetLoadPhase : uint8_t
 	{
@@ -27,17 +41,31 @@ namespace ZE::Asset
 	public:
 
 		void AsyncLoad();
+		/* Returns immediately if the request is not dispatched by the asset manager yet. */
 		void WaitUntilLoaded() const;
 
 		void SetAsset(Asset* pAsset) { m_Asset = pAsset; }
 		Asset* GetAsset() const { return m_Asset; }
 
-		void SetLoadPhase(EAssetLoadPhase loadPhase) { m_LoadPhase.store(loadPhase, std::memory_order::release); }
+		void SetLoadPhase(EAssetLoadPhase loadPhase) { m_LoadPhase.store(loadPhase, std::memory_order::release); m_LoadPhase.notify_all(); }
 		EAssetLoadPhase GetLoadPhase() const { return m_LoadPhase.load(std::memory_order::acquire); }
 		
 		bool IsUnloaded() const { return m_LoadPhase.load(std::memory_order::acquire) == EAssetLoadPhase::Unloaded; }
 		bool IsLoading() const { return m_LoadPhase.load(std::memory_order::acquire) == EAssetLoadPhase::Loading; }
 		bool IsLoaded() const { return m_LoadPhase.load(std::memory_order::acquire) == EAssetLoadPhase::Loaded; }
+		bool IsFailed() const { return m_LoadPhase.load(std::memory_order::acquire) == EAssetLoadPhase::Failed; }
+
+		const AssetId& GetId() const { return m_Id; }
+		// only valid once the request is failed
+		const std::string& GetFailureReason() const { return m_FailureReason; }
+
+		/* Requests of the declared dependencies, all of them are loaded before the loader loads this one. */
+		const std::vector<AssetRequest*>& GetDependencies() const { return m_Dependencies; }
+
+		// counted by the asset ptrs pointing to the request, only unreferenced requests are unloaded
+		void AddRef() const;
+		void Release() const;
+		uint32_t GetRefCount() const { return m_RefCount.load(std::memory_order::acquire); }
 	
 	private:
 
@@ -45,7 +73,37 @@ namespace ZE::Asset
 		AssetId										m_Id;
 		IAssetLoader*								m_Loader = nullptr;
 		Asset*										m_Asset = nullptr;
-		TaskSystem::TaskHandle						m_AsyncLoadTaskHandle;
+		std::string									m_FailureReason;
+		// link of the completion queue of the manager
+		AssetRequest*								m_pNextCompleted = nullptr;
+
+		// written by the load task before the request is completed the first time
+		bool										m_bDependenciesGathered = false;
+		std::vector<AssetId>						m_DependencyIds;
+
+		// only touched by the main thread, each dependency is referenced by the request until it is deleted
+		std::vector<AssetRequest*>					m_Dependencies;
+		std::vector<AssetRequest*>					m_WaitingDependents;
+		uint32_t									m_UnfinishedDependencyCount = 0;
+
+		// guarded by the lock of the shard, set once the manager has taken the request out of the completion queue
+		mutable bool								m_bFinished = false;
+		mutable std::vector<AssetLoadCallback>		m_Callbacks;
+
+		mutable std::atomic<uint32_t>				m_RefCount = 0;
+		mutable std::atomic<int32_t>				m_Priority = 0;
+		// update index of the manager when the request was last referenced
+		mutable std::atomic<uint64_t>				m_LastAccess = 0;
+		uint64_t									m_MemorySizeInByte = 0;
+	};
+
+	/* Resident assets of one type, see AssetManager::GetResidencyReport(). */
+	struct AssetTypeResidency
+	{
+		std::string									m_AssetTypeName;
+		uint32_t									m_ResidentCount = 0;
+		uint32_t									m_ReferencedCount = 0;
+		uint64_t									m_MemorySizeInByte = 0;
 	};
 
 	class AssetPtrBase;
@@ -53,10 +111,22 @@ namespace ZE::Asset
 	template <typename T>
 	class AssetPtr;
 	
+	/* Loads assets asynchronously and keeps them resident while they are referenced.
+	 * Unreferenced assets stay cached until the resident memory exceeds the budget, then the least recently used ones are unloaded.
+	 * Requests can be made from any thread. The requested assets are spread over shards, each with its own lock, so concurrent
+	 * requests rarely contend, and a ptr which already holds its request never locks at all.
+	 * Loaders may declare dependencies of an asset, which are requested and loaded before it. Queued requests are dispatched by
+	 * priority, a dependency inherits the highest priority of the requests waiting on it. Requests nobody references anymore
+	 * are cancelled before they are dispatched.
+	 */
 	class AssetManager final
 	{
+		friend class AssetRequest;
+
 	public:
 
+		static constexpr int32_t kDefaultLoadPriority = 0;
+
 		~AssetManager();
 		
 		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(AssetManager);
@@ -66,15 +136,85 @@ namespace ZE::Asset
 		template <typename T>
 		void RegisterAssetLoader(IAssetLoader* pLoader) { RegisterAssetLoader(Core::GetTypeName_Direct<T>(), pLoader); }
 
-		// Only main thread can call update
+		// Only main thread can call update and wait, no lock is held while dispatching or waiting
 		void Update();
+		/* Also fires the callbacks added to requests which had already finished. */
 		void WaitUntilAllRequestsFinished();
 		
 		void RequestLoad(AssetPtrBase& assetPtr);
+		/* The callback is fired by the update which sees the request finished, callbacks of a request fire in the order they are added. */
+		void RequestLoad(AssetPtrBase& assetPtr, AssetLoadCallback callback);
+		/* Same as requesting each one, but locks each shard and the pending queue only once. */
+		void RequestLoadBatch(std::span<AssetPtrBase* const> assetPtrs);
+
+		/* Higher priorities are dispatched first, e.g. by the distance to the camera. Changes apply to requests not dispatched yet. */
+		void SetLoadPriority(const AssetPtrBase& assetPtr, int32_t priority);
+		/* Loads running at the same time, the rest stay queued by priority. */
+		void SetMaxInFlightRequestCount(uint32_t count) { m_MaxInFlightRequestCount = std::max(count, 1u); }
+
+		/* Budget of the memory of resident assets, checked on every update. */
+		void SetResidencyBudget(uint64_t budgetInByte) { m_ResidencyBudgetInByte.store(budgetInByte, std::memory_order::relaxed); }
+		uint64_t GetResidencyBudget() const { return m_ResidencyBudgetInByte.load(std::memory_order::relaxed); }
+		uint64_t GetResidentSizeInByte() const { return m_ResidentSizeInByte.load(std::memory_order::relaxed); }
+
+		/* Unloads every loaded asset which is not referenced, e.g. after switching levels, including the dependencies only they referenced.
+		 * Only main thread can call it.
+		 */
+		void UnloadUnreferencedAssets();
+
+		std::vector<AssetTypeResidency> GetResidencyReport();
+		void LogResidency();
 
 	private:
 
-		void UpdateLoadingRequests();
+		static constexpr uint32_t kRequestMapShardCount = 64;
+
+		// aligned to a cache line, so locking one shard doesn't invalidate its neighbors
+		struct alignas(64) RequestMapShard
+		{
+			std::shared_mutex									m_Mutex;
+			std::unordered_map<AssetId, AssetRequest*>			m_RequestMap;
+		};
+
+		RequestMapShard& GetShard(const AssetId& assetId) { return m_RequestMapShards[assetId.GetHash() % kRequestMapShardCount]; }
+
+		/* Finds or creates the request of the ptr within the locked shard, new requests are appended to the new requests. */
+		void AttachRequestLocked(RequestMapShard& shard, AssetPtrBase& assetPtr, std::vector<AssetRequest*>& newRequests);
+		/* Referenced by the caller, bCreated tells whether it has to be queued. */
+		AssetRequest* FindOrCreateRequestLocked(RequestMapShard& shard, const AssetId& assetId, bool& bCreated);
+
+		/* Drains the completion queue and fires the callbacks of the finished requests, in the order they are finished. */
+		void ProcessCompletedRequests();
+		void AddLoadCallback(const AssetRequest& request, AssetLoadCallback callback);
+
+		/* Requests the gathered dependencies, the request is queued again once all of them are finished. */
+		void ResolveDependencies(AssetRequest* pRequest);
+		/* Each request is visited once, so shared dependencies don't make it exponential. */
+		bool DependsOn(const AssetRequest* pRequest, const AssetRequest* pDependency, std::unordered_set<const AssetRequest*>& visitedRequests) const;
+		void FinishRequest(AssetRequest* pRequest);
+		void FailRequest(AssetRequest* pRequest, std::string reason);
+		void ReleaseDependencies(AssetRequest* pRequest);
+
+		/* Cancels queued requests which are not referenced anymore. */
+		void CancelUnreferencedRequests();
+		bool TryCancelRequest(AssetRequest* pRequest);
+		/* Cached per dispatch, a request waited on through many paths is evaluated once. */
+		int32_t GetEffectivePriority(const AssetRequest* pRequest, std::unordered_map<const AssetRequest*, int32_t>& priorityCache) const;
+		void DispatchReadyRequests();
+
+		/* Unloads unreferenced assets, least recently used first, until the resident memory fits into the budget. */
+		void EvictUnreferencedAssets(uint64_t budgetInByte);
+		static bool IsUnloadable(const AssetRequest& request);
+		/* Unloads the request unless it is referenced again, the dependencies it left unreferenced are appended to unload after it. */
+		bool TryUnloadRequest(AssetRequest* pRequest, std::vector<AssetRequest*>& outUnloadableDependencies);
+		// the caller removes it from the requested asset map
+		void DeleteRequest(AssetRequest* pRequest);
+
+		void OnRequestLoaded(AssetRequest& request);
+		// called by the load task as its last access to the request
+		void OnRequestFinished(AssetRequest& request);
+		// a plain load, so referencing assets from many threads never contends on the clock
+		uint64_t GetAccessClock() const { return m_AccessClock.load(std::memory_order::relaxed); }
 		
 		IAssetLoader* FindAssetLoader(const std::string& assetTypeName);
 
@@ -86,14 +226,32 @@ namespace ZE::Asset
 	
 	private:
 
-		std::unordered_map<AssetId, AssetRequest*>				m_RequestedAssetMap;
+		std::array<RequestMapShard, kRequestMapShardCount>		m_RequestMapShards;
+
+		std::shared_mutex										m_AssetLoaderMutex;
 		std::unordered_map<std::string, IAssetLoader*>			m_AssetLoaderMap;
 
+		// only held to swap the queue, requests are dispatched outside of it
+		std::mutex												m_PendingRequestMutex;
 		std::vector<AssetRequest*>								m_PendingRequests;
-		std::vector<AssetRequest*>								m_LoadingRequests[2];
-		uint8_t													m_CurrentLoadingRequestIndex = 0;			
 
-		std::recursive_mutex									m_Mutex;
+		// only touched by the main thread
+		std::vector<AssetRequest*>								m_ReadyRequests;
+		std::unordered_set<AssetRequest*>						m_WaitingRequests;
+		uint32_t												m_MaxInFlightRequestCount = 64;
+
+		// pushed by the load tasks without a lock, in LIFO order
+		std::atomic<AssetRequest*>								m_CompletedHead = nullptr;
+		std::atomic<uint32_t>									m_InFlightRequestCount = 0;
+
+		// callbacks added to requests which are already finished, fired by the next update
+		std::mutex												m_ReadyCallbackMutex;
+		std::vector<std::pair<const AssetRequest*, AssetLoadCallback>>	m_ReadyCallbacks;
+
+		std::atomic<uint64_t>									m_ResidencyBudgetInByte = 1024ull * 1024u * 1024u;
+		std::atomic<uint64_t>									m_ResidentSizeInByte = 0;
+		// advanced on every update, the request with the smallest access is the least recently used
+		std::atomic<uint64_t>									m_AccessClock = 0;
 	};
 
 }
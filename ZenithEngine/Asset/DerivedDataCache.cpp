@@ -0,0 +1,272 @@
+#include "DerivedDataCache.h"
+
+#include "Core/Assertion.h"
+#include "Core/Hash.h"
+#include "Log/Log.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ZE::Asset
+{
+	namespace
+	{
+		DerivedDataCache* gDerivedDataCache = nullptr;
+
+		constexpr std::string_view kEntryExtension = ".ddc";
+		constexpr std::string_view kTemporaryExtension = ".tmp";
+
+		void AppendHex(std::string& outString, uint64_t value)
+		{
+			char buffer[16];
+			const auto [pEnd, errorCode] = std::to_chars(std::begin(buffer), std::end(buffer), value, 16);
+			// fixed width, so names of the same importer line up
+			outString.append(static_cast<size_t>(std::end(buffer) - pEnd), '0');
+			outString.append(buffer, pEnd);
+		}
+	}
+
+	std::string DerivedDataKey::ToString() const
+	{
+		std::string name;
+		name.reserve(m_ImporterName.size() + 48u);
+		name += m_ImporterName;
+		name += "_v";
+		name += std::to_string(m_ImporterVersion);
+		name += '_';
+		AppendHex(name, m_SourceContentHash);
+		name += '_';
+		AppendHex(name, m_ImportSettingsHash);
+		return name;
+	}
+
+	DerivedDataCache::DerivedDataCache(const Settings& settings)
+		: m_Settings(settings)
+	{
+		ZE_ASSERT_LOG(!gDerivedDataCache, "Only one derived data cache can exist at a time!");
+		gDerivedDataCache = this;
+
+		Core::FileSystem::Sanitize(m_Settings.m_CachePath);
+		m_AbsoluteCachePath = Core::FileSystem::ToAbsoluteEnginePath(m_Settings.m_CachePath).ToString();
+		Scan();
+	}
+
+	DerivedDataCache::~DerivedDataCache()
+	{
+		gDerivedDataCache = nullptr;
+	}
+
+	DerivedDataCache& DerivedDataCache::Get()
+	{
+		ZE_ASSERT_LOG(gDerivedDataCache, "Derived data cache is accessed before the core module is initialized!");
+		return *gDerivedDataCache;
+	}
+
+	Core::FileHandle DerivedDataCache::Load(const DerivedDataKey& key)
+	{
+		const auto name = key.ToString();
+		{
+			std::shared_lock lock(m_Mutex);
+			const auto iter = m_Entries.find(name);
+			if (iter == m_Entries.end())
+			{
+				return {};
+			}
+			iter->second.m_LastAccess.store(++m_AccessClock, std::memory_order_relaxed);
+		}
+
+		auto handle = Core::FileSystem::Load(GetEntryPath(name));
+		if (!handle.IsValid())
+		{
+			// deleted behind our back, forget it so it is imported again
+			std::unique_lock lock(m_Mutex);
+			if (const auto iter = m_Entries.find(name); iter != m_Entries.end())
+			{
+				m_SizeInByte -= iter->second.m_SizeInByte;
+				m_Entries.erase(iter);
+			}
+			return {};
+		}
+
+		// the write time carries the recency over to the next launch
+		std::error_code errorCode;
+		std::filesystem::last_write_time(GetEntryPath(name), std::filesystem::file_time_type::clock::now(), errorCode);
+		return handle;
+	}
+
+	bool DerivedDataCache::Contains(const DerivedDataKey& key) const
+	{
+		std::shared_lock lock(m_Mutex);
+		return m_Entries.contains(key.ToString());
+	}
+
+	bool DerivedDataCache::Store(const DerivedDataKey& key, std::span<const std::byte> data)
+	{
+		auto name = key.ToString();
+		if (data.size() > m_Settings.m_MaxSizeInByte)
+		{
+			ZE_LOG_WARNING("Derived data {} of {} bytes exceeds the whole cache, it is not cached", name, data.size());
+			return false;
+		}
+
+		if (Contains(key))
+		{
+			// same key means same data, whoever stored it first wins
+			return true;
+		}
+
+		const auto entryPath = GetEntryPath(name);
+		auto temporaryPath = entryPath;
+		temporaryPath += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+		temporaryPath += kTemporaryExtension;
+
+		{
+			std::ofstream outFileStream(temporaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			outFileStream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+			if (!outFileStream.good())
+			{
+				ZE_LOG_WARNING("Failed to write derived data [{}]!", temporaryPath.string());
+				outFileStream.close();
+
+				std::error_code errorCode;
+				std::filesystem::remove(temporaryPath, errorCode);
+				return false;
+			}
+		}
+
+		std::error_code errorCode;
+		std::filesystem::rename(temporaryPath, entryPath, errorCode);
+		if (errorCode)
+		{
+			ZE_LOG_WARNING("Failed to store derived data [{}], error code: {}", entryPath.string(), errorCode.message());
+			std::filesystem::remove(temporaryPath, errorCode);
+			return false;
+		}
+
+		std::unique_lock lock(m_Mutex);
+		const auto [iter, bInserted] = m_Entries.try_emplace(std::move(name));
+		if (bInserted)
+		{
+			iter->second.m_SizeInByte = data.size();
+			m_SizeInByte += data.size();
+		}
+		iter->second.m_LastAccess.store(++m_AccessClock, std::memory_order_relaxed);
+
+		EvictLocked(iter->first);
+		return true;
+	}
+
+	uint64_t DerivedDataCache::HashSourceContent(const Core::FilePath& sourcePath)
+	{
+		const auto handle = Core::FileSystem::Load(sourcePath);
+		if (!handle.IsValid())
+		{
+			return 0;
+		}
+		return Core::StableHash(handle.GetData());
+	}
+
+	void DerivedDataCache::Scan()
+	{
+		std::error_code errorCode;
+		std::filesystem::create_directories(m_AbsoluteCachePath, errorCode);
+
+		struct ScannedEntry
+		{
+			std::string									m_Name;
+			uint64_t									m_SizeInByte = 0;
+			std::filesystem::file_time_type				m_LastWriteTime;
+		};
+		std::vector<ScannedEntry> scannedEntries;
+
+		for (const auto& directoryEntry : std::filesystem::directory_iterator(m_AbsoluteCachePath, errorCode))
+		{
+			if (!directoryEntry.is_regular_file(errorCode))
+			{
+				continue;
+			}
+
+			const auto& path = directoryEntry.path();
+			if (path.extension() == kTemporaryExtension)
+			{
+				// left behind by a writer which didn't finish
+				std::filesystem::remove(path, errorCode);
+				continue;
+			}
+
+			if (path.extension() == kEntryExtension)
+			{
+				auto& scannedEntry = scannedEntries.emplace_back();
+				scannedEntry.m_Name = path.stem().string();
+				scannedEntry.m_SizeInByte = directoryEntry.file_size(errorCode);
+				scannedEntry.m_LastWriteTime = directoryEntry.last_write_time(errorCode);
+			}
+		}
+
+		std::ranges::sort(scannedEntries, {}, &ScannedEntry::m_LastWriteTime);
+
+		std::unique_lock lock(m_Mutex);
+		for (auto& scannedEntry : scannedEntries)
+		{
+			auto& entry = m_Entries[std::move(scannedEntry.m_Name)];
+			entry.m_SizeInByte = scannedEntry.m_SizeInByte;
+			entry.m_LastAccess.store(++m_AccessClock, std::memory_order_relaxed);
+			m_SizeInByte += scannedEntry.m_SizeInByte;
+		}
+		EvictLocked({});
+
+		ZE_LOG_INFO("Derived data cache [{}] has {} entries, {} bytes", m_AbsoluteCachePath.string(), m_Entries.size(), GetSizeInByte());
+	}
+
+	void DerivedDataCache::EvictLocked(std::string_view protectedName)
+	{
+		if (GetSizeInByte() <= m_Settings.m_MaxSizeInByte)
+		{
+			return;
+		}
+
+		std::vector<std::pair<uint64_t, const std::string*>> candidates;
+		candidates.reserve(m_Entries.size());
+		for (const auto& [name, entry] : m_Entries)
+		{
+			if (name != protectedName)
+			{
+				candidates.emplace_back(entry.m_LastAccess.load(std::memory_order_relaxed), &name);
+			}
+		}
+		std::ranges::sort(candidates, {}, &std::pair<uint64_t, const std::string*>::first);
+
+		for (const auto& [lastAccess, pName] : candidates)
+		{
+			if (GetSizeInByte() <= m_Settings.m_MaxSizeInByte)
+			{
+				break;
+			}
+
+			// POSIX unlinks a file still mapped by loaded handles, they keep their mapping,
+			// but Windows refuses to delete a mapped file, the entry is kept and retried by a later eviction
+			std::error_code errorCode;
+			std::filesystem::remove(GetEntryPath(*pName), errorCode);
+			if (errorCode)
+			{
+				ZE_LOG_WARNING("Failed to evict derived data {}, error code: {}", *pName, errorCode.message());
+				continue;
+			}
+
+			const auto iter = m_Entries.find(*pName);
+			m_SizeInByte -= iter->second.m_SizeInByte;
+			m_Entries.erase(iter);
+		}
+	}
+
+	std::filesystem::path DerivedDataCache::GetEntryPath(std::string_view name) const
+	{
+		auto path = m_AbsoluteCachePath / name;
+		path += kEntryExtension;
+		return path;
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Core/ClassProperty.h"
+#include "Core/FileSystem.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace ZE::Asset
+{
+	/* Identity of an import output, any change of the source, the importer or its settings makes a new key. */
+	struct DerivedDataKey
+	{
+		// names the importer, e.g. StaticMesh, so outputs of different importers never collide
+		std::string_view					m_ImporterName;
+		// bump whenever the importer or its output format changes
+		uint32_t							m_ImporterVersion = 0;
+		uint64_t							m_SourceContentHash = 0;
+		uint64_t							m_ImportSettingsHash = 0;
+
+		std::string ToString() const;
+	};
+
+	/* Local on-disk cache of imported asset data, e.g. cooked meshes imported from source files.
+	 * Each output is one file named by its key, so looking up a key never reads an index. Outputs are written to a temporary file
+	 * and renamed into place, so a crashed or concurrent writer never leaves a partial one behind.
+	 * The total size is bounded, least recently used outputs are evicted first. Recency survives restarts through the file write times.
+	 * All functions are thread-safe, lookups only take a shared lock.
+	 */
+	class DerivedDataCache
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(DerivedDataCache);
+
+	public:
+
+		struct Settings
+		{
+			// relative to the engine mount path
+			Core::FilePath					m_CachePath = "/DerivedDataCache";
+			uint64_t						m_MaxSizeInByte = 4ull * 1024u * 1024u * 1024u;
+		};
+
+		explicit DerivedDataCache(const Settings& settings);
+		~DerivedDataCache();
+
+		/* Instance owned by the core module. */
+		static DerivedDataCache& Get();
+
+		/* Invalid handle if the key is not cached. */
+		Core::FileHandle Load(const DerivedDataKey& key);
+		bool Contains(const DerivedDataKey& key) const;
+		bool Store(const DerivedDataKey& key, std::span<const std::byte> data);
+
+		uint64_t GetSizeInByte() const { return m_SizeInByte.load(std::memory_order_relaxed); }
+
+		/* Core::StableHash() of the whole file, 0 if it can't be loaded. */
+		static uint64_t HashSourceContent(const Core::FilePath& sourcePath);
+
+	private:
+
+		struct Entry
+		{
+			uint64_t						m_SizeInByte = 0;
+			std::atomic<uint64_t>			m_LastAccess = 0;
+		};
+
+		void Scan();
+		/* Evict until the cache fits into the budget, never the protected entry. */
+		void EvictLocked(std::string_view protectedName);
+
+		std::filesystem::path GetEntryPath(std::string_view name) const;
+
+	private:
+
+		Settings							m_Settings;
+		std::filesystem::path				m_AbsoluteCachePath;
+
+		mutable std::shared_mutex			m_Mutex;
+		std::unordered_map<std::string, Entry>	m_Entries;
+		std::atomic<uint64_t>				m_SizeInByte = 0;
+		// logical clock of accesses, the entry with the smallest one is the least recently used
+		std::atomic<uint64_t>				m_AccessClock = 0;
+	};
+}
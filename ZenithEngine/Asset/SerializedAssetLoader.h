@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include "AssetLoader.h"
+#include "AssetManager.h"
+#include "Core/Serialization.h"
+
+#include <vector>
+
+namespace ZE::Asset
+{
+	/* Serialized assets referencing other assets, e.g. a material storing the paths of its textures, list them to be loaded first. */
+	template <typename T>
+	concept HasAssetDependencies = requires(const T& asset, std::vector<AssetId>& outDependencies)
+	{
+		asset.GetDependencies(outDependencies);
+	};
+
+	/* Load any reflected asset from its serialized binary, written by Core::SaveToFile().
+	 * e.g. AssetManager::Get().RegisterAssetLoader<Foo>(new SerializedAssetLoader<Foo>);
+	 */
+	template <typename T>
+	class SerializedAssetLoader final : public IAssetLoader
+	{
+	public:
+
+		virtual bool GatherDependencies(const Core::FilePath& filePath, AssetRequest& pAssetRequest, std::vector<AssetId>& outDependencies) override
+		{
+			if constexpr (HasAssetDependencies<T>)
+			{
+				// the dependencies are stored in the asset, so it is read here once and Load() keeps it
+				T* pAsset = new T;
+				if (!Core::LoadFromFile(filePath, *pAsset))
+				{
+					delete pAsset;
+					return false;
+				}
+
+				pAsset->GetDependencies(outDependencies);
+				pAssetRequest.SetAsset(pAsset);
+			}
+			return true;
+		}
+
+		virtual bool Load(const Core::FilePath& filePath, AssetRequest& pAssetRequest) override
+		{
+			if (pAssetRequest.GetAsset())
+			{
+				return true;
+			}
+
+			T* pAsset = new T;
+			if (!Core::LoadFromFile(filePath, *pAsset))
+			{
+				delete pAsset;
+				return false;
+			}
+
+			pAssetRequest.SetAsset(pAsset);
+			return true;
+		}
+	};
+}
@@ -0,0 +1,808 @@
+#include "AsyncFileIO.h"
+
+#include "Core/Assertion.h"
+#include "Log/Log.h"
+#include "TaskSystem/TaskManager.h"
+
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#	undef WIN32_LEAN_AND_MEAN
+#else
+#	include <cerrno>
+#	include <fcntl.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#	include <linux/io_uring.h>
+#	include <sys/mman.h>
+#	include <sys/syscall.h>
+#	include <sys/uio.h>
+#endif
+
+namespace ZE::Core
+{
+	namespace
+	{
+		AsyncFileIO* gAsyncFileIO = nullptr;
+
+		constexpr intptr_t kInvalidNativeFile = -1;
+		// a single read never exceeds what a 32-bit length can hold on every platform
+		constexpr uint64_t kMaxReadChunkSizeInByte = 1ull << 30;
+#if defined(_WIN32)
+		constexpr int32_t kCorruptedDataErrorCode = ERROR_INVALID_DATA;
+#else
+		constexpr int32_t kCorruptedDataErrorCode = EIO;
+#endif
+
+		int32_t GetLastErrorCode()
+		{
+#if defined(_WIN32)
+			return static_cast<int32_t>(GetLastError());
+#else
+			return errno;
+#endif
+		}
+
+		std::byte* GetReadDestination(IOReadPayload& payload)
+		{
+			return payload.m_Request.m_Destination.empty() ? payload.m_OwnedData.data() : payload.m_Request.m_Destination.data();
+		}
+
+		void CloseRequestFile(IOReadPayload& payload)
+		{
+			if (payload.m_NativeFile == kInvalidNativeFile)
+			{
+				return;
+			}
+
+#if defined(_WIN32)
+			CloseHandle(reinterpret_cast<HANDLE>(payload.m_NativeFile));
+#else
+			close(static_cast<int>(payload.m_NativeFile));
+#endif
+			payload.m_NativeFile = kInvalidNativeFile;
+		}
+
+		/* Open the file, resolve the size to read and allocate the memory unless the destination is given. Return the error code. */
+		int32_t OpenRequestFile(IOReadPayload& payload)
+		{
+			const auto& request = payload.m_Request;
+
+			uint64_t fileSize = 0;
+#if defined(_WIN32)
+			HANDLE file = CreateFileW(request.m_AbsolutePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+			{
+				return GetLastErrorCode();
+			}
+			payload.m_NativeFile = reinterpret_cast<intptr_t>(file);
+
+			LARGE_INTEGER size{};
+			if (!GetFileSizeEx(file, &size))
+			{
+				const int32_t errorCode = GetLastErrorCode();
+				CloseRequestFile(payload);
+				return errorCode;
+			}
+			fileSize = static_cast<uint64_t>(size.QuadPart);
+#else
+			const int file = open(request.m_AbsolutePath.c_str(), O_RDONLY | O_CLOEXEC);
+			if (file < 0)
+			{
+				return GetLastErrorCode();
+			}
+			payload.m_NativeFile = file;
+
+			struct stat fileStat{};
+			if (fstat(file, &fileStat) != 0)
+			{
+				const int32_t errorCode = GetLastErrorCode();
+				CloseRequestFile(payload);
+				return errorCode;
+			}
+			fileSize = static_cast<uint64_t>(fileStat.st_size);
+#endif
+
+			uint64_t totalSize = request.m_Offset < fileSize ? fileSize - request.m_Offset : 0u;
+			if (request.m_SizeInByte)
+			{
+				totalSize = std::min(totalSize, *request.m_SizeInByte);
+			}
+
+			if (!request.m_Destination.empty())
+			{
+				ZE_ASSERT_LOG(!request.m_SizeInByte || *request.m_SizeInByte <= request.m_Destination.size(), "Read of {} bytes can NOT fit into the destination of {} bytes!", request.m_SizeInByte.value_or(0), request.m_Destination.size());
+				totalSize = std::min<uint64_t>(totalSize, request.m_Destination.size());
+			}
+			else
+			{
+				payload.m_OwnedData.resize(totalSize);
+			}
+
+			payload.m_TotalSizeInByte = totalSize;
+			payload.m_ReadSizeInByte = 0;
+			return 0;
+		}
+
+		/* Blocking positional read of the whole request. Return the error code. */
+		int32_t ReadRequestFile(IOReadPayload& payload)
+		{
+			std::byte* pDestination = GetReadDestination(payload);
+			while (payload.m_ReadSizeInByte < payload.m_TotalSizeInByte)
+			{
+				const uint64_t chunkSize = std::min(payload.m_TotalSizeInByte - payload.m_ReadSizeInByte, kMaxReadChunkSizeInByte);
+				const uint64_t offset = payload.m_Request.m_Offset + payload.m_ReadSizeInByte;
+
+#if defined(_WIN32)
+				// offset of a synchronous handle read is taken from the overlapped struct
+				OVERLAPPED overlapped{};
+				overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFull);
+				overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+				DWORD readSize = 0;
+				if (!::ReadFile(reinterpret_cast<HANDLE>(payload.m_NativeFile), pDestination + payload.m_ReadSizeInByte, static_cast<DWORD>(chunkSize), &readSize, &overlapped))
+				{
+					const int32_t errorCode = GetLastErrorCode();
+					if (errorCode == ERROR_HANDLE_EOF)
+					{
+						break;
+					}
+					return errorCode;
+				}
+#else
+				const ssize_t readSize = pread(static_cast<int>(payload.m_NativeFile), pDestination + payload.m_ReadSizeInByte, chunkSize, static_cast<off_t>(offset));
+				if (readSize < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+					return GetLastErrorCode();
+				}
+#endif
+				if (readSize == 0)
+				{
+					// the file is truncated since it was opened
+					break;
+				}
+				payload.m_ReadSizeInByte += static_cast<uint64_t>(readSize);
+			}
+			return 0;
+		}
+
+		class ThreadPoolFileIOBackend final : public IAsyncFileIOBackend
+		{
+		public:
+
+			ThreadPoolFileIOBackend(AsyncFileIO& asyncFileIO, uint32_t threadCount)
+				: m_AsyncFileIO(asyncFileIO)
+			{
+				// dedicated threads, so blocking reads never occupy task workers
+				for (uint32_t i = 0; i < std::max(threadCount, 1u); ++i)
+				{
+					m_Threads.emplace_back([this] { Run(); });
+				}
+			}
+
+			virtual ~ThreadPoolFileIOBackend() override
+			{
+				for (auto& thread : m_Threads)
+				{
+					thread.join();
+				}
+			}
+
+			virtual const char* GetName() const override { return "thread pool"; }
+
+			// reads go straight into the memory, nothing to pin
+			virtual bool RegisterBuffers(std::span<const std::span<std::byte>>) override { return true; }
+			virtual void UnregisterBuffers() override {}
+
+		private:
+
+			void Run()
+			{
+				std::vector<std::shared_ptr<IOReadPayload>> requests;
+				while (m_AsyncFileIO.PopPendingRequests(requests, 1u, true))
+				{
+					for (const auto& pPayload : requests)
+					{
+						int32_t errorCode = OpenRequestFile(*pPayload);
+						if (errorCode == 0)
+						{
+							errorCode = ReadRequestFile(*pPayload);
+						}
+						CloseRequestFile(*pPayload);
+						m_AsyncFileIO.CompleteRequest(pPayload, errorCode);
+					}
+					requests.clear();
+				}
+			}
+
+		private:
+
+			AsyncFileIO&						m_AsyncFileIO;
+			std::vector<std::thread>			m_Threads;
+		};
+
+#if defined(__linux__)
+		/* Raw io_uring without liburing. One thread owns the ring: it opens the files of popped requests, fills the submission queue,
+		 * submits them in one io_uring_enter() and reaps completions. It only blocks on the pending queue when nothing is in flight,
+		 * otherwise on completions, so newly queued requests are submitted as soon as any read in flight finishes.
+		 */
+		class IoUringFileIOBackend final : public IAsyncFileIOBackend
+		{
+		public:
+
+			static std::unique_ptr<IoUringFileIOBackend> Create(AsyncFileIO& asyncFileIO, uint32_t queueDepth)
+			{
+				auto pBackend = std::unique_ptr<IoUringFileIOBackend>(new IoUringFileIOBackend(asyncFileIO, queueDepth));
+				if (!pBackend->Initialize())
+				{
+					return nullptr;
+				}
+
+				pBackend->m_Thread = std::thread([pRawBackend = pBackend.get()] { pRawBackend->Run(); });
+				return pBackend;
+			}
+
+			virtual ~IoUringFileIOBackend() override
+			{
+				if (m_Thread.joinable())
+				{
+					m_Thread.join();
+				}
+
+				if (m_Sqes)
+				{
+					munmap(m_Sqes, m_SqesSizeInByte);
+				}
+				if (m_CqRing && m_CqRing != m_SqRing)
+				{
+					munmap(m_CqRing, m_CqRingSizeInByte);
+				}
+				if (m_SqRing)
+				{
+					munmap(m_SqRing, m_SqRingSizeInByte);
+				}
+				if (m_RingFile >= 0)
+				{
+					close(m_RingFile);
+				}
+			}
+
+			virtual const char* GetName() const override { return "io_uring"; }
+
+			virtual bool RegisterBuffers(std::span<const std::span<std::byte>> buffers) override
+			{
+				UnregisterBuffers();
+				if (buffers.empty())
+				{
+					return true;
+				}
+
+				std::vector<iovec> iovecs;
+				iovecs.reserve(buffers.size());
+				for (const auto& buffer : buffers)
+				{
+					iovecs.push_back({ .iov_base = buffer.data(), .iov_len = buffer.size() });
+				}
+
+				// nothing is in flight, so the ring is idle and can be registered from any thread
+				if (syscall(__NR_io_uring_register, m_RingFile, IORING_REGISTER_BUFFERS, iovecs.data(), static_cast<unsigned>(iovecs.size())) < 0)
+				{
+					ZE_LOG_ERROR("Failed to register {} io_uring buffers, errno: {}", iovecs.size(), errno);
+					return false;
+				}
+				m_HasRegisteredBuffers = true;
+				return true;
+			}
+
+			virtual void UnregisterBuffers() override
+			{
+				if (m_HasRegisteredBuffers)
+				{
+					syscall(__NR_io_uring_register, m_RingFile, IORING_UNREGISTER_BUFFERS, nullptr, 0u);
+					m_HasRegisteredBuffers = false;
+				}
+			}
+
+		private:
+
+			IoUringFileIOBackend(AsyncFileIO& asyncFileIO, uint32_t queueDepth)
+				: m_AsyncFileIO(asyncFileIO), m_QueueDepth(std::max(queueDepth, 1u))
+			{}
+
+			bool Initialize()
+			{
+				io_uring_params params{};
+				m_RingFile = static_cast<int>(syscall(__NR_io_uring_setup, m_QueueDepth, &params));
+				if (m_RingFile < 0)
+				{
+					ZE_LOG_WARNING("io_uring is unavailable, errno: {}", errno);
+					return false;
+				}
+
+				// IORING_OP_READ comes with the same kernel (5.6) as this feature
+				if ((params.features & IORING_FEAT_RW_CUR_POS) == 0)
+				{
+					ZE_LOG_WARNING("io_uring of the kernel is too old, IORING_OP_READ is required");
+					return false;
+				}
+
+				m_SqRingSizeInByte = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+				m_CqRingSizeInByte = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+				const bool bSingleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+				if (bSingleMap)
+				{
+					m_SqRingSizeInByte = m_CqRingSizeInByte = std::max(m_SqRingSizeInByte, m_CqRingSizeInByte);
+				}
+
+				void* pSqRing = mmap(nullptr, m_SqRingSizeInByte, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFile, IORING_OFF_SQ_RING);
+				if (pSqRing == MAP_FAILED)
+				{
+					ZE_LOG_WARNING("Failed to map io_uring submission queue, errno: {}", errno);
+					return false;
+				}
+				m_SqRing = static_cast<std::byte*>(pSqRing);
+
+				if (bSingleMap)
+				{
+					m_CqRing = m_SqRing;
+				}
+				else
+				{
+					void* pCqRing = mmap(nullptr, m_CqRingSizeInByte, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFile, IORING_OFF_CQ_RING);
+					if (pCqRing == MAP_FAILED)
+					{
+						ZE_LOG_WARNING("Failed to map io_uring completion queue, errno: {}", errno);
+						return false;
+					}
+					m_CqRing = static_cast<std::byte*>(pCqRing);
+				}
+
+				m_SqesSizeInByte = params.sq_entries * sizeof(io_uring_sqe);
+				void* pSqes = mmap(nullptr, m_SqesSizeInByte, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFile, IORING_OFF_SQES);
+				if (pSqes == MAP_FAILED)
+				{
+					ZE_LOG_WARNING("Failed to map io_uring submission entries, errno: {}", errno);
+					return false;
+				}
+				m_Sqes = static_cast<io_uring_sqe*>(pSqes);
+
+				m_SqHead = reinterpret_cast<uint32_t*>(m_SqRing + params.sq_off.head);
+				m_SqTail = reinterpret_cast<uint32_t*>(m_SqRing + params.sq_off.tail);
+				m_SqMask = *reinterpret_cast<uint32_t*>(m_SqRing + params.sq_off.ring_mask);
+				m_SqEntryCount = params.sq_entries;
+				m_SqArray = reinterpret_cast<uint32_t*>(m_SqRing + params.sq_off.array);
+
+				m_CqHead = reinterpret_cast<uint32_t*>(m_CqRing + params.cq_off.head);
+				m_CqTail = reinterpret_cast<uint32_t*>(m_CqRing + params.cq_off.tail);
+				m_CqMask = *reinterpret_cast<uint32_t*>(m_CqRing + params.cq_off.ring_mask);
+				m_Cqes = reinterpret_cast<io_uring_cqe*>(m_CqRing + params.cq_off.cqes);
+
+				// the kernel rounds the entries up to a power of two
+				m_QueueDepth = std::min(m_QueueDepth, m_SqEntryCount);
+				return true;
+			}
+
+			void Run()
+			{
+				std::vector<std::shared_ptr<IOReadPayload>> requests;
+				while (true)
+				{
+					const auto freeSlotCount = static_cast<uint32_t>(m_QueueDepth - m_InFlightRequests.size());
+					if (freeSlotCount > 0)
+					{
+						// block on the queue only if there is no completion to wait for
+						const bool bPopped = m_AsyncFileIO.PopPendingRequests(requests, freeSlotCount, m_InFlightRequests.empty());
+						if (!bPopped && m_InFlightRequests.empty() && m_AsyncFileIO.IsShuttingDown())
+						{
+							break;
+						}
+
+						for (const auto& pPayload : requests)
+						{
+							const int32_t errorCode = OpenRequestFile(*pPayload);
+							if (errorCode != 0 || pPayload->m_TotalSizeInByte == 0)
+							{
+								CloseRequestFile(*pPayload);
+								m_AsyncFileIO.CompleteRequest(pPayload, errorCode);
+								continue;
+							}
+
+							m_InFlightRequests.emplace(pPayload.get(), pPayload);
+							PrepareRead(*pPayload);
+						}
+						requests.clear();
+					}
+
+					if (m_InFlightRequests.empty())
+					{
+						continue;
+					}
+
+					// submit the whole batch and wait for at least one completion in the same call
+					if (!Enter(1u))
+					{
+						FailAllInFlightRequests(GetLastErrorCode());
+						continue;
+					}
+					ReapCompletions();
+				}
+			}
+
+			void PrepareRead(IOReadPayload& payload)
+			{
+				// the submission queue holds at least the queue depth, and each request in flight has at most one entry
+				const uint32_t tail = *m_SqTail;
+				ZE_ASSERT(tail - std::atomic_ref<uint32_t>(*m_SqHead).load(std::memory_order_acquire) < m_SqEntryCount);
+
+				const uint32_t index = tail & m_SqMask;
+				io_uring_sqe& sqe = m_Sqes[index];
+				sqe = {};
+
+				const uint64_t chunkSize = std::min(payload.m_TotalSizeInByte - payload.m_ReadSizeInByte, kMaxReadChunkSizeInByte);
+				sqe.opcode = payload.m_RegisteredBufferIndex != ~0u ? IORING_OP_READ_FIXED : IORING_OP_READ;
+				sqe.fd = static_cast<int>(payload.m_NativeFile);
+				sqe.off = payload.m_Request.m_Offset + payload.m_ReadSizeInByte;
+				sqe.addr = reinterpret_cast<uint64_t>(GetReadDestination(payload) + payload.m_ReadSizeInByte);
+				sqe.len = static_cast<uint32_t>(chunkSize);
+				sqe.user_data = reinterpret_cast<uint64_t>(&payload);
+				if (payload.m_RegisteredBufferIndex != ~0u)
+				{
+					sqe.buf_index = static_cast<uint16_t>(payload.m_RegisteredBufferIndex);
+				}
+
+				m_SqArray[index] = index;
+				std::atomic_ref<uint32_t>(*m_SqTail).store(tail + 1, std::memory_order_release);
+				++m_UnsubmittedCount;
+			}
+
+			bool Enter(uint32_t minCompleteCount)
+			{
+				while (true)
+				{
+					const long result = syscall(__NR_io_uring_enter, m_RingFile, m_UnsubmittedCount, minCompleteCount, IORING_ENTER_GETEVENTS, nullptr, 0);
+					if (result >= 0)
+					{
+						m_UnsubmittedCount -= std::min(m_UnsubmittedCount, static_cast<uint32_t>(result));
+						return true;
+					}
+
+					if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+					{
+						ZE_LOG_ERROR("io_uring_enter failed, errno: {}", errno);
+						return false;
+					}
+				}
+			}
+
+			void ReapCompletions()
+			{
+				uint32_t head = *m_CqHead;
+				const uint32_t tail = std::atomic_ref<uint32_t>(*m_CqTail).load(std::memory_order_acquire);
+				for (; head != tail; ++head)
+				{
+					const io_uring_cqe& cqe = m_Cqes[head & m_CqMask];
+					auto iter = m_InFlightRequests.find(reinterpret_cast<IOReadPayload*>(cqe.user_data));
+					ZE_ASSERT(iter != m_InFlightRequests.end());
+					auto& payload = *iter->second;
+
+					if (cqe.res == -EINTR || cqe.res == -EAGAIN)
+					{
+						PrepareRead(payload);
+						continue;
+					}
+
+					if (cqe.res > 0)
+					{
+						payload.m_ReadSizeInByte += static_cast<uint64_t>(cqe.res);
+						if (payload.m_ReadSizeInByte < payload.m_TotalSizeInByte)
+						{
+							// short read, continue from where it stopped
+							PrepareRead(payload);
+							continue;
+						}
+					}
+
+					// zero is the end of the file
+					CloseRequestFile(payload);
+					m_AsyncFileIO.CompleteRequest(iter->second, cqe.res < 0 ? -cqe.res : 0);
+					m_InFlightRequests.erase(iter);
+				}
+				std::atomic_ref<uint32_t>(*m_CqHead).store(head, std::memory_order_release);
+			}
+
+			void FailAllInFlightRequests(int32_t errorCode)
+			{
+				// entries the kernel never took are dropped with their requests
+				*m_SqTail = std::atomic_ref<uint32_t>(*m_SqTail).load(std::memory_order_relaxed) - m_UnsubmittedCount;
+				m_UnsubmittedCount = 0;
+
+				for (auto& [pRawPayload, pPayload] : m_InFlightRequests)
+				{
+					CloseRequestFile(*pPayload);
+					m_AsyncFileIO.CompleteRequest(pPayload, errorCode);
+				}
+				m_InFlightRequests.clear();
+			}
+
+		private:
+
+			AsyncFileIO&													m_AsyncFileIO;
+			uint32_t														m_QueueDepth = 0;
+			std::thread														m_Thread;
+
+			int																m_RingFile = -1;
+			std::byte*														m_SqRing = nullptr;
+			std::byte*														m_CqRing = nullptr;
+			io_uring_sqe*													m_Sqes = nullptr;
+			size_t															m_SqRingSizeInByte = 0;
+			size_t															m_CqRingSizeInByte = 0;
+			size_t															m_SqesSizeInByte = 0;
+
+			uint32_t*														m_SqHead = nullptr;
+			uint32_t*														m_SqTail = nullptr;
+			uint32_t*														m_SqArray = nullptr;
+			uint32_t														m_SqMask = 0;
+			uint32_t														m_SqEntryCount = 0;
+			uint32_t*														m_CqHead = nullptr;
+			uint32_t*														m_CqTail = nullptr;
+			io_uring_cqe*													m_Cqes = nullptr;
+			uint32_t														m_CqMask = 0;
+
+			uint32_t														m_UnsubmittedCount = 0;
+			bool															m_HasRegisteredBuffers = false;
+			// only touched by the ring thread
+			std::unordered_map<IOReadPayload*, std::shared_ptr<IOReadPayload>>	m_InFlightRequests;
+		};
+#endif
+	}
+
+	void IORequestHandle::Wait() const
+	{
+		if (m_Payload)
+		{
+			m_Payload->m_IsFinished.wait(false, std::memory_order_acquire);
+		}
+	}
+
+	const IOReadResult& IORequestHandle::GetResult() const
+	{
+		ZE_ASSERT_LOG(IsFinished(), "Result of a read is accessed before it is finished!");
+		return m_Payload->m_Result;
+	}
+
+	AsyncFileIO::AsyncFileIO(const Settings& settings)
+		: m_Settings(settings)
+	{
+		ZE_ASSERT_LOG(!gAsyncFileIO, "Only one async file I/O can exist at a time!");
+		gAsyncFileIO = this;
+
+#if defined(__linux__)
+		if (!m_Settings.m_ForceThreadPoolBackend)
+		{
+			m_Backend = IoUringFileIOBackend::Create(*this, m_Settings.m_QueueDepth);
+		}
+#endif
+		if (!m_Backend)
+		{
+			m_Backend = std::make_unique<ThreadPoolFileIOBackend>(*this, m_Settings.m_FallbackThreadCount);
+		}
+		ZE_LOG_INFO("Async file I/O uses {} backend", m_Backend->GetName());
+	}
+
+	AsyncFileIO::~AsyncFileIO()
+	{
+		WaitUntilIdle();
+
+		{
+			std::scoped_lock lock(m_Mutex);
+			m_IsShuttingDown.store(true, std::memory_order_release);
+		}
+		m_PendingCondition.notify_all();
+		m_Backend.reset();
+
+		gAsyncFileIO = nullptr;
+	}
+
+	AsyncFileIO& AsyncFileIO::Get()
+	{
+		ZE_ASSERT_LOG(gAsyncFileIO, "Async file I/O is accessed before the core module is initialized!");
+		return *gAsyncFileIO;
+	}
+
+	IORequestHandle AsyncFileIO::Read(IOReadRequest request)
+	{
+		auto pPayload = std::make_shared<IOReadPayload>();
+		pPayload->m_Request = std::move(request);
+
+		{
+			std::scoped_lock lock(m_Mutex);
+			QueueLocked(pPayload);
+		}
+		m_PendingCondition.notify_one();
+		return IORequestHandle(std::move(pPayload));
+	}
+
+	std::vector<IORequestHandle> AsyncFileIO::ReadBatch(std::vector<IOReadRequest> requests)
+	{
+		std::vector<IORequestHandle> handles;
+		handles.reserve(requests.size());
+		for (auto& request : requests)
+		{
+			auto pPayload = std::make_shared<IOReadPayload>();
+			pPayload->m_Request = std::move(request);
+			handles.push_back(IORequestHandle(std::move(pPayload)));
+		}
+
+		{
+			std::scoped_lock lock(m_Mutex);
+			for (const auto& handle : handles)
+			{
+				QueueLocked(handle.m_Payload);
+			}
+		}
+		m_PendingCondition.notify_all();
+		return handles;
+	}
+
+	bool AsyncFileIO::RegisterBuffers(std::vector<std::span<std::byte>> buffers)
+	{
+		std::scoped_lock lock(m_Mutex);
+		ZE_ASSERT_LOG(m_OutstandingRequestCount == 0, "Buffers are registered while {} reads are outstanding!", m_OutstandingRequestCount);
+
+		if (!m_Backend->RegisterBuffers(buffers))
+		{
+			m_RegisteredBuffers.clear();
+			return false;
+		}
+		m_RegisteredBuffers = std::move(buffers);
+		return true;
+	}
+
+	void AsyncFileIO::UnregisterBuffers()
+	{
+		std::scoped_lock lock(m_Mutex);
+		ZE_ASSERT_LOG(m_OutstandingRequestCount == 0, "Buffers are unregistered while {} reads are outstanding!", m_OutstandingRequestCount);
+
+		m_Backend->UnregisterBuffers();
+		m_RegisteredBuffers.clear();
+	}
+
+	void AsyncFileIO::WaitUntilIdle()
+	{
+		std::unique_lock lock(m_Mutex);
+		m_IdleCondition.wait(lock, [this] { return m_OutstandingRequestCount == 0; });
+	}
+
+	const char* AsyncFileIO::GetBackendName() const
+	{
+		return m_Backend->GetName();
+	}
+
+	uint32_t AsyncFileIO::GetOutstandingRequestCount() const
+	{
+		std::scoped_lock lock(m_Mutex);
+		return m_OutstandingRequestCount;
+	}
+
+	bool AsyncFileIO::PopPendingRequests(std::vector<std::shared_ptr<IOReadPayload>>& outRequests, uint32_t maxCount, bool bWait)
+	{
+		std::unique_lock lock(m_Mutex);
+
+		const auto HasPendingRequest = [this]
+		{
+			return std::ranges::any_of(m_PendingRequests, [](const auto& queue) { return !queue.empty(); });
+		};
+
+		if (bWait)
+		{
+			m_PendingCondition.wait(lock, [&] { return IsShuttingDown() || HasPendingRequest(); });
+		}
+
+		// highest priority first
+		for (auto iter = m_PendingRequests.rbegin(); iter != m_PendingRequests.rend() && outRequests.size() < maxCount; ++iter)
+		{
+			while (!iter->empty() && outRequests.size() < maxCount)
+			{
+				outRequests.push_back(std::move(iter->front()));
+				iter->pop_front();
+			}
+		}
+		return !outRequests.empty();
+	}
+
+	void AsyncFileIO::CompleteRequest(const std::shared_ptr<IOReadPayload>& pPayload, int32_t errorCode)
+	{
+		auto& payload = *pPayload;
+		if (payload.m_Request.m_Destination.empty())
+		{
+			payload.m_OwnedData.resize(payload.m_ReadSizeInByte);
+		}
+
+		payload.m_Result.m_ErrorCode = errorCode;
+		if (errorCode == 0)
+		{
+			payload.m_Result.m_Data = std::span<const std::byte>(GetReadDestination(payload), payload.m_ReadSizeInByte);
+		}
+
+		if (errorCode == 0 && payload.m_Request.m_Compression != ECompressionMethod::None)
+		{
+			// keep decompression off the I/O threads, the request stays outstanding until it is done
+			TaskSystem::TaskManager::Get().RunTask([this, pPayload]
+			{
+				auto& payload = *pPayload;
+				payload.m_DecompressedData.resize(payload.m_Request.m_UncompressedSizeInByte);
+				if (Decompress(payload.m_Request.m_Compression, payload.m_Result.m_Data, payload.m_DecompressedData))
+				{
+					payload.m_Result.m_Data = payload.m_DecompressedData;
+				}
+				else
+				{
+					ZE_LOG_ERROR("Failed to decompress [{}] at offset {}, the data is corrupted!", payload.m_Request.m_AbsolutePath.string(), payload.m_Request.m_Offset);
+					payload.m_DecompressedData.clear();
+					payload.m_Result.m_ErrorCode = kCorruptedDataErrorCode;
+					payload.m_Result.m_Data = {};
+				}
+				FinishRequest(pPayload);
+			});
+			return;
+		}
+
+		FinishRequest(pPayload);
+	}
+
+	void AsyncFileIO::FinishRequest(const std::shared_ptr<IOReadPayload>& pPayload)
+	{
+		auto& payload = *pPayload;
+		payload.m_IsFinished.store(true, std::memory_order_release);
+		payload.m_IsFinished.notify_all();
+
+		if (payload.m_Request.m_Callback)
+		{
+			// the payload keeps the data alive until the callback returns
+			TaskSystem::TaskManager::Get().RunTask([pPayload]
+			{
+				pPayload->m_Request.m_Callback(pPayload->m_Result);
+			});
+		}
+
+		{
+			std::scoped_lock lock(m_Mutex);
+			ZE_ASSERT(m_OutstandingRequestCount > 0);
+			--m_OutstandingRequestCount;
+		}
+		m_IdleCondition.notify_all();
+	}
+
+	void AsyncFileIO::QueueLocked(const std::shared_ptr<IOReadPayload>& pPayload)
+	{
+		ZE_ASSERT_LOG(!IsShuttingDown(), "Read is requested while async file I/O is shutting down!");
+
+		const auto& destination = pPayload->m_Request.m_Destination;
+		if (!destination.empty())
+		{
+			const auto iter = std::ranges::find_if(m_RegisteredBuffers, [&destination](const std::span<std::byte>& buffer)
+			{
+				return destination.data() >= buffer.data() && destination.data() + destination.size() <= buffer.data() + buffer.size();
+			});
+			if (iter != m_RegisteredBuffers.end())
+			{
+				pPayload->m_RegisteredBufferIndex = static_cast<uint32_t>(std::distance(m_RegisteredBuffers.begin(), iter));
+			}
+		}
+
+		const auto priority = std::min(static_cast<size_t>(pPayload->m_Request.m_Priority), m_PendingRequests.size() - 1);
+		m_PendingRequests[priority].push_back(pPayload);
+		++m_OutstandingRequestCount;
+	}
+}
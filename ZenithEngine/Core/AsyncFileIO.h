@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Core/ClassProperty.h"
+#include "Core/Compression.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace ZE::Core
+{
+	class AsyncFileIO;
+
+	enum class EIOPriority : uint8_t
+	{
+		Low = 0,
+		Normal,
+		// e.g. data the current frame is waiting for
+		High,
+		Count,
+	};
+
+	struct IOReadResult
+	{
+		// errno on POSIX, GetLastError() on Windows, 0 on success
+		int32_t								m_ErrorCode = 0;
+		// read bytes, may be shorter than requested if the file ends before
+		std::span<const std::byte>			m_Data;
+
+		bool IsSucceeded() const { return m_ErrorCode == 0; }
+	};
+
+	/* Called on a task thread once the read is finished, the data is owned by the request and outlives the call as long as its handle. */
+	using IOReadCallback = std::function<void(const IOReadResult&)>;
+
+	struct IOReadRequest
+	{
+		std::filesystem::path				m_AbsolutePath;
+		uint64_t							m_Offset = 0;
+		// empty to read from the offset to the end of the file
+		std::optional<uint64_t>				m_SizeInByte;
+		// read into the memory if it is not empty, e.g. a range of a registered buffer, otherwise the request allocates the memory
+		std::span<std::byte>				m_Destination;
+		EIOPriority							m_Priority = EIOPriority::Normal;
+		IOReadCallback						m_Callback;
+
+		// the read bytes are compressed, e.g. an archive entry, they are decompressed on a task thread before the read is finished
+		ECompressionMethod					m_Compression = ECompressionMethod::None;
+		uint64_t							m_UncompressedSizeInByte = 0;
+	};
+
+	struct IOReadPayload
+	{
+		IOReadRequest						m_Request;
+		// index into the registered buffers if the destination lies inside one of them
+		uint32_t							m_RegisteredBufferIndex = ~0u;
+
+		std::vector<std::byte>				m_OwnedData;
+		std::vector<std::byte>				m_DecompressedData;
+		IOReadResult						m_Result;
+		std::atomic<bool>					m_IsFinished = false;
+
+		// backend states of the read in flight
+		intptr_t							m_NativeFile = -1;
+		uint64_t							m_TotalSizeInByte = 0;
+		uint64_t							m_ReadSizeInByte = 0;
+	};
+
+	/* Non-blocking handle of an asynchronous read. */
+	class IORequestHandle
+	{
+		friend class AsyncFileIO;
+
+	public:
+
+		IORequestHandle() = default;
+
+		bool IsValid() const { return m_Payload != nullptr; }
+		bool IsFinished() const { return m_Payload && m_Payload->m_IsFinished.load(std::memory_order_acquire); }
+
+		/* Block until the read is finished, its callback may still be running. */
+		void Wait() const;
+
+		/* Only valid once finished. */
+		const IOReadResult& GetResult() const;
+
+	private:
+
+		explicit IORequestHandle(std::shared_ptr<IOReadPayload> pPayload)
+			: m_Payload(std::move(pPayload))
+		{}
+
+	private:
+
+		std::shared_ptr<IOReadPayload>		m_Payload;
+	};
+
+	class IAsyncFileIOBackend
+	{
+	public:
+
+		virtual ~IAsyncFileIOBackend() = default;
+
+		virtual const char* GetName() const = 0;
+		virtual bool RegisterBuffers(std::span<const std::span<std::byte>> buffers) = 0;
+		virtual void UnregisterBuffers() = 0;
+	};
+
+	/* Asynchronous file reads which never block task workers.
+	 * On Linux reads go through io_uring, one I/O thread keeps up to the queue depth of reads in flight, batches their submissions
+	 * and reads into registered buffers without mapping them per read. Everywhere else, or if io_uring is unavailable,
+	 * a small pool of dedicated I/O threads issues blocking positional reads.
+	 * Queued requests are issued by priority, higher ones first, and completion callbacks run on the task thread pool.
+	 * Read() and ReadBatch() are thread-safe.
+	 */
+	class AsyncFileIO
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(AsyncFileIO);
+
+	public:
+
+		struct Settings
+		{
+			// reads in flight at once, queued requests beyond wait in the priority queues
+			uint32_t						m_QueueDepth = 256u;
+			uint32_t						m_FallbackThreadCount = 4u;
+			bool							m_ForceThreadPoolBackend = false;
+		};
+
+		explicit AsyncFileIO(const Settings& settings);
+		~AsyncFileIO();
+
+		/* Instance owned by the core module. */
+		static AsyncFileIO& Get();
+
+		IORequestHandle Read(IOReadRequest request);
+		/* Queue all requests under one lock and wake the backend once. */
+		std::vector<IORequestHandle> ReadBatch(std::vector<IOReadRequest> requests);
+
+		/* Pin the buffers for reads whose destination lies inside one of them, replacing the previous ones.
+		 * Must NOT be called while any read is queued or in flight.
+		 */
+		bool RegisterBuffers(std::vector<std::span<std::byte>> buffers);
+		void UnregisterBuffers();
+
+		void WaitUntilIdle();
+
+		const char* GetBackendName() const;
+		uint32_t GetQueueDepth() const { return m_Settings.m_QueueDepth; }
+		/* Requests queued or in flight. */
+		uint32_t GetOutstandingRequestCount() const;
+
+		// backend interface
+
+		/* Pop up to maxCount queued requests, highest priority first. Block until there is one if bWait, return false once shutting down. */
+		bool PopPendingRequests(std::vector<std::shared_ptr<IOReadPayload>>& outRequests, uint32_t maxCount, bool bWait);
+		/* Finish the request with the read size or the error code. */
+		void CompleteRequest(const std::shared_ptr<IOReadPayload>& pPayload, int32_t errorCode);
+
+		bool IsShuttingDown() const { return m_IsShuttingDown.load(std::memory_order_acquire); }
+
+	private:
+
+		void QueueLocked(const std::shared_ptr<IOReadPayload>& pPayload);
+		void FinishRequest(const std::shared_ptr<IOReadPayload>& pPayload);
+
+	private:
+
+		Settings													m_Settings;
+		std::unique_ptr<IAsyncFileIOBackend>						m_Backend;
+
+		mutable std::mutex											m_Mutex;
+		std::condition_variable										m_PendingCondition;
+		std::condition_variable										m_IdleCondition;
+		std::array<std::deque<std::shared_ptr<IOReadPayload>>, static_cast<size_t>(EIOPriority::Count)>	m_PendingRequests;
+		uint32_t													m_OutstandingRequestCount = 0;
+		std::vector<std::span<std::byte>>							m_RegisteredBuffers;
+
+		std::atomic<bool>											m_IsShuttingDown = false;
+	};
+}
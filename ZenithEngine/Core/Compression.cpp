@@ -0,0 +1,255 @@
+#include "Compression.h"
+
+#include "Core/Assertion.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace ZE::Core
+{
+	namespace
+	{
+		// a sequence is a token, literals, a 2 byte offset and the extended match length
+		// token: high 4 bits literal length, low 4 bits match length - kMinMatchLength, 15 means more bytes of 255 runs follow
+		constexpr std::size_t kMinMatchLength = 4u;
+		constexpr std::size_t kMaxOffset = 0xffffu;
+		// the last bytes are always literals, so a match never reads past the end of the source
+		constexpr std::size_t kLastLiteralCount = 5u;
+		constexpr uint32_t kHashTableBits = 16u;
+
+		uint32_t ReadUint32(const std::byte* pData)
+		{
+			uint32_t value;
+			std::memcpy(&value, pData, sizeof(value));
+			return value;
+		}
+
+		uint32_t HashSequence(uint32_t sequence)
+		{
+			return (sequence * 2654435761u) >> (32u - kHashTableBits);
+		}
+
+		void WriteLength(std::vector<std::byte>& output, std::size_t length)
+		{
+			while (length >= 255u)
+			{
+				output.push_back(std::byte{ 255u });
+				length -= 255u;
+			}
+			output.push_back(static_cast<std::byte>(length));
+		}
+
+		void WriteSequence(std::vector<std::byte>& output, const std::byte* pLiterals, std::size_t literalCount, std::size_t offset, std::size_t matchLength)
+		{
+			const std::size_t extraMatchLength = matchLength != 0 ? matchLength - kMinMatchLength : 0;
+			const auto literalToken = static_cast<uint8_t>(std::min<std::size_t>(literalCount, 15u));
+			const auto matchToken = static_cast<uint8_t>(std::min<std::size_t>(extraMatchLength, 15u));
+			output.push_back(static_cast<std::byte>((literalToken << 4u) | matchToken));
+
+			if (literalCount >= 15u)
+			{
+				WriteLength(output, literalCount - 15u);
+			}
+			output.insert(output.end(), pLiterals, pLiterals + literalCount);
+
+			// the last sequence has literals only
+			if (matchLength == 0)
+			{
+				return;
+			}
+
+			output.push_back(static_cast<std::byte>(offset & 0xffu));
+			output.push_back(static_cast<std::byte>((offset >> 8u) & 0xffu));
+			if (extraMatchLength >= 15u)
+			{
+				WriteLength(output, extraMatchLength - 15u);
+			}
+		}
+
+		bool ReadLength(const std::byte*& pSource, const std::byte* pSourceEnd, std::size_t& length)
+		{
+			uint8_t value;
+			do
+			{
+				if (pSource >= pSourceEnd)
+				{
+					return false;
+				}
+				value = static_cast<uint8_t>(*pSource++);
+				length += value;
+			} while (value == 255u);
+			return true;
+		}
+
+		std::size_t CompressLz(std::span<const std::byte> source, std::vector<std::byte>& output)
+		{
+			const std::size_t outputBegin = output.size();
+			output.reserve(outputBegin + GetMaxCompressedSize(source.size()));
+
+			const std::byte* pBase = source.data();
+			const std::size_t size = source.size();
+
+			std::size_t anchor = 0;
+			if (size > kLastLiteralCount + kMinMatchLength)
+			{
+				// positions + 1, 0 means empty
+				std::vector<uint32_t> hashTable(1u << kHashTableBits, 0u);
+
+				const std::size_t matchLimit = size - kLastLiteralCount;
+				std::size_t position = 0;
+				while (position + kMinMatchLength <= matchLimit)
+				{
+					const uint32_t sequence = ReadUint32(pBase + position);
+					uint32_t& entry = hashTable[HashSequence(sequence)];
+					const std::size_t candidate = entry;
+					entry = static_cast<uint32_t>(position + 1u);
+
+					if (candidate == 0 || position - (candidate - 1u) > kMaxOffset || ReadUint32(pBase + candidate - 1u) != sequence)
+					{
+						++position;
+						continue;
+					}
+
+					const std::size_t matchPosition = candidate - 1u;
+					std::size_t matchLength = kMinMatchLength;
+					while (position + matchLength < matchLimit && pBase[matchPosition + matchLength] == pBase[position + matchLength])
+					{
+						++matchLength;
+					}
+
+					WriteSequence(output, pBase + anchor, position - anchor, position - matchPosition, matchLength);
+					position += matchLength;
+					anchor = position;
+				}
+			}
+
+			WriteSequence(output, pBase + anchor, size - anchor, 0, 0);
+			return output.size() - outputBegin;
+		}
+
+		bool DecompressLz(std::span<const std::byte> source, std::span<std::byte> destination)
+		{
+			const std::byte* pSource = source.data();
+			const std::byte* const pSourceEnd = pSource + source.size();
+			std::byte* const pDestinationBegin = destination.data();
+			std::byte* pDestination = pDestinationBegin;
+			std::byte* const pDestinationEnd = pDestination + destination.size();
+
+			while (pSource < pSourceEnd)
+			{
+				const auto token = static_cast<uint8_t>(*pSource++);
+
+				std::size_t literalCount = token >> 4u;
+				if (literalCount == 15u && !ReadLength(pSource, pSourceEnd, literalCount))
+				{
+					return false;
+				}
+				if (literalCount > static_cast<std::size_t>(pSourceEnd - pSource) || literalCount > static_cast<std::size_t>(pDestinationEnd - pDestination))
+				{
+					return false;
+				}
+				if (literalCount != 0)
+				{
+					std::memcpy(pDestination, pSource, literalCount);
+				}
+				pSource += literalCount;
+				pDestination += literalCount;
+
+				if (pSource == pSourceEnd)
+				{
+					break;
+				}
+
+				if (pSourceEnd - pSource < 2)
+				{
+					return false;
+				}
+				const std::size_t offset = static_cast<std::size_t>(pSource[0]) | (static_cast<std::size_t>(pSource[1]) << 8u);
+				pSource += 2;
+
+				std::size_t matchLength = token & 0x0fu;
+				if (matchLength == 15u && !ReadLength(pSource, pSourceEnd, matchLength))
+				{
+					return false;
+				}
+				matchLength += kMinMatchLength;
+
+				if (offset == 0 || offset > static_cast<std::size_t>(pDestination - pDestinationBegin) || matchLength > static_cast<std::size_t>(pDestinationEnd - pDestination))
+				{
+					return false;
+				}
+
+				// matches may overlap themselves, e.g. runs, so copy byte by byte
+				const std::byte* pMatch = pDestination - offset;
+				for (std::size_t i = 0; i < matchLength; ++i)
+				{
+					pDestination[i] = pMatch[i];
+				}
+				pDestination += matchLength;
+			}
+
+			return pDestination == pDestinationEnd;
+		}
+	}
+
+	std::size_t GetMaxCompressedSize(std::size_t sizeInByte)
+	{
+		return sizeInByte + sizeInByte / 255u + 16u;
+	}
+
+	bool IsValidCompressionMethod(ECompressionMethod method)
+	{
+		return method == ECompressionMethod::None || method == ECompressionMethod::Lz;
+	}
+
+	std::size_t GetMaxDecompressedSize(ECompressionMethod method, std::size_t compressedSizeInByte)
+	{
+		switch (method)
+		{
+		case ECompressionMethod::None:
+			return compressedSizeInByte;
+		case ECompressionMethod::Lz:
+			// every byte of a sequence expands to at most 255 bytes, which is an extended length byte of a match
+			return compressedSizeInByte <= std::numeric_limits<std::size_t>::max() / 255u ? compressedSizeInByte * 255u : std::numeric_limits<std::size_t>::max();
+		}
+
+		return 0;
+	}
+
+	std::size_t Compress(ECompressionMethod method, std::span<const std::byte> source, std::vector<std::byte>& outCompressed)
+	{
+		switch (method)
+		{
+		case ECompressionMethod::None:
+			outCompressed.insert(outCompressed.end(), source.begin(), source.end());
+			return source.size();
+		case ECompressionMethod::Lz:
+			return CompressLz(source, outCompressed);
+		}
+
+		ZE_ASSERT_LOG(false, "Unknown compression method: {}", static_cast<uint32_t>(method));
+		return 0;
+	}
+
+	bool Decompress(ECompressionMethod method, std::span<const std::byte> source, std::span<std::byte> destination)
+	{
+		switch (method)
+		{
+		case ECompressionMethod::None:
+			if (source.size() != destination.size())
+			{
+				return false;
+			}
+			if (!source.empty())
+			{
+				std::memcpy(destination.data(), source.data(), source.size());
+			}
+			return true;
+		case ECompressionMethod::Lz:
+			return DecompressLz(source, destination);
+		}
+
+		return false;
+	}
+}
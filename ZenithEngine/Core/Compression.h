@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace ZE::Core
+{
+	enum class ECompressionMethod : uint8_t
+	{
+		None = 0,
+		// byte-oriented LZ77 in the spirit of LZ4, fast to decode and cheap to encode
+		Lz = 1,
+	};
+
+	/* Upper bound of the compressed size, for incompressible data. */
+	std::size_t GetMaxCompressedSize(std::size_t sizeInByte);
+	/* Upper bound of the uncompressed size of compressed data, so a corrupted size is rejected before it is allocated. 0 for unknown methods. */
+	std::size_t GetMaxDecompressedSize(ECompressionMethod method, std::size_t compressedSizeInByte);
+	/* False for values read from disk which are not a method of this version. */
+	bool IsValidCompressionMethod(ECompressionMethod method);
+
+	/* Append the compressed data to the output, return the size written. */
+	std::size_t Compress(ECompressionMethod method, std::span<const std::byte> source, std::vector<std::byte>& outCompressed);
+
+	/* Destination must be exactly the uncompressed size. Return false on corrupted data, the destination is then left partially written. */
+	bool Decompress(ECompressionMethod method, std::span<const std::byte> source, std::span<std::byte> destination);
+}
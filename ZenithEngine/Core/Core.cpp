@@ -6,7 +6,11 @@
 #include "Platform/Displayable.h"
 
 #include "FileSystem.h"
+#include "AsyncFileIO.h"
 #include "Asset/Asset.h"
+#include "Asset/DerivedDataCache.h"
+
+#include <filesystem>
 
 namespace ZE::Core
 {
@@ -21,11 +25,32 @@ namespace ZE::Core
 
 		FileSystem::Mount();
 
+		// cooked archives at the mount root serve their files instead of the loose ones
+		std::error_code errorCode;
+		for (const auto& entry : std::filesystem::directory_iterator(FileSystem::ToAbsoluteEnginePath(FilePath("/")).ToString(), errorCode))
+		{
+			if (entry.is_regular_file() && entry.path().extension() == ".zpak")
+			{
+				FileSystem::MountArchive(FilePath(entry.path()));
+			}
+		}
+
+		m_AsyncFileIO = new AsyncFileIO(AsyncFileIO::Settings{});
+		m_DerivedDataCache = new Asset::DerivedDataCache(Asset::DerivedDataCache::Settings{});
+
         return true;
     }
 
     void CoreModule::ShutdownModule()
     {
+		delete m_DerivedDataCache;
+		m_DerivedDataCache = nullptr;
+
+		// waits for the outstanding reads
+		delete m_AsyncFileIO;
+		m_AsyncFileIO = nullptr;
+		FileSystem::UnmountArchives();
+
 		if (m_DisplayDevice)
 		{
 			m_DisplayDevice->Shutdown();
@@ -3,9 +3,12 @@
 #include "Core/Module.h"
 
 namespace ZE::Platform { class IDisplayable; class Window; }
+namespace ZE::Asset { class DerivedDataCache; }
 
 namespace ZE::Core
 {
+	class AsyncFileIO;
+
 	class CoreModule : public IModule
 	{
 	public:
@@ -22,5 +25,7 @@ namespace ZE::Core
 	private:
 
 		Platform::IDisplayable*				m_DisplayDevice = nullptr;
+		AsyncFileIO*						m_AsyncFileIO = nullptr;
+		Asset::DerivedDataCache*			m_DerivedDataCache = nullptr;
 	};
 }
@@ -49,7 +49,7 @@ namespace ZE::Core
 	{
 		ZE_ASSERT(!m_IsInitialized);
 
-		m_RenderModule = new Render::RenderModule(*this);
+		m_RenderModule = new Render::RenderModule(*this, m_Settings.m_Render);
 		if (!InitializeModule(m_RenderModule))
 		{
 			return false;
@@ -89,7 +89,7 @@ namespace ZE::Core
 		double frameTimes[20] = {};
 
 		TaskSystem::TaskHandle renderTask;
-		while (!m_RequestExit)
+		while (!m_RequestExit.load(std::memory_order_relaxed))
 		{
 			{
 				ScopedTimer<ETimeUnit::MilliSecond> scopedTimer(frameTimes[frameCounter % 10]);
@@ -98,9 +98,9 @@ namespace ZE::Core
 				
 				Asset::AssetManager::Get().Update();
 				
-				if (m_RenderModule->GetMainRenderWindow()->IsCloseRequested())
+				if (auto pMainWindow = m_RenderModule->GetMainRenderWindow(); pMainWindow && pMainWindow->IsCloseRequested())
 				{
-					m_RequestExit = true;
+					m_RequestExit.store(true, std::memory_order_relaxed);
 					break;
 				}
 
@@ -113,7 +113,7 @@ namespace ZE::Core
 
 			if (frameCounter % 1000 == 1 /* skip first 1000 frames */)
 			{
-				const double averageFrameTime = std::accumulate(frameTimes, frameTimes + std::min(frameCounter, 10ull), 0.0) / static_cast<double>(std::min(frameCounter, 10ull));
+				const double averageFrameTime = std::accumulate(frameTimes, frameTimes + std::min<uint64_t>(frameCounter, 10u), 0.0) / static_cast<double>(std::min<uint64_t>(frameCounter, 10u));
 				ZE_LOG_INFO("Current frame rate: {:.5} fps", 1000.f / averageFrameTime);
 			}
 			frameCounter++;
@@ -122,6 +122,11 @@ namespace ZE::Core
 		TaskSystem::TaskManager::Get().WaitAllFinished();
 	}
 
+	void Engine::RequestExit()
+	{
+		m_RequestExit.store(true, std::memory_order_relaxed);
+	}
+
 	//-------------------------------------------------------------------------
 	
 	bool Engine::InitializeModule(Core::IModule* pModule)
@@ -2,6 +2,9 @@
 
 #include "ModuleDefines.h"
 #include "Core/Module.h"
+#include "Render/RenderSettings.h"
+
+#include <atomic>
 
 namespace ZE::Core { class CoreModule; }
 namespace ZE::Log { class LogModule; }
@@ -15,6 +18,14 @@ namespace ZE::Core
 	{
 	public:
 
+		struct ENGINE_API Settings
+		{
+			Render::RenderSettings			m_Render;
+		};
+
+		explicit Engine(const Settings& settings = {})
+			: m_Settings(settings)
+		{}
 		virtual ~Engine() = default;
 
 		virtual bool PreInitialize();
@@ -23,6 +34,8 @@ namespace ZE::Core
 		virtual void PostShutdown();
 
 		virtual void Run();
+		/* Exit the main loop after the current frame, e.g. when an offscreen capture is done. */
+		void RequestExit();
 
 		//-------------------------------------------------------------------------
 
@@ -30,6 +43,7 @@ namespace ZE::Core
 		Input::InputModule* GetInputModule() const { return m_InputModule; }
 		Log::LogModule* GetLogModule() const { return m_LogModule; }
 		Render::RenderModule* GetRenderModule() const { return m_RenderModule; }
+		const Settings& GetSettings() const { return m_Settings; }
 	
 	private:
 		
@@ -37,6 +51,8 @@ namespace ZE::Core
 		
 	protected:
 
+		Settings						m_Settings;
+
 		CoreModule*						m_CoreModule = nullptr;
 		Input::InputModule*				m_InputModule = nullptr;
 		Log::LogModule*					m_LogModule = nullptr;
@@ -47,6 +63,14 @@ namespace ZE::Core
 		
 		bool							m_IsPreInitialized = false;
 		bool							m_IsInitialized = false;
-		bool							m_RequestExit = false;
+		// written by the render thread, e.g. once an offscreen capture is done, only touched inside the engine module
+#if defined(_MSC_VER)
+#	pragma warning(push)
+#	pragma warning(disable: 4251)
+#endif
+		std::atomic<bool>				m_RequestExit = false;
+#if defined(_MSC_VER)
+#	pragma warning(pop)
+#endif
 	};
 }
@@ -46,6 +46,9 @@ namespace ZE::Core
 		}
 	}
 
+	template <typename... Args>
+	class Event;
+
 	// Class to only expose bind and unbind interface to user. Forbid user to call other functions.
 	// User should be aware of the lifetime of this object. It should be destroyed before its owner (Event).
 	template <typename... Args>
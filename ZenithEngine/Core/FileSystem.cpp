@@ -1,12 +1,29 @@
 ﻿#include "FileSystem.h"
 
+#include "PackedArchive.h"
 #include "Log/Log.h"
 
 #include <fstream>
+#include <mutex>
+#include <ranges>
+#include <utility>
+
+#if defined(_WIN32)
+#   define WIN32_LEAN_AND_MEAN
+#   include <windows.h>
+#   undef WIN32_LEAN_AND_MEAN
+#else
+#   include <cerrno>
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
 
 namespace ZE::Core
 {
     std::filesystem::path FileSystem::m_EngineMountPath{};
+    std::shared_mutex FileSystem::m_ArchiveMutex{};
+    std::vector<std::shared_ptr<PackedArchive>> FileSystem::m_MountedArchives{};
 
     FilePath::FilePath(const char* path)
         : m_Path(path)
@@ -20,12 +37,77 @@ namespace ZE::Core
         : m_Path{std::move(path)}
     {}
     
+    FileHandle::~FileHandle()
+    {
+        Unmap();
+    }
+
+    FileHandle::FileHandle(FileHandle&& other) noexcept
+        : m_HadOpen(std::exchange(other.m_HadOpen, false))
+        , m_Binary(std::move(other.m_Binary))
+        , m_MappedView(std::exchange(other.m_MappedView, nullptr))
+        , m_MappedSize(std::exchange(other.m_MappedSize, 0))
+        , m_Container(std::move(other.m_Container))
+    {}
+
+    FileHandle& FileHandle::operator=(FileHandle&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Unmap();
+            m_HadOpen = std::exchange(other.m_HadOpen, false);
+            m_Binary = std::move(other.m_Binary);
+            m_MappedView = std::exchange(other.m_MappedView, nullptr);
+            m_MappedSize = std::exchange(other.m_MappedSize, 0);
+            m_Container = std::move(other.m_Container);
+        }
+        return *this;
+    }
+
+    std::span<const std::byte> FileHandle::GetData() const
+    {
+        if (!m_HadOpen)
+        {
+            return {};
+        }
+
+        if (m_MappedView)
+        {
+            return { m_MappedView, m_MappedSize };
+        }
+        return m_Binary;
+    }
+
     FileHandle FileHandle::FailedToOpen()
     {
         FileHandle handle;
         handle.m_HadOpen = false;
         return handle;
     }
+
+    void FileHandle::Unmap()
+    {
+        if (!m_MappedView)
+        {
+            return;
+        }
+
+        if (m_Container)
+        {
+            m_Container.reset();
+            m_MappedView = nullptr;
+            m_MappedSize = 0;
+            return;
+        }
+
+#if defined(_WIN32)
+        UnmapViewOfFile(m_MappedView);
+#else
+        munmap(const_cast<std::byte*>(m_MappedView), m_MappedSize);
+#endif
+        m_MappedView = nullptr;
+        m_MappedSize = 0;
+    }
     
     void FileSystem::Mount()
     {
@@ -33,14 +115,15 @@ namespace ZE::Core
         m_EngineMountPath = std::filesystem::absolute(std::filesystem::current_path().parent_path()).make_preferred();
     }
     
-    FileHandle FileSystem::Load(const FilePath& filePath)
+    FileHandle FileSystem::Load(const FilePath& filePath, EFileAccessPattern accessPattern)
     {
-        // TODO: support memory-mapped file (i.e. mmap)
-        // This allows us to directly map memory to disk storage, without copy the disk binary into the ram and then read/write it
-        // This reduce the memory copy operation and it is more efficient
-
         auto path = filePath.m_Path;
         Sanitize(path);
+
+        if (const auto [pArchive, pEntry] = FindArchiveEntry(path); pEntry)
+        {
+            return pArchive->Load(*pEntry);
+        }
         
         std::error_code errorCode;
         const auto absolutePath = ToAbsoluteEnginePath(path);
@@ -53,23 +136,226 @@ namespace ZE::Core
 
         FileHandle handle;
 
-        auto fileSize = std::filesystem::file_size(absolutePath);
-        std::ifstream inFileStream(absolutePath, std::ios::in | std::ios::binary);
-        if (inFileStream.is_open())
+        const auto fileSize = static_cast<std::size_t>(std::filesystem::file_size(absolutePath, errorCode));
+        if (errorCode)
+        {
+            ZE_LOG_ERROR("Failed to query size of [{}], error code: {}", absolutePath.string(), errorCode.message());
+            return FileHandle::FailedToOpen();
+        }
+
+        // map large files, so they are paged in on demand instead of copied into a buffer first
+        if (fileSize >= kMinMappedFileSizeInByte && MapFile(absolutePath, fileSize, accessPattern, handle))
         {
-            std::vector<std::byte> binary(fileSize);
-            inFileStream.read(reinterpret_cast<char*>(binary.data()), static_cast<long long>(fileSize));
+            return handle;
+        }
+
+        ReadIntoBuffer(absolutePath, fileSize, handle);
+        return handle;
+    }
+
+    IORequestHandle FileSystem::LoadAsync(const FilePath& filePath, IOReadCallback callback, EIOPriority priority)
+    {
+        auto path = filePath.m_Path;
+        Sanitize(path);
 
-            handle.m_Binary = std::move(binary);
-            handle.m_HadOpen = true;
+        IOReadRequest request;
+        request.m_Priority = priority;
+        request.m_Callback = std::move(callback);
+
+        if (const auto [pArchive, pEntry] = FindArchiveEntry(path); pEntry)
+        {
+            // read the range of the entry rather than its mapped pages, so page faults never stall the caller
+            request.m_AbsolutePath = pArchive->GetAbsolutePath();
+            request.m_Offset = pEntry->m_DataOffset;
+            request.m_SizeInByte = pEntry->m_StoredSizeInByte;
+            request.m_Compression = pEntry->m_Compression;
+            request.m_UncompressedSizeInByte = pEntry->m_UncompressedSizeInByte;
         }
         else
+        {
+            request.m_AbsolutePath = ToAbsoluteEnginePath(path);
+        }
+        return AsyncFileIO::Get().Read(std::move(request));
+    }
+
+    bool FileSystem::Exists(const FilePath& filePath)
+    {
+        auto path = filePath.m_Path;
+        Sanitize(path);
+
+        if (FindArchiveEntry(path).second)
+        {
+            return true;
+        }
+
+        std::error_code errorCode;
+        return std::filesystem::exists(ToAbsoluteEnginePath(path), errorCode);
+    }
+
+    bool FileSystem::Save(const FilePath& filePath, std::span<const std::byte> data)
+    {
+        auto path = filePath.m_Path;
+        Sanitize(path);
+
+        const auto absolutePath = ToAbsoluteEnginePath(path);
+        std::error_code errorCode;
+        std::filesystem::create_directories(absolutePath.parent_path(), errorCode);
+
+        std::ofstream outFileStream(absolutePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!outFileStream.is_open())
+        {
+            ZE_LOG_ERROR("Failed to open [{}] for write!", absolutePath.string());
+            return false;
+        }
+
+        outFileStream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!outFileStream.good())
+        {
+            ZE_LOG_ERROR("Failed to write [{}]!", absolutePath.string());
+            return false;
+        }
+        return true;
+    }
+
+    bool FileSystem::MountArchive(const FilePath& archivePath)
+    {
+        auto path = archivePath.m_Path;
+        Sanitize(path);
+
+        std::error_code errorCode;
+        const auto absolutePath = ToAbsoluteEnginePath(path);
+        const auto fileSize = static_cast<std::size_t>(std::filesystem::file_size(absolutePath, errorCode));
+        if (errorCode)
+        {
+            ZE_LOG_ERROR("Failed to mount archive [{}], error code: {}", absolutePath.string(), errorCode.message());
+            return false;
+        }
+
+        // archives are always mapped, entries are paged in as they are loaded
+        auto pContainer = std::make_shared<FileHandle>();
+        if (!MapFile(absolutePath, fileSize, EFileAccessPattern::Random, *pContainer) && !ReadIntoBuffer(absolutePath, fileSize, *pContainer))
+        {
+            return false;
+        }
+
+        auto pArchive = PackedArchive::Create(std::move(pContainer), absolutePath);
+        if (!pArchive)
+        {
+            return false;
+        }
+
+        ZE_LOG_INFO("Mounted archive [{}] with {} files", absolutePath.string(), pArchive->GetEntries().size());
+
+        std::unique_lock lock(m_ArchiveMutex);
+        m_MountedArchives.push_back(std::move(pArchive));
+        return true;
+    }
+
+    void FileSystem::UnmountArchives()
+    {
+        std::unique_lock lock(m_ArchiveMutex);
+        m_MountedArchives.clear();
+    }
+
+    std::pair<std::shared_ptr<PackedArchive>, const PackedArchiveEntry*> FileSystem::FindArchiveEntry(const std::filesystem::path& path)
+    {
+        std::shared_lock lock(m_ArchiveMutex);
+        if (m_MountedArchives.empty())
+        {
+            return {};
+        }
+
+        const auto archivePath = NormalizeArchivePath(path.string());
+        for (const auto& pArchive : m_MountedArchives | std::views::reverse)
+        {
+            if (const auto* pEntry = pArchive->FindEntry(archivePath))
+            {
+                return { pArchive, pEntry };
+            }
+        }
+        return {};
+    }
+
+    bool FileSystem::MapFile(const std::filesystem::path& absolutePath, std::size_t fileSize, EFileAccessPattern accessPattern, FileHandle& handle)
+    {
+#if defined(_WIN32)
+        HANDLE file = CreateFileW(absolutePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            ZE_LOG_WARNING("Failed to open [{}] for mapping, error: {}", absolutePath.string(), GetLastError());
+            return false;
+        }
+
+        // the view keeps the mapping and the file alive once it is mapped
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping)
+        {
+            ZE_LOG_WARNING("Failed to create file mapping of [{}], error: {}", absolutePath.string(), GetLastError());
+            return false;
+        }
+
+        void* pView = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, fileSize);
+        CloseHandle(mapping);
+        if (!pView)
+        {
+            ZE_LOG_WARNING("Failed to map [{}], error: {}", absolutePath.string(), GetLastError());
+            return false;
+        }
+
+        if (accessPattern == EFileAccessPattern::Sequential)
+        {
+            // counterpart of madvise(MADV_WILLNEED), the pages are read ahead asynchronously
+            WIN32_MEMORY_RANGE_ENTRY range{ pView, fileSize };
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+        }
+#else
+        const int file = open(absolutePath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0)
+        {
+            ZE_LOG_WARNING("Failed to open [{}] for mapping, errno: {}", absolutePath.string(), errno);
+            return false;
+        }
+
+        // the mapping keeps the file alive once it is mapped
+        void* pView = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (pView == MAP_FAILED)
+        {
+            ZE_LOG_WARNING("Failed to map [{}], errno: {}", absolutePath.string(), errno);
+            return false;
+        }
+
+        madvise(pView, fileSize, accessPattern == EFileAccessPattern::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+#endif
+
+        handle.m_MappedView = static_cast<const std::byte*>(pView);
+        handle.m_MappedSize = fileSize;
+        handle.m_HadOpen = true;
+        return true;
+    }
+
+    bool FileSystem::ReadIntoBuffer(const std::filesystem::path& absolutePath, std::size_t fileSize, FileHandle& handle)
+    {
+        std::ifstream inFileStream(absolutePath, std::ios::in | std::ios::binary);
+        if (!inFileStream.is_open())
         {
             ZE_LOG_ERROR("Failed to open [{}] for read!", absolutePath.string().c_str());
+            return false;
         }
-        inFileStream.close();
 
-        return handle;
+        std::vector<std::byte> binary(fileSize);
+        inFileStream.read(reinterpret_cast<char*>(binary.data()), static_cast<std::streamsize>(fileSize));
+        // the file may have been truncated since its size was queried, a partial buffer is never handed out
+        if (static_cast<std::size_t>(inFileStream.gcount()) != fileSize)
+        {
+            ZE_LOG_ERROR("Failed to read [{}], read {} of {} bytes!", absolutePath.string(), inFileStream.gcount(), fileSize);
+            return false;
+        }
+
+        handle.m_Binary = std::move(binary);
+        handle.m_HadOpen = true;
+        return true;
     }
     
     FilePath FileSystem::ToAbsoluteEnginePath(const FilePath& filePath)
@@ -1,9 +1,19 @@
 ﻿#pragma once
 
+#include "AsyncFileIO.h"
+
 #include <filesystem>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <utility>
+#include <vector>
 
 namespace ZE::Core
 {
+    class PackedArchive;
+    struct PackedArchiveEntry;
+
     // User relative path.
     // Use as /ZenithEngine/Shaders/TriangleVS.spirv etc.
     class FilePath
@@ -38,24 +48,55 @@ namespace ZE::Core
         std::filesystem::path                  m_Path{};
     };
 
+    // How a mapped file is going to be read, so the OS can read ahead or not.
+    enum class EFileAccessPattern : uint8_t
+    {
+        // The whole file is consumed from the beginning, e.g. a mesh or a shader.
+        Sequential = 0,
+        // Only parts of the file are touched, e.g. entries of an archive.
+        Random,
+    };
+
+    // Read-only content of a loaded file.
+    // Large files are memory-mapped, their pages are faulted in on first access and never copied into an owned buffer.
+    // Small files, or files which failed to map, are read into an owned buffer instead.
+    // Uncompressed entries of a mounted archive are views into the archive, which is kept alive by the handle.
     class FileHandle
     {
         friend class FileSystem;
+        friend class PackedArchive;
 
     public:
 
+        FileHandle() = default;
+        ~FileHandle();
+
+        FileHandle(const FileHandle&) = delete;
+        FileHandle& operator=(const FileHandle&) = delete;
+        FileHandle(FileHandle&& other) noexcept;
+        FileHandle& operator=(FileHandle&& other) noexcept;
+
         bool IsValid() const { return m_HadOpen; }
+        bool IsMapped() const { return m_MappedView != nullptr && (!m_Container || m_Container->IsMapped()); }
 
-        const std::vector<std::byte>* TryGetBinaryData() const { if (m_HadOpen && !m_Binary.empty()) { return &m_Binary; } return nullptr; }
+        // Empty if the file failed to open. Only valid during the lifetime of the handle.
+        std::span<const std::byte> GetData() const;
 
     private:
 
         static FileHandle FailedToOpen();
+
+        void Unmap();
         
     private:
 
         bool                                    m_HadOpen = false;
         std::vector<std::byte>                  m_Binary;
+
+        const std::byte*                        m_MappedView = nullptr;
+        std::size_t                             m_MappedSize = 0;
+        // The view lies inside the container rather than being mapped by this handle.
+        std::shared_ptr<const FileHandle>       m_Container;
     };
     
     class FileSystem
@@ -64,7 +105,21 @@ namespace ZE::Core
 
         static void Mount();
 
-        static FileHandle Load(const FilePath& filePath);
+        // Files smaller than this are read rather than mapped, mapping costs more than copying a few pages.
+        static constexpr std::size_t kMinMappedFileSizeInByte = 64u * 1024u;
+
+        // Mounted archives are looked up first, loose files are only touched if no archive contains the path.
+        static FileHandle Load(const FilePath& filePath, EFileAccessPattern accessPattern = EFileAccessPattern::Sequential);
+        // Read the whole file on the async file I/O without blocking the calling thread, the callback runs on a task thread.
+        static IORequestHandle LoadAsync(const FilePath& filePath, IOReadCallback callback, EIOPriority priority = EIOPriority::Normal);
+        static bool Exists(const FilePath& filePath);
+        // Write the whole file, replacing the previous one. Loads keep being served by a mounted archive containing the path.
+        static bool Save(const FilePath& filePath, std::span<const std::byte> data);
+
+        // Map a .zpak and serve the files it contains from memory, archives mounted later take precedence.
+        // Thread-safe, but handles and reads already issued keep using what they had found.
+        static bool MountArchive(const FilePath& archivePath);
+        static void UnmountArchives();
         
         static FilePath ToAbsoluteEnginePath(const FilePath& filePath);
 
@@ -74,6 +129,12 @@ namespace ZE::Core
     private:
 
         static void Sanitize(std::filesystem::path& path);
+
+        static bool MapFile(const std::filesystem::path& absolutePath, std::size_t fileSize, EFileAccessPattern accessPattern, FileHandle& handle);
+        static bool ReadIntoBuffer(const std::filesystem::path& absolutePath, std::size_t fileSize, FileHandle& handle);
+
+        // Path must be sanitized.
+        static std::pair<std::shared_ptr<PackedArchive>, const PackedArchiveEntry*> FindArchiveEntry(const std::filesystem::path& path);
         
     private:
 
@@ -83,6 +144,9 @@ namespace ZE::Core
 
         // Engine absolute mount path. Can be different on different machine or user environment
         static std::filesystem::path            m_EngineMountPath;
+
+        static std::shared_mutex                m_ArchiveMutex;
+        static std::vector<std::shared_ptr<PackedArchive>> m_MountedArchives;
     };
 }
 
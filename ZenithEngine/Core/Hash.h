@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <span>
+#include <string_view>
 
 namespace ZE::Core
 {
@@ -22,4 +25,29 @@ namespace ZE::Core
 	{
 		return seed ^ std::hash<Hashable>{}(value);
 	}
+
+	// FNV-1a, unlike std::hash it is stable across builds and platforms, so it can be stored on disk
+	constexpr uint64_t kStableHashSeed = 0xcbf29ce484222325ull;
+
+	constexpr uint64_t StableHash(std::span<const std::byte> data, uint64_t seed = kStableHashSeed)
+	{
+		uint64_t hash = seed;
+		for (const std::byte value : data)
+		{
+			hash ^= static_cast<uint64_t>(value);
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	constexpr uint64_t StableHash(std::string_view value, uint64_t seed = kStableHashSeed)
+	{
+		uint64_t hash = seed;
+		for (const char c : value)
+		{
+			hash ^= static_cast<uint64_t>(static_cast<uint8_t>(c));
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
 }
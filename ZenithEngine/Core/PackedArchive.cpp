@@ -0,0 +1,357 @@
+#include "PackedArchive.h"
+
+#include "Core/Assertion.h"
+#include "Core/Hash.h"
+#include "Log/Log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+
+namespace ZE::Core
+{
+	namespace
+	{
+		uint64_t AlignUp(uint64_t value, uint64_t alignment)
+		{
+			return (value + alignment - 1u) / alignment * alignment;
+		}
+
+		void WritePadding(std::ofstream& outFileStream, uint64_t& cursor, uint64_t targetOffset)
+		{
+			static constexpr char kZeros[256]{};
+			while (cursor < targetOffset)
+			{
+				const auto paddingSize = std::min<uint64_t>(targetOffset - cursor, sizeof(kZeros));
+				outFileStream.write(kZeros, static_cast<std::streamsize>(paddingSize));
+				cursor += paddingSize;
+			}
+		}
+	}
+
+	std::string NormalizeArchivePath(std::string_view path)
+	{
+		std::string normalizedPath;
+		normalizedPath.reserve(path.size() + 1u);
+		if (path.empty() || (path.front() != '/' && path.front() != '\\'))
+		{
+			normalizedPath.push_back('/');
+		}
+
+		for (const char c : path)
+		{
+			normalizedPath.push_back(c == '\\' ? '/' : c);
+		}
+		return normalizedPath;
+	}
+
+	PackedArchiveWriter::PackedArchiveWriter(uint32_t dataAlignment)
+		: m_DataAlignment(std::max(dataAlignment, kSmallEntryAlignment))
+	{
+		ZE_ASSERT_LOG((m_DataAlignment & (m_DataAlignment - 1u)) == 0, "Data alignment {} of archive must be power of two!", m_DataAlignment);
+	}
+
+	bool PackedArchiveWriter::AddFile(std::string_view archivePath, std::span<const std::byte> data, ECompressionMethod compression)
+	{
+		auto path = NormalizeArchivePath(archivePath);
+		if (path.size() > std::numeric_limits<uint16_t>::max())
+		{
+			ZE_LOG_ERROR("Path [{}] is too long to be packed!", path);
+			return false;
+		}
+
+		const uint64_t pathHash = StableHash(path);
+		for (const auto& entry : m_Entries)
+		{
+			if (entry.m_PathHash != pathHash)
+			{
+				continue;
+			}
+
+			if (entry.m_Path == path)
+			{
+				ZE_LOG_WARNING("File [{}] is already packed!", path);
+			}
+			else
+			{
+				// lookups would have to probe, which is not worth it for a collision that practically never happens
+				ZE_LOG_ERROR("Path hash of [{}] collides with [{}], rename one of them!", path, entry.m_Path);
+			}
+			return false;
+		}
+
+		const uint64_t contentHash = StableHash(data);
+		uint32_t blobIndex = FindBlob(contentHash, data);
+		if (blobIndex == ~0u)
+		{
+			Blob blob;
+			blob.m_ContentHash = contentHash;
+			blob.m_UncompressedSizeInByte = data.size();
+
+			if (compression != ECompressionMethod::None && !data.empty())
+			{
+				Compress(compression, data, blob.m_StoredData);
+				// keep it raw unless compression saves space, raw entries are served without a copy
+				if (blob.m_StoredData.size() < data.size())
+				{
+					blob.m_Compression = compression;
+				}
+				else
+				{
+					blob.m_StoredData.clear();
+				}
+			}
+
+			if (blob.m_Compression == ECompressionMethod::None)
+			{
+				blob.m_StoredData.assign(data.begin(), data.end());
+			}
+
+			blobIndex = static_cast<uint32_t>(m_Blobs.size());
+			m_Blobs.push_back(std::move(blob));
+			m_BlobsByContentHash.emplace(contentHash, blobIndex);
+		}
+
+		auto& entry = m_Entries.emplace_back();
+		entry.m_Path = std::move(path);
+		entry.m_PathHash = pathHash;
+		entry.m_BlobIndex = blobIndex;
+		return true;
+	}
+
+	bool PackedArchiveWriter::AddFileFromDisk(const FilePath& filePath, ECompressionMethod compression)
+	{
+		auto path = filePath;
+		FileSystem::Sanitize(path);
+
+		const auto handle = FileSystem::Load(path);
+		if (!handle.IsValid())
+		{
+			return false;
+		}
+		return AddFile(path.ToString(), handle.GetData(), compression);
+	}
+
+	uint32_t PackedArchiveWriter::FindBlob(uint64_t contentHash, std::span<const std::byte> data) const
+	{
+		const auto [begin, end] = m_BlobsByContentHash.equal_range(contentHash);
+		for (auto iter = begin; iter != end; ++iter)
+		{
+			const auto& blob = m_Blobs[iter->second];
+			if (blob.m_UncompressedSizeInByte != data.size())
+			{
+				continue;
+			}
+
+			// the hash only narrows it down, contents are compared before sharing them
+			if (blob.m_Compression == ECompressionMethod::None)
+			{
+				if (std::ranges::equal(blob.m_StoredData, data))
+				{
+					return iter->second;
+				}
+				continue;
+			}
+
+			std::vector<std::byte> uncompressedData(blob.m_UncompressedSizeInByte);
+			if (Decompress(blob.m_Compression, blob.m_StoredData, uncompressedData) && std::ranges::equal(uncompressedData, data))
+			{
+				return iter->second;
+			}
+		}
+		return ~0u;
+	}
+
+	bool PackedArchiveWriter::Write(const std::filesystem::path& absolutePath) const
+	{
+		std::vector<uint32_t> sortedEntries(m_Entries.size());
+		std::iota(sortedEntries.begin(), sortedEntries.end(), 0u);
+		std::ranges::sort(sortedEntries, {}, [this](uint32_t index) { return m_Entries[index].m_PathHash; });
+
+		PackedArchiveHeader header;
+		header.m_EntryCount = static_cast<uint32_t>(m_Entries.size());
+		header.m_DataAlignment = m_DataAlignment;
+		header.m_EntryTableOffset = sizeof(PackedArchiveHeader);
+		header.m_PathTableOffset = header.m_EntryTableOffset + m_Entries.size() * sizeof(PackedArchiveEntry);
+
+		std::string pathTable;
+		std::vector<PackedArchiveEntry> entries(m_Entries.size());
+		for (size_t i = 0; i < sortedEntries.size(); ++i)
+		{
+			const auto& entry = m_Entries[sortedEntries[i]];
+			auto& packedEntry = entries[i];
+			packedEntry.m_PathHash = entry.m_PathHash;
+			packedEntry.m_PathOffset = static_cast<uint32_t>(pathTable.size());
+			packedEntry.m_PathLength = static_cast<uint16_t>(entry.m_Path.size());
+			pathTable += entry.m_Path;
+		}
+		header.m_PathTableSizeInByte = pathTable.size();
+
+		// data is laid out in the order files are added, so files added together are read together
+		std::vector<uint64_t> blobOffsets(m_Blobs.size());
+		uint64_t fileSize = header.m_PathTableOffset + header.m_PathTableSizeInByte;
+		for (size_t i = 0; i < m_Blobs.size(); ++i)
+		{
+			const auto storedSize = m_Blobs[i].m_StoredData.size();
+			blobOffsets[i] = AlignUp(fileSize, storedSize >= m_DataAlignment ? m_DataAlignment : kSmallEntryAlignment);
+			fileSize = blobOffsets[i] + storedSize;
+		}
+		header.m_FileSizeInByte = fileSize;
+
+		for (size_t i = 0; i < sortedEntries.size(); ++i)
+		{
+			const uint32_t blobIndex = m_Entries[sortedEntries[i]].m_BlobIndex;
+			const auto& blob = m_Blobs[blobIndex];
+			auto& packedEntry = entries[i];
+			packedEntry.m_ContentHash = blob.m_ContentHash;
+			packedEntry.m_DataOffset = blobOffsets[blobIndex];
+			packedEntry.m_StoredSizeInByte = blob.m_StoredData.size();
+			packedEntry.m_UncompressedSizeInByte = blob.m_UncompressedSizeInByte;
+			packedEntry.m_Compression = blob.m_Compression;
+		}
+
+		std::ofstream outFileStream(absolutePath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!outFileStream.is_open())
+		{
+			ZE_LOG_ERROR("Failed to open [{}] for write!", absolutePath.string());
+			return false;
+		}
+
+		outFileStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		outFileStream.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(PackedArchiveEntry)));
+		outFileStream.write(pathTable.data(), static_cast<std::streamsize>(pathTable.size()));
+
+		uint64_t cursor = header.m_PathTableOffset + header.m_PathTableSizeInByte;
+		for (size_t i = 0; i < m_Blobs.size(); ++i)
+		{
+			const auto& storedData = m_Blobs[i].m_StoredData;
+			WritePadding(outFileStream, cursor, blobOffsets[i]);
+			outFileStream.write(reinterpret_cast<const char*>(storedData.data()), static_cast<std::streamsize>(storedData.size()));
+			cursor += storedData.size();
+		}
+
+		if (!outFileStream.good())
+		{
+			ZE_LOG_ERROR("Failed to write archive [{}]!", absolutePath.string());
+			return false;
+		}
+
+		ZE_LOG_INFO("Packed {} files with {} unique contents into [{}], {} bytes", m_Entries.size(), m_Blobs.size(), absolutePath.string(), fileSize);
+		return true;
+	}
+
+	std::shared_ptr<PackedArchive> PackedArchive::Create(std::shared_ptr<const FileHandle> pContainer, std::filesystem::path absolutePath)
+	{
+		auto pArchive = std::shared_ptr<PackedArchive>(new PackedArchive(std::move(pContainer), std::move(absolutePath)));
+		if (!pArchive->Validate())
+		{
+			return nullptr;
+		}
+		return pArchive;
+	}
+
+	PackedArchive::PackedArchive(std::shared_ptr<const FileHandle> pContainer, std::filesystem::path absolutePath)
+		: m_Container(std::move(pContainer))
+		, m_AbsolutePath(std::move(absolutePath))
+	{}
+
+	bool PackedArchive::Validate()
+	{
+		const auto data = m_Container ? m_Container->GetData() : std::span<const std::byte>{};
+		if (data.size() < sizeof(PackedArchiveHeader))
+		{
+			ZE_LOG_ERROR("[{}] is too small to be an archive!", m_AbsolutePath.string());
+			return false;
+		}
+
+		const auto& header = *reinterpret_cast<const PackedArchiveHeader*>(data.data());
+		if (header.m_Magic != PackedArchiveHeader::kMagic || header.m_Version != PackedArchiveHeader::kVersion)
+		{
+			ZE_LOG_ERROR("[{}] is not an archive of version {}!", m_AbsolutePath.string(), PackedArchiveHeader::kVersion);
+			return false;
+		}
+
+		const uint64_t entryTableSize = static_cast<uint64_t>(header.m_EntryCount) * sizeof(PackedArchiveEntry);
+		if (header.m_FileSizeInByte != data.size()
+			|| header.m_EntryTableOffset % alignof(PackedArchiveEntry) != 0
+			|| header.m_EntryTableOffset > data.size() || entryTableSize > data.size() - header.m_EntryTableOffset
+			|| header.m_PathTableOffset > data.size() || header.m_PathTableSizeInByte > data.size() - header.m_PathTableOffset)
+		{
+			ZE_LOG_ERROR("Archive [{}] is truncated or corrupted!", m_AbsolutePath.string());
+			return false;
+		}
+
+		m_Entries = { reinterpret_cast<const PackedArchiveEntry*>(data.data() + header.m_EntryTableOffset), header.m_EntryCount };
+		m_PathTable = { reinterpret_cast<const char*>(data.data() + header.m_PathTableOffset), static_cast<size_t>(header.m_PathTableSizeInByte) };
+
+		// only the table is checked here, pages of the entry data are not touched until they are loaded
+		for (size_t i = 0; i < m_Entries.size(); ++i)
+		{
+			const auto& entry = m_Entries[i];
+			const bool bIsSorted = i == 0 || m_Entries[i - 1].m_PathHash <= entry.m_PathHash;
+			const bool bIsPathInside = static_cast<uint64_t>(entry.m_PathOffset) + entry.m_PathLength <= m_PathTable.size();
+			const bool bIsDataInside = entry.m_DataOffset <= data.size() && entry.m_StoredSizeInByte <= data.size() - entry.m_DataOffset;
+			// the uncompressed size is allocated on load, so it must be one the stored data can actually expand to
+			const bool bIsCompressionValid = IsValidCompressionMethod(entry.m_Compression)
+				&& (entry.m_Compression == ECompressionMethod::None
+					? entry.m_UncompressedSizeInByte == entry.m_StoredSizeInByte
+					: entry.m_UncompressedSizeInByte <= GetMaxDecompressedSize(entry.m_Compression, static_cast<size_t>(entry.m_StoredSizeInByte)));
+			if (!bIsSorted || !bIsPathInside || !bIsDataInside || !bIsCompressionValid)
+			{
+				ZE_LOG_ERROR("Entry {} of archive [{}] is corrupted!", i, m_AbsolutePath.string());
+				return false;
+			}
+		}
+		return true;
+	}
+
+	const PackedArchiveEntry* PackedArchive::FindEntry(std::string_view normalizedPath) const
+	{
+		const uint64_t pathHash = StableHash(normalizedPath);
+		for (auto iter = std::ranges::lower_bound(m_Entries, pathHash, {}, &PackedArchiveEntry::m_PathHash);
+			iter != m_Entries.end() && iter->m_PathHash == pathHash; ++iter)
+		{
+			if (GetEntryPath(*iter) == normalizedPath)
+			{
+				return &*iter;
+			}
+		}
+		return nullptr;
+	}
+
+	std::string_view PackedArchive::GetEntryPath(const PackedArchiveEntry& entry) const
+	{
+		return m_PathTable.substr(entry.m_PathOffset, entry.m_PathLength);
+	}
+
+	std::span<const std::byte> PackedArchive::GetStoredData(const PackedArchiveEntry& entry) const
+	{
+		return m_Container->GetData().subspan(static_cast<size_t>(entry.m_DataOffset), static_cast<size_t>(entry.m_StoredSizeInByte));
+	}
+
+	FileHandle PackedArchive::Load(const PackedArchiveEntry& entry) const
+	{
+		const auto storedData = GetStoredData(entry);
+
+		FileHandle handle;
+		if (entry.m_Compression == ECompressionMethod::None)
+		{
+			handle.m_MappedView = storedData.data();
+			handle.m_MappedSize = storedData.size();
+			handle.m_Container = m_Container;
+			handle.m_HadOpen = true;
+			return handle;
+		}
+
+		handle.m_Binary.resize(static_cast<size_t>(entry.m_UncompressedSizeInByte));
+		if (!Decompress(entry.m_Compression, storedData, handle.m_Binary))
+		{
+			ZE_LOG_ERROR("Failed to decompress [{}] in archive [{}], the data is corrupted!", GetEntryPath(entry), m_AbsolutePath.string());
+			return FileHandle::FailedToOpen();
+		}
+		handle.m_HadOpen = true;
+		return handle;
+	}
+}
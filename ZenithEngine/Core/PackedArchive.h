@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Core/ClassProperty.h"
+#include "Core/Compression.h"
+#include "Core/FileSystem.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ZE::Core
+{
+	/* On-disk layout of a .zpak, little endian:
+	 * header | entries sorted by path hash | path table | aligned entry data
+	 * Everything up to the entry data is read with one mapping, looking up a file is a binary search without touching the disk.
+	 */
+	struct PackedArchiveHeader
+	{
+		static constexpr uint32_t kMagic = 0x4b41505au; // "ZPAK"
+		static constexpr uint32_t kVersion = 1u;
+
+		uint32_t							m_Magic = kMagic;
+		uint32_t							m_Version = kVersion;
+		uint32_t							m_EntryCount = 0;
+		uint32_t							m_DataAlignment = 0;
+		uint64_t							m_EntryTableOffset = 0;
+		uint64_t							m_PathTableOffset = 0;
+		uint64_t							m_PathTableSizeInByte = 0;
+		uint64_t							m_FileSizeInByte = 0;
+	};
+	static_assert(sizeof(PackedArchiveHeader) == 48);
+
+	struct PackedArchiveEntry
+	{
+		// Core::StableHash() of the normalized path
+		uint64_t							m_PathHash = 0;
+		// Core::StableHash() of the uncompressed content, entries with the same content share the data
+		uint64_t							m_ContentHash = 0;
+		uint64_t							m_DataOffset = 0;
+		uint64_t							m_StoredSizeInByte = 0;
+		uint64_t							m_UncompressedSizeInByte = 0;
+		uint32_t							m_PathOffset = 0;
+		uint16_t							m_PathLength = 0;
+		ECompressionMethod					m_Compression = ECompressionMethod::None;
+		uint8_t								m_Padding = 0;
+	};
+	static_assert(sizeof(PackedArchiveEntry) == 48);
+
+	/* Paths inside archives use '/' and start with it, as sanitized engine paths do, e.g. /ZenithEngine/Shaders/TriangleVS.spirv */
+	std::string NormalizeArchivePath(std::string_view path);
+
+	/* Build a .zpak from files, usually by a cook step. */
+	class PackedArchiveWriter
+	{
+		ZE_NON_COPYABLE_CLASS(PackedArchiveWriter);
+
+	public:
+
+		// large entries start on a page, so reading or mapping one never touches a page of its neighbours
+		static constexpr uint32_t kDefaultDataAlignment = 4096u;
+		// small entries are only aligned for in-place use of their data, padding each one to a page would bloat the archive
+		static constexpr uint32_t kSmallEntryAlignment = 16u;
+
+		explicit PackedArchiveWriter(uint32_t dataAlignment = kDefaultDataAlignment);
+
+		/* Entries are compressed only if it saves space, identical contents are stored once. Return false if the path is already added. */
+		bool AddFile(std::string_view archivePath, std::span<const std::byte> data, ECompressionMethod compression = ECompressionMethod::Lz);
+		/* Add a loose engine file under its sanitized path. */
+		bool AddFileFromDisk(const FilePath& filePath, ECompressionMethod compression = ECompressionMethod::Lz);
+
+		bool Write(const std::filesystem::path& absolutePath) const;
+
+		uint32_t GetEntryCount() const { return static_cast<uint32_t>(m_Entries.size()); }
+		uint32_t GetUniqueDataCount() const { return static_cast<uint32_t>(m_Blobs.size()); }
+
+	private:
+
+		struct Blob
+		{
+			uint64_t						m_ContentHash = 0;
+			uint64_t						m_UncompressedSizeInByte = 0;
+			ECompressionMethod				m_Compression = ECompressionMethod::None;
+			std::vector<std::byte>			m_StoredData;
+		};
+
+		struct Entry
+		{
+			std::string						m_Path;
+			uint64_t						m_PathHash = 0;
+			uint32_t						m_BlobIndex = 0;
+		};
+
+		uint32_t FindBlob(uint64_t contentHash, std::span<const std::byte> data) const;
+
+	private:
+
+		uint32_t							m_DataAlignment;
+		std::vector<Entry>					m_Entries;
+		std::vector<Blob>					m_Blobs;
+		std::unordered_multimap<uint64_t, uint32_t>	m_BlobsByContentHash;
+	};
+
+	/* Read-only view of a .zpak loaded into memory, usually mapped.
+	 * Uncompressed entries are served straight from the container without a copy, their handles keep the container alive.
+	 */
+	class PackedArchive
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(PackedArchive);
+
+	public:
+
+		/* Null if the container is not a valid archive. */
+		static std::shared_ptr<PackedArchive> Create(std::shared_ptr<const FileHandle> pContainer, std::filesystem::path absolutePath);
+
+		/* Path must be normalized. Null if the archive doesn't contain it. */
+		const PackedArchiveEntry* FindEntry(std::string_view normalizedPath) const;
+
+		std::span<const PackedArchiveEntry> GetEntries() const { return m_Entries; }
+		std::string_view GetEntryPath(const PackedArchiveEntry& entry) const;
+		/* Bytes as stored, compressed or not. */
+		std::span<const std::byte> GetStoredData(const PackedArchiveEntry& entry) const;
+
+		FileHandle Load(const PackedArchiveEntry& entry) const;
+
+		const std::filesystem::path& GetAbsolutePath() const { return m_AbsolutePath; }
+
+	private:
+
+		PackedArchive(std::shared_ptr<const FileHandle> pContainer, std::filesystem::path absolutePath);
+
+		bool Validate();
+
+	private:
+
+		std::shared_ptr<const FileHandle>	m_Container;
+		std::filesystem::path				m_AbsolutePath;
+
+		std::span<const PackedArchiveEntry>	m_Entries;
+		std::string_view					m_PathTable;
+	};
+}
@@ -2,6 +2,7 @@
 
 #include <refl.hpp>
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <type_traits>
@@ -0,0 +1,389 @@
+#pragma once
+
+#include "Core/FileSystem.h"
+#include "Core/Hash.h"
+#include "Core/Reflection.h"
+#include "Log/Log.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ZE::Core
+{
+	/* Type attribute, version of the serialized layout, written in front of the fields of each object of the type.
+	 * e.g. REFL_AUTO(type(Foo, ZE::Core::SerializedVersion(2)), field(m_A), field(m_B, ZE::Core::SinceVersion(2)))
+	 */
+	struct SerializedVersion : refl::attr::usage::type
+	{
+		uint32_t							m_Version;
+
+		constexpr explicit SerializedVersion(uint32_t version) noexcept
+			: m_Version(version)
+		{}
+	};
+
+	/* Field attribute, the field is added in the version, data of older versions leaves it as is. */
+	struct SinceVersion : refl::attr::usage::field
+	{
+		uint32_t							m_Version;
+
+		constexpr explicit SinceVersion(uint32_t version) noexcept
+			: m_Version(version)
+		{}
+	};
+
+	/* Field attribute, the field is never serialized, e.g. runtime states. */
+	struct NonSerialized : refl::attr::usage::field {};
+
+	class BinaryWriter
+	{
+	public:
+
+		void Write(const void* pData, std::size_t sizeInByte)
+		{
+			const auto* pBytes = static_cast<const std::byte*>(pData);
+			m_Buffer.insert(m_Buffer.end(), pBytes, pBytes + sizeInByte);
+		}
+
+		template <IsTriviallyCopyable T>
+		void WriteValue(const T& value) { Write(&value, sizeof(T)); }
+
+		void Reserve(std::size_t sizeInByte) { m_Buffer.reserve(sizeInByte); }
+
+		const std::vector<std::byte>& GetBuffer() const { return m_Buffer; }
+		std::vector<std::byte> ReleaseBuffer() { return std::move(m_Buffer); }
+
+	private:
+
+		std::vector<std::byte>				m_Buffer;
+	};
+
+	/* Reads are bounds-checked, once one fails all the following ones fail too. */
+	class BinaryReader
+	{
+	public:
+
+		explicit BinaryReader(std::span<const std::byte> data)
+			: m_Data(data)
+		{}
+
+		bool Read(void* pData, std::size_t sizeInByte)
+		{
+			if (m_HasFailed || sizeInByte > GetRemainingSize())
+			{
+				m_HasFailed = true;
+				return false;
+			}
+
+			if (sizeInByte != 0)
+			{
+				std::memcpy(pData, m_Data.data() + m_Cursor, sizeInByte);
+				m_Cursor += sizeInByte;
+			}
+			return true;
+		}
+
+		template <IsTriviallyCopyable T>
+		bool ReadValue(T& value) { return Read(&value, sizeof(T)); }
+
+		void Fail() { m_HasFailed = true; }
+		bool HasFailed() const { return m_HasFailed; }
+		std::size_t GetRemainingSize() const { return m_Data.size() - m_Cursor; }
+
+	private:
+
+		std::span<const std::byte>			m_Data;
+		std::size_t							m_Cursor = 0;
+		bool								m_HasFailed = false;
+	};
+
+	namespace Detail
+	{
+		template <typename T>
+		struct IsVector : std::false_type {};
+
+		template <typename T, typename Allocator>
+		struct IsVector<std::vector<T, Allocator>> : std::true_type {};
+
+		template <typename T>
+		consteval bool HasSerializedVersion()
+		{
+			if constexpr (Reflectable<T>)
+			{
+				return refl::descriptor::has_attribute<SerializedVersion>(refl::reflect<T>());
+			}
+			return false;
+		}
+
+		template <typename T>
+		consteval uint32_t GetSerializedVersion()
+		{
+			if constexpr (HasSerializedVersion<T>())
+			{
+				return refl::descriptor::get_attribute<SerializedVersion>(refl::reflect<T>()).m_Version;
+			}
+			return 0u;
+		}
+
+		// versioned types are walked field by field even if they are trivially copyable, so older data can still be read
+		template <typename T>
+		concept BulkCopyable = IsTriviallyCopyable<T> && !std::is_pointer_v<T> && !HasSerializedVersion<T>();
+
+		template <typename Member>
+		consteval bool IsSerializedField(Member member)
+		{
+			if constexpr (refl::descriptor::is_field(Member{}))
+			{
+				return !Member::is_static && !refl::descriptor::has_attribute<NonSerialized>(member);
+			}
+			return false;
+		}
+	}
+
+	template <typename T>
+	void Serialize(BinaryWriter& writer, const T& value);
+
+	template <typename T>
+	bool Deserialize(BinaryReader& reader, T& value);
+
+	namespace Detail
+	{
+		template <typename T>
+		void SerializeObject(BinaryWriter& writer, const T& value)
+		{
+			constexpr auto type = refl::reflect<T>();
+			if constexpr (HasSerializedVersion<T>())
+			{
+				writer.WriteValue(GetSerializedVersion<T>());
+			}
+
+			// bases are always walked, copying a base subobject as a whole may clobber members of the derived type in its tail padding
+			refl::util::for_each(refl::util::reflect_types(type.declared_bases), [&writer, &value](auto baseType)
+			{
+				using Base = typename decltype(baseType)::type;
+				SerializeObject<Base>(writer, static_cast<const Base&>(value));
+			});
+
+			// members of the bases are written by their own SerializeObject() above, type.members would list them again
+			refl::util::for_each(type.declared_members, [&writer, &value](auto member)
+			{
+				if constexpr (IsSerializedField(member))
+				{
+					Serialize(writer, member(value));
+				}
+			});
+		}
+
+		template <typename T>
+		bool DeserializeObject(BinaryReader& reader, T& value)
+		{
+			constexpr auto type = refl::reflect<T>();
+
+			uint32_t version = 0;
+			if constexpr (HasSerializedVersion<T>())
+			{
+				if (!reader.ReadValue(version))
+				{
+					return false;
+				}
+				if (version > GetSerializedVersion<T>())
+				{
+					ZE_LOG_ERROR("Serialized {} is of version {}, which is newer than {}!", type.name.c_str(), version, GetSerializedVersion<T>());
+					reader.Fail();
+					return false;
+				}
+			}
+
+			refl::util::for_each(refl::util::reflect_types(type.declared_bases), [&reader, &value](auto baseType)
+			{
+				using Base = typename decltype(baseType)::type;
+				DeserializeObject<Base>(reader, static_cast<Base&>(value));
+			});
+
+			refl::util::for_each(type.declared_members, [&reader, &value, version](auto member)
+			{
+				if constexpr (IsSerializedField(member))
+				{
+					if constexpr (refl::descriptor::has_attribute<SinceVersion>(member))
+					{
+						constexpr uint32_t sinceVersion = refl::descriptor::get_attribute<SinceVersion>(member).m_Version;
+						static_assert(HasSerializedVersion<T>(), "SinceVersion requires SerializedVersion on the type!");
+						static_assert(sinceVersion <= GetSerializedVersion<T>(), "Field is added in a version newer than its type!");
+
+						if (version < sinceVersion)
+						{
+							return;
+						}
+					}
+					Deserialize(reader, member(value));
+				}
+			});
+			return !reader.HasFailed();
+		}
+	}
+
+	/* Dispatched per type at compile time:
+	 * - trivially copyable values, and contiguous vectors of them, are copied as a whole
+	 * - strings and other vectors are written as a count followed by the elements
+	 * - reflected types are written field by field, bases first, prefixed by their SerializedVersion if any
+	 */
+	template <typename T>
+	void Serialize(BinaryWriter& writer, const T& value)
+	{
+		if constexpr (Detail::BulkCopyable<T>)
+		{
+			writer.WriteValue(value);
+		}
+		else if constexpr (std::is_same_v<T, std::string>)
+		{
+			writer.WriteValue(static_cast<uint64_t>(value.size()));
+			writer.Write(value.data(), value.size());
+		}
+		else if constexpr (Detail::IsVector<T>::value)
+		{
+			using Element = typename T::value_type;
+			writer.WriteValue(static_cast<uint64_t>(value.size()));
+			if constexpr (Detail::BulkCopyable<Element>)
+			{
+				writer.Write(value.data(), value.size() * sizeof(Element));
+			}
+			else
+			{
+				for (const auto& element : value)
+				{
+					Serialize(writer, element);
+				}
+			}
+		}
+		else if constexpr (Reflectable<T>)
+		{
+			Detail::SerializeObject(writer, value);
+		}
+		else
+		{
+			static_assert(sizeof(T) == 0, "Type is neither trivially copyable, a string, a vector nor reflected!");
+		}
+	}
+
+	template <typename T>
+	bool Deserialize(BinaryReader& reader, T& value)
+	{
+		if constexpr (Detail::BulkCopyable<T>)
+		{
+			return reader.ReadValue(value);
+		}
+		else if constexpr (std::is_same_v<T, std::string>)
+		{
+			uint64_t size = 0;
+			if (!reader.ReadValue(size) || size > reader.GetRemainingSize())
+			{
+				reader.Fail();
+				return false;
+			}
+			value.resize(static_cast<std::size_t>(size));
+			return reader.Read(value.data(), value.size());
+		}
+		else if constexpr (Detail::IsVector<T>::value)
+		{
+			using Element = typename T::value_type;
+
+			uint64_t count = 0;
+			if (!reader.ReadValue(count))
+			{
+				return false;
+			}
+
+			if constexpr (Detail::BulkCopyable<Element>)
+			{
+				// checked before resizing, so corrupted data never makes a huge allocation
+				if (count > reader.GetRemainingSize() / sizeof(Element))
+				{
+					reader.Fail();
+					return false;
+				}
+				value.resize(static_cast<std::size_t>(count));
+				return reader.Read(value.data(), value.size() * sizeof(Element));
+			}
+			else
+			{
+				value.clear();
+				value.reserve(static_cast<std::size_t>(std::min<uint64_t>(count, reader.GetRemainingSize())));
+				for (uint64_t i = 0; i < count; ++i)
+				{
+					if (!Deserialize(reader, value.emplace_back()))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+		}
+		else if constexpr (Reflectable<T>)
+		{
+			return Detail::DeserializeObject(reader, value);
+		}
+		else
+		{
+			static_assert(sizeof(T) == 0, "Type is neither trivially copyable, a string, a vector nor reflected!");
+		}
+	}
+
+	/* Serialized object prefixed with a header naming its type, so data of another type is rejected. */
+	struct SerializedHeader
+	{
+		static constexpr uint32_t kMagic = 0x5245535au; // "ZSER"
+
+		uint32_t							m_Magic = kMagic;
+		uint32_t							m_Reserved = 0;
+		uint64_t							m_TypeHash = 0;
+	};
+
+	template <Reflectable T>
+	constexpr uint64_t GetSerializedTypeHash()
+	{
+		return StableHash(std::string_view{ refl::reflect<T>().name.c_str() });
+	}
+
+	template <Reflectable T>
+	std::vector<std::byte> SaveToBinary(const T& value)
+	{
+		BinaryWriter writer;
+		SerializedHeader header;
+		header.m_TypeHash = GetSerializedTypeHash<T>();
+		writer.WriteValue(header);
+		Serialize(writer, value);
+		return writer.ReleaseBuffer();
+	}
+
+	template <Reflectable T>
+	bool LoadFromBinary(std::span<const std::byte> data, T& value)
+	{
+		BinaryReader reader(data);
+
+		SerializedHeader header;
+		if (!reader.ReadValue(header) || header.m_Magic != SerializedHeader::kMagic || header.m_TypeHash != GetSerializedTypeHash<T>())
+		{
+			ZE_LOG_ERROR("Data is not a serialized {}!", refl::reflect<T>().name.c_str());
+			return false;
+		}
+		return Deserialize(reader, value);
+	}
+
+	template <Reflectable T>
+	bool SaveToFile(const T& value, const FilePath& filePath)
+	{
+		return FileSystem::Save(filePath, SaveToBinary(value));
+	}
+
+	template <Reflectable T>
+	bool LoadFromFile(const FilePath& filePath, T& value)
+	{
+		const auto file = FileSystem::Load(filePath);
+		return file.IsValid() && LoadFromBinary(file.GetData(), value);
+	}
+}
@@ -0,0 +1,325 @@
+#include "TLSFAllocator.h"
+
+#include "Core/Assertion.h"
+
+#include <bit>
+#include <algorithm>
+
+namespace ZE::Core
+{
+	TLSFAllocator::TLSFAllocator(uint32_t capacity, uint32_t granularity)
+		: m_Capacity(capacity - capacity % granularity), m_Granularity(granularity)
+	{
+		ZE_ASSERT(std::has_single_bit(granularity));
+		ZE_ASSERT(m_Capacity != 0);
+
+		m_FreeListHeads.fill(kInvalidIndex);
+
+		const uint32_t nodeIndex = CreateNode();
+		m_Nodes[nodeIndex].m_Offset = 0;
+		m_Nodes[nodeIndex].m_Size = m_Capacity;
+		InsertFreeNode(nodeIndex);
+		m_FreeSize = m_Capacity;
+	}
+
+	uint64_t TLSFAllocator::GetRequiredCapacity(uint32_t size, uint32_t alignment, uint32_t granularity)
+	{
+		ZE_ASSERT(std::has_single_bit(granularity));
+
+		alignment = std::max(alignment, granularity);
+		const uint64_t alignedSize = (static_cast<uint64_t>(size) + granularity - 1) & ~static_cast<uint64_t>(granularity - 1);
+		// same search size as Allocate()
+		uint64_t capacity = alignedSize + (alignment - granularity);
+		if (capacity >= kSecondLevelCount)
+		{
+			// a free node is only found if it is in the bin the search size is rounded up to, or a higher one
+			const uint32_t msb = static_cast<uint32_t>(std::bit_width(capacity)) - 1u;
+			const uint64_t roundedSize = capacity + (1ull << (msb - kSecondLevelBits)) - 1ull;
+			const uint32_t roundedMsb = static_cast<uint32_t>(std::bit_width(roundedSize)) - 1u;
+			capacity = roundedSize & ~((1ull << (roundedMsb - kSecondLevelBits)) - 1ull);
+		}
+		return (capacity + granularity - 1) & ~static_cast<uint64_t>(granularity - 1);
+	}
+
+	TLSFAllocation TLSFAllocator::Allocate(uint32_t size, uint32_t alignment)
+	{
+		if (size == 0 || size > m_Capacity)
+		{
+			return {};
+		}
+
+		alignment = std::max(alignment, m_Granularity);
+		ZE_ASSERT(std::has_single_bit(alignment));
+
+		const uint64_t alignedSize = (static_cast<uint64_t>(size) + m_Granularity - 1) & ~static_cast<uint64_t>(m_Granularity - 1);
+		// any node this large can hold an aligned range after skipping the padding in front of it
+		const uint64_t searchSize = alignedSize + (alignment - m_Granularity);
+		if (searchSize > m_Capacity)
+		{
+			return {};
+		}
+
+		uint32_t nodeIndex = kInvalidIndex;
+		if (!FindFreeNode(static_cast<uint32_t>(searchSize), nodeIndex))
+		{
+			return {};
+		}
+
+		RemoveFreeNode(nodeIndex);
+
+		const uint32_t offset = m_Nodes[nodeIndex].m_Offset;
+		const uint32_t padding = ((offset + alignment - 1) & ~(alignment - 1)) - offset;
+		if (padding != 0)
+		{
+			SplitHead(nodeIndex, padding);
+		}
+
+		if (m_Nodes[nodeIndex].m_Size > alignedSize)
+		{
+			SplitTail(nodeIndex, static_cast<uint32_t>(alignedSize));
+		}
+
+		auto& node = m_Nodes[nodeIndex];
+		node.m_IsFree = false;
+
+		m_FreeSize -= node.m_Size;
+		++m_AllocationCount;
+
+		TLSFAllocation allocation;
+		allocation.m_Offset = node.m_Offset;
+		allocation.m_Size = node.m_Size;
+		allocation.m_NodeIndex = nodeIndex;
+		return allocation;
+	}
+
+	void TLSFAllocator::Free(const TLSFAllocation& allocation)
+	{
+		if (!allocation.IsValid())
+		{
+			return;
+		}
+
+		uint32_t nodeIndex = allocation.m_NodeIndex;
+		ZE_ASSERT(nodeIndex < m_Nodes.size() && !m_Nodes[nodeIndex].m_IsFree);
+		ZE_ASSERT(m_Nodes[nodeIndex].m_Offset == allocation.m_Offset);
+
+		m_FreeSize += m_Nodes[nodeIndex].m_Size;
+		--m_AllocationCount;
+
+		m_Nodes[nodeIndex].m_IsFree = true;
+
+		// coalesce with free neighbors, so there are never two adjacent free nodes
+		if (const uint32_t nextIndex = m_Nodes[nodeIndex].m_NextPhysical; nextIndex != kInvalidIndex && m_Nodes[nextIndex].m_IsFree)
+		{
+			RemoveFreeNode(nextIndex);
+			MergeNext(nodeIndex);
+		}
+
+		if (const uint32_t prevIndex = m_Nodes[nodeIndex].m_PrevPhysical; prevIndex != kInvalidIndex && m_Nodes[prevIndex].m_IsFree)
+		{
+			RemoveFreeNode(prevIndex);
+			MergeNext(prevIndex);
+			nodeIndex = prevIndex;
+		}
+
+		InsertFreeNode(nodeIndex);
+	}
+
+	void TLSFAllocator::MapInsert(uint32_t size, uint32_t& outFirstLevel, uint32_t& outSecondLevel)
+	{
+		if (size < kSecondLevelCount)
+		{
+			// tiny sizes are linearly mapped into the first level 0
+			outFirstLevel = 0;
+			outSecondLevel = size;
+			return;
+		}
+
+		const uint32_t msb = static_cast<uint32_t>(std::bit_width(size)) - 1u;
+		outFirstLevel = msb - kSecondLevelBits + 1u;
+		outSecondLevel = (size >> (msb - kSecondLevelBits)) & (kSecondLevelCount - 1u);
+	}
+
+	bool TLSFAllocator::MapSearch(uint32_t size, uint32_t& outFirstLevel, uint32_t& outSecondLevel)
+	{
+		uint64_t roundedSize = size;
+		if (size >= kSecondLevelCount)
+		{
+			// round up to the next bin boundary
+			const uint32_t msb = static_cast<uint32_t>(std::bit_width(size)) - 1u;
+			roundedSize += (1ull << (msb - kSecondLevelBits)) - 1ull;
+		}
+
+		if (roundedSize > std::numeric_limits<uint32_t>::max())
+		{
+			return false;
+		}
+
+		MapInsert(static_cast<uint32_t>(roundedSize), outFirstLevel, outSecondLevel);
+		return true;
+	}
+
+	bool TLSFAllocator::FindFreeNode(uint32_t size, uint32_t& outNodeIndex) const
+	{
+		uint32_t firstLevel = 0, secondLevel = 0;
+		if (!MapSearch(size, firstLevel, secondLevel))
+		{
+			return false;
+		}
+
+		uint32_t secondLevelMap = m_SecondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+		if (secondLevelMap == 0)
+		{
+			// no free node in this first level, go to the next non-empty one
+			const uint32_t firstLevelMap = (firstLevel + 1u < 32u) ? (m_FirstLevelBitmap & (~0u << (firstLevel + 1u))) : 0u;
+			if (firstLevelMap == 0)
+			{
+				return false;
+			}
+
+			firstLevel = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+			secondLevelMap = m_SecondLevelBitmaps[firstLevel];
+		}
+
+		secondLevel = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+		outNodeIndex = m_FreeListHeads[firstLevel * kSecondLevelCount + secondLevel];
+		ZE_ASSERT(outNodeIndex != kInvalidIndex);
+		return true;
+	}
+
+	void TLSFAllocator::InsertFreeNode(uint32_t nodeIndex)
+	{
+		auto& node = m_Nodes[nodeIndex];
+
+		uint32_t firstLevel = 0, secondLevel = 0;
+		MapInsert(node.m_Size, firstLevel, secondLevel);
+
+		auto& head = m_FreeListHeads[firstLevel * kSecondLevelCount + secondLevel];
+		node.m_IsFree = true;
+		node.m_PrevFree = kInvalidIndex;
+		node.m_NextFree = head;
+		if (head != kInvalidIndex)
+		{
+			m_Nodes[head].m_PrevFree = nodeIndex;
+		}
+		head = nodeIndex;
+
+		m_FirstLevelBitmap |= 1u << firstLevel;
+		m_SecondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+	}
+
+	void TLSFAllocator::RemoveFreeNode(uint32_t nodeIndex)
+	{
+		auto& node = m_Nodes[nodeIndex];
+		ZE_ASSERT(node.m_IsFree);
+
+		uint32_t firstLevel = 0, secondLevel = 0;
+		MapInsert(node.m_Size, firstLevel, secondLevel);
+
+		if (node.m_PrevFree != kInvalidIndex)
+		{
+			m_Nodes[node.m_PrevFree].m_NextFree = node.m_NextFree;
+		}
+		if (node.m_NextFree != kInvalidIndex)
+		{
+			m_Nodes[node.m_NextFree].m_PrevFree = node.m_PrevFree;
+		}
+
+		auto& head = m_FreeListHeads[firstLevel * kSecondLevelCount + secondLevel];
+		if (head == nodeIndex)
+		{
+			head = node.m_NextFree;
+			if (head == kInvalidIndex)
+			{
+				m_SecondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+				if (m_SecondLevelBitmaps[firstLevel] == 0)
+				{
+					m_FirstLevelBitmap &= ~(1u << firstLevel);
+				}
+			}
+		}
+
+		node.m_PrevFree = kInvalidIndex;
+		node.m_NextFree = kInvalidIndex;
+		node.m_IsFree = false;
+	}
+
+	void TLSFAllocator::SplitTail(uint32_t nodeIndex, uint32_t size)
+	{
+		const uint32_t tailIndex = CreateNode();
+		// m_Nodes may be reallocated by CreateNode()
+		auto& node = m_Nodes[nodeIndex];
+		auto& tail = m_Nodes[tailIndex];
+
+		tail.m_Offset = node.m_Offset + size;
+		tail.m_Size = node.m_Size - size;
+		tail.m_PrevPhysical = nodeIndex;
+		tail.m_NextPhysical = node.m_NextPhysical;
+		if (node.m_NextPhysical != kInvalidIndex)
+		{
+			m_Nodes[node.m_NextPhysical].m_PrevPhysical = tailIndex;
+		}
+
+		node.m_Size = size;
+		node.m_NextPhysical = tailIndex;
+
+		InsertFreeNode(tailIndex);
+	}
+
+	void TLSFAllocator::SplitHead(uint32_t nodeIndex, uint32_t headSize)
+	{
+		const uint32_t headIndex = CreateNode();
+		auto& node = m_Nodes[nodeIndex];
+		auto& head = m_Nodes[headIndex];
+
+		head.m_Offset = node.m_Offset;
+		head.m_Size = headSize;
+		head.m_PrevPhysical = node.m_PrevPhysical;
+		head.m_NextPhysical = nodeIndex;
+		if (node.m_PrevPhysical != kInvalidIndex)
+		{
+			m_Nodes[node.m_PrevPhysical].m_NextPhysical = headIndex;
+		}
+
+		node.m_Offset += headSize;
+		node.m_Size -= headSize;
+		node.m_PrevPhysical = headIndex;
+
+		InsertFreeNode(headIndex);
+	}
+
+	void TLSFAllocator::MergeNext(uint32_t nodeIndex)
+	{
+		auto& node = m_Nodes[nodeIndex];
+		const uint32_t nextIndex = node.m_NextPhysical;
+		const auto& next = m_Nodes[nextIndex];
+
+		node.m_Size += next.m_Size;
+		node.m_NextPhysical = next.m_NextPhysical;
+		if (next.m_NextPhysical != kInvalidIndex)
+		{
+			m_Nodes[next.m_NextPhysical].m_PrevPhysical = nodeIndex;
+		}
+
+		DestroyNode(nextIndex);
+	}
+
+	uint32_t TLSFAllocator::CreateNode()
+	{
+		if (!m_FreeNodeIndices.empty())
+		{
+			const uint32_t nodeIndex = m_FreeNodeIndices.back();
+			m_FreeNodeIndices.pop_back();
+			m_Nodes[nodeIndex] = {};
+			return nodeIndex;
+		}
+
+		m_Nodes.emplace_back();
+		return static_cast<uint32_t>(m_Nodes.size() - 1);
+	}
+
+	void TLSFAllocator::DestroyNode(uint32_t nodeIndex)
+	{
+		m_FreeNodeIndices.push_back(nodeIndex);
+	}
+}
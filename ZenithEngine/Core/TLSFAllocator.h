@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <limits>
+#include <vector>
+
+namespace ZE::Core
+{
+	/* Range handed out by TLSFAllocator, m_NodeIndex is needed to free it. */
+	struct TLSFAllocation
+	{
+		static constexpr uint32_t kInvalidNodeIndex = std::numeric_limits<uint32_t>::max();
+
+		uint32_t					m_Offset = 0;
+		uint32_t					m_Size = 0;
+		uint32_t					m_NodeIndex = kInvalidNodeIndex;
+
+		bool IsValid() const { return m_NodeIndex != kInvalidNodeIndex; }
+	};
+
+	/* Two-level segregated fit allocator of an abstract range [0, capacity).
+	 * It only manages offsets, so it can suballocate any memory (e.g. GPU buffers) which the CPU can NOT touch.
+	 * Both Allocate() and Free() are O(1). NOT thread-safe.
+	 */
+	class TLSFAllocator
+	{
+	public:
+
+		static constexpr uint32_t kSecondLevelBits = 4u;
+		static constexpr uint32_t kSecondLevelCount = 1u << kSecondLevelBits;
+		static constexpr uint32_t kFirstLevelCount = 32u - kSecondLevelBits + 1u;
+
+		/* All offsets and sizes are multiples of granularity, which must be power of two. */
+		TLSFAllocator(uint32_t capacity, uint32_t granularity = 16u);
+
+		/* Smallest capacity of a fresh allocator which can satisfy the allocation.
+		 * It is larger than the aligned size, because searches round the size up to the next bin boundary.
+		 */
+		static uint64_t GetRequiredCapacity(uint32_t size, uint32_t alignment, uint32_t granularity);
+
+		/* Return invalid allocation if there is no free range large enough. Alignment must be power of two. */
+		TLSFAllocation Allocate(uint32_t size, uint32_t alignment = 0u);
+		void Free(const TLSFAllocation& allocation);
+
+		uint32_t GetCapacity() const { return m_Capacity; }
+		uint32_t GetFreeSize() const { return m_FreeSize; }
+		uint32_t GetAllocationCount() const { return m_AllocationCount; }
+		bool IsEmpty() const { return m_AllocationCount == 0; }
+
+	private:
+
+		static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+		struct Node
+		{
+			uint32_t				m_Offset = 0;
+			uint32_t				m_Size = 0;
+			// neighbors in address order
+			uint32_t				m_PrevPhysical = kInvalidIndex;
+			uint32_t				m_NextPhysical = kInvalidIndex;
+			// neighbors in the same free list
+			uint32_t				m_PrevFree = kInvalidIndex;
+			uint32_t				m_NextFree = kInvalidIndex;
+			bool					m_IsFree = false;
+		};
+
+		// bin which contains size, used when inserting a free node
+		static void MapInsert(uint32_t size, uint32_t& outFirstLevel, uint32_t& outSecondLevel);
+		// smallest bin whose nodes are all large enough for size, used when searching
+		static bool MapSearch(uint32_t size, uint32_t& outFirstLevel, uint32_t& outSecondLevel);
+
+		bool FindFreeNode(uint32_t size, uint32_t& outNodeIndex) const;
+
+		void InsertFreeNode(uint32_t nodeIndex);
+		void RemoveFreeNode(uint32_t nodeIndex);
+
+		// split the tail of the node off as a new free node
+		void SplitTail(uint32_t nodeIndex, uint32_t size);
+		// split the head of the node off as a new free node, the original node keeps the tail
+		void SplitHead(uint32_t nodeIndex, uint32_t headSize);
+		// merge the node with its next physical node, which is removed
+		void MergeNext(uint32_t nodeIndex);
+
+		uint32_t CreateNode();
+		void DestroyNode(uint32_t nodeIndex);
+
+	private:
+
+		uint32_t																m_Capacity = 0;
+		uint32_t																m_Granularity = 0;
+		uint32_t																m_FreeSize = 0;
+		uint32_t																m_AllocationCount = 0;
+
+		uint32_t																m_FirstLevelBitmap = 0;
+		std::array<uint32_t, kFirstLevelCount>									m_SecondLevelBitmaps = {};
+		std::array<uint32_t, kFirstLevelCount * kSecondLevelCount>				m_FreeListHeads = {};
+
+		std::vector<Node>														m_Nodes;
+		std::vector<uint32_t>													m_FreeNodeIndices;
+	};
+}
@@ -1,6 +1,8 @@
 #pragma once
 
-#if ZENITH_ENGINE_DLL_EXPORT
+#if !defined(_WIN32)
+#	define ENGINE_API __attribute__(( visibility("default") ))
+#elif ZENITH_ENGINE_DLL_EXPORT
 #	define ENGINE_API __declspec( dllexport )
 #else
 #	define ENGINE_API __declspec( dllimport )
@@ -54,7 +54,7 @@ namespace ZE::Platform
 
 	private:
 		
-		friend static void _Impl::KeyCallbackFunc(GLFWwindow* window, int key, int scancode, int action, int mods);
+		friend void _Impl::KeyCallbackFunc(GLFWwindow* window, int key, int scancode, int action, int mods);
 		void AddKeyInputEvent(int key, int action);
 	
 	private:
@@ -0,0 +1,36 @@
+﻿#pragma once
+
+#include <cstdint>
+
+namespace ZE::Render
+{
+	/* Cooked static mesh, a flat little endian binary which is loaded without parsing:
+	 * header | vertices | indices
+	 * Arrays start on kCookedStaticMeshAlignment, so they can be used straight from a mapping.
+	 * Bump the version whenever the layout or StaticMesh::Vertex changes, stale files are then re-cooked from the source.
+	 */
+	constexpr uint32_t kCookedStaticMeshAlignment = 64u;
+	constexpr const char* kCookedStaticMeshExtension = ".zmesh";
+
+	struct CookedStaticMeshHeader
+	{
+		static constexpr uint32_t kMagic = 0x48534d5au; // "ZMSH"
+		static constexpr uint32_t kVersion = 1u;
+
+		uint32_t							m_Magic = kMagic;
+		uint32_t							m_Version = kVersion;
+		uint32_t							m_VertexStride = 0;
+		uint32_t							m_IndexStride = 0;
+		// last write time of the source it was cooked from, a mismatch means the source had changed since
+		uint64_t							m_SourceTimestamp = 0;
+
+		uint64_t							m_VertexOffset = 0;
+		uint64_t							m_VertexCount = 0;
+		uint64_t							m_IndexOffset = 0;
+		uint64_t							m_IndexCount = 0;
+
+		float								m_AABBMin[3] = {};
+		float								m_AABBMax[3] = {};
+	};
+	static_assert(sizeof(CookedStaticMeshHeader) == 80);
+}
@@ -29,15 +29,16 @@ namespace ZE::Render
 			return false;
 		}
 	
+		// the byte code is handed to the driver straight from the file, it is never copied on our side
 		auto handle = Core::FileSystem::Load(filePath);
-		if (auto pBinary = handle.TryGetBinaryData(); pBinary)
+		if (const auto binary = handle.GetData(); !binary.empty())
 		{
 			VulkanZeroStruct(VkShaderModuleCreateInfo, shaderCI);
 			shaderCI.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-			shaderCI.codeSize = pBinary->size();
-			shaderCI.pCode = reinterpret_cast<const uint32_t*>(pBinary->data());
+			shaderCI.codeSize = binary.size();
+			shaderCI.pCode = reinterpret_cast<const uint32_t*>(binary.data());
 
-			pShaderAsset->m_Hash = Core::Hash(*pBinary);
+			pShaderAsset->m_Hash = Core::Hash(std::string_view{ reinterpret_cast<const char*>(binary.data()), binary.size() });
 			
 			VulkanCheckSucceed(vkCreateShaderModule(pShaderAsset->GetRenderDevice().GetNativeDevice(), &shaderCI, nullptr, &(pShaderAsset->m_Shader)));
 		}
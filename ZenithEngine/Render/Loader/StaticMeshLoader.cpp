@@ -1,13 +1,24 @@
 ﻿#include "StaticMeshLoader.h"
 
+#include "CookedStaticMesh.h"
+#include "Asset/DerivedDataCache.h"
 #include "Log/Log.h"
 #include "Core/Assertion.h"
+#include "Core/Hash.h"
+#include "Core/Timer.h"
 #include "Render/StaticMesh.h"
 
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include <glm/ext/matrix_transform.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
 #include "Asset/AssetManager.h"
 
 namespace ZE::Render
@@ -38,21 +49,124 @@ namespace ZE::Render
 			result[3][3] = mat.d1;
 			return result;
 		}
+
+		uint64_t AlignUp(uint64_t value, uint64_t alignment)
+		{
+			return (value + alignment - 1u) / alignment * alignment;
+		}
+
+		// the cooked arrays are copied as they are
+		static_assert(std::is_trivially_copyable_v<StaticMesh::Vertex>);
+
+		constexpr uint32_t kImportFlags = aiProcess_JoinIdenticalVertices | aiProcess_GenBoundingBoxes;
+		// bump whenever the import produces different data from the same source, so cached imports are redone
+		constexpr uint32_t kImporterVersion = 1u;
 	}
 
 	bool StaticMeshLoader::Load(const Core::FilePath& filePath, Asset::AssetRequest& pAssetRequest)
+	{
+		StaticMesh* pStaticMesh = nullptr;
+		bool bIsCooked = false;
+
+		double loadTimeInMs = 0.0;
+		{
+			Core::ScopedTimer<Core::ETimeUnit::MilliSecond> timer(loadTimeInMs);
+
+			if (filePath.GetExtension() == kCookedStaticMeshExtension)
+			{
+				pStaticMesh = new StaticMesh;
+				bIsCooked = LoadCooked(filePath, 0, pStaticMesh);
+				if (!bIsCooked)
+				{
+					delete pStaticMesh;
+					pStaticMesh = nullptr;
+				}
+			}
+			else
+			{
+				const auto cookedPath = GetCookedPath(filePath);
+				const uint64_t sourceTimestamp = GetSourceTimestamp(filePath);
+				if (Core::FileSystem::Exists(cookedPath))
+				{
+					pStaticMesh = new StaticMesh;
+					bIsCooked = LoadCooked(cookedPath, sourceTimestamp, pStaticMesh);
+				}
+
+				// otherwise the source had been imported before, as long as none of the files the import read had changed
+				Asset::DerivedDataKey manifestKey;
+				if (!bIsCooked)
+				{
+					manifestKey = MakeImportManifestKey(filePath);
+					if (std::vector<Asset::ImportedFile> readFiles; LoadImportManifest(manifestKey, readFiles))
+					{
+						const auto key = MakeDerivedDataKey(std::move(readFiles));
+						if (auto cachedData = Asset::DerivedDataCache::Get().Load(key); cachedData.IsValid())
+						{
+							pStaticMesh = pStaticMesh ? pStaticMesh : new StaticMesh;
+							bIsCooked = ReadCooked(cachedData.GetData(), key.ToString(), 0, pStaticMesh);
+						}
+					}
+				}
+
+				if (!bIsCooked)
+				{
+					delete pStaticMesh;
+					std::vector<Asset::ImportedFile> readFiles;
+					pStaticMesh = Import(filePath, &readFiles);
+					if (pStaticMesh && manifestKey.m_SourceContentHash != 0)
+					{
+						// following loads skip Assimp, the manifest is only stored once the output it leads to is
+						auto& derivedDataCache = Asset::DerivedDataCache::Get();
+						if (derivedDataCache.Store(MakeDerivedDataKey(readFiles), BuildCooked(*pStaticMesh, sourceTimestamp)))
+						{
+							derivedDataCache.Store(manifestKey, BuildImportManifest(readFiles));
+						}
+					}
+				}
+			}
+		}
+
+		if (!pStaticMesh)
+		{
+			return false;
+		}
+
+		ZE_LOG_INFO("Loaded static mesh [{}] from {} in {:.3f} ms, {} vertices, {} indices", filePath.ToString(), bIsCooked ? "cooked data" : "Assimp",
+			loadTimeInMs, pStaticMesh->m_Vertices.size(), pStaticMesh->m_Indices.size());
+
+		pAssetRequest.SetAsset(pStaticMesh);
+		return true;
+	}
+
+	bool StaticMeshLoader::Cook(const Core::FilePath& sourcePath, const Core::FilePath& cookedPath)
+	{
+		const StaticMesh* pStaticMesh = Import(sourcePath);
+		if (!pStaticMesh)
+		{
+			return false;
+		}
+
+		const bool bSucceeded = WriteCooked(*pStaticMesh, cookedPath, GetSourceTimestamp(sourcePath));
+		delete pStaticMesh;
+		return bSucceeded;
+	}
+
+	Core::FilePath StaticMeshLoader::GetCookedPath(const Core::FilePath& sourcePath)
+	{
+		return Core::FilePath(std::filesystem::path(sourcePath.ToString() + kCookedStaticMeshExtension));
+	}
+
+	StaticMesh* StaticMeshLoader::Import(const Core::FilePath& sourcePath, std::vector<Asset::ImportedFile>* pOutReadFiles)
 	{
 		Assimp::Importer importer;
-		importer.SetIOHandler(new Asset::AssimpIOSystem);
+		importer.SetIOHandler(new Asset::AssimpIOSystem(pOutReadFiles));
 		
-		const aiScene* pScene = importer.ReadFile(
-			filePath.ToString().c_str(),
-			aiProcess_JoinIdenticalVertices | aiProcess_GenBoundingBoxes);
+		const aiScene* pScene = importer.ReadFile(sourcePath.ToString().c_str(), kImportFlags);
 			
 		if (!pScene || pScene->mNumMeshes == 0)
 		{
 			ZE_LOG_ERROR("Failed to load asset! [{}]", importer.GetErrorString());
-			return false;
+			return nullptr;
 		}
 
 		auto* pStaticMesh = new StaticMesh;
@@ -63,10 +177,185 @@ namespace ZE::Render
 		// transform = ToEngineMat4(pScene->mRootNode->mTransformation);
 		// ReadNode(pScene, pScene->mRootNode, pStaticMesh, transform);
 
-		pAssetRequest.SetAsset(pStaticMesh);
+		return pStaticMesh;
+	}
+
+	bool StaticMeshLoader::LoadCooked(const Core::FilePath& cookedPath, uint64_t sourceTimestamp, StaticMesh* pAsset)
+	{
+		// large meshes are mapped, the arrays are copied straight out of the page cache
+		const auto file = Core::FileSystem::Load(cookedPath);
+		return ReadCooked(file.GetData(), cookedPath.ToString(), sourceTimestamp, pAsset);
+	}
+
+	bool StaticMeshLoader::ReadCooked(std::span<const std::byte> data, std::string_view name, uint64_t sourceTimestamp, StaticMesh* pAsset)
+	{
+		if (data.size() < sizeof(CookedStaticMeshHeader))
+		{
+			ZE_LOG_WARNING("Cooked mesh [{}] is empty or truncated!", name);
+			return false;
+		}
+
+		CookedStaticMeshHeader header;
+		std::memcpy(&header, data.data(), sizeof(header));
+		if (header.m_Magic != CookedStaticMeshHeader::kMagic || header.m_Version != CookedStaticMeshHeader::kVersion
+			|| header.m_VertexStride != sizeof(StaticMesh::Vertex) || header.m_IndexStride != sizeof(uint32_t))
+		{
+			ZE_LOG_INFO("Cooked mesh [{}] is of another version, it is skipped until it is cooked again", name);
+			return false;
+		}
+
+		if (sourceTimestamp != 0 && header.m_SourceTimestamp != sourceTimestamp)
+		{
+			ZE_LOG_INFO("Cooked mesh [{}] is older than its source, it is skipped and the source is loaded instead", name);
+			return false;
+		}
+
+		const auto IsInside = [&data](uint64_t offset, uint64_t count, uint64_t stride)
+		{
+			return offset % kCookedStaticMeshAlignment == 0 && offset <= data.size() && count <= (data.size() - offset) / stride;
+		};
+		if (!IsInside(header.m_VertexOffset, header.m_VertexCount, header.m_VertexStride) || !IsInside(header.m_IndexOffset, header.m_IndexCount, header.m_IndexStride))
+		{
+			ZE_LOG_WARNING("Cooked mesh [{}] is corrupted!", name);
+			return false;
+		}
+
+		const auto* pVertices = reinterpret_cast<const StaticMesh::Vertex*>(data.data() + header.m_VertexOffset);
+		const auto* pIndices = reinterpret_cast<const uint32_t*>(data.data() + header.m_IndexOffset);
+		pAsset->m_Vertices.assign(pVertices, pVertices + header.m_VertexCount);
+		pAsset->m_Indices.assign(pIndices, pIndices + header.m_IndexCount);
+
+		pAsset->m_AABB.SetMin({ header.m_AABBMin[0], header.m_AABBMin[1], header.m_AABBMin[2] });
+		pAsset->m_AABB.SetMax({ header.m_AABBMax[0], header.m_AABBMax[1], header.m_AABBMax[2] });
 		return true;
 	}
 
+	bool StaticMeshLoader::WriteCooked(const StaticMesh& mesh, const Core::FilePath& cookedPath, uint64_t sourceTimestamp)
+	{
+		return Core::FileSystem::Save(cookedPath, BuildCooked(mesh, sourceTimestamp));
+	}
+
+	std::vector<std::byte> StaticMeshLoader::BuildCooked(const StaticMesh& mesh, uint64_t sourceTimestamp)
+	{
+		CookedStaticMeshHeader header;
+		header.m_VertexStride = sizeof(StaticMesh::Vertex);
+		header.m_IndexStride = sizeof(uint32_t);
+		header.m_SourceTimestamp = sourceTimestamp;
+		header.m_VertexCount = mesh.m_Vertices.size();
+		header.m_IndexCount = mesh.m_Indices.size();
+		header.m_VertexOffset = AlignUp(sizeof(CookedStaticMeshHeader), kCookedStaticMeshAlignment);
+		header.m_IndexOffset = AlignUp(header.m_VertexOffset + header.m_VertexCount * header.m_VertexStride, kCookedStaticMeshAlignment);
+
+		const auto aabbMin = mesh.m_AABB.GetMin();
+		const auto aabbMax = mesh.m_AABB.GetMax();
+		for (int i = 0; i < 3; ++i)
+		{
+			header.m_AABBMin[i] = aabbMin[i];
+			header.m_AABBMax[i] = aabbMax[i];
+		}
+
+		std::vector<std::byte> binary(header.m_IndexOffset + header.m_IndexCount * header.m_IndexStride);
+		std::memcpy(binary.data(), &header, sizeof(header));
+		std::memcpy(binary.data() + header.m_VertexOffset, mesh.m_Vertices.data(), mesh.m_Vertices.size() * sizeof(StaticMesh::Vertex));
+		std::memcpy(binary.data() + header.m_IndexOffset, mesh.m_Indices.data(), mesh.m_Indices.size() * sizeof(uint32_t));
+
+		return binary;
+	}
+
+	Asset::DerivedDataKey StaticMeshLoader::MakeDerivedDataKey(std::vector<Asset::ImportedFile> readFiles)
+	{
+		// importers may open the same file several times, the order they open files in doesn't matter
+		std::ranges::sort(readFiles, {}, &Asset::ImportedFile::m_Path);
+		const auto duplicates = std::ranges::unique(readFiles, {}, &Asset::ImportedFile::m_Path);
+		readFiles.erase(duplicates.begin(), duplicates.end());
+
+		uint64_t contentHash = Core::kStableHashSeed;
+		for (const auto& readFile : readFiles)
+		{
+			contentHash = Core::StableHash(readFile.m_Path.ToString(), contentHash);
+			contentHash = Core::StableHash(std::as_bytes(std::span{ &readFile.m_ContentHash, 1 }), contentHash);
+		}
+
+		Asset::DerivedDataKey key;
+		key.m_ImporterName = "StaticMesh";
+		// the cooked layout is part of the output as well
+		key.m_ImporterVersion = kImporterVersion * 1000u + CookedStaticMeshHeader::kVersion;
+		key.m_SourceContentHash = contentHash;
+		key.m_ImportSettingsHash = Core::StableHash(std::as_bytes(std::span{ &kImportFlags, 1 }));
+		return key;
+	}
+
+	Asset::DerivedDataKey StaticMeshLoader::MakeImportManifestKey(const Core::FilePath& sourcePath)
+	{
+		Asset::DerivedDataKey key;
+		key.m_ImporterName = "StaticMeshImportManifest";
+		key.m_ImporterVersion = kImporterVersion;
+		key.m_SourceContentHash = Asset::DerivedDataCache::HashSourceContent(sourcePath);
+		key.m_ImportSettingsHash = Core::StableHash(std::as_bytes(std::span{ &kImportFlags, 1 }));
+		return key;
+	}
+
+	std::vector<std::byte> StaticMeshLoader::BuildImportManifest(std::span<const Asset::ImportedFile> readFiles)
+	{
+		// one path per line, the contents are hashed again on every lookup
+		std::string manifest;
+		for (const auto& readFile : readFiles)
+		{
+			manifest += readFile.m_Path.ToString();
+			manifest += '\n';
+		}
+
+		const auto bytes = std::as_bytes(std::span{ manifest });
+		return { bytes.begin(), bytes.end() };
+	}
+
+	bool StaticMeshLoader::LoadImportManifest(const Asset::DerivedDataKey& manifestKey, std::vector<Asset::ImportedFile>& outReadFiles)
+	{
+		if (manifestKey.m_SourceContentHash == 0)
+		{
+			return false;
+		}
+
+		const auto manifestData = Asset::DerivedDataCache::Get().Load(manifestKey);
+		if (!manifestData.IsValid())
+		{
+			return false;
+		}
+
+		const auto data = manifestData.GetData();
+		const std::string_view manifest(reinterpret_cast<const char*>(data.data()), data.size());
+		for (const auto line : std::views::split(manifest, '\n'))
+		{
+			if (line.empty())
+			{
+				continue;
+			}
+
+			Core::FilePath path(std::string_view(line.begin(), line.end()));
+			const uint64_t contentHash = Asset::DerivedDataCache::HashSourceContent(path);
+			if (contentHash == 0)
+			{
+				return false;
+			}
+			outReadFiles.emplace_back(std::move(path), contentHash);
+		}
+		return !outReadFiles.empty();
+	}
+
+	uint64_t StaticMeshLoader::GetSourceTimestamp(const Core::FilePath& sourcePath)
+	{
+		auto path = sourcePath;
+		Core::FileSystem::Sanitize(path);
+
+		std::error_code errorCode;
+		const auto lastWriteTime = std::filesystem::last_write_time(Core::FileSystem::ToAbsoluteEnginePath(path).ToString(), errorCode);
+		if (errorCode)
+		{
+			return 0;
+		}
+		return static_cast<uint64_t>(lastWriteTime.time_since_epoch().count());
+	}
+
 	void StaticMeshLoader::ReadNode(const aiScene* pScene, aiNode* pNode, StaticMesh* pAsset, glm::mat4 accumTransform)
 	{
 		for (auto i = 0u; i < pNode->mNumMeshes; ++i)
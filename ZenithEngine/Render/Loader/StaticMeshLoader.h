@@ -5,24 +5,61 @@
 #include <assimp/Importer.hpp>
 #include <glm/fwd.hpp>
 
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
 struct aiScene;
 struct aiNode;
 struct aiMesh;
 
+namespace ZE::Asset
+{
+	struct DerivedDataKey;
+	struct ImportedFile;
+}
+
 namespace ZE::Render
 {
 	class AssetRequest;
 	class StaticMesh;
 	
+	/* Meshes are loaded from their cooked binary next to the source, e.g. scene.gltf.zmesh, which skips Assimp entirely.
+	 * Without an up-to-date one the source is imported through Assimp once, its cooked binary is then kept in the derived data cache
+	 * keyed by the content of every file the import read, so the following loads skip Assimp too.
+	 * Which files those are is only known after an import, so a manifest listing them is cached as well, keyed by the source content.
+	 */
 	class StaticMeshLoader : public Asset::IAssetLoader
 	{
 	public:
 		
 		virtual bool Load(const Core::FilePath& filePath, Asset::AssetRequest& pAssetRequest) override;
 
+		/* Import the source and write its cooked mesh, e.g. in a cook step before packing. */
+		static bool Cook(const Core::FilePath& sourcePath, const Core::FilePath& cookedPath);
+		static Core::FilePath GetCookedPath(const Core::FilePath& sourcePath);
+
 	private:
 
-		void ReadNode(const aiScene* pScene, aiNode* pNode, StaticMesh* pAsset, glm::mat4 accumTransform);
-		void ReadMesh(aiMesh* pMesh, StaticMesh* pAsset);
+		/* Files read by the import are recorded into the list if there is one. */
+		static StaticMesh* Import(const Core::FilePath& sourcePath, std::vector<Asset::ImportedFile>* pOutReadFiles = nullptr);
+		/* Fail if the cooked mesh is of another version, or is cooked from another revision of the source unless the timestamp is 0. */
+		static bool LoadCooked(const Core::FilePath& cookedPath, uint64_t sourceTimestamp, StaticMesh* pAsset);
+		static bool ReadCooked(std::span<const std::byte> data, std::string_view name, uint64_t sourceTimestamp, StaticMesh* pAsset);
+		static bool WriteCooked(const StaticMesh& mesh, const Core::FilePath& cookedPath, uint64_t sourceTimestamp);
+		static std::vector<std::byte> BuildCooked(const StaticMesh& mesh, uint64_t sourceTimestamp);
+		/* Key of the import output, hashed from the path and content of every file the import read, e.g. the buffers of a glTF. */
+		static Asset::DerivedDataKey MakeDerivedDataKey(std::vector<Asset::ImportedFile> readFiles);
+		/* Key of the list of files the import of the source read, it changes with the source content. */
+		static Asset::DerivedDataKey MakeImportManifestKey(const Core::FilePath& sourcePath);
+		static std::vector<std::byte> BuildImportManifest(std::span<const Asset::ImportedFile> readFiles);
+		/* Hash the current content of the listed files, fail if the manifest isn't cached or any of them is gone. */
+		static bool LoadImportManifest(const Asset::DerivedDataKey& manifestKey, std::vector<Asset::ImportedFile>& outReadFiles);
+		/* 0 if the source doesn't exist as a loose file, e.g. only its cooked mesh is shipped. */
+		static uint64_t GetSourceTimestamp(const Core::FilePath& sourcePath);
+
+		static void ReadNode(const aiScene* pScene, aiNode* pNode, StaticMesh* pAsset, glm::mat4 accumTransform);
+		static void ReadMesh(aiMesh* pMesh, StaticMesh* pAsset);
 	};
 }
\ No newline at end of file
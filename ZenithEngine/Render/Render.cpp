@@ -1,9 +1,11 @@
 #include "Render.h"
 
 #include "RenderGraph.h"
+#include "ViewBatch.h"
 #include "Render/Shader.h"
 #include "RenderBackend/RenderDevice.h"
 #include "RenderBackend/RenderWindow.h"
+#include "RenderBackend/OffscreenRenderTarget.h"
 #include "RenderBackend/PipelineStateCache.h"
 #include "Render/Loader/StaticMeshLoader.h"
 #include "Render/Loader/ShaderLoader.h"
@@ -18,23 +20,55 @@ namespace ZE::Render
 {
     bool RenderModule::InitializeModule()
     {
-		m_RenderDevice = new RenderBackend::RenderDevice(*this, RenderBackend::RenderDevice::Settings{});
+		RenderBackend::RenderDevice::Settings deviceSettings;
+		deviceSettings.m_Offscreen = m_Settings.m_Offscreen;
+		deviceSettings.m_EnableGpuProfiler = m_Settings.m_EnableGpuProfiler;
+		deviceSettings.m_EnableGpuPipelineStatistics = m_Settings.m_EnableGpuPipelineStatistics;
+		deviceSettings.m_EnableBindless = m_Settings.m_EnableBindless;
+		m_RenderDevice = new RenderBackend::RenderDevice(*this, deviceSettings);
 
     	Asset::AssetManager::Get().RegisterAssetLoader<StaticMesh>(new StaticMeshLoader);
     	Asset::AssetManager::Get().RegisterAssetLoader<VertexShader>(new ShaderLoader(*m_RenderDevice));
     	Asset::AssetManager::Get().RegisterAssetLoader<PixelShader>(new ShaderLoader(*m_RenderDevice));
     	
-    	m_MainRenderWindow = std::make_shared<RenderBackend::RenderWindow>(*m_RenderDevice, Platform::Window::Settings{});
+    	if (!m_Settings.m_Offscreen)
+    	{
+    		// surface of the render device is created from the main window
+    		m_MainRenderWindow = std::make_shared<RenderBackend::RenderWindow>(*m_RenderDevice, Platform::Window::Settings{});
+    	}
     	
         if (m_RenderDevice && !m_RenderDevice->Initialize())
         {
+        	// the window refers to the device, it goes first
+        	if (m_MainRenderWindow)
+        	{
+        		m_MainRenderWindow->Shutdown();
+        		m_MainRenderWindow.reset();
+        	}
+        	
             m_RenderDevice->Shutdown();
         	delete m_RenderDevice;
+        	// ShutdownModule() is still called on failure, it must NOT release the device again
+        	m_RenderDevice = nullptr;
             return false;
         }
     	
-        m_MainRenderWindow->Initialize();
-    	GetEngine().GetInputModule()->AddWindow(m_MainRenderWindow.get());
+    	if (m_Settings.m_Offscreen)
+    	{
+    		RenderBackend::OffscreenRenderTarget::Settings offscreenSettings;
+    		offscreenSettings.m_Width = m_Settings.m_OffscreenWidth;
+    		offscreenSettings.m_Height = m_Settings.m_OffscreenHeight;
+    		m_OffscreenRenderTarget = new RenderBackend::OffscreenRenderTarget(*m_RenderDevice, offscreenSettings);
+    		if (!m_OffscreenRenderTarget->Initialize())
+    		{
+    			return false;
+    		}
+    	}
+    	else
+    	{
+    		m_MainRenderWindow->Initialize();
+    		GetEngine().GetInputModule()->AddWindow(m_MainRenderWindow.get());
+    	}
 
     	m_PipelineStateCache = new RenderBackend::PipelineStateCache(*m_RenderDevice);
 
@@ -48,6 +82,12 @@ namespace ZE::Render
 
     void RenderModule::ShutdownModule()
     {
+    	if (!m_RenderDevice)
+    	{
+    		// failed to initialize the device, everything is released already
+    		return;
+    	}
+    	
     	m_RenderDevice->WaitUntilIdle();
 
     	m_TriangleRenderer.Release(*m_RenderDevice);
@@ -62,45 +102,102 @@ namespace ZE::Render
             m_MainRenderWindow.reset();
         }
 
+    	if (m_OffscreenRenderTarget)
+    	{
+    		m_OffscreenRenderTarget->Shutdown();
+    		delete m_OffscreenRenderTarget;
+    		m_OffscreenRenderTarget = nullptr;
+    	}
+
         if (m_RenderDevice)
 		{
 			m_RenderDevice->Shutdown();
 			delete m_RenderDevice;
+			m_RenderDevice = nullptr;
 		}
     }
 	
+	RenderBackend::IRenderOutput* RenderModule::GetMainRenderOutput() const
+	{
+		if (m_OffscreenRenderTarget)
+		{
+			return m_OffscreenRenderTarget;
+		}
+		return m_MainRenderWindow.get();
+	}
+	
     void RenderModule::Render()
     {
     	using namespace ZE::Render;
     	using namespace ZE::RenderBackend;
     	
-    	m_MainRenderWindow->BeginFrame();
+    	auto& renderOutput = *GetMainRenderOutput();
+    	
+    	renderOutput.BeginFrame();
     	// must wait for the commands to finish before releasing all defer release resources
     	m_RenderDevice->BeginFrame();
     	
     	RenderGraph renderGraph(*m_RenderDevice);
     	
-    	auto pSwapchainRT = GetMainRenderWindow()->GetFrameSwapchainRenderTarget();
-    	ZE_ASSERT(pSwapchainRT);
+    	auto pOutputRT = renderOutput.GetFrameRenderTarget();
+    	ZE_ASSERT(pOutputRT);
     	TextureDesc depthDesc("depth render target");
-    	depthDesc.m_Size = pSwapchainRT->GetDesc().m_Size;
+    	depthDesc.m_Size = pOutputRT->GetDesc().m_Size;
     	depthDesc.m_Format = VK_FORMAT_D32_SFLOAT_S8_UINT;
     	depthDesc.m_Usage = 1 << static_cast<uint8_t>(ETextureUsage::DepthStencil);
 
-    	auto swapchainRTHandle = renderGraph.ImportResource(pSwapchainRT, ERenderResourceState::Present);
+    	auto outputRTHandle = renderGraph.ImportResource(pOutputRT, renderOutput.GetFrameRenderTargetState());
     	auto depthRTHandle = renderGraph.CreateResource(depthDesc);
 
-    	m_TriangleRenderer.Render(renderGraph, swapchainRTHandle, depthRTHandle);
+    	m_TriangleRenderer.Render(renderGraph, outputRTHandle, depthRTHandle);
+
+    	{
+    		std::scoped_lock lock(m_ScreenshotMutex);
+    		const bool bCanReadback = (pOutputRT->GetDesc().m_Usage & (1 << static_cast<uint8_t>(ETextureUsage::TransferSrc))) != 0;
+    		if (!m_PendingScreenshotCallbacks.empty() && !bCanReadback)
+    		{
+    			ZE_LOG_WARNING("Render target of the render output can NOT be read back, screenshots are dropped!");
+    			m_PendingScreenshotCallbacks.clear();
+    		}
+    		for (auto& callback : m_PendingScreenshotCallbacks)
+    		{
+    			renderGraph.AddReadbackNode(outputRTHandle, std::move(callback));
+    		}
+    		m_PendingScreenshotCallbacks.clear();
+    	}
 
 	    {
     		auto& presentNode = renderGraph.AddNode("Present");
-    		presentNode.Read(swapchainRTHandle, ERenderResourceState::Present);
+    		presentNode.Read(outputRTHandle, renderOutput.GetFrameRenderTargetFinalState());
 	    }
     	
-    	renderGraph.Execute(*m_PipelineStateCache, *m_MainRenderWindow);
-    	m_MainRenderWindow->Present();
+    	renderGraph.Execute(*m_PipelineStateCache, renderOutput);
+    	renderOutput.Present();
+
+    	renderOutput.EndFrame();
+    	m_RenderDevice->EndFrame();
+    }
+
+    void RenderModule::RequestScreenshot(RenderBackend::ReadbackCallback callback)
+    {
+    	std::scoped_lock lock(m_ScreenshotMutex);
+    	m_PendingScreenshotCallbacks.push_back(std::move(callback));
+    }
+
+    void RenderModule::RenderViewBatch(ViewBatch& viewBatch)
+    {
+    	// frame slot is reused the same way as a render output does
+    	m_RenderDevice->WaitForFrame(m_RenderDevice->GetFrameIndex());
+    	m_RenderDevice->BeginFrame();
+
+    	RenderGraph renderGraph(*m_RenderDevice);
+
+    	viewBatch.Setup(renderGraph);
+    	m_TriangleRenderer.RenderViews(renderGraph, viewBatch);
+    	viewBatch.AddReadbackNode(renderGraph);
+
+    	viewBatch.Execute(renderGraph, *m_PipelineStateCache);
 
-    	m_MainRenderWindow->EndFrame();
     	m_RenderDevice->EndFrame();
     }
 }
@@ -1,41 +1,74 @@
 #pragma once
 
 #include "Core/Module.h"
+#include "Render/RenderSettings.h"
 #include "Renderer/TriangleRenderer.h"
+#include "RenderBackend/ReadbackManager.h"
 
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace ZE::RenderBackend
 {
 	class PipelineStateCache;
 	class RenderDevice; class RenderWindow;
+	class IRenderOutput; class OffscreenRenderTarget;
 	class VertexShader; class PixelShader;
 }
 
 namespace ZE::Render
 {
+	class ViewBatch;
+
 	class RenderModule : public Core::IModule
 	{
 	public:
 
+		using Settings = RenderSettings;
+
 		RenderModule(Core::Engine& engine)
-			: IModule(engine, Core::EModuleInitializePhase::Init, "Render")
+			: RenderModule(engine, Settings{})
+		{}
+
+		RenderModule(Core::Engine& engine, const Settings& settings)
+			: IModule(engine, Core::EModuleInitializePhase::Init, "Render"), m_Settings(settings)
 		{}
 
 		virtual bool InitializeModule() override;
 		virtual void ShutdownModule() override;
 
 		void Render();
+		/* Render the views of the batch with the renderers and read them back, as a frame of its own without any render output.
+		 * Called on the render thread between frames, the readback is ready once ViewBatch::IsFinished().
+		 */
+		void RenderViewBatch(ViewBatch& viewBatch);
+
+		/* Read back the render target of the next frame without stalling, e.g. for screenshots. Thread-safe.
+		 * Callback runs on the task thread pool with tightly packed pixels of GetFrameRenderTarget() format.
+		 */
+		void RequestScreenshot(RenderBackend::ReadbackCallback callback);
 		
+		// null in offscreen mode
 		std::shared_ptr<RenderBackend::RenderWindow> GetMainRenderWindow() const { return m_MainRenderWindow; }
+		// where frames are rendered to, the main window or the offscreen render target
+		RenderBackend::IRenderOutput* GetMainRenderOutput() const;
+		// null unless in offscreen mode
+		RenderBackend::OffscreenRenderTarget* GetOffscreenRenderTarget() const { return m_OffscreenRenderTarget; }
 
 	private:
 
+		Settings										m_Settings;
+
 		RenderBackend::RenderDevice*					m_RenderDevice = nullptr;
 		RenderBackend::PipelineStateCache*				m_PipelineStateCache = nullptr;
 
 		std::shared_ptr<RenderBackend::RenderWindow>	m_MainRenderWindow = nullptr;
+		RenderBackend::OffscreenRenderTarget*			m_OffscreenRenderTarget = nullptr;
 
 		Renderer::TriangleRenderer						m_TriangleRenderer;
+
+		std::mutex										m_ScreenshotMutex;
+		std::vector<RenderBackend::ReadbackCallback>	m_PendingScreenshotCallbacks;
 	};
 }
\ No newline at end of file
@@ -7,7 +7,9 @@
 #include "RenderBackend/DescriptorCache.h"
 #include "RenderBackend/PipelineStateCache.h"
 #include "RenderBackend/VulkanHelper.h"
-#include "RenderBackend/RenderWindow.h"
+#include "RenderBackend/IRenderOutput.h"
+#include "RenderBackend/SamplerCache.h"
+#include "RenderBackend/GpuProfiler.h"
 
 #include <vulkan/vulkan_core.h>
 
@@ -33,14 +35,22 @@ namespace ZE::Render
 			switch (type)
 			{
 				case EShaderBindingResourceType::Unknown: return VK_DESCRIPTOR_TYPE_MAX_ENUM;
-				case EShaderBindingResourceType::UniformBuffer: return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+				case EShaderBindingResourceType::UniformBuffer: return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 				case EShaderBindingResourceType::StorageBuffer: return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 				case EShaderBindingResourceType::Texture2D: return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+				case EShaderBindingResourceType::Sampler: return VK_DESCRIPTOR_TYPE_SAMPLER;
 			}
 			
 			ZE_UNREACHABLE();
 			return VK_DESCRIPTOR_TYPE_MAX_ENUM;
 		}
+
+		bool IsSameDescriptor(const RenderBackend::DescriptorWrite& lhs, const RenderBackend::DescriptorWrite& rhs)
+		{
+			return lhs.m_Binding == rhs.m_Binding && lhs.m_Type == rhs.m_Type
+				&& lhs.m_BufferInfo.buffer == rhs.m_BufferInfo.buffer && lhs.m_BufferInfo.offset == rhs.m_BufferInfo.offset && lhs.m_BufferInfo.range == rhs.m_BufferInfo.range
+				&& lhs.m_ImageInfo.sampler == rhs.m_ImageInfo.sampler && lhs.m_ImageInfo.imageView == rhs.m_ImageInfo.imageView && lhs.m_ImageInfo.imageLayout == rhs.m_ImageInfo.imageLayout;
+		}
 	}
 	
 	GraphExecutionContext::GraphExecutionContext(RenderGraph& renderGraph)
@@ -51,9 +61,9 @@ namespace ZE::Render
 	{
 		ZE_ASSERT(m_RenderTargetPtrs && m_RenderTargetBindings);
 		
-		m_RenderCommandList->CmdBeginDynamicRendering(viewportSize, *m_RenderTargetPtrs, *m_RenderTargetBindings);
-		m_RenderCommandList->CmdSetViewport(viewportSize);
-		m_RenderCommandList->CmdSetScissor(viewportSize);
+		m_CommandStream->CmdBeginDynamicRendering(viewportSize, *m_RenderTargetPtrs, *m_RenderTargetBindings);
+		m_CommandStream->CmdSetViewport(viewportSize);
+		m_CommandStream->CmdSetScissor(viewportSize);
 	}
 	
 	void GraphExecutionContext::BindVertexInput(const GraphResourceHandle& vertexBufferHandle, const GraphResourceHandle& indexBufferHandle) const
@@ -63,55 +73,47 @@ namespace ZE::Render
 		if (indexBufferHandle.IsValid())
 		{
 			const auto& indexBuffer = m_RenderGraph.get().GetResource(indexBufferHandle);
-			m_RenderCommandList->CmdBindVertexInput(
+			m_CommandStream->CmdBindVertexInput(
 				vertexBuffer.GetResourceStorage<GraphResourceType::Buffer>().get(),
 				indexBuffer.GetResourceStorage<GraphResourceType::Buffer>().get());
 		}
 		else
 		{
-			m_RenderCommandList->CmdBindVertexInput(vertexBuffer.GetResourceStorage<GraphResourceType::Buffer>().get());
+			m_CommandStream->CmdBindVertexInput(vertexBuffer.GetResourceStorage<GraphResourceType::Buffer>().get());
 		}
 	}
 
-	void GraphExecutionContext::BindResource(const std::string& name, const GraphResourceHandle& handle)
+	void GraphExecutionContext::BindVertexInput(const RenderBackend::BufferRange& vertexRange, const RenderBackend::BufferRange& indexRange) const
 	{
-		if (m_PipelineState && m_DescriptorSets)
+		// recorded before the graph is submitted, so its submission still waits for the uploads
+		m_RenderGraph.get().WaitForUpload(vertexRange.m_pBuffer->GetPendingUpload());
+		if (indexRange.IsValid())
 		{
-			const auto& location = m_PipelineState->FindBoundResourceLocation(name);
-
-			VulkanZeroStruct(VkWriteDescriptorSet, writeSet);
-			writeSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			writeSet.descriptorCount = 1;
-			writeSet.descriptorType = ToVkDescriptorType(m_PipelineState->FindBoundResourceType(name));
-			writeSet.dstBinding = location.GetBindingIndex();
-			writeSet.dstSet = (*m_DescriptorSets)[location.GetSetIndex()];
+			m_RenderGraph.get().WaitForUpload(indexRange.m_pBuffer->GetPendingUpload());
+		}
+		m_CommandStream->CmdBindVertexInput(vertexRange, indexRange);
+	}
 
+	void GraphExecutionContext::BindResource(const std::string& name, const GraphResourceHandle& handle, const RenderBackend::TextureViewDesc& viewDesc)
+	{
+		if (m_PipelineState)
+		{
 			auto& resource = m_RenderGraph.get().GetResource(handle);
 			if (resource.IsTypeOf<GraphResourceType::Buffer>())
 			{
-				VkDescriptorBufferInfo bufferInfo;
-				bufferInfo.buffer = resource.GetResourceStorage<GraphResourceType::Buffer>()->GetNativeHandle();
-				bufferInfo.offset = 0;
-				bufferInfo.range = VK_WHOLE_SIZE;
-				m_TemporaryBufferInfos.push_front(bufferInfo);
-
-				writeSet.pBufferInfo = &m_TemporaryBufferInfos.front();
-				m_WriteDescriptorSets.resize(location.GetSetIndex() + 1);
-				m_WriteDescriptorSets[location.GetSetIndex()].emplace_back(writeSet);
+				BindBuffer(name, resource.GetResourceStorage<GraphResourceType::Buffer>()->GetNativeHandle(), 0, VK_WHOLE_SIZE);
 			}
 			else if (resource.IsTypeOf<GraphResourceType::Texture>())
 			{
 				auto& resourceStorage = resource.GetResourceStorage<GraphResourceType::Texture>();
-				VkDescriptorImageInfo imageInfo;
-				imageInfo.imageView = resourceStorage->GetOrCreateView();
-				imageInfo.imageLayout = GetTextureLayout(m_RenderGraph.get().GetResourceState(handle));
-				// TODO: static sampler
-				imageInfo.sampler = nullptr;
-				m_TemporaryImageInfos.push_front(imageInfo);
-				
-				writeSet.pImageInfo = &m_TemporaryImageInfos.front();
-				m_WriteDescriptorSets.resize(location.GetSetIndex() + 1);
-				m_WriteDescriptorSets[location.GetSetIndex()].emplace_back(writeSet);
+
+				RenderBackend::DescriptorWrite write;
+				write.m_Type = ToVkDescriptorType(m_PipelineState->FindBoundResourceType(name));
+				write.m_ImageInfo.imageView = resourceStorage->GetOrCreateView(viewDesc);
+				write.m_ImageInfo.imageLayout = GetTextureLayout(m_RenderGraph.get().GetResourceState(handle));
+				// samplers are bound separately by BindSampler()
+				write.m_ImageInfo.sampler = nullptr;
+				BindDescriptor(name, write);
 			}
 			else
 			{
@@ -119,33 +121,154 @@ namespace ZE::Render
 			}
 		}
 	}
+
+	void GraphExecutionContext::BindResource(const std::string& name, const RenderBackend::BufferRange& range)
+	{
+		ZE_ASSERT(range.IsValid());
+
+		if (m_PipelineState)
+		{
+			m_RenderGraph.get().WaitForUpload(range.m_pBuffer->GetPendingUpload());
+			BindBuffer(name, range.GetNativeHandle(), range.m_Offset, range.m_Size);
+		}
+	}
+
+	void GraphExecutionContext::BindSampler(const std::string& name, const RenderBackend::SamplerDesc& samplerDesc)
+	{
+		if (m_PipelineState)
+		{
+			RenderBackend::DescriptorWrite write;
+			write.m_Type = ToVkDescriptorType(m_PipelineState->FindBoundResourceType(name));
+			write.m_ImageInfo.sampler = m_RenderGraph.get().m_RenderDevice.get().GetSamplerCache().GetOrCreate(samplerDesc);
+			BindDescriptor(name, write);
+		}
+	}
+
+	void GraphExecutionContext::BindBuffer(const std::string& name, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+	{
+		RenderBackend::DescriptorWrite write;
+		write.m_Type = ToVkDescriptorType(m_PipelineState->FindBoundResourceType(name));
+		write.m_BufferInfo.buffer = buffer;
+		write.m_BufferInfo.offset = offset;
+		write.m_BufferInfo.range = range;
+
+		if (const uint32_t dynamicIndex = m_PipelineState->FindDynamicOffsetIndex(name); dynamicIndex != RenderBackend::PipelineState::BoundShaderResourceLocation::kInvalidIndex)
+		{
+			// the offset moves into the dynamic offset, so the descriptor stays the same among draws
+			ZE_ASSERT(dynamicIndex < m_DynamicOffsets.size());
+			m_DynamicOffsets[dynamicIndex] = static_cast<uint32_t>(offset);
+			write.m_BufferInfo.offset = 0;
+		}
+
+		BindDescriptor(name, write);
+	}
+
+	void GraphExecutionContext::BindDescriptor(const std::string& name, const RenderBackend::DescriptorWrite& write)
+	{
+		const auto& location = m_PipelineState->FindBoundResourceLocation(name);
+		if (!location.IsValid())
+		{
+			ZE_LOG_WARNING("Try to bind {} which is not used by the pipeline!", name);
+			return;
+		}
+
+		RenderBackend::DescriptorWrite boundWrite = write;
+		boundWrite.m_Binding = location.GetBindingIndex();
+
+		auto& boundSet = m_BoundDescriptorSets[location.GetSetIndex()];
+		if (auto iter = std::ranges::find(boundSet.m_Writes, boundWrite.m_Binding, &RenderBackend::DescriptorWrite::m_Binding); iter != boundSet.m_Writes.end())
+		{
+			// e.g. the uniform ring buffer bound again with another dynamic offset, the set is kept
+			if (IsSameDescriptor(*iter, boundWrite))
+			{
+				return;
+			}
+			*iter = boundWrite;
+		}
+		else
+		{
+			boundSet.m_Writes.push_back(boundWrite);
+		}
+		boundSet.m_IsDirty = true;
+	}
 	
 	void GraphExecutionContext::BindPipeline()
 	{
-		if (m_RenderCommandList)
+		if (m_CommandStream && m_PipelineState)
 		{
-			for (const auto& set : m_WriteDescriptorSets)
+			ZE_ASSERT(m_DescriptorCache);
+
+			// sets are written while replaying, a set bound by commands recorded before is never touched, so changed descriptors go into a new set
+			for (uint32_t setIndex = 0; setIndex < m_BoundDescriptorSets.size(); ++setIndex)
 			{
-				vkUpdateDescriptorSets(m_RenderGraph.get().m_RenderDevice.get().GetNativeDevice(),
-					static_cast<uint32_t>(set.size()), set.data(),
-					0, nullptr);
+				auto& boundSet = m_BoundDescriptorSets[setIndex];
+				if (!boundSet.m_IsDirty)
+				{
+					continue;
+				}
+
+				m_DescriptorSets[setIndex] = m_DescriptorCache->Allocate(m_PipelineState, setIndex);
+				if (!m_DescriptorSets[setIndex])
+				{
+					ZE_LOG_ERROR("Failed to allocate descriptor set {}, pipeline is NOT bound!", setIndex);
+					return;
+				}
+				m_CommandStream->CmdUpdateDescriptorSet(m_DescriptorSets[setIndex], boundSet.m_Writes);
+				boundSet.m_IsDirty = false;
 			}
-			m_WriteDescriptorSets.clear();
-			m_TemporaryBufferInfos.clear();
-			m_TemporaryImageInfos.clear();
 			
-			m_RenderCommandList->CmdBindShaderResource(m_PipelineBindPoint, m_PipelineState, *m_DescriptorSets);
-			m_RenderCommandList->CmdBindPipeline(m_PipelineBindPoint, m_PipelineState);
+			m_CommandStream->CmdBindShaderResource(m_PipelineBindPoint, m_PipelineState, m_DescriptorSets, m_DynamicOffsets);
+			m_CommandStream->CmdBindPipeline(m_PipelineBindPoint, m_PipelineState);
 		}
 		else
 		{
-			ZE_LOG_WARNING("Try to execute command in unbounded render graph command list!");
+			ZE_LOG_WARNING("Try to bind pipeline without a pipeline state or a command stream!");
 		}
 	}
 	
 	void GraphExecutionContext::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) const
 	{
-		m_RenderCommandList->CmdDrawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+		m_CommandStream->CmdDrawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+	}
+
+	void GraphExecutionContext::CopyTextureToBuffer(const GraphResourceHandle& textureHandle, const GraphResourceHandle& bufferHandle, uint32_t dstOffset) const
+	{
+		const auto& texture = m_RenderGraph.get().GetResource(textureHandle);
+		const auto& buffer = m_RenderGraph.get().GetResource(bufferHandle);
+		ZE_ASSERT(texture.IsTypeOf<GraphResourceType::Texture>() && buffer.IsTypeOf<GraphResourceType::Buffer>());
+		ZE_ASSERT(m_RenderGraph.get().GetResourceState(textureHandle) == RenderBackend::ERenderResourceState::TransferRead);
+		ZE_ASSERT(m_RenderGraph.get().GetResourceState(bufferHandle) == RenderBackend::ERenderResourceState::TransferWrite);
+
+		m_CommandStream->CmdCopyTextureToBuffer(texture.GetResourceStorage<GraphResourceType::Texture>().get(), buffer.GetResourceStorage<GraphResourceType::Buffer>().get(), dstOffset);
+	}
+
+	void GraphExecutionContext::CopyToReadback(const GraphResourceHandle& handle, const RenderBackend::ReadbackFuture& readback) const
+	{
+		using namespace ZE::RenderBackend;
+
+		ZE_ASSERT(readback.IsValid());
+		ZE_ASSERT(m_RenderGraph.get().GetResourceState(handle) == ERenderResourceState::TransferRead);
+
+		const auto& resource = m_RenderGraph.get().GetResource(handle);
+		if (resource.IsTypeOf<GraphResourceType::Texture>())
+		{
+			m_CommandStream->CmdCopyTextureToBuffer(resource.GetResourceStorage<GraphResourceType::Texture>().get(), readback.GetDstBuffer(), readback.GetDstOffset());
+		}
+		else
+		{
+			m_CommandStream->CmdCopyBuffer(resource.GetResourceStorage<GraphResourceType::Buffer>().get(), readback.GetDstBuffer(), 0, readback.GetDstOffset(), readback.GetSizeInByte());
+		}
+
+		// readback memory is outside the graph, host access is made visible right after the copy
+		constexpr ERenderResourceState prevAccess[] = {ERenderResourceState::TransferWrite};
+		constexpr ERenderResourceState nextAccess[] = {ERenderResourceState::HostRead};
+
+		GlobalMemoryBarrier hostReadBarrier;
+		hostReadBarrier.m_PrevAccessesCount = 1;
+		hostReadBarrier.m_NextAccessesCount = 1;
+		hostReadBarrier.m_PreviousAccesses = prevAccess;
+		hostReadBarrier.m_pNextAccesses = nextAccess;
+		m_CommandStream->CmdResourceBarrier(&hostReadBarrier, {}, {});
 	}
 
     void GraphNode::Read(const GraphResourceHandle& handle, RenderBackend::ERenderResourceState access)
@@ -183,6 +306,24 @@ namespace ZE::Render
 		return *this;
     }
 
+    GraphNode& GraphNode::AddView(const GraphResourceHandle& colorHandle, const GraphResourceHandle& depthStencilHandle, RenderBackend::ERenderTargetLoadOperation loadOp, const glm::vec4& clearColor)
+    {
+		ZE_ASSERT(m_ColorAttachments.empty() && !m_DepthStencilAttachment.has_value());
+		ZE_ASSERT(m_RenderGraph->GetResource(colorHandle).IsTypeOf<GraphResourceType::Texture>());
+
+		auto& view = m_Views.emplace_back();
+		view.m_ColorAttachment = colorHandle;
+		view.m_ColorAttachmentBinding = {.m_LoadOp = loadOp, .m_StoreOp = RenderBackend::ERenderTargetStoreOperation::Store, .m_ClearValue = clearColor};
+		if (depthStencilHandle.IsValid())
+		{
+			ZE_ASSERT(m_RenderGraph->GetResource(depthStencilHandle).IsTypeOf<GraphResourceType::Texture>());
+			// depth is only needed while the view is rendered
+			view.m_DepthStencilAttachment = depthStencilHandle;
+			view.m_DepthStencilAttachmentBinding = {.m_LoadOp = loadOp, .m_StoreOp = RenderBackend::ERenderTargetStoreOperation::DontCare, .m_ClearValue = RenderBackend::DepthStencilClearValue{}};
+		}
+		return *this;
+    }
+
     GraphNode& GraphNode::BindVertexShader(const VertexShader* pVertexShader)
     {
         m_VertexShader = pVertexShader;
@@ -249,17 +390,44 @@ namespace ZE::Render
 
         return *m_TailNode;
     }
+
+	void RenderGraph::WaitForUpload(RenderBackend::UploadHandle handle)
+	{
+		if (handle.m_TimelineValue > m_WaitUpload.m_TimelineValue)
+		{
+			m_WaitUpload = handle;
+		}
+	}
 	
-    void RenderGraph::Execute(RenderBackend::PipelineStateCache& pipelineStateCache, RenderBackend::RenderWindow& renderWindow)
+    void RenderGraph::Execute(RenderBackend::PipelineStateCache& pipelineStateCache, RenderBackend::IRenderOutput& renderOutput)
+    {
+		auto* pFrameCmdList = m_RenderDevice.get().GetFrameCommandList();
+		Record(pipelineStateCache, *pFrameCmdList);
+
+		m_SubmittedTimelineValue = m_RenderDevice.get().SubmitCommandList(pFrameCmdList, renderOutput, m_WaitUpload);
+    }
+
+    void RenderGraph::Execute(RenderBackend::PipelineStateCache& pipelineStateCache)
+    {
+		auto* pFrameCmdList = m_RenderDevice.get().GetFrameCommandList();
+		Record(pipelineStateCache, *pFrameCmdList);
+
+		m_SubmittedTimelineValue = m_RenderDevice.get().SubmitCommandList(pFrameCmdList, m_WaitUpload);
+    }
+
+    void RenderGraph::Record(RenderBackend::PipelineStateCache& pipelineStateCache, RenderBackend::RenderCommandList& commandList)
     {
         Build();
 
 		ZE_ASSERT_LOG(m_Resources.size() == m_CurrentResourcesStates.size(), "Inconsistent number of graph resources and its states!");
 		
 		GraphExecutionContext context(*this);
-		auto* pFrameCmdList = m_RenderDevice.get().GetFrameCommandList();
+		context.SetCommandStream(m_CommandStream);
+		// sets of this recording are only recycled once GPU had finished the frame
+		context.SetDescriptorCache(*m_RenderDevice.get().GetFrameDescriptorCache());
 		
-		pFrameCmdList->BeginRecord();
+		m_CommandStream.Reset();
+		auto* pGpuProfiler = m_RenderDevice.get().GetGpuProfiler();
 		for (const auto* pNode : m_ExecutionNodes)
 		{
 			ZE_ASSERT_LOG(pNode->m_InputResources.size() == pNode->m_InputResourceStates.size(), "Inconsistent number of node {} input resources and its states!", pNode->m_NodeName.c_str());
@@ -274,7 +442,7 @@ namespace ZE::Render
 				auto dstResourceState = pNode->m_InputResourceStates[i];
 				if (IsResourceStateChanged(pNode->m_InputResources[i], dstResourceState))
 				{
-					TransitionResource(pNode->m_InputResources[i], dstResourceState, pFrameCmdList->GetQueueIndex());
+					TransitionResource(pNode->m_InputResources[i], dstResourceState, commandList.GetQueueIndex());
 				}
 			}
 			for (uint32_t i = 0; i < pNode->m_OutputResourceStates.size(); ++i)
@@ -282,66 +450,164 @@ namespace ZE::Render
 				auto dstResourceState = pNode->m_OutputResourceStates[i];
 				if (IsResourceStateChanged(pNode->m_OutputResources[i], dstResourceState))
 				{
-					TransitionResource(pNode->m_OutputResources[i], dstResourceState, pFrameCmdList->GetQueueIndex());
+					TransitionResource(pNode->m_OutputResources[i], dstResourceState, commandList.GetQueueIndex());
 				}
 			}
-			pFrameCmdList->CmdResourceBarrier(nullptr, gsTempBufferBarriers, gsTempTextureBarriers);
+			m_CommandStream.CmdResourceBarrier(nullptr, gsTempBufferBarriers, gsTempTextureBarriers);
 			
 			gsTempBufferBarriers.clear();
 			gsTempTextureBarriers.clear();
 			gsTempPrevResourceTransitionStates.clear();
 			gsTempNextResourceTransitionStates.clear();
 			
-			if (pNode->m_Job)
+			if (!pNode->m_Job)
 			{
-				// Create pipeline state here? may be far more ahead
-				RenderBackend::GraphicPipelineStateCreateDesc graphicPSOCreateDesc;
-				std::vector<RenderBackend::Texture*> renderTargetPtrs;
-				std::vector<RenderBackend::RenderPassRenderTargetBinding> renderTargetBindings;
+				continue;
+			}
 
-				for (auto i = 0u; i < pNode->m_ColorAttachments.size(); ++i)
+			context.m_ViewIndex = 0;
+
+			// barriers are left out of the node timing
+			const uint32_t gpuScope = pGpuProfiler ? pGpuProfiler->BeginScope(m_CommandStream, pNode->m_NodeName) : RenderBackend::GpuProfiler::kInvalidScope;
+
+			if (!pNode->m_VertexShader)
+			{
+				// transfer node, it has neither pipeline nor render targets
+				context.SetPipeline(nullptr, VK_PIPELINE_BIND_POINT_GRAPHICS);
+				context.SetRenderTargets(nullptr, nullptr);
+
+				pNode->m_Job(context);
+
+				if (pGpuProfiler)
 				{
-					const auto& resource = GetResource(pNode->m_ColorAttachments[i]);
-					ZE_ASSERT(resource.IsTypeOf<GraphResourceType::Texture>());
-					
-					graphicPSOCreateDesc.AddColorOutput(resource.GetDesc<GraphResourceType::Texture>().m_Format);
+					pGpuProfiler->EndScope(m_CommandStream, gpuScope);
+				}
+				continue;
+			}
+
+			struct RenderTargetSet
+			{
+				std::vector<RenderBackend::Texture*>						m_RenderTargetPtrs;
+				std::vector<RenderBackend::RenderPassRenderTargetBinding>	m_RenderTargetBindings;
+			};
+
+			auto fAddRenderTarget = [this](RenderTargetSet& set, const GraphResourceHandle& handle, const RenderBackend::RenderPassRenderTargetBinding& binding)
+			{
+				const auto& resource = GetResource(handle);
+				ZE_ASSERT(resource.IsTypeOf<GraphResourceType::Texture>());
+
+				set.m_RenderTargetPtrs.push_back(resource.GetResourceStorage<GraphResourceType::Texture>().get());
+				set.m_RenderTargetBindings.push_back(binding);
+				return resource.GetDesc<GraphResourceType::Texture>().m_Format;
+			};
 
-					renderTargetPtrs.push_back(resource.GetResourceStorage<GraphResourceType::Texture>().get());
-					renderTargetBindings.push_back(pNode->m_ColorAttachmentBindings[i]);
+			// Create pipeline state here? may be far more ahead
+			RenderBackend::GraphicPipelineStateCreateDesc graphicPSOCreateDesc;
+			// one set per view, a node without views has a single set
+			std::vector<RenderTargetSet> renderTargetSets(std::max<size_t>(pNode->m_Views.size(), 1u));
+
+			if (pNode->m_Views.empty())
+			{
+				for (auto i = 0u; i < pNode->m_ColorAttachments.size(); ++i)
+				{
+					graphicPSOCreateDesc.AddColorOutput(fAddRenderTarget(renderTargetSets[0], pNode->m_ColorAttachments[i], pNode->m_ColorAttachmentBindings[i]));
 				}
 
 				if (pNode->m_DepthStencilAttachment.has_value())
 				{
-					const auto& resource = GetResource(*pNode->m_DepthStencilAttachment);
-					ZE_ASSERT(resource.IsTypeOf<GraphResourceType::Texture>());
-					graphicPSOCreateDesc.SetDepthStencilOutput(resource.GetDesc<GraphResourceType::Texture>().m_Format);
+					graphicPSOCreateDesc.SetDepthStencilOutput(fAddRenderTarget(renderTargetSets[0], *pNode->m_DepthStencilAttachment, pNode->m_DepthStencilAttachmentBinding));
+				}
+			}
+			else
+			{
+				// views share one pipeline state, so their render targets must have the same formats
+				VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+				VkFormat depthStencilFormat = VK_FORMAT_UNDEFINED;
+				for (auto i = 0u; i < pNode->m_Views.size(); ++i)
+				{
+					const auto& view = pNode->m_Views[i];
+					const VkFormat viewColorFormat = fAddRenderTarget(renderTargetSets[i], view.m_ColorAttachment, view.m_ColorAttachmentBinding);
+					const VkFormat viewDepthStencilFormat = view.m_DepthStencilAttachment.IsValid()
+						? fAddRenderTarget(renderTargetSets[i], view.m_DepthStencilAttachment, view.m_DepthStencilAttachmentBinding) : VK_FORMAT_UNDEFINED;
+
+					if (i == 0)
+					{
+						colorFormat = viewColorFormat;
+						depthStencilFormat = viewDepthStencilFormat;
+					}
+					ZE_ASSERT_LOG(viewColorFormat == colorFormat && viewDepthStencilFormat == depthStencilFormat, "View {} of node {} has different render target formats from the first view!", i, pNode->m_NodeName);
+				}
 
-					renderTargetPtrs.push_back(resource.GetResourceStorage<GraphResourceType::Texture>().get());
-					renderTargetBindings.push_back(pNode->m_DepthStencilAttachmentBinding);
+				graphicPSOCreateDesc.AddColorOutput(colorFormat);
+				if (depthStencilFormat != VK_FORMAT_UNDEFINED)
+				{
+					graphicPSOCreateDesc.SetDepthStencilOutput(depthStencilFormat);
 				}
+			}
+
+			graphicPSOCreateDesc.SetVertexShader(pNode->m_VertexShader);
+			graphicPSOCreateDesc.SetPixelShaderOptional(pNode->m_PixelShader);
 
-				graphicPSOCreateDesc.SetVertexShader(pNode->m_VertexShader);
-				graphicPSOCreateDesc.SetPixelShaderOptional(pNode->m_PixelShader);
+			auto pPipelineState = pipelineStateCache.CreateGraphicPipelineState(graphicPSOCreateDesc);
+			if (pPipelineState)
+			{
+				context.SetPipeline(pPipelineState.get(), VK_PIPELINE_BIND_POINT_GRAPHICS);
 
-				auto pPipelineState = pipelineStateCache.CreateGraphicPipelineState(graphicPSOCreateDesc);
-				if (pPipelineState)
+				for (auto i = 0u; i < renderTargetSets.size(); ++i)
 				{
-					auto& sets = m_RenderDevice.get().GetFrameDescriptorCache()->FindOrAdd(pPipelineState.get());
-				
-					context.SetDescriptorSets(sets);
-					context.SetPipeline(pPipelineState.get(), VK_PIPELINE_BIND_POINT_GRAPHICS);
-					context.SetRenderTargets(&renderTargetPtrs, &renderTargetBindings);
-					context.SetCommandList(*pFrameCmdList);
-				
+					context.m_ViewIndex = i;
+					context.SetRenderTargets(&renderTargetSets[i].m_RenderTargetPtrs, &renderTargetSets[i].m_RenderTargetBindings);
+			
 					pNode->m_Job(context);
 
-					pFrameCmdList->CmdEndDynamicRendering();	
+					m_CommandStream.CmdEndDynamicRendering();
 				}
 			}
+
+			if (pGpuProfiler)
+			{
+				pGpuProfiler->EndScope(m_CommandStream, gpuScope);
+			}
+		}
+
+		// translate in one pass, recording above never touched the command buffer
+		commandList.BeginRecord();
+		m_ReplayStatistics = m_CommandStream.Replay(commandList);
+		commandList.EndRecord();
+    }
+
+    RenderBackend::ReadbackFuture RenderGraph::AddReadbackNode(const GraphResourceHandle& handle, RenderBackend::ReadbackCallback callback)
+    {
+		using namespace ZE::RenderBackend;
+
+		const auto& resource = GetResource(handle);
+		uint32_t sizeInByte = 0;
+		if (resource.IsTypeOf<GraphResourceType::Texture>())
+		{
+			const auto& desc = resource.GetDesc<GraphResourceType::Texture>();
+			ZE_ASSERT_LOG((desc.m_Usage & (1 << static_cast<uint8_t>(ETextureUsage::TransferSrc))) != 0, "Readback texture {} is not created with TransferSrc usage!", desc.m_DebugName);
+			sizeInByte = desc.m_Size.x * desc.m_Size.y * GetFormatSizeInByte(desc.m_Format);
+		}
+		else
+		{
+			sizeInByte = resource.GetDesc<GraphResourceType::Buffer>().m_Size;
+		}
+
+		if (sizeInByte == 0)
+		{
+			ZE_LOG_ERROR("Failed to read back graph resource, unsupported format or empty resource!");
+			return {};
 		}
-		pFrameCmdList->EndRecord();
 
-		m_RenderDevice.get().SubmitCommandList(pFrameCmdList, renderWindow);
+		auto readback = m_RenderDevice.get().GetReadbackManager().Allocate(sizeInByte, std::move(callback));
+
+		auto& readbackNode = AddNode("Readback");
+		readbackNode.Read(handle, ERenderResourceState::TransferRead);
+		readbackNode.Execute([handle, readback](GraphExecutionContext& context)
+		{
+			context.CopyToReadback(handle, readback);
+		});
+		return readback;
     }
 
     void RenderGraph::Build()
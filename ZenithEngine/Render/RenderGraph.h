@@ -6,8 +6,12 @@
 #include "Math/Math.h"
 #include "RenderBackend/RenderResourceState.h"
 #include "RenderBackend/RenderCommandList.h"
+#include "RenderBackend/RenderCommandStream.h"
 #include "RenderBackend/RenderPass.h"
 #include "RenderBackend/RenderDevice.h"
+#include "RenderBackend/UploadManager.h"
+#include "RenderBackend/UniformRingBuffer.h"
+#include "RenderBackend/ReadbackManager.h"
 
 #include <cstdint>
 #include <vector>
@@ -17,17 +21,19 @@
 #include <memory>
 #include <functional>
 #include <optional>
-#include <forward_list>
 
 namespace ZE::RenderBackend
 {
-	class PipelineStateCache; class PipelineState;
-	class RenderDevice;
+	class PipelineStateCache; class PipelineState; class DescriptorCache;
+	struct SamplerDesc;
+	class RenderDevice; class IRenderOutput;
 	class VertexShader; class PixelShader;
 }
 
 namespace ZE::Render
 {
+	class RenderGraph;
+
 	class GraphResourceHandle
 	{
 		friend class RenderGraph;
@@ -77,6 +83,15 @@ namespace ZE::Render
 			RenderBackend::ERenderTargetStoreOperation storeOp = RenderBackend::ERenderTargetStoreOperation::Store,
 			const RenderBackend::DepthStencilClearValue& clearValue = {});
 
+		/* Render the node once per view into the render targets of the view, all views must have the same render target formats.
+		*  It can NOT be mixed with node-wide render targets. Targets are NOT written implicitly, Write() them as well.
+		*  The job is called once per view, see GraphExecutionContext::GetViewIndex().
+		*/
+		GraphNode& AddView(const GraphResourceHandle& colorHandle, const GraphResourceHandle& depthStencilHandle = {},
+			RenderBackend::ERenderTargetLoadOperation loadOp = RenderBackend::ERenderTargetLoadOperation::Clear,
+			const glm::vec4& clearColor = RenderBackend::CommonColors::m_Transparent);
+
+		/* Node without a vertex shader is a transfer node, its job runs without pipeline and render targets. */
 		GraphNode& BindVertexShader(const VertexShader* pVertexShader);
 		GraphNode& BindPixelShader(const PixelShader* pPixelShader);
 		
@@ -99,6 +114,15 @@ namespace ZE::Render
 		const VertexShader*											m_VertexShader = nullptr;
 		const PixelShader*											m_PixelShader = nullptr;
 
+		struct View
+		{
+			GraphResourceHandle										m_ColorAttachment;
+			RenderBackend::RenderPassRenderTargetBinding			m_ColorAttachmentBinding;
+			GraphResourceHandle										m_DepthStencilAttachment;
+			RenderBackend::RenderPassRenderTargetBinding			m_DepthStencilAttachmentBinding;
+		};
+		std::vector<View>											m_Views;
+
 		std::vector<GraphNode*>					            		m_PrecedeNodes;
 		std::vector<GraphNode*>					            		m_SucceedNodes;
 		
@@ -232,11 +256,29 @@ namespace ZE::Render
 
 		[[nodiscard("Allocated graph node must be used.")]] GraphNode& AddNode(const std::string& nodeName);
 
+		/* GPU execution of this graph will wait until the upload is finished, CPU is not blocked.
+		*  Pending uploads of imported buffers and bound buffer ranges are waited without calling this.
+		*/
+		void WaitForUpload(RenderBackend::UploadHandle handle);
+
 		/* Execute render graph.
 		*  All graph nodes will be executed.
 		*  Allocated dedicated memory owned by graph node will be released after execution.
 		*/
-		void Execute(RenderBackend::PipelineStateCache& pipelineStateCache, RenderBackend::RenderWindow& renderWindow);
+		void Execute(RenderBackend::PipelineStateCache& pipelineStateCache, RenderBackend::IRenderOutput& renderOutput);
+		/* Execute render graph of a frame without any output, e.g. one only rendering into readback buffers. */
+		void Execute(RenderBackend::PipelineStateCache& pipelineStateCache);
+
+		/* Add a node copying the texture or buffer into the readback ring of the render device.
+		*  The future resolves once GPU had finished this graph, the callback runs on the task thread pool.
+		*/
+		RenderBackend::ReadbackFuture AddReadbackNode(const GraphResourceHandle& handle, RenderBackend::ReadbackCallback callback = {});
+
+		/* Graphic timeline value signaled once GPU had finished the latest Execute(). */
+		uint64_t GetSubmittedTimelineValue() const { return m_SubmittedTimelineValue; }
+
+		/* Statistics of the latest Execute(), counts how many redundant state commands were dropped. */
+		const RenderBackend::RenderCommandReplayStatistics& GetReplayStatistics() const { return m_ReplayStatistics; }
 
 	private:
 
@@ -246,6 +288,9 @@ namespace ZE::Render
 		*/
 		void Build();
 		void TopologySort();
+
+		/* Record all nodes and replay them into the command list. */
+		void Record(RenderBackend::PipelineStateCache& pipelineStateCache, RenderBackend::RenderCommandList& commandList);
 		
 		const GraphResource& GetResource(const GraphResourceHandle& handle) const;
 		uint32_t GetResourceIndex(const GraphResourceHandle& handle) const;
@@ -270,6 +315,14 @@ namespace ZE::Render
 
 		std::vector<GraphResource>								m_Resources;
 		std::vector<RenderBackend::ERenderResourceState>		m_CurrentResourcesStates;
+
+		// uploads finish in order, so only the latest one needs to be waited
+		RenderBackend::UploadHandle								m_WaitUpload;
+
+		// nodes record here, it is replayed into the frame command list once all nodes had run
+		RenderBackend::RenderCommandStream						m_CommandStream;
+		RenderBackend::RenderCommandReplayStatistics			m_ReplayStatistics;
+		uint64_t												m_SubmittedTimelineValue = 0;
 	};
 
 	template <ValidUnderlyingGraphResource T, typename... Args>
@@ -277,7 +330,9 @@ namespace ZE::Render
 	{
 		constexpr GraphResourceType resourceType = GraphUnderlyingResourceTrait<T>::type;
 		// TODO: defer create this
-		auto pResource = std::shared_ptr<GraphResourceUnderlyingType<resourceType>>(GraphResourceUnderlyingType<resourceType>::Create(m_RenderDevice, desc, std::forward<Args>(args)...));
+		T transientDesc = desc;
+		transientDesc.m_MemoryCategory = RenderBackend::EMemoryCategory::GraphTransient;
+		auto pResource = std::shared_ptr<GraphResourceUnderlyingType<resourceType>>(GraphResourceUnderlyingType<resourceType>::Create(m_RenderDevice, transientDesc, std::forward<Args>(args)...));
 		const auto resourceIndex = static_cast<uint32_t>(m_Resources.size());
 		m_Resources.emplace_back(pResource);
 		m_CurrentResourcesStates.push_back(RenderBackend::ERenderResourceState::Undefined);
@@ -294,6 +349,11 @@ namespace ZE::Render
 	GraphResourceHandle RenderGraph::ImportResource(const std::shared_ptr<T>& resource, RenderBackend::ERenderResourceState currentState)
 	{
 		static_assert(ValidUnderlyingGraphResource<T>);
+		if constexpr (std::is_same_v<T, RenderBackend::Buffer>)
+		{
+			WaitForUpload(resource->GetPendingUpload());
+		}
+
 		const auto resourceIndex = static_cast<uint32_t>(m_Resources.size()); 
 		m_Resources.emplace_back(resource);
 		m_CurrentResourcesStates.push_back(currentState);
@@ -335,14 +395,29 @@ namespace ZE::Render
 		void SetViewportSize(const glm::uvec2& viewportSize) const;
 
 		void BindVertexInput(const GraphResourceHandle& vertexBufferHandle, const GraphResourceHandle& indexBufferHandle = {}) const;
+		/* Ranges are NOT tracked by the graph, they must be in the right state already. */
+		void BindVertexInput(const RenderBackend::BufferRange& vertexRange, const RenderBackend::BufferRange& indexRange = {}) const;
 		
+		/* Copy data into the uniform ring of current frame and bind it to the uniform buffer of the name. */
 		template <typename T>
-		void UpdateUniformBuffer(const GraphResourceHandle& handle, const T& data);
+		void UpdateUniformBuffer(const std::string& name, const T& data);
 
-		void BindResource(const std::string& name, const GraphResourceHandle& handle);
+		/* View desc is ignored if the resource is a buffer. */
+		void BindResource(const std::string& name, const GraphResourceHandle& handle, const RenderBackend::TextureViewDesc& viewDesc = {});
+		void BindResource(const std::string& name, const RenderBackend::BufferRange& range);
+		/* Sampler is deduplicated by the sampler cache of the render device. */
+		void BindSampler(const std::string& name, const RenderBackend::SamplerDesc& samplerDesc);
 		void BindPipeline();
 
 		void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) const;
+
+		/* Texture must be read as TransferRead and buffer must be written as TransferWrite by the node. */
+		void CopyTextureToBuffer(const GraphResourceHandle& textureHandle, const GraphResourceHandle& bufferHandle, uint32_t dstOffset = 0) const;
+		/* Copy texture or buffer into its readback memory and make it visible to host, resource must be read as TransferRead by the node. */
+		void CopyToReadback(const GraphResourceHandle& handle, const RenderBackend::ReadbackFuture& readback) const;
+
+		/* Index of the view being rendered, always 0 for nodes without views. */
+		uint32_t GetViewIndex() const { return m_ViewIndex; }
 		
 	private:
 
@@ -353,16 +428,21 @@ namespace ZE::Render
 		{
 			m_PipelineState = pPipelineState;
 			m_PipelineBindPoint = bindPoint;
+			m_DynamicOffsets.assign(pPipelineState ? pPipelineState->GetDynamicOffsetCount() : 0u, 0u);
+
+			const uint32_t setCount = pPipelineState ? pPipelineState->GetDescriptorSetCount() : 0u;
+			m_BoundDescriptorSets.assign(setCount, {});
+			m_DescriptorSets.assign(setCount, nullptr);
 		}
 
-		void SetDescriptorSets(const std::vector<VkDescriptorSet>& sets)
+		void SetDescriptorCache(RenderBackend::DescriptorCache& descriptorCache)
 		{
-			m_DescriptorSets = &sets;
+			m_DescriptorCache = &descriptorCache;
 		}
 
-		void SetCommandList(RenderBackend::RenderCommandList& commandList)
+		void SetCommandStream(RenderBackend::RenderCommandStream& commandStream)
 		{
-			m_RenderCommandList = &commandList;
+			m_CommandStream = &commandStream;
 		}
 
 		void SetRenderTargets(std::vector<RenderBackend::Texture*>* pRenderTargetPtrs, std::vector<RenderBackend::RenderPassRenderTargetBinding>* pRenderTargetBindings)
@@ -370,23 +450,35 @@ namespace ZE::Render
 			m_RenderTargetPtrs = pRenderTargetPtrs;
 			m_RenderTargetBindings = pRenderTargetBindings;
 		}
+
+		void BindBuffer(const std::string& name, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+		void BindDescriptor(const std::string& name, const RenderBackend::DescriptorWrite& write);
 		
 	private:
 
+		// descriptors bound to a set index since the pipeline was set
+		struct BoundDescriptorSet
+		{
+			std::vector<RenderBackend::DescriptorWrite>		m_Writes;
+			// changed since the set was last written, the next bind writes them into a new set
+			bool											m_IsDirty = true;
+		};
+
 		std::reference_wrapper<RenderGraph>					m_RenderGraph;
-		RenderBackend::RenderCommandList*					m_RenderCommandList = nullptr;
+		RenderBackend::RenderCommandStream*					m_CommandStream = nullptr;
+		uint32_t											m_ViewIndex = 0;
 
 		std::vector<RenderBackend::Texture*>*							m_RenderTargetPtrs = nullptr;
 		std::vector<RenderBackend::RenderPassRenderTargetBinding>*		m_RenderTargetBindings = nullptr;
 
 		RenderBackend::PipelineState*						m_PipelineState = nullptr;
-		const std::vector<VkDescriptorSet>*					m_DescriptorSets = nullptr;
 		VkPipelineBindPoint									m_PipelineBindPoint = VK_PIPELINE_BIND_POINT_MAX_ENUM;
-		
-		std::vector<std::vector<VkWriteDescriptorSet>>		m_WriteDescriptorSets;
-		// TODO: replace to inline linked list
-		std::forward_list<VkDescriptorBufferInfo>			m_TemporaryBufferInfos;
-		std::forward_list<VkDescriptorImageInfo>			m_TemporaryImageInfos;
+		RenderBackend::DescriptorCache*						m_DescriptorCache = nullptr;
+
+		std::vector<BoundDescriptorSet>						m_BoundDescriptorSets;
+		// sets recorded by the latest bind, a written set is never written again, so commands recorded before keep their descriptors
+		std::vector<VkDescriptorSet>						m_DescriptorSets;
+		std::vector<uint32_t>								m_DynamicOffsets;
 	};
 
 	template <GraphResourceType Type>
@@ -396,17 +488,16 @@ namespace ZE::Render
 	}
 	
 	template <typename T>
-	void GraphExecutionContext::UpdateUniformBuffer(const GraphResourceHandle& handle, const T& data)
+	void GraphExecutionContext::UpdateUniformBuffer(const std::string& name, const T& data)
 	{
-		auto& renderResource = m_RenderGraph.get().GetResource(handle);
-		if (renderResource.IsTypeOf<GraphResourceType::Buffer>() && (renderResource.GetDesc<GraphResourceType::Buffer>().m_Usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) != 0)
+		const auto range = m_RenderGraph.get().m_RenderDevice.get().GetUniformRingBuffer().Write(&data, static_cast<uint32_t>(sizeof(T)));
+		if (range.IsValid())
 		{
-			auto scope = renderResource.GetResourceStorage<GraphResourceType::Buffer>()->Map();
-			memcpy(scope.m_pMappedMemory, &data, sizeof(T)); 
+			BindResource(name, range);
 		}
 		else
 		{
-			ZE_LOG_WARNING("Try to update a non uniform buffer resource in UpdateUniformBuffer().");
+			ZE_LOG_WARNING("Failed to update uniform buffer {}, uniform ring buffer is exhausted.", name);
 		}
 	}
 }
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "ModuleDefines.h"
+
+#include <cstdint>
+
+namespace ZE::Render
+{
+	/* Options of the render module, given to the engine before it is initialized. */
+	struct ENGINE_API RenderSettings
+	{
+		// Render into a ring of offscreen images instead of a window swapchain, no window is created.
+		bool								m_Offscreen = false;
+		uint32_t							m_OffscreenWidth = 1920u;
+		uint32_t							m_OffscreenHeight = 1080u;
+		// GPU timing of render graph nodes, read through RenderDevice::GetGpuProfiler().
+		bool								m_EnableGpuProfiler = false;
+		bool								m_EnableGpuPipelineStatistics = false;
+		// Global descriptor arrays indexed by shaders, read through RenderDevice::GetBindlessResourceTable().
+		bool								m_EnableBindless = false;
+	};
+}
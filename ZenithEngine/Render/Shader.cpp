@@ -19,6 +19,7 @@ namespace ZE::Render
 				case EShaderBindingResourceType::UniformBuffer: return "UniformBuffer";
 				case EShaderBindingResourceType::StorageBuffer: return "StorageBuffer";
 				case EShaderBindingResourceType::Texture2D: return "Texture2D";
+				case EShaderBindingResourceType::Sampler: return "Sampler";
 			}
 			return "";
 		}
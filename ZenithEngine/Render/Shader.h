@@ -31,6 +31,7 @@ namespace ZE::Render
 		UniformBuffer,
 		StorageBuffer,
 		Texture2D,
+		Sampler,
 	};
 	
 	class Shader : public Asset::Asset, public RenderBackend::RenderDeviceChild
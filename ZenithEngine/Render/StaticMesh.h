@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "Core/Reflection.h"
+#include "Core/Serialization.h"
 #include "Asset/Asset.h"
 
 namespace ZE::Render
@@ -20,6 +21,11 @@ namespace ZE::Render
 		};
 
 		Math::AxisAlignedBoundingBox GetAABB() const { return m_AABB; }
+
+		virtual uint64_t GetMemorySizeInByte() const override
+		{
+			return sizeof(StaticMesh) + m_Vertices.capacity() * sizeof(Vertex) + m_Indices.capacity() * sizeof(uint32_t);
+		}
 	
 	private:
 
@@ -31,4 +37,4 @@ namespace ZE::Render
 
 }
 
-REFL_AUTO(type(ZE::Render::StaticMesh, bases<ZE::Asset::Asset>), field(m_Vertices), field(m_Indices), field(m_AABB))
+REFL_AUTO(type(ZE::Render::StaticMesh, bases<ZE::Asset::Asset>, ZE::Core::SerializedVersion(1)), field(m_Vertices), field(m_Indices), field(m_AABB))
@@ -0,0 +1,175 @@
+#include "ViewBatch.h"
+
+#include "Core/Assertion.h"
+#include "RenderBackend/RenderDevice.h"
+#include "RenderBackend/TimelineSemaphore.h"
+#include "RenderBackend/DeferReleaseQueue.h"
+
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <array>
+#include <format>
+
+namespace ZE::Render
+{
+	ViewBatch::ViewBatch(RenderBackend::RenderDevice& renderDevice, const Settings& settings)
+		: m_RenderDevice(renderDevice), m_Settings(settings)
+	{
+	}
+
+	ViewBatch::~ViewBatch()
+	{
+		if (m_ReadbackBuffer)
+		{
+			// the batch may be dropped before GPU had finished it
+			m_RenderDevice.get().DeferRelease(RenderBackend::DeferReleaseLifetimeResource<RenderBackend::Buffer>(std::move(m_ReadbackBuffer)));
+		}
+	}
+
+	uint32_t ViewBatch::AddView(const glm::mat4& viewMat, const glm::mat4& projectionMat)
+	{
+		ZE_ASSERT_LOG(!m_ReadbackBuffer, "Views can NOT be added once the batch is set up!");
+
+		m_Views.push_back({ .m_ViewMat = viewMat, .m_ProjectionMat = projectionMat });
+		return static_cast<uint32_t>(m_Views.size() - 1);
+	}
+
+	void ViewBatch::AddCubeViews(const glm::vec3& position, float nearPlane)
+	{
+		struct CubeFace
+		{
+			glm::vec3		m_Direction;
+			glm::vec3		m_Up;
+		};
+
+		constexpr std::array kCubeFaces{
+			CubeFace{ .m_Direction = {  1.0f,  0.0f,  0.0f }, .m_Up = { 0.0f, -1.0f,  0.0f } },
+			CubeFace{ .m_Direction = { -1.0f,  0.0f,  0.0f }, .m_Up = { 0.0f, -1.0f,  0.0f } },
+			CubeFace{ .m_Direction = {  0.0f,  1.0f,  0.0f }, .m_Up = { 0.0f,  0.0f,  1.0f } },
+			CubeFace{ .m_Direction = {  0.0f, -1.0f,  0.0f }, .m_Up = { 0.0f,  0.0f, -1.0f } },
+			CubeFace{ .m_Direction = {  0.0f,  0.0f,  1.0f }, .m_Up = { 0.0f, -1.0f,  0.0f } },
+			CubeFace{ .m_Direction = {  0.0f,  0.0f, -1.0f }, .m_Up = { 0.0f, -1.0f,  0.0f } },
+		};
+
+		ZE_ASSERT_LOG(m_Settings.m_ViewSize.x == m_Settings.m_ViewSize.y, "Cube views must be square!");
+
+		const glm::mat4 projectionMat = glm::infinitePerspectiveRH_ZO(glm::radians(90.0f), 1.0f, nearPlane);
+		for (const auto& face : kCubeFaces)
+		{
+			AddView(glm::lookAtRH(position, position + face.m_Direction, face.m_Up), projectionMat);
+		}
+	}
+
+	uint32_t ViewBatch::GetViewSizeInByte() const
+	{
+		return m_Settings.m_ViewSize.x * m_Settings.m_ViewSize.y * RenderBackend::GetFormatSizeInByte(m_Settings.m_ColorFormat);
+	}
+
+	void ViewBatch::Setup(RenderGraph& renderGraph)
+	{
+		using namespace ZE::RenderBackend;
+
+		ZE_ASSERT_LOG(!m_Views.empty(), "View batch without any view!");
+		ZE_ASSERT_LOG(GetFormatSizeInByte(m_Settings.m_ColorFormat) != 0, "Unsupported view batch color format {}!", static_cast<int>(m_Settings.m_ColorFormat));
+
+		m_ColorHandles.clear();
+		m_DepthStencilHandles.clear();
+
+		// transient targets of all views, only the readback buffer outlives the graph
+		for (uint32_t i = 0; i < GetViewCount(); ++i)
+		{
+			TextureDesc colorDesc(std::format("view batch color {}", i));
+			colorDesc.m_Size = m_Settings.m_ViewSize;
+			colorDesc.m_Format = m_Settings.m_ColorFormat;
+			colorDesc.m_Usage = (1 << static_cast<uint8_t>(ETextureUsage::Color)) | (1 << static_cast<uint8_t>(ETextureUsage::TransferSrc));
+			m_ColorHandles.push_back(renderGraph.CreateResource(colorDesc));
+
+			TextureDesc depthStencilDesc(std::format("view batch depth {}", i));
+			depthStencilDesc.m_Size = m_Settings.m_ViewSize;
+			depthStencilDesc.m_Format = m_Settings.m_DepthStencilFormat;
+			depthStencilDesc.m_Usage = 1 << static_cast<uint8_t>(ETextureUsage::DepthStencil);
+			m_DepthStencilHandles.push_back(renderGraph.CreateResource(depthStencilDesc));
+		}
+
+		if (!m_ReadbackBuffer)
+		{
+			BufferDesc readbackDesc("view batch readback");
+			readbackDesc.m_Size = GetViewSizeInByte() * GetViewCount();
+			readbackDesc.m_Usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+			readbackDesc.m_MemoryUsage = BufferMemoryUsage::GpuToCpu;
+			readbackDesc.m_MemoryCategory = EMemoryCategory::Readback;
+			m_ReadbackBuffer = std::shared_ptr<Buffer>(Buffer::Create(m_RenderDevice, readbackDesc));
+			ZE_ASSERT(m_ReadbackBuffer);
+		}
+		m_ReadbackHandle = renderGraph.ImportResource(m_ReadbackBuffer, m_ReadbackBufferState);
+	}
+
+	GraphNode& ViewBatch::AddViewNode(RenderGraph& renderGraph, std::string nodeName) const
+	{
+		using namespace ZE::RenderBackend;
+
+		ZE_ASSERT_LOG(m_ColorHandles.size() == m_Views.size(), "View batch must be set up before adding nodes!");
+
+		auto& viewNode = renderGraph.AddNode(std::move(nodeName));
+		for (uint32_t i = 0; i < GetViewCount(); ++i)
+		{
+			viewNode.Write(m_ColorHandles[i], ERenderResourceState::ColorAttachmentWrite);
+			viewNode.Write(m_DepthStencilHandles[i], ERenderResourceState::DepthStencilAttachmentWrite);
+			viewNode.AddView(m_ColorHandles[i], m_DepthStencilHandles[i], ERenderTargetLoadOperation::Clear, m_Settings.m_ClearColor);
+		}
+		return viewNode;
+	}
+
+	void ViewBatch::AddReadbackNode(RenderGraph& renderGraph)
+	{
+		using namespace ZE::RenderBackend;
+
+		ZE_ASSERT_LOG(m_ColorHandles.size() == m_Views.size(), "View batch must be set up before adding nodes!");
+
+		auto& copyNode = renderGraph.AddNode("View Batch Readback");
+		for (const auto& colorHandle : m_ColorHandles)
+		{
+			copyNode.Read(colorHandle, ERenderResourceState::TransferRead);
+		}
+		copyNode.Write(m_ReadbackHandle, ERenderResourceState::TransferWrite);
+
+		// one transfer node for all views, so the copies share one barrier
+		copyNode.Execute([colorHandles = m_ColorHandles, readbackHandle = m_ReadbackHandle, viewSize = GetViewSizeInByte()](GraphExecutionContext& context)
+		{
+			for (uint32_t i = 0; i < colorHandles.size(); ++i)
+			{
+				context.CopyTextureToBuffer(colorHandles[i], readbackHandle, i * viewSize);
+			}
+		});
+
+		// make the copies visible to the host
+		auto& hostReadNode = renderGraph.AddNode("View Batch Host Read");
+		hostReadNode.Read(m_ReadbackHandle, ERenderResourceState::HostRead);
+		m_ReadbackBufferState = ERenderResourceState::HostRead;
+	}
+
+	void ViewBatch::Execute(RenderGraph& renderGraph, RenderBackend::PipelineStateCache& pipelineStateCache)
+	{
+		renderGraph.Execute(pipelineStateCache);
+		m_SubmittedTimelineValue = renderGraph.GetSubmittedTimelineValue();
+	}
+
+	bool ViewBatch::IsFinished() const
+	{
+		return m_SubmittedTimelineValue != 0 && m_RenderDevice.get().GetGraphicTimeline().IsCompleted(m_SubmittedTimelineValue);
+	}
+
+	void ViewBatch::Wait() const
+	{
+		ZE_ASSERT_LOG(m_SubmittedTimelineValue != 0, "Wait for a view batch which had not been executed!");
+		m_RenderDevice.get().GetGraphicTimeline().Wait(m_SubmittedTimelineValue);
+	}
+
+	RenderBackend::Buffer::MappedMemoryScope ViewBatch::MapReadback() const
+	{
+		ZE_ASSERT_LOG(IsFinished(), "Map view batch readback before GPU had finished it!");
+		return RenderBackend::Buffer::MappedMemoryScope(m_ReadbackBuffer);
+	}
+}
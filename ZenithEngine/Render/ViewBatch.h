@@ -0,0 +1,102 @@
+#pragma once
+
+#include "RenderGraph.h"
+#include "Core/ClassProperty.h"
+#include "RenderBackend/RenderPass.h"
+#include "RenderBackend/RenderResource.h"
+#include "RenderBackend/RenderResourceState.h"
+
+#include <vulkan/vulkan_core.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ZE::RenderBackend
+{
+	class RenderDevice;
+	class PipelineStateCache;
+}
+
+namespace ZE::Render
+{
+	/* Many views of the same scene rendered by one render graph, e.g. asset thumbnails or cubemap faces.
+	 * All views have color and depth targets of the same size and format, so one pipeline state serves every view,
+	 * barriers of all views are coalesced into one per node and the whole batch is a single submission.
+	 * Colors are copied tightly packed into one host visible readback buffer, view i starts at i * GetViewSizeInByte().
+	 */
+	class ViewBatch
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(ViewBatch);
+
+	public:
+
+		struct Settings
+		{
+			glm::uvec2						m_ViewSize = { 256u, 256u };
+			VkFormat						m_ColorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+			VkFormat						m_DepthStencilFormat = VK_FORMAT_D32_SFLOAT_S8_UINT;
+			glm::vec4						m_ClearColor = { 0.0f, 0.0f, 0.0f, 0.0f };
+		};
+
+		struct View
+		{
+			glm::mat4						m_ViewMat;
+			glm::mat4						m_ProjectionMat;
+		};
+
+		ViewBatch(RenderBackend::RenderDevice& renderDevice, const Settings& settings);
+		~ViewBatch();
+
+		uint32_t AddView(const glm::mat4& viewMat, const glm::mat4& projectionMat);
+		/* Six 90 degree views around the position in +X, -X, +Y, -Y, +Z, -Z cube face order. */
+		void AddCubeViews(const glm::vec3& position, float nearPlane);
+
+		/* Create the render targets of all views and import the readback buffer, views can NOT be added afterwards. */
+		void Setup(RenderGraph& renderGraph);
+
+		/* Node rendering all views, its job is called once per view, see GraphExecutionContext::GetViewIndex(). */
+		GraphNode& AddViewNode(RenderGraph& renderGraph, std::string nodeName) const;
+		/* Copy colors of all views into the readback buffer. */
+		void AddReadbackNode(RenderGraph& renderGraph);
+
+		/* Execute a graph rendering only this batch, it is submitted without any render output. */
+		void Execute(RenderGraph& renderGraph, RenderBackend::PipelineStateCache& pipelineStateCache);
+
+		bool IsFinished() const;
+		void Wait() const;
+
+		/* Readback of all views, only valid once finished. */
+		RenderBackend::Buffer::MappedMemoryScope MapReadback() const;
+
+		const Settings& GetSettings() const { return m_Settings; }
+		uint32_t GetViewCount() const { return static_cast<uint32_t>(m_Views.size()); }
+		const View& GetView(uint32_t viewIndex) const { return m_Views[viewIndex]; }
+		uint32_t GetViewSizeInByte() const;
+
+		const GraphResourceHandle& GetColorHandle(uint32_t viewIndex) const { return m_ColorHandles[viewIndex]; }
+		const GraphResourceHandle& GetDepthStencilHandle(uint32_t viewIndex) const { return m_DepthStencilHandles[viewIndex]; }
+
+	private:
+
+		std::reference_wrapper<RenderBackend::RenderDevice>		m_RenderDevice;
+		Settings												m_Settings;
+
+		std::vector<View>										m_Views;
+
+		std::vector<GraphResourceHandle>						m_ColorHandles;
+		std::vector<GraphResourceHandle>						m_DepthStencilHandles;
+		GraphResourceHandle										m_ReadbackHandle;
+
+		std::shared_ptr<RenderBackend::Buffer>					m_ReadbackBuffer;
+		RenderBackend::ERenderResourceState						m_ReadbackBufferState = RenderBackend::ERenderResourceState::Undefined;
+
+		// graphic timeline value of the batch submission, 0 if not executed yet
+		uint64_t												m_SubmittedTimelineValue = 0;
+	};
+}
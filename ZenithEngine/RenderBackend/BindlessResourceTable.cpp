@@ -0,0 +1,274 @@
+#include "BindlessResourceTable.h"
+
+#include "Core/Assertion.h"
+#include "RenderDevice.h"
+#include "RenderResource.h"
+#include "VulkanHelper.h"
+
+#include <algorithm>
+
+namespace ZE::RenderBackend
+{
+	// give the slot back to its table once GPU had finished the submissions which may reference it
+	class DeferFreeBindlessSlot : public IDeferReleaseResource
+	{
+	public:
+
+		DeferFreeBindlessSlot(BindlessResourceTable& table, EBindlessResourceType type, uint32_t index)
+			: m_Table(table), m_Type(type), m_Index(index)
+		{}
+
+		virtual void Release() override
+		{
+			m_Table.FreeSlot(m_Type, m_Index);
+			delete this;
+		}
+
+	private:
+
+		BindlessResourceTable&		m_Table;
+		EBindlessResourceType		m_Type;
+		uint32_t					m_Index;
+	};
+
+	static VkDescriptorType ToVkDescriptorType(EBindlessResourceType type)
+	{
+		switch (type)
+		{
+		case EBindlessResourceType::SampledImage: return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+		case EBindlessResourceType::StorageBuffer: return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		case EBindlessResourceType::Sampler: return VK_DESCRIPTOR_TYPE_SAMPLER;
+		default:
+			break;
+		}
+
+		ZE_ASSERT(false);
+		return VK_DESCRIPTOR_TYPE_MAX_ENUM;
+	}
+
+	uint32_t BindlessResourceTable::SlotAllocator::Allocate()
+	{
+		if (!m_FreeIndices.empty())
+		{
+			const uint32_t index = m_FreeIndices.back();
+			m_FreeIndices.pop_back();
+			return index;
+		}
+
+		if (m_NextUnused < m_Capacity)
+		{
+			return m_NextUnused++;
+		}
+
+		return kInvalidIndex;
+	}
+
+	BindlessResourceTable::BindlessResourceTable(RenderDevice& renderDevice)
+	{
+		SetRenderDevice(&renderDevice);
+
+		VulkanZeroStruct(VkPhysicalDeviceDescriptorIndexingProperties, descriptorIndexingProps);
+		descriptorIndexingProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+
+		VulkanZeroStruct(VkPhysicalDeviceProperties2, physicalDeviceProps2);
+		physicalDeviceProps2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		physicalDeviceProps2.pNext = &descriptorIndexingProps;
+		vkGetPhysicalDeviceProperties2(renderDevice.GetPhysicalDevice().m_Handle, &physicalDeviceProps2);
+
+		// every stage sees the whole table, so both the per set and the per stage limits apply
+		m_SlotAllocators[static_cast<size_t>(EBindlessResourceType::SampledImage)].m_Capacity = std::min({ kMaxSampledImageCount,
+			descriptorIndexingProps.maxDescriptorSetUpdateAfterBindSampledImages, descriptorIndexingProps.maxPerStageDescriptorUpdateAfterBindSampledImages });
+		m_SlotAllocators[static_cast<size_t>(EBindlessResourceType::StorageBuffer)].m_Capacity = std::min({ kMaxStorageBufferCount,
+			descriptorIndexingProps.maxDescriptorSetUpdateAfterBindStorageBuffers, descriptorIndexingProps.maxPerStageDescriptorUpdateAfterBindStorageBuffers });
+		m_SlotAllocators[static_cast<size_t>(EBindlessResourceType::Sampler)].m_Capacity = std::min({ kMaxSamplerCount,
+			descriptorIndexingProps.maxDescriptorSetUpdateAfterBindSamplers, descriptorIndexingProps.maxPerStageDescriptorUpdateAfterBindSamplers });
+
+		uint64_t totalCapacity = 0;
+		for (const auto& slotAllocator : m_SlotAllocators)
+		{
+			if (slotAllocator.m_Capacity == 0)
+			{
+				ZE_LOG_ERROR("Device has no update-after-bind descriptors of a bindless resource type!");
+				return;
+			}
+			totalCapacity += slotAllocator.m_Capacity;
+		}
+
+		if (totalCapacity > descriptorIndexingProps.maxPerStageUpdateAfterBindResources)
+		{
+			ZE_LOG_ERROR("Bindless resource table needs {} descriptors per stage, device supports only {} update-after-bind resources!",
+				totalCapacity, descriptorIndexingProps.maxPerStageUpdateAfterBindResources);
+			return;
+		}
+
+		std::array<VkDescriptorSetLayoutBinding, static_cast<size_t>(EBindlessResourceType::Count)> bindings = {};
+		std::array<VkDescriptorBindingFlags, static_cast<size_t>(EBindlessResourceType::Count)> bindingFlags = {};
+		std::array<VkDescriptorPoolSize, static_cast<size_t>(EBindlessResourceType::Count)> poolSizes = {};
+
+		for (uint32_t i = 0; i < bindings.size(); ++i)
+		{
+			const auto type = static_cast<EBindlessResourceType>(i);
+
+			bindings[i].binding = i;
+			bindings[i].descriptorType = ToVkDescriptorType(type);
+			bindings[i].descriptorCount = m_SlotAllocators[i].m_Capacity;
+			bindings[i].stageFlags = VK_SHADER_STAGE_ALL;
+			bindings[i].pImmutableSamplers = nullptr;
+
+			// slots can be written while the set is bound and not all of them are valid
+			bindingFlags[i] = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+
+			poolSizes[i].type = bindings[i].descriptorType;
+			poolSizes[i].descriptorCount = bindings[i].descriptorCount;
+		}
+
+		VulkanZeroStruct(VkDescriptorSetLayoutBindingFlagsCreateInfo, bindingFlagsCI);
+		bindingFlagsCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+		bindingFlagsCI.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+		bindingFlagsCI.pBindingFlags = bindingFlags.data();
+
+		VulkanZeroStruct(VkDescriptorSetLayoutCreateInfo, setLayoutCI);
+		setLayoutCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		setLayoutCI.pNext = &bindingFlagsCI;
+		setLayoutCI.bindingCount = static_cast<uint32_t>(bindings.size());
+		setLayoutCI.pBindings = bindings.data();
+		setLayoutCI.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+
+		VulkanCheckSucceed(vkCreateDescriptorSetLayout(GetRenderDevice().GetNativeDevice(), &setLayoutCI, nullptr, &m_DescriptorSetLayout));
+
+		// used to pad the pipeline layout up to the bindless set
+		VulkanZeroStruct(VkDescriptorSetLayoutCreateInfo, emptySetLayoutCI);
+		emptySetLayoutCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+
+		VulkanCheckSucceed(vkCreateDescriptorSetLayout(GetRenderDevice().GetNativeDevice(), &emptySetLayoutCI, nullptr, &m_EmptyDescriptorSetLayout));
+
+		VulkanZeroStruct(VkDescriptorPoolCreateInfo, poolCI);
+		poolCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolCI.maxSets = 1u;
+		poolCI.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+		poolCI.pPoolSizes = poolSizes.data();
+		poolCI.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+
+		VulkanCheckSucceed(vkCreateDescriptorPool(GetRenderDevice().GetNativeDevice(), &poolCI, nullptr, &m_DescriptorPool));
+
+		VulkanZeroStruct(VkDescriptorSetAllocateInfo, setAllocInfo);
+		setAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		setAllocInfo.descriptorPool = m_DescriptorPool;
+		setAllocInfo.descriptorSetCount = 1u;
+		setAllocInfo.pSetLayouts = &m_DescriptorSetLayout;
+
+		VulkanCheckSucceed(vkAllocateDescriptorSets(GetRenderDevice().GetNativeDevice(), &setAllocInfo, &m_DescriptorSet));
+	}
+
+	BindlessResourceTable::~BindlessResourceTable()
+	{
+		// descriptor set is freed along with the pool
+		vkDestroyDescriptorPool(GetRenderDevice().GetNativeDevice(), m_DescriptorPool, nullptr);
+		m_DescriptorPool = nullptr;
+		m_DescriptorSet = nullptr;
+
+		vkDestroyDescriptorSetLayout(GetRenderDevice().GetNativeDevice(), m_EmptyDescriptorSetLayout, nullptr);
+		m_EmptyDescriptorSetLayout = nullptr;
+		vkDestroyDescriptorSetLayout(GetRenderDevice().GetNativeDevice(), m_DescriptorSetLayout, nullptr);
+		m_DescriptorSetLayout = nullptr;
+	}
+
+	uint32_t BindlessResourceTable::RegisterTexture(Texture* pTexture)
+	{
+		ZE_ASSERT(pTexture);
+
+		const uint32_t index = AllocateSlot(EBindlessResourceType::SampledImage);
+		if (index == kInvalidIndex)
+		{
+			return kInvalidIndex;
+		}
+
+		VkDescriptorImageInfo imageInfo = {};
+		imageInfo.imageView = pTexture->GetOrCreateView();
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageInfo.sampler = nullptr;
+
+		WriteDescriptor(EBindlessResourceType::SampledImage, index, &imageInfo, nullptr);
+		return index;
+	}
+
+	uint32_t BindlessResourceTable::RegisterBuffer(Buffer* pBuffer)
+	{
+		ZE_ASSERT(pBuffer);
+
+		const uint32_t index = AllocateSlot(EBindlessResourceType::StorageBuffer);
+		if (index == kInvalidIndex)
+		{
+			return kInvalidIndex;
+		}
+
+		VkDescriptorBufferInfo bufferInfo = {};
+		bufferInfo.buffer = pBuffer->GetNativeHandle();
+		bufferInfo.offset = 0;
+		bufferInfo.range = VK_WHOLE_SIZE;
+
+		WriteDescriptor(EBindlessResourceType::StorageBuffer, index, nullptr, &bufferInfo);
+		return index;
+	}
+
+	uint32_t BindlessResourceTable::RegisterSampler(VkSampler sampler)
+	{
+		ZE_ASSERT(sampler);
+
+		const uint32_t index = AllocateSlot(EBindlessResourceType::Sampler);
+		if (index == kInvalidIndex)
+		{
+			return kInvalidIndex;
+		}
+
+		VkDescriptorImageInfo samplerInfo = {};
+		samplerInfo.sampler = sampler;
+
+		WriteDescriptor(EBindlessResourceType::Sampler, index, &samplerInfo, nullptr);
+		return index;
+	}
+
+	void BindlessResourceTable::Unregister(EBindlessResourceType type, uint32_t index)
+	{
+		if (index == kInvalidIndex)
+		{
+			return;
+		}
+
+		// submissions of any frame, or outside of frames, may still reference the slot
+		GetRenderDevice().DeferRelease(new DeferFreeBindlessSlot(*this, type, index));
+	}
+
+	uint32_t BindlessResourceTable::AllocateSlot(EBindlessResourceType type)
+	{
+		std::scoped_lock lock(m_Mutex);
+
+		const uint32_t index = m_SlotAllocators[static_cast<size_t>(type)].Allocate();
+		if (index == kInvalidIndex)
+		{
+			ZE_LOG_ERROR("Bindless resource table is full! (type: {}, capacity: {})", static_cast<uint32_t>(type), m_SlotAllocators[static_cast<size_t>(type)].m_Capacity);
+		}
+		return index;
+	}
+
+	void BindlessResourceTable::FreeSlot(EBindlessResourceType type, uint32_t index)
+	{
+		std::scoped_lock lock(m_Mutex);
+		m_SlotAllocators[static_cast<size_t>(type)].m_FreeIndices.push_back(index);
+	}
+
+	void BindlessResourceTable::WriteDescriptor(EBindlessResourceType type, uint32_t index, const VkDescriptorImageInfo* pImageInfo, const VkDescriptorBufferInfo* pBufferInfo) const
+	{
+		VulkanZeroStruct(VkWriteDescriptorSet, writeDescriptorSet);
+		writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSet.dstSet = m_DescriptorSet;
+		writeDescriptorSet.dstBinding = static_cast<uint32_t>(type);
+		writeDescriptorSet.dstArrayElement = index;
+		writeDescriptorSet.descriptorCount = 1u;
+		writeDescriptorSet.descriptorType = ToVkDescriptorType(type);
+		writeDescriptorSet.pImageInfo = pImageInfo;
+		writeDescriptorSet.pBufferInfo = pBufferInfo;
+
+		vkUpdateDescriptorSets(GetRenderDevice().GetNativeDevice(), 1u, &writeDescriptorSet, 0u, nullptr);
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "RenderDeviceChild.h"
+#include "Core/ClassProperty.h"
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <vector>
+#include <mutex>
+#include <limits>
+
+namespace ZE::RenderBackend
+{
+	class RenderDevice;
+	class Buffer;
+	class Texture;
+
+	enum class EBindlessResourceType : uint8_t
+	{
+		SampledImage = 0,
+		StorageBuffer,
+		Sampler,
+		Count
+	};
+
+	/* Global descriptor arrays shared by every pipeline when bindless mode is on.
+	 * Resources get a stable slot index at creation, shaders index into the arrays directly.
+	 * The array sizes are clamped to the update-after-bind limits of the device, IsValid() is false if they can not fit.
+	 */
+	class BindlessResourceTable : public RenderDeviceChild
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(BindlessResourceTable);
+
+	public:
+
+		static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+		// Reserved set index in every pipeline layout, lower sets are left to the shader layout.
+		static constexpr uint32_t kBindlessSetIndex = 3u;
+
+		// upper bounds, devices with lower update-after-bind limits get smaller arrays
+		static constexpr uint32_t kMaxSampledImageCount = 16384u;
+		static constexpr uint32_t kMaxStorageBufferCount = 16384u;
+		static constexpr uint32_t kMaxSamplerCount = 256u;
+
+		BindlessResourceTable(RenderDevice& renderDevice);
+		~BindlessResourceTable();
+
+		bool IsValid() const { return m_DescriptorSet != nullptr; }
+		uint32_t GetCapacity(EBindlessResourceType type) const { return m_SlotAllocators[static_cast<size_t>(type)].m_Capacity; }
+
+		uint32_t RegisterTexture(Texture* pTexture);
+		uint32_t RegisterBuffer(Buffer* pBuffer);
+		uint32_t RegisterSampler(VkSampler sampler);
+
+		/* The slot is deferred released, tagged with the graphic timeline value of the next submission.
+		 * It is recycled once GPU had reached that value, whichever frame or extra submission used it before.
+		 */
+		void Unregister(EBindlessResourceType type, uint32_t index);
+
+		VkDescriptorSet GetDescriptorSet() const { return m_DescriptorSet; }
+		VkDescriptorSetLayout GetDescriptorSetLayout() const { return m_DescriptorSetLayout; }
+		VkDescriptorSetLayout GetEmptyDescriptorSetLayout() const { return m_EmptyDescriptorSetLayout; }
+
+	private:
+
+		friend class DeferFreeBindlessSlot;
+
+		struct SlotAllocator
+		{
+			uint32_t					m_Capacity = 0;
+			uint32_t					m_NextUnused = 0;
+			std::vector<uint32_t>		m_FreeIndices;
+
+			uint32_t Allocate();
+		};
+
+		uint32_t AllocateSlot(EBindlessResourceType type);
+		void FreeSlot(EBindlessResourceType type, uint32_t index);
+		void WriteDescriptor(EBindlessResourceType type, uint32_t index, const VkDescriptorImageInfo* pImageInfo, const VkDescriptorBufferInfo* pBufferInfo) const;
+
+	private:
+
+		VkDescriptorSetLayout												m_DescriptorSetLayout = nullptr;
+		VkDescriptorSetLayout												m_EmptyDescriptorSetLayout = nullptr;
+		VkDescriptorPool													m_DescriptorPool = nullptr;
+		VkDescriptorSet														m_DescriptorSet = nullptr;
+
+		std::mutex															m_Mutex;
+		std::array<SlotAllocator, static_cast<size_t>(EBindlessResourceType::Count)>			m_SlotAllocators;
+	};
+}
@@ -0,0 +1,164 @@
+#include "BufferHeap.h"
+
+#include "Core/Assertion.h"
+#include "RenderDevice.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace ZE::RenderBackend
+{
+	// give the range back to its heap once GPU had finished using it
+	class DeferFreeBufferRange : public IDeferReleaseResource
+	{
+	public:
+
+		DeferFreeBufferRange(BufferHeap& heap, const BufferRange& range)
+			: m_Heap(heap), m_Range(range)
+		{}
+
+		virtual void Release() override
+		{
+			m_Heap.Free(m_Range);
+			delete this;
+		}
+
+	private:
+
+		BufferHeap&					m_Heap;
+		BufferRange					m_Range;
+	};
+
+	BufferHeap::BufferHeap(RenderDevice& renderDevice, const BufferDesc& pageDesc)
+		: m_PageDesc(pageDesc)
+	{
+		SetRenderDevice(&renderDevice);
+
+		if (m_PageDesc.m_Size == 0)
+		{
+			m_PageDesc.m_Size = kDefaultPageSizeInByte;
+		}
+
+		// every range must be able to be bound with any usage of the pages
+		const auto& limits = renderDevice.GetPhysicalDevice().m_Props.limits;
+		VkDeviceSize granularity = 16u;
+		if ((m_PageDesc.m_Usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) != 0)
+		{
+			granularity = std::max(granularity, limits.minUniformBufferOffsetAlignment);
+		}
+		if ((m_PageDesc.m_Usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) != 0)
+		{
+			granularity = std::max(granularity, limits.minStorageBufferOffsetAlignment);
+		}
+		m_Granularity = static_cast<uint32_t>(std::bit_ceil(granularity));
+	}
+
+	BufferHeap::~BufferHeap()
+	{
+		std::scoped_lock lock(m_Mutex);
+		for (const auto& pPage : m_Pages)
+		{
+			ZE_ASSERT_LOG(pPage->m_Allocator.IsEmpty(), "Buffer heap {} is destroyed with {} ranges still allocated!", m_PageDesc.m_DebugName, pPage->m_Allocator.GetAllocationCount());
+		}
+		m_Pages.clear();
+	}
+
+	BufferRange BufferHeap::Allocate(uint32_t sizeInByte, uint32_t alignment)
+	{
+		ZE_ASSERT(sizeInByte != 0);
+
+		std::scoped_lock lock(m_Mutex);
+
+		BufferRange range;
+		for (uint32_t i = 0; i < m_Pages.size(); ++i)
+		{
+			if (auto allocation = m_Pages[i]->m_Allocator.Allocate(sizeInByte, alignment); allocation.IsValid())
+			{
+				range.m_PageIndex = i;
+				range.m_Allocation = allocation;
+				break;
+			}
+		}
+
+		if (!range.m_Allocation.IsValid())
+		{
+			// oversized ranges get a page of their own, large enough for the bin the search rounds the size up to
+			const uint64_t requiredPageSize = Core::TLSFAllocator::GetRequiredCapacity(sizeInByte, alignment, m_Granularity);
+			if (requiredPageSize > std::numeric_limits<uint32_t>::max())
+			{
+				ZE_LOG_ERROR("Buffer heap {} can NOT allocate {} bytes, it exceeds the max page size!", m_PageDesc.m_DebugName, sizeInByte);
+				return {};
+			}
+
+			auto& page = CreatePage(std::max(m_PageDesc.m_Size, static_cast<uint32_t>(requiredPageSize)));
+
+			range.m_PageIndex = static_cast<uint32_t>(m_Pages.size() - 1);
+			range.m_Allocation = page.m_Allocator.Allocate(sizeInByte, alignment);
+			if (!range.m_Allocation.IsValid())
+			{
+				ZE_ASSERT_LOG(false, "Buffer heap {} failed to allocate {} bytes from a dedicated page!", m_PageDesc.m_DebugName, sizeInByte);
+				m_Pages.pop_back();
+				return {};
+			}
+		}
+
+		range.m_pBuffer = m_Pages[range.m_PageIndex]->m_Buffer.get();
+		range.m_Offset = range.m_Allocation.m_Offset;
+		range.m_Size = sizeInByte;
+		return range;
+	}
+
+	void BufferHeap::Free(const BufferRange& range)
+	{
+		if (!range.IsValid())
+		{
+			return;
+		}
+
+		std::scoped_lock lock(m_Mutex);
+		ZE_ASSERT(range.m_PageIndex < m_Pages.size() && m_Pages[range.m_PageIndex]->m_Buffer.get() == range.m_pBuffer);
+		m_Pages[range.m_PageIndex]->m_Allocator.Free(range.m_Allocation);
+	}
+
+	void BufferHeap::DeferFree(const BufferRange& range)
+	{
+		if (!range.IsValid())
+		{
+			return;
+		}
+
+		GetRenderDevice().DeferRelease(new DeferFreeBufferRange(*this, range));
+	}
+
+	uint32_t BufferHeap::GetPageCount() const
+	{
+		std::scoped_lock lock(m_Mutex);
+		return static_cast<uint32_t>(m_Pages.size());
+	}
+
+	uint32_t BufferHeap::GetAllocationCount() const
+	{
+		std::scoped_lock lock(m_Mutex);
+
+		uint32_t count = 0;
+		for (const auto& pPage : m_Pages)
+		{
+			count += pPage->m_Allocator.GetAllocationCount();
+		}
+		return count;
+	}
+
+	BufferHeap::Page& BufferHeap::CreatePage(uint32_t sizeInByte)
+	{
+		BufferDesc pageDesc = m_PageDesc;
+		pageDesc.m_Size = sizeInByte;
+
+		auto pBuffer = std::shared_ptr<Buffer>(Buffer::Create(GetRenderDevice(), pageDesc));
+		ZE_ASSERT(pBuffer);
+
+		auto& pPage = m_Pages.emplace_back(std::make_unique<Page>(std::move(pBuffer), Core::TLSFAllocator(sizeInByte, m_Granularity)));
+		ZE_LOG_INFO("Buffer heap {} grows to {} pages ({} bytes per page)", m_PageDesc.m_DebugName, m_Pages.size(), sizeInByte);
+		return *pPage;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "RenderDeviceChild.h"
+#include "RenderResource.h"
+#include "Core/ClassProperty.h"
+#include "Core/TLSFAllocator.h"
+
+#include <vulkan/vulkan_core.h>
+
+#include <memory>
+#include <vector>
+#include <mutex>
+
+namespace ZE::RenderBackend
+{
+	class RenderDevice;
+
+	/* View of a range suballocated from a BufferHeap. */
+	struct BufferRange
+	{
+		Buffer*						m_pBuffer = nullptr;
+		uint32_t					m_Offset = 0;
+		uint32_t					m_Size = 0;
+
+		bool IsValid() const { return m_pBuffer != nullptr; }
+		VkBuffer GetNativeHandle() const { return m_pBuffer ? m_pBuffer->GetNativeHandle() : nullptr; }
+
+	private:
+
+		friend class BufferHeap;
+
+		uint32_t					m_PageIndex = 0;
+		Core::TLSFAllocation		m_Allocation;
+	};
+
+	/* Suballocate small buffers out of large VkBuffers, so they do NOT pay for their own buffer and VMA allocation.
+	 * All ranges of a heap share the usage and memory usage of its pages. Thread-safe.
+	 */
+	class BufferHeap : public RenderDeviceChild
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(BufferHeap);
+
+	public:
+
+		static constexpr uint32_t kDefaultPageSizeInByte = 32u * 1024u * 1024u;
+
+		/* pageDesc describes the usage of every page, m_Size is the page size. */
+		BufferHeap(RenderDevice& renderDevice, const BufferDesc& pageDesc);
+		~BufferHeap();
+
+		/* Alignment must be power of two, offset alignment required by the usage is always respected. */
+		BufferRange Allocate(uint32_t sizeInByte, uint32_t alignment = 0u);
+		/* Range is freed immediately, GPU must NOT be using it. */
+		void Free(const BufferRange& range);
+		/* Range is freed once GPU had finished the next frame submission. */
+		void DeferFree(const BufferRange& range);
+
+		uint32_t GetPageCount() const;
+		uint32_t GetAllocationCount() const;
+
+	private:
+
+		struct Page
+		{
+			std::shared_ptr<Buffer>				m_Buffer;
+			Core::TLSFAllocator					m_Allocator;
+		};
+
+		Page& CreatePage(uint32_t sizeInByte);
+
+	private:
+
+		BufferDesc										m_PageDesc;
+		uint32_t										m_Granularity = 0;
+
+		mutable std::mutex								m_Mutex;
+		std::vector<std::unique_ptr<Page>>				m_Pages;
+	};
+}
@@ -0,0 +1,157 @@
+#include "CommandListPool.h"
+
+#include "Core/Assertion.h"
+#include "RenderDevice.h"
+#include "RenderCommandList.h"
+#include "VulkanHelper.h"
+
+#include <ranges>
+
+namespace ZE::RenderBackend
+{
+	CommandListPool::CommandListPool(RenderDevice& renderDevice, uint32_t queueFamilyIndex)
+		: m_QueueFamilyIndex(queueFamilyIndex)
+	{
+		SetRenderDevice(&renderDevice);
+	}
+
+	CommandListPool::~CommandListPool()
+	{
+		std::scoped_lock lock(m_ThreadPoolMapMutex);
+
+		for (auto& pThreadPools : m_ThreadPoolMap | std::views::values)
+		{
+			for (auto& framePool : pThreadPools->m_FramePools)
+			{
+				ZE_ASSERT_LOG(framePool.m_OutstandingCount == 0, "Command list is still in use when its pool is being destroyed!");
+
+				// command buffers are freed along with the pool
+				framePool.m_CommandLists.clear();
+				vkDestroyCommandPool(GetRenderDevice().GetNativeDevice(), framePool.m_CommandPool, nullptr);
+				framePool.m_CommandPool = nullptr;
+			}
+		}
+		m_ThreadPoolMap.clear();
+	}
+
+	RenderCommandList* CommandListPool::Acquire(uint32_t frameIndex)
+	{
+		auto& threadPools = GetOrCreateThreadPools();
+
+		std::scoped_lock lock(threadPools.m_Mutex);
+		ZE_ASSERT(frameIndex < threadPools.m_FramePools.size());
+		auto& framePool = threadPools.m_FramePools[frameIndex];
+
+		if (!framePool.m_CommandPool)
+		{
+			VulkanZeroStruct(VkCommandPoolCreateInfo, commandPoolCI);
+			commandPoolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			commandPoolCI.queueFamilyIndex = m_QueueFamilyIndex;
+			// command buffers are only reset with the whole pool
+			commandPoolCI.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+			VulkanCheckSucceed(vkCreateCommandPool(GetRenderDevice().GetNativeDevice(), &commandPoolCI, nullptr, &framePool.m_CommandPool));
+			++m_CreatedCommandPoolCount;
+		}
+
+		RenderCommandList* pCmdList = nullptr;
+		if (framePool.m_NextFreeIndex < framePool.m_CommandLists.size())
+		{
+			pCmdList = framePool.m_CommandLists[framePool.m_NextFreeIndex].get();
+			++m_RecycledCommandListCount;
+		}
+		else
+		{
+			VulkanZeroStruct(VkCommandBufferAllocateInfo, allocateInfo);
+			allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocateInfo.commandBufferCount = 1;
+			allocateInfo.commandPool = framePool.m_CommandPool;
+			allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+
+			VkCommandBuffer commandBuffer = nullptr;
+			VulkanCheckSucceed(vkAllocateCommandBuffers(GetRenderDevice().GetNativeDevice(), &allocateInfo, &commandBuffer));
+			++m_AllocatedCommandBufferCount;
+
+			auto& pNewCmdList = framePool.m_CommandLists.emplace_back(std::make_unique<RenderCommandList>(GetRenderDevice(), commandBuffer, m_QueueFamilyIndex));
+			pNewCmdList->m_OwnerThreadPools = &threadPools;
+			pNewCmdList->m_OwnerFrameIndex = frameIndex;
+			pCmdList = pNewCmdList.get();
+		}
+
+		++framePool.m_NextFreeIndex;
+		++framePool.m_OutstandingCount;
+
+		ZE_ASSERT(!pCmdList->m_IsCommandRecording);
+		return pCmdList;
+	}
+
+	void CommandListPool::Release(RenderCommandList* pCmdList)
+	{
+		if (!pCmdList)
+		{
+			return;
+		}
+
+		ZE_ASSERT(pCmdList->m_OwnerThreadPools);
+		auto& threadPools = *pCmdList->m_OwnerThreadPools;
+
+		std::scoped_lock lock(threadPools.m_Mutex);
+		auto& framePool = threadPools.m_FramePools[pCmdList->m_OwnerFrameIndex];
+
+		ZE_ASSERT(framePool.m_OutstandingCount > 0);
+		--framePool.m_OutstandingCount;
+	}
+
+	void CommandListPool::ResetFrame(uint32_t frameIndex)
+	{
+		std::scoped_lock mapLock(m_ThreadPoolMapMutex);
+
+		for (auto& pThreadPools : m_ThreadPoolMap | std::views::values)
+		{
+			std::scoped_lock lock(pThreadPools->m_Mutex);
+			auto& framePool = pThreadPools->m_FramePools[frameIndex];
+
+			if (!framePool.m_CommandPool || framePool.m_NextFreeIndex == 0)
+			{
+				continue;
+			}
+
+			// some command lists are still recording on other threads, try it again next time
+			if (framePool.m_OutstandingCount != 0)
+			{
+				continue;
+			}
+
+			VulkanCheckSucceed(vkResetCommandPool(GetRenderDevice().GetNativeDevice(), framePool.m_CommandPool, 0));
+			for (auto& pCmdList : framePool.m_CommandLists)
+			{
+				pCmdList->m_IsCommandRecording = false;
+			}
+			framePool.m_NextFreeIndex = 0;
+			++m_CommandPoolResetCount;
+		}
+	}
+
+	CommandListPoolStatistics CommandListPool::GetStatistics() const
+	{
+		CommandListPoolStatistics statistics;
+		statistics.m_CreatedCommandPoolCount = m_CreatedCommandPoolCount.load(std::memory_order_relaxed);
+		statistics.m_AllocatedCommandBufferCount = m_AllocatedCommandBufferCount.load(std::memory_order_relaxed);
+		statistics.m_RecycledCommandListCount = m_RecycledCommandListCount.load(std::memory_order_relaxed);
+		statistics.m_CommandPoolResetCount = m_CommandPoolResetCount.load(std::memory_order_relaxed);
+		return statistics;
+	}
+
+	CommandListPool::ThreadPools& CommandListPool::GetOrCreateThreadPools()
+	{
+		std::scoped_lock lock(m_ThreadPoolMapMutex);
+
+		auto& pThreadPools = m_ThreadPoolMap[std::this_thread::get_id()];
+		if (!pThreadPools)
+		{
+			pThreadPools = std::make_unique<ThreadPools>();
+			pThreadPools->m_FramePools.resize(RenderDevice::kSwapBufferCount);
+		}
+		return *pThreadPools;
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "RenderDeviceChild.h"
+#include "Core/ClassProperty.h"
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+
+namespace ZE::RenderBackend
+{
+	class RenderDevice;
+	class RenderCommandList;
+
+	struct CommandListPoolStatistics
+	{
+		uint32_t					m_CreatedCommandPoolCount = 0;
+		uint32_t					m_AllocatedCommandBufferCount = 0;
+		uint32_t					m_RecycledCommandListCount = 0;
+		uint32_t					m_CommandPoolResetCount = 0;
+	};
+
+	/* Per-thread, per-frame ring of command pools.
+	 * Command lists acquired in a frame are recycled in bulk by resetting the whole pool once the frame is retired.
+	 */
+	class CommandListPool : public RenderDeviceChild
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(CommandListPool);
+
+		friend class RenderCommandList;
+
+	public:
+
+		CommandListPool(RenderDevice& renderDevice, uint32_t queueFamilyIndex);
+		~CommandListPool();
+
+		/* Acquire a command list from the calling thread's pool of the frame.
+		 * It must be given back by Release() before the pool can be reset.
+		 */
+		RenderCommandList* Acquire(uint32_t frameIndex);
+		void Release(RenderCommandList* pCmdList);
+
+		/* Reset all thread pools of the frame. Must be called after GPU finished the frame. */
+		void ResetFrame(uint32_t frameIndex);
+
+		CommandListPoolStatistics GetStatistics() const;
+
+	private:
+
+		struct FramePool
+		{
+			VkCommandPool											m_CommandPool = nullptr;
+			std::vector<std::unique_ptr<RenderCommandList>>			m_CommandLists;
+			// command lists before it had been handed out since last reset
+			uint32_t												m_NextFreeIndex = 0;
+			uint32_t												m_OutstandingCount = 0;
+		};
+
+		struct ThreadPools
+		{
+			std::mutex												m_Mutex;
+			std::vector<FramePool>									m_FramePools;
+		};
+
+		ThreadPools& GetOrCreateThreadPools();
+
+	private:
+
+		uint32_t																m_QueueFamilyIndex = 0;
+
+		mutable std::mutex														m_ThreadPoolMapMutex;
+		std::unordered_map<std::thread::id, std::unique_ptr<ThreadPools>>		m_ThreadPoolMap;
+
+		std::atomic<uint32_t>													m_CreatedCommandPoolCount = 0;
+		std::atomic<uint32_t>													m_AllocatedCommandBufferCount = 0;
+		std::atomic<uint32_t>													m_RecycledCommandListCount = 0;
+		std::atomic<uint32_t>													m_CommandPoolResetCount = 0;
+	};
+}
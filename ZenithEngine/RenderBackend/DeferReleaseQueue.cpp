@@ -1,26 +1,125 @@
 ﻿#include "DeferReleaseQueue.h"
 
+#include <algorithm>
+#include <type_traits>
+
 namespace ZE::RenderBackend
 {
+	DeferReleaseQueue::~DeferReleaseQueue()
+	{
+		DrainIncoming();
+		ZE_ASSERT_LOG(m_PendingBatch.IsEmpty() && m_SealedBatches.empty(), "Defer release queue is destroyed before releasing all its resources!");
+	}
+
 	void DeferReleaseQueue::DeferRelease(IDeferReleaseResource* pDeferReleaseResource)
 	{
 		if (pDeferReleaseResource)
 		{
-			m_ToBeReleaseResources.push_back(pDeferReleaseResource);
+			Enqueue(ResourceVariant(std::in_place_type<IDeferReleaseResource*>, pDeferReleaseResource));
 		}
 	}
 	
 	void DeferReleaseQueue::DeferRelease(const DeferReleaseLifetimeResource<Buffer>& deferReleaseResource)
 	{
-		m_ToBeReleaseBuffers.push_back(deferReleaseResource);
+		Enqueue(ResourceVariant(std::in_place_type<DeferReleaseLifetimeResource<Buffer>>, deferReleaseResource));
 	}
 	
 	void DeferReleaseQueue::DeferRelease(const DeferReleaseLifetimeResource<Texture>& deferReleaseResource)
 	{
-		m_ToBeReleaseTextures.push_back(deferReleaseResource);
+		Enqueue(ResourceVariant(std::in_place_type<DeferReleaseLifetimeResource<Texture>>, deferReleaseResource));
+	}
+
+	void DeferReleaseQueue::Enqueue(ResourceVariant&& resource)
+	{
+		auto* pNode = new IncomingNode{ nullptr, std::move(resource) };
+
+		IncomingNode* pHead = m_IncomingHead.load(std::memory_order_relaxed);
+		do
+		{
+			pNode->m_pNext = pHead;
+		} while (!m_IncomingHead.compare_exchange_weak(pHead, pNode, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	void DeferReleaseQueue::DrainIncoming()
+	{
+		IncomingNode* pNode = m_IncomingHead.exchange(nullptr, std::memory_order_acquire);
+
+		// nodes are pushed in LIFO order, reverse them to release in the order they were deferred
+		IncomingNode* pReversed = nullptr;
+		while (pNode)
+		{
+			IncomingNode* pNext = pNode->m_pNext;
+			pNode->m_pNext = pReversed;
+			pReversed = pNode;
+			pNode = pNext;
+		}
+
+		while (pReversed)
+		{
+			std::visit([this](auto&& resource)
+			{
+				using ResourceType = std::decay_t<decltype(resource)>;
+				if constexpr (std::is_same_v<ResourceType, IDeferReleaseResource*>)
+				{
+					m_PendingBatch.m_ToBeReleaseResources.push_back(resource);
+				}
+				else if constexpr (std::is_same_v<ResourceType, DeferReleaseLifetimeResource<Buffer>>)
+				{
+					m_PendingBatch.m_ToBeReleaseBuffers.emplace_back(std::move(resource));
+				}
+				else
+				{
+					m_PendingBatch.m_ToBeReleaseTextures.emplace_back(std::move(resource));
+				}
+			}, pReversed->m_Resource);
+
+			IncomingNode* pNext = pReversed->m_pNext;
+			delete pReversed;
+			pReversed = pNext;
+		}
+	}
+
+	void DeferReleaseQueue::Seal(uint64_t timelineValue, uint64_t transferTimelineValue)
+	{
+		DrainIncoming();
+
+		if (m_PendingBatch.IsEmpty())
+		{
+			return;
+		}
+
+		ZE_ASSERT(m_SealedBatches.empty() || m_SealedBatches.back().m_TimelineValue <= timelineValue);
+
+		m_PendingBatch.m_TimelineValue = timelineValue;
+		// concurrent submissions may read the transfer value out of order, a later value is only more conservative
+		m_PendingBatch.m_TransferTimelineValue = m_SealedBatches.empty() ? transferTimelineValue : std::max(transferTimelineValue, m_SealedBatches.back().m_TransferTimelineValue);
+		m_SealedBatches.emplace_back(std::move(m_PendingBatch));
+		m_PendingBatch = {};
+	}
+
+	void DeferReleaseQueue::ReleaseCompleted(uint64_t completedTimelineValue, uint64_t completedTransferTimelineValue)
+	{
+		while (!m_SealedBatches.empty() && m_SealedBatches.front().m_TimelineValue <= completedTimelineValue && m_SealedBatches.front().m_TransferTimelineValue <= completedTransferTimelineValue)
+		{
+			m_SealedBatches.front().Release();
+			m_SealedBatches.pop_front();
+		}
 	}
 
 	void DeferReleaseQueue::ReleaseAllImmediately()
+	{
+		DrainIncoming();
+
+		for (auto& batch : m_SealedBatches)
+		{
+			batch.Release();
+		}
+		m_SealedBatches.clear();
+
+		m_PendingBatch.Release();
+	}
+
+	void DeferReleaseQueue::Batch::Release()
 	{
 		for (auto& pResource : m_ToBeReleaseResources)
 		{
@@ -1,11 +1,13 @@
 ﻿#pragma once
 
 #include "Core/Assertion.h"
+#include "Core/ClassProperty.h"
 
 #include <vector>
 #include <memory>
-
-#include "Render/Render.h"
+#include <deque>
+#include <atomic>
+#include <variant>
 
 namespace ZE::RenderBackend
 {
@@ -44,21 +46,70 @@ namespace ZE::RenderBackend
 		std::shared_ptr<T>::reset();
 	}
 
+	/* Resources are tagged with the timeline value of the submission which may still use them,
+	 * and released once the GPU timeline reaches that value.
+	 * A resource may also be the destination of an upload on the transfer queue, whose timeline is NOT ordered with the graphic one.
+	 * So each batch is tagged with a pair: the graphic value of the next graphic submission, and the latest transfer value requested so far.
+	 * The batch is released once both timelines had reached their value.
+	 * DeferRelease() can be called from any thread without locking, the others must be called on the render thread only.
+	 */
 	class DeferReleaseQueue
 	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(DeferReleaseQueue);
+
 	public:
 
+		DeferReleaseQueue() = default;
+		~DeferReleaseQueue();
+
 		void DeferRelease(IDeferReleaseResource* pDeferReleaseResource);
 
 		void DeferRelease(const DeferReleaseLifetimeResource<Buffer>& deferReleaseResource);
 		void DeferRelease(const DeferReleaseLifetimeResource<Texture>& deferReleaseResource);
 
+		/* Tag all resources deferred since last call with the graphic timeline value of the submission which may use them,
+		 * and the transfer timeline value of the latest upload which may write them.
+		 */
+		void Seal(uint64_t timelineValue, uint64_t transferTimelineValue);
+		/* Release resources whose timeline values had been reached by GPU. */
+		void ReleaseCompleted(uint64_t completedTimelineValue, uint64_t completedTransferTimelineValue);
+
 		void ReleaseAllImmediately();
 			
 	private:
 
-		std::vector<IDeferReleaseResource*>						m_ToBeReleaseResources;
-		std::vector<DeferReleaseLifetimeResource<Buffer>>		m_ToBeReleaseBuffers;
-		std::vector<DeferReleaseLifetimeResource<Texture>>		m_ToBeReleaseTextures;
+		using ResourceVariant = std::variant<IDeferReleaseResource*, DeferReleaseLifetimeResource<Buffer>, DeferReleaseLifetimeResource<Texture>>;
+
+		// intrusive node of the multi-producer single-consumer list
+		struct IncomingNode
+		{
+			IncomingNode*											m_pNext = nullptr;
+			ResourceVariant											m_Resource;
+		};
+
+		void Enqueue(ResourceVariant&& resource);
+		// move all incoming resources into the pending batch in enqueue order
+		void DrainIncoming();
+
+		struct Batch
+		{
+			uint64_t												m_TimelineValue = 0;
+			uint64_t												m_TransferTimelineValue = 0;
+
+			std::vector<IDeferReleaseResource*>						m_ToBeReleaseResources;
+			std::vector<DeferReleaseLifetimeResource<Buffer>>		m_ToBeReleaseBuffers;
+			std::vector<DeferReleaseLifetimeResource<Texture>>		m_ToBeReleaseTextures;
+
+			bool IsEmpty() const { return m_ToBeReleaseResources.empty() && m_ToBeReleaseBuffers.empty() && m_ToBeReleaseTextures.empty(); }
+			void Release();
+		};
+
+		// lock-free stack pushed by any thread, taken as a whole by the render thread
+		std::atomic<IncomingNode*>								m_IncomingHead = nullptr;
+
+		// resources deferred after the last sealed submission
+		Batch													m_PendingBatch;
+		// sorted by both timeline values
+		std::deque<Batch>										m_SealedBatches;
 	};
 }
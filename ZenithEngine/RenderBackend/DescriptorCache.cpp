@@ -1,8 +1,8 @@
 #include "DescriptorCache.h"
 
+#include "Core/Assertion.h"
 #include "PipelineState.h"
 #include "RenderDevice.h"
-#include "VulkanHelper.h"
 
 #include <ranges>
 
@@ -13,53 +13,41 @@ namespace ZE::RenderBackend
 		SetRenderDevice(&renderDevice);
 	}
 	
-	std::vector<VkDescriptorSet>& DescriptorCache::FindOrAdd(PipelineState* pPipelineState)
+	VkDescriptorSet DescriptorCache::Allocate(PipelineState* pPipelineState, uint32_t setIndex)
 	{
-		if (!pPipelineState)
-		{
-			static std::vector<VkDescriptorSet> dummy{};
-			return dummy;
-		}
-		
-		auto iter = m_PipelineDescriptorCache.find(pPipelineState);
-		if (iter == m_PipelineDescriptorCache.end())
-		{
-			auto sets = std::vector<VkDescriptorSet>{};
-			
-			sets.resize(pPipelineState->m_DescriptorSetLayouts.size());
+		ZE_ASSERT(pPipelineState && setIndex < pPipelineState->GetDescriptorSetCount());
+
+		auto& setLists = m_PipelineDescriptorCache[pPipelineState];
+		setLists.resize(pPipelineState->GetDescriptorSetCount());
 
-			for (uint32_t setIndex = 0; setIndex < sets.size(); ++setIndex)
+		auto& setList = setLists[setIndex];
+		if (setList.m_UsedCount == setList.m_Sets.size())
+		{
+			const VkDescriptorSet set = pPipelineState->AllocateDescriptorSet(setIndex);
+			if (!set)
 			{
-				VulkanZeroStruct(VkDescriptorSetAllocateInfo, descriptorAllocInfo);
-				descriptorAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-				descriptorAllocInfo.descriptorSetCount = 1u;
-				descriptorAllocInfo.descriptorPool = pPipelineState->m_DescriptorPool;
-				descriptorAllocInfo.pSetLayouts = &pPipelineState->m_DescriptorSetLayouts[setIndex];
-				
-				VulkanCheckSucceed(vkAllocateDescriptorSets(GetRenderDevice().GetNativeDevice(), &descriptorAllocInfo, &sets[setIndex]));
+				return nullptr;
 			}
-
-			auto insertIter = m_PipelineDescriptorCache.emplace(pPipelineState, std::move(sets));
-			return insertIter.first->second;
+			setList.m_Sets.push_back(set);
 		}
 
-		return iter->second;
+		return setList.m_Sets[setList.m_UsedCount++];
 	}
-	
-	void DescriptorCache::MarkDirty(PipelineState* pPipelineState)
+
+	void DescriptorCache::Reset()
 	{
-		if (const auto iter = m_PipelineDescriptorCache.find(pPipelineState); iter != m_PipelineDescriptorCache.end())
+		for (auto& setLists : m_PipelineDescriptorCache | std::views::values)
 		{
-			m_PipelineDescriptorCache.erase(iter);
+			for (auto& setList : setLists)
+			{
+				setList.m_UsedCount = 0;
+			}
 		}
 	}
-
-	void DescriptorCache::FreeAll()
+	
+	void DescriptorCache::MarkDirty(PipelineState* pPipelineState)
 	{
-		for (auto& [pPSO, set] : m_PipelineDescriptorCache)
-		{
-			VulkanCheckSucceed(vkFreeDescriptorSets(GetRenderDevice().GetNativeDevice(), pPSO->m_DescriptorPool, static_cast<uint32_t>(set.size()), set.data()));
-		}
-		m_PipelineDescriptorCache.clear();
+		// sets are owned by the pools of the pipeline, they are gone with it
+		m_PipelineDescriptorCache.erase(pPipelineState);
 	}
 }
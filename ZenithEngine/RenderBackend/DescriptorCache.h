@@ -12,21 +12,30 @@ namespace ZE::RenderBackend
 	class RenderDevice;
 	class PipelineState;
 
+	/* Descriptor sets of one frame. Every allocated set belongs to the recording it is allocated for, so recordings never write a shared set.
+	 * Sets are kept and handed out again once the frame is reused, i.e. GPU had finished every submission of it.
+	 */
 	class DescriptorCache : public RenderDeviceChild
 	{
 	public:
 
 		DescriptorCache(RenderDevice& renderDevice);
 
-		std::vector<VkDescriptorSet>& FindOrAdd(PipelineState* pPipelineState);
+		/* Set of the set index of the pipeline, its descriptors are undefined until written. */
+		VkDescriptorSet Allocate(PipelineState* pPipelineState, uint32_t setIndex);
+		/* Recycle all sets, must only be called once GPU had finished this frame. */
+		void Reset();
 		void MarkDirty(PipelineState* pPipelineState);
 
 	private:
+
+		struct SetList
+		{
+			std::vector<VkDescriptorSet>					m_Sets;
+			uint32_t										m_UsedCount = 0;
+		};
 		
-		void FreeAll();
-		
-	private:
-		
-		std::unordered_map<PipelineState*, std::vector<VkDescriptorSet>>		m_PipelineDescriptorCache;
+		// one set list per set index of the pipeline
+		std::unordered_map<PipelineState*, std::vector<SetList>>		m_PipelineDescriptorCache;
 	};
 }
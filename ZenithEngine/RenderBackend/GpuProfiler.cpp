@@ -0,0 +1,231 @@
+#include "GpuProfiler.h"
+
+#include "Core/Assertion.h"
+#include "RenderCommandStream.h"
+#include "VulkanHelper.h"
+
+#include <algorithm>
+
+namespace ZE::RenderBackend
+{
+	namespace
+	{
+		constexpr VkQueryPipelineStatisticFlags kPipelineStatisticFlags = VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT
+			| VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT
+			| VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT
+			| VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT
+			| VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT
+			| VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+		// results are written in the order of the flag bits, followed by the availability
+		struct PipelineStatisticsResult
+		{
+			GpuPipelineStatistics			m_Statistics;
+			uint64_t						m_Available = 0;
+		};
+		static_assert(sizeof(PipelineStatisticsResult) == 7 * sizeof(uint64_t));
+
+		struct TimestampResult
+		{
+			uint64_t						m_Timestamp = 0;
+			uint64_t						m_Available = 0;
+		};
+	}
+
+	GpuProfiler::GpuProfiler(RenderDevice& renderDevice, bool bEnablePipelineStatistics)
+		: m_EnablePipelineStatistics(bEnablePipelineStatistics)
+	{
+		SetRenderDevice(&renderDevice);
+
+		const auto& physicalDevice = renderDevice.GetPhysicalDevice();
+		m_TimestampPeriodInNs = physicalDevice.m_Props.limits.timestampPeriod;
+
+		const auto iter = std::ranges::find(physicalDevice.m_QueueArray, renderDevice.m_GraphicQueueFamilyIndex, &RenderDevice::QueueFamily::m_Index);
+		ZE_ASSERT(iter != physicalDevice.m_QueueArray.end());
+		const uint32_t validBits = iter->m_Props.timestampValidBits;
+		m_TimestampMask = validBits >= 64u ? ~0ull : ((1ull << validBits) - 1ull);
+
+		VulkanZeroStruct(VkQueryPoolCreateInfo, timestampPoolCI);
+		timestampPoolCI.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		timestampPoolCI.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		// begin and end of each scope
+		timestampPoolCI.queryCount = kMaxScopeCountPerFrame * 2u;
+
+		VulkanZeroStruct(VkQueryPoolCreateInfo, statisticsPoolCI);
+		statisticsPoolCI.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		statisticsPoolCI.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+		statisticsPoolCI.queryCount = kMaxScopeCountPerFrame;
+		statisticsPoolCI.pipelineStatistics = kPipelineStatisticFlags;
+
+		for (auto& frame : m_Frames)
+		{
+			VulkanCheckSucceed(vkCreateQueryPool(renderDevice.GetNativeDevice(), &timestampPoolCI, nullptr, &frame.m_TimestampQueryPool));
+			if (m_EnablePipelineStatistics)
+			{
+				VulkanCheckSucceed(vkCreateQueryPool(renderDevice.GetNativeDevice(), &statisticsPoolCI, nullptr, &frame.m_StatisticsQueryPool));
+			}
+			frame.m_ScopeNames.reserve(kMaxScopeCountPerFrame);
+		}
+	}
+
+	GpuProfiler::~GpuProfiler()
+	{
+		for (auto& frame : m_Frames)
+		{
+			vkDestroyQueryPool(GetRenderDevice().GetNativeDevice(), frame.m_TimestampQueryPool, nullptr);
+			if (frame.m_StatisticsQueryPool)
+			{
+				vkDestroyQueryPool(GetRenderDevice().GetNativeDevice(), frame.m_StatisticsQueryPool, nullptr);
+			}
+		}
+	}
+
+	void GpuProfiler::BeginFrame(uint32_t frameIndex)
+	{
+		ZE_ASSERT(frameIndex < m_Frames.size());
+		m_FrameIndex = frameIndex;
+
+		auto& frame = m_Frames[m_FrameIndex];
+		if (frame.m_IsSubmitted && !frame.m_ScopeNames.empty())
+		{
+			ResolveFrame(frame);
+		}
+
+		frame.m_ScopeNames.clear();
+		frame.m_HadReset = false;
+		frame.m_IsSubmitted = false;
+	}
+
+	void GpuProfiler::OnFrameSubmitted(uint32_t frameIndex)
+	{
+		auto& frame = m_Frames[frameIndex];
+		if (!frame.m_IsSubmitted)
+		{
+			frame.m_IsSubmitted = true;
+			frame.m_CpuSubmitTime = std::chrono::steady_clock::now();
+		}
+	}
+
+	uint32_t GpuProfiler::BeginScope(RenderCommandStream& commandStream, std::string_view name)
+	{
+		auto& frame = m_Frames[m_FrameIndex];
+
+		if (frame.m_ScopeNames.size() >= kMaxScopeCountPerFrame)
+		{
+			return kInvalidScope;
+		}
+
+		if (!frame.m_HadReset)
+		{
+			// queries must be reset before use, only the ones of the recycled frame are touched
+			// later submissions of the frame are executed after this one, so the reset is recorded only once
+			commandStream.CmdResetQueryPool(frame.m_TimestampQueryPool, 0, kMaxScopeCountPerFrame * 2u);
+			if (frame.m_StatisticsQueryPool)
+			{
+				commandStream.CmdResetQueryPool(frame.m_StatisticsQueryPool, 0, kMaxScopeCountPerFrame);
+			}
+			frame.m_HadReset = true;
+		}
+
+		const auto scope = static_cast<uint32_t>(frame.m_ScopeNames.size());
+		frame.m_ScopeNames.emplace_back(name);
+
+		commandStream.CmdWriteTimestamp(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.m_TimestampQueryPool, scope * 2u);
+		if (frame.m_StatisticsQueryPool)
+		{
+			commandStream.CmdBeginQuery(frame.m_StatisticsQueryPool, scope);
+		}
+		return scope;
+	}
+
+	void GpuProfiler::EndScope(RenderCommandStream& commandStream, uint32_t scope)
+	{
+		if (scope == kInvalidScope)
+		{
+			return;
+		}
+
+		auto& frame = m_Frames[m_FrameIndex];
+		ZE_ASSERT(scope < frame.m_ScopeNames.size());
+
+		if (frame.m_StatisticsQueryPool)
+		{
+			commandStream.CmdEndQuery(frame.m_StatisticsQueryPool, scope);
+		}
+		commandStream.CmdWriteTimestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.m_TimestampQueryPool, scope * 2u + 1u);
+	}
+
+	const GpuScopeTiming* GpuProfiler::FindScopeTiming(std::string_view name) const
+	{
+		const auto iter = std::ranges::find(m_LatestFrameProfile.m_Scopes, name, &GpuScopeTiming::m_Name);
+		return iter != m_LatestFrameProfile.m_Scopes.end() ? &*iter : nullptr;
+	}
+
+	void GpuProfiler::ResolveFrame(FrameQueries& frame)
+	{
+		const auto scopeCount = static_cast<uint32_t>(frame.m_ScopeNames.size());
+
+		// GPU had finished the frame, no need to wait
+		std::vector<TimestampResult> timestamps(scopeCount * 2u);
+		const VkResult timestampResult = vkGetQueryPoolResults(GetRenderDevice().GetNativeDevice(), frame.m_TimestampQueryPool, 0, scopeCount * 2u,
+			timestamps.size() * sizeof(TimestampResult), timestamps.data(), sizeof(TimestampResult), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+		if (timestampResult != VK_SUCCESS && timestampResult != VK_NOT_READY)
+		{
+			ZE_LOG_WARNING("Failed to resolve GPU timestamps of the frame, result: {}!", static_cast<int>(timestampResult));
+			return;
+		}
+
+		std::vector<PipelineStatisticsResult> statistics;
+		if (frame.m_StatisticsQueryPool)
+		{
+			statistics.resize(scopeCount);
+			const VkResult statisticsResult = vkGetQueryPoolResults(GetRenderDevice().GetNativeDevice(), frame.m_StatisticsQueryPool, 0, scopeCount,
+				statistics.size() * sizeof(PipelineStatisticsResult), statistics.data(), sizeof(PipelineStatisticsResult), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+			if (statisticsResult != VK_SUCCESS && statisticsResult != VK_NOT_READY)
+			{
+				statistics.clear();
+			}
+		}
+
+		const auto ToMs = [this](uint64_t beginTick, uint64_t endTick)
+		{
+			const uint64_t deltaTick = (endTick - beginTick) & m_TimestampMask;
+			return static_cast<double>(deltaTick) * m_TimestampPeriodInNs * 1e-6;
+		};
+
+		GpuFrameProfile profile;
+		profile.m_FrameNumber = ++m_ResolvedFrameCount;
+		profile.m_CpuSubmitTime = frame.m_CpuSubmitTime;
+		profile.m_Scopes.reserve(scopeCount);
+
+		const uint64_t frameBeginTick = timestamps[0].m_Timestamp;
+		uint64_t frameEndTick = frameBeginTick;
+		for (uint32_t i = 0; i < scopeCount; ++i)
+		{
+			const auto& begin = timestamps[i * 2u];
+			const auto& end = timestamps[i * 2u + 1u];
+			if (begin.m_Available == 0 || end.m_Available == 0)
+			{
+				continue;
+			}
+
+			auto& scope = profile.m_Scopes.emplace_back();
+			scope.m_Name = std::move(frame.m_ScopeNames[i]);
+			scope.m_StartTimeInMs = ToMs(frameBeginTick, begin.m_Timestamp);
+			scope.m_DurationInMs = ToMs(begin.m_Timestamp, end.m_Timestamp);
+			scope.m_CpuTimeStart = frame.m_CpuSubmitTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(scope.m_StartTimeInMs));
+			if (i < statistics.size() && statistics[i].m_Available != 0)
+			{
+				scope.m_PipelineStatistics = statistics[i].m_Statistics;
+			}
+
+			if (ToMs(frameBeginTick, end.m_Timestamp) > ToMs(frameBeginTick, frameEndTick))
+			{
+				frameEndTick = end.m_Timestamp;
+			}
+		}
+		profile.m_TotalTimeInMs = ToMs(frameBeginTick, frameEndTick);
+
+		m_LatestFrameProfile = std::move(profile);
+	}
+}
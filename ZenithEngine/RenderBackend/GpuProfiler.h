@@ -0,0 +1,118 @@
+#pragma once
+
+#include "RenderDeviceChild.h"
+#include "RenderDevice.h"
+#include "Core/ClassProperty.h"
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ZE::RenderBackend
+{
+	class RenderCommandStream;
+
+	struct GpuPipelineStatistics
+	{
+		uint64_t							m_InputAssemblyVertices = 0;
+		uint64_t							m_InputAssemblyPrimitives = 0;
+		uint64_t							m_VertexShaderInvocations = 0;
+		uint64_t							m_ClippingInvocations = 0;
+		uint64_t							m_ClippingPrimitives = 0;
+		uint64_t							m_FragmentShaderInvocations = 0;
+	};
+
+	struct GpuScopeTiming
+	{
+		std::string							m_Name;
+		// relative to the start of the first scope of the frame
+		double								m_StartTimeInMs = 0.0;
+		double								m_DurationInMs = 0.0;
+		// start of the scope on CPU clock, so it can be put on the same timeline as CPU work
+		std::chrono::steady_clock::time_point	m_CpuTimeStart;
+		// all zero unless pipeline statistics are enabled
+		GpuPipelineStatistics				m_PipelineStatistics;
+	};
+
+	struct GpuFrameProfile
+	{
+		// increased by every profiled frame
+		uint64_t							m_FrameNumber = 0;
+		std::chrono::steady_clock::time_point	m_CpuSubmitTime;
+		// from the start of the first scope to the end of the last one
+		double								m_TotalTimeInMs = 0.0;
+		std::vector<GpuScopeTiming>			m_Scopes;
+	};
+
+	/* GPU timing of command scopes, e.g. render graph nodes, with timestamp and optional pipeline statistics queries.
+	 * Each frame slot has its own query pools, they are resolved when the slot is reused kSwapBufferCount frames later,
+	 * GPU had already finished it by then, so reading the results never stalls.
+	 * GPU timestamps are mapped onto CPU clock by anchoring the first scope of a frame at its submission,
+	 * which is an approximation, the GPU may start the frame a little later.
+	 * A frame may be submitted several times, e.g. by several render graphs, scopes of all its submissions share the queries of the frame
+	 * and the frame is anchored at its first submission.
+	 * All functions must be called on the render thread.
+	 */
+	class GpuProfiler : public RenderDeviceChild
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(GpuProfiler);
+
+	public:
+
+		static constexpr uint32_t kMaxScopeCountPerFrame = 256u;
+		static constexpr uint32_t kInvalidScope = ~0u;
+
+		GpuProfiler(RenderDevice& renderDevice, bool bEnablePipelineStatistics);
+		~GpuProfiler();
+
+		/* Resolve the results of the frame slot and recycle its queries, GPU must had finished the frame. Called by render device each frame. */
+		void BeginFrame(uint32_t frameIndex);
+		/* Anchor the frame on CPU clock at its first submission. Called by render device every time the frame is submitted. */
+		void OnFrameSubmitted(uint32_t frameIndex);
+
+		/* Scopes must NOT overlap and must NOT be inside a render pass. They can be recorded after a submission of the frame, to be submitted by a later one.
+		 * kInvalidScope is returned once the frame runs out of queries.
+		 */
+		uint32_t BeginScope(RenderCommandStream& commandStream, std::string_view name);
+		void EndScope(RenderCommandStream& commandStream, uint32_t scope);
+
+		/* Latest resolved frame, it is kSwapBufferCount frames behind the one being recorded. */
+		const GpuFrameProfile& GetLatestFrameProfile() const { return m_LatestFrameProfile; }
+		/* Timing of the first scope with the name in the latest resolved frame, null if there is none. */
+		const GpuScopeTiming* FindScopeTiming(std::string_view name) const;
+
+		bool IsPipelineStatisticsEnabled() const { return m_EnablePipelineStatistics; }
+
+	private:
+
+		struct FrameQueries
+		{
+			VkQueryPool								m_TimestampQueryPool = nullptr;
+			VkQueryPool								m_StatisticsQueryPool = nullptr;
+
+			std::vector<std::string>				m_ScopeNames;
+			bool									m_HadReset = false;
+			bool									m_IsSubmitted = false;
+			std::chrono::steady_clock::time_point	m_CpuSubmitTime;
+		};
+
+		void ResolveFrame(FrameQueries& frame);
+
+	private:
+
+		std::array<FrameQueries, RenderDevice::kSwapBufferCount>	m_Frames;
+		uint32_t													m_FrameIndex = 0;
+
+		bool														m_EnablePipelineStatistics = false;
+		double														m_TimestampPeriodInNs = 1.0;
+		uint64_t													m_TimestampMask = ~0ull;
+
+		GpuFrameProfile												m_LatestFrameProfile;
+		uint64_t													m_ResolvedFrameCount = 0;
+	};
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "RenderBackend/RenderResourceState.h"
+
+#include <vulkan/vulkan_core.h>
+
+#include <memory>
+
+namespace ZE::RenderBackend
+{
+	class Texture;
+
+	/* Synchronization of the frame submission, null handles are skipped. */
+	struct RenderOutputSubmitInfo
+	{
+		// signaled when the frame render target can be written
+		VkSemaphore							m_WaitSemaphore = nullptr;
+		// signaled when rendering is done, consumed by presentation
+		VkSemaphore							m_SignalSemaphore = nullptr;
+		// signaled when GPU had finished the frame
+		VkFence								m_Fence = nullptr;
+	};
+
+	/* Where frames are rendered to, a window swapchain or offscreen images. */
+	class IRenderOutput
+	{
+	public:
+
+		virtual ~IRenderOutput() = default;
+
+		virtual void BeginFrame() = 0;
+		virtual void EndFrame() = 0;
+
+		virtual void Present() = 0;
+
+		virtual const std::shared_ptr<Texture>& GetFrameRenderTarget() const = 0;
+		// state of the frame render target when the frame begins
+		virtual ERenderResourceState GetFrameRenderTargetState() const = 0;
+		// state the frame render target must be left in before Present()
+		virtual ERenderResourceState GetFrameRenderTargetFinalState() const = 0;
+
+		virtual RenderOutputSubmitInfo GetFrameSubmitInfo() const = 0;
+	};
+}
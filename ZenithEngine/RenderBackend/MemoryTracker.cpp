@@ -0,0 +1,194 @@
+#include "MemoryTracker.h"
+
+#include "Core/Assertion.h"
+#include "RenderDevice.h"
+
+#include <algorithm>
+
+namespace ZE::RenderBackend
+{
+	static const char* ToString(EMemoryCategory category)
+	{
+		switch (category)
+		{
+		case EMemoryCategory::GraphTransient: return "Graph Transient";
+		case EMemoryCategory::StaticBuffer: return "Static Buffer";
+		case EMemoryCategory::Texture: return "Texture";
+		case EMemoryCategory::Staging: return "Staging";
+		case EMemoryCategory::Uniform: return "Uniform";
+		case EMemoryCategory::Readback: return "Readback";
+		default:
+			break;
+		}
+
+		ZE_ASSERT(false);
+		return "Unknown";
+	}
+
+	static double ToMiB(uint64_t sizeInByte)
+	{
+		return static_cast<double>(sizeInByte) / (1024.0 * 1024.0);
+	}
+
+	MemoryTracker::MemoryTracker(RenderDevice& renderDevice, bool bIsBudgetFromDriver)
+		: m_IsBudgetFromDriver(bIsBudgetFromDriver)
+	{
+		SetRenderDevice(&renderDevice);
+
+		const VkPhysicalDeviceMemoryProperties* pMemoryProps = nullptr;
+		vmaGetMemoryProperties(renderDevice.m_GlobalAllocator, &pMemoryProps);
+		m_IsHeapOverBudget.resize(pMemoryProps->memoryHeapCount, false);
+	}
+
+	void MemoryTracker::OnAllocated(EMemoryCategory category, uint64_t sizeInByte)
+	{
+		const auto index = static_cast<size_t>(category);
+		m_CategorySizeInByte[index].fetch_add(sizeInByte, std::memory_order_relaxed);
+		m_CategoryAllocationCount[index].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void MemoryTracker::OnFreed(EMemoryCategory category, uint64_t sizeInByte)
+	{
+		const auto index = static_cast<size_t>(category);
+		ZE_ASSERT(m_CategoryAllocationCount[index].load(std::memory_order_relaxed) > 0);
+		m_CategorySizeInByte[index].fetch_sub(sizeInByte, std::memory_order_relaxed);
+		m_CategoryAllocationCount[index].fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	MemoryStatistics MemoryTracker::QueryStatistics() const
+	{
+		MemoryStatistics statistics;
+		statistics.m_Heaps = QueryHeapBudgets();
+		statistics.m_IsBudgetFromDriver = m_IsBudgetFromDriver;
+
+		for (size_t i = 0; i < statistics.m_Categories.size(); ++i)
+		{
+			statistics.m_Categories[i] = GetCategoryStatistics(static_cast<EMemoryCategory>(i));
+		}
+
+		VmaTotalStatistics totalStatistics = {};
+		vmaCalculateStatistics(GetRenderDevice().m_GlobalAllocator, &totalStatistics);
+
+		const auto& total = totalStatistics.total;
+		statistics.m_TotalAllocationCount = total.statistics.allocationCount;
+		statistics.m_TotalAllocationSizeInByte = total.statistics.allocationBytes;
+		statistics.m_TotalBlockSizeInByte = total.statistics.blockBytes;
+		statistics.m_UnusedRangeCount = total.unusedRangeCount;
+		statistics.m_LargestUnusedRangeInByte = total.unusedRangeCount != 0 ? total.unusedRangeSizeMax : 0;
+
+		// free memory which can NOT be used by the largest possible allocation
+		const uint64_t unusedSizeInByte = total.statistics.blockBytes - total.statistics.allocationBytes;
+		if (unusedSizeInByte != 0)
+		{
+			statistics.m_Fragmentation = 1.0f - static_cast<float>(static_cast<double>(statistics.m_LargestUnusedRangeInByte) / static_cast<double>(unusedSizeInByte));
+		}
+
+		return statistics;
+	}
+
+	MemoryCategoryStatistics MemoryTracker::GetCategoryStatistics(EMemoryCategory category) const
+	{
+		const auto index = static_cast<size_t>(category);
+
+		MemoryCategoryStatistics statistics;
+		statistics.m_SizeInByte = m_CategorySizeInByte[index].load(std::memory_order_relaxed);
+		statistics.m_AllocationCount = m_CategoryAllocationCount[index].load(std::memory_order_relaxed);
+		return statistics;
+	}
+
+	void MemoryTracker::SetOverBudgetCallback(OverBudgetCallback callback, float threshold)
+	{
+		ZE_ASSERT(threshold > 0.0f);
+
+		std::scoped_lock lock(m_CallbackMutex);
+		m_OverBudgetCallback = std::move(callback);
+		m_OverBudgetThreshold = threshold;
+		std::fill(m_IsHeapOverBudget.begin(), m_IsHeapOverBudget.end(), false);
+	}
+
+	void MemoryTracker::Dump(bool bDetailed) const
+	{
+		const auto statistics = QueryStatistics();
+
+		ZE_LOG_INFO("GPU memory statistics ({} budget):", statistics.m_IsBudgetFromDriver ? "driver" : "estimated");
+		for (uint32_t i = 0; i < statistics.m_Heaps.size(); ++i)
+		{
+			const auto& heap = statistics.m_Heaps[i];
+			ZE_LOG_INFO("\tHeap {}{}: {:.2f} / {:.2f} MiB ({:.1f}%), {} blocks {:.2f} MiB, {} allocations {:.2f} MiB",
+				i, heap.IsDeviceLocal() ? " (device local)" : "",
+				ToMiB(heap.m_UsageInByte), ToMiB(heap.m_BudgetInByte), heap.GetUsageRatio() * 100.0f,
+				heap.m_BlockCount, ToMiB(heap.m_BlockSizeInByte), heap.m_AllocationCount, ToMiB(heap.m_AllocationSizeInByte));
+		}
+
+		for (size_t i = 0; i < statistics.m_Categories.size(); ++i)
+		{
+			const auto& category = statistics.m_Categories[i];
+			ZE_LOG_INFO("\t{}: {} allocations {:.2f} MiB", ToString(static_cast<EMemoryCategory>(i)), category.m_AllocationCount, ToMiB(category.m_SizeInByte));
+		}
+
+		ZE_LOG_INFO("\tTotal: {} allocations {:.2f} MiB in {:.2f} MiB blocks, {} unused ranges, largest {:.2f} MiB, fragmentation {:.1f}%",
+			statistics.m_TotalAllocationCount, ToMiB(statistics.m_TotalAllocationSizeInByte), ToMiB(statistics.m_TotalBlockSizeInByte),
+			statistics.m_UnusedRangeCount, ToMiB(statistics.m_LargestUnusedRangeInByte), statistics.m_Fragmentation * 100.0f);
+
+		if (bDetailed)
+		{
+			// includes every allocation with its debug name
+			char* pStatsString = nullptr;
+			vmaBuildStatsString(GetRenderDevice().m_GlobalAllocator, &pStatsString, VK_TRUE);
+			ZE_LOG_INFO("{}", pStatsString);
+			vmaFreeStatsString(GetRenderDevice().m_GlobalAllocator, pStatsString);
+		}
+	}
+
+	void MemoryTracker::Update()
+	{
+		// budgets are cached by VMA and refreshed when the frame index changes
+		vmaSetCurrentFrameIndex(GetRenderDevice().m_GlobalAllocator, ++m_FrameCounter);
+
+		{
+			std::scoped_lock lock(m_CallbackMutex);
+			if (m_OverBudgetCallback)
+			{
+				const auto heaps = QueryHeapBudgets();
+				for (uint32_t i = 0; i < heaps.size(); ++i)
+				{
+					const bool bIsOverBudget = static_cast<float>(heaps[i].m_UsageInByte) > static_cast<float>(heaps[i].m_BudgetInByte) * m_OverBudgetThreshold;
+					if (bIsOverBudget && !m_IsHeapOverBudget[i])
+					{
+						ZE_LOG_WARNING("GPU memory heap {} is over budget: {:.2f} / {:.2f} MiB", i, ToMiB(heaps[i].m_UsageInByte), ToMiB(heaps[i].m_BudgetInByte));
+						m_OverBudgetCallback(i, heaps[i]);
+					}
+					m_IsHeapOverBudget[i] = bIsOverBudget;
+				}
+			}
+		}
+
+		if (m_DumpIntervalInFrame != 0 && m_FrameCounter % m_DumpIntervalInFrame == 0)
+		{
+			Dump();
+		}
+	}
+
+	std::vector<MemoryHeapStatistics> MemoryTracker::QueryHeapBudgets() const
+	{
+		const VkPhysicalDeviceMemoryProperties* pMemoryProps = nullptr;
+		vmaGetMemoryProperties(GetRenderDevice().m_GlobalAllocator, &pMemoryProps);
+
+		std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets = {};
+		vmaGetHeapBudgets(GetRenderDevice().m_GlobalAllocator, budgets.data());
+
+		std::vector<MemoryHeapStatistics> heaps(pMemoryProps->memoryHeapCount);
+		for (uint32_t i = 0; i < heaps.size(); ++i)
+		{
+			auto& heap = heaps[i];
+			heap.m_Flags = pMemoryProps->memoryHeaps[i].flags;
+			heap.m_BudgetInByte = budgets[i].budget;
+			heap.m_UsageInByte = budgets[i].usage;
+			heap.m_BlockSizeInByte = budgets[i].statistics.blockBytes;
+			heap.m_AllocationSizeInByte = budgets[i].statistics.allocationBytes;
+			heap.m_BlockCount = budgets[i].statistics.blockCount;
+			heap.m_AllocationCount = budgets[i].statistics.allocationCount;
+		}
+		return heaps;
+	}
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "RenderDeviceChild.h"
+#include "RenderResource.h"
+#include "Core/ClassProperty.h"
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <functional>
+
+namespace ZE::RenderBackend
+{
+	class RenderDevice;
+
+	struct MemoryHeapStatistics
+	{
+		VkMemoryHeapFlags			m_Flags = 0;
+		// budget and usage of the whole process, including memory not allocated by the engine
+		uint64_t					m_BudgetInByte = 0;
+		uint64_t					m_UsageInByte = 0;
+		// VkDeviceMemory blocks allocated by the engine and the allocations placed in them
+		uint64_t					m_BlockSizeInByte = 0;
+		uint64_t					m_AllocationSizeInByte = 0;
+		uint32_t					m_BlockCount = 0;
+		uint32_t					m_AllocationCount = 0;
+
+		bool IsDeviceLocal() const { return (m_Flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0; }
+		float GetUsageRatio() const { return m_BudgetInByte != 0 ? static_cast<float>(m_UsageInByte) / static_cast<float>(m_BudgetInByte) : 0.0f; }
+	};
+
+	struct MemoryCategoryStatistics
+	{
+		uint64_t					m_SizeInByte = 0;
+		uint32_t					m_AllocationCount = 0;
+	};
+
+	struct MemoryStatistics
+	{
+		std::vector<MemoryHeapStatistics>														m_Heaps;
+		std::array<MemoryCategoryStatistics, static_cast<size_t>(EMemoryCategory::Count)>		m_Categories = {};
+
+		uint32_t					m_TotalAllocationCount = 0;
+		uint64_t					m_TotalAllocationSizeInByte = 0;
+		uint64_t					m_TotalBlockSizeInByte = 0;
+
+		uint32_t					m_UnusedRangeCount = 0;
+		uint64_t					m_LargestUnusedRangeInByte = 0;
+		// 0 means all free memory inside blocks is one range, close to 1 means it is scattered into small ranges
+		float						m_Fragmentation = 0.0f;
+
+		// false if VK_EXT_memory_budget is not supported, budgets are estimated from heap sizes then
+		bool						m_IsBudgetFromDriver = false;
+	};
+
+	/* Track GPU memory usage of the render device.
+	 * Per-category totals are counted by the engine, heap budgets and fragmentation are queried from VMA.
+	 */
+	class MemoryTracker : public RenderDeviceChild
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(MemoryTracker);
+
+	public:
+
+		using OverBudgetCallback = std::function<void(uint32_t heapIndex, const MemoryHeapStatistics& heapStatistics)>;
+
+		static constexpr float kDefaultOverBudgetThreshold = 0.9f;
+
+		MemoryTracker(RenderDevice& renderDevice, bool bIsBudgetFromDriver);
+
+		void OnAllocated(EMemoryCategory category, uint64_t sizeInByte);
+		void OnFreed(EMemoryCategory category, uint64_t sizeInByte);
+
+		/* Full statistics, it walks all memory blocks so do NOT call it every frame. */
+		MemoryStatistics QueryStatistics() const;
+		MemoryCategoryStatistics GetCategoryStatistics(EMemoryCategory category) const;
+
+		/* Callback is invoked on the render thread when the usage of a heap exceeds threshold * budget.
+		 * It is invoked once each time the heap goes over, and again only after it went back under budget.
+		 */
+		void SetOverBudgetCallback(OverBudgetCallback callback, float threshold = kDefaultOverBudgetThreshold);
+		/* Dump statistics to log every N frames, 0 to disable. */
+		void SetDumpInterval(uint32_t intervalInFrame) { m_DumpIntervalInFrame = intervalInFrame; }
+
+		/* Log the statistics, detailed dump also lists every allocation by its debug name. */
+		void Dump(bool bDetailed = false) const;
+
+		// Refresh heap budgets and check them against the threshold. Called by render device each frame.
+		void Update();
+
+	private:
+
+		std::vector<MemoryHeapStatistics> QueryHeapBudgets() const;
+
+	private:
+
+		bool																				m_IsBudgetFromDriver = false;
+
+		std::array<std::atomic<uint64_t>, static_cast<size_t>(EMemoryCategory::Count)>		m_CategorySizeInByte = {};
+		std::array<std::atomic<uint32_t>, static_cast<size_t>(EMemoryCategory::Count)>		m_CategoryAllocationCount = {};
+
+		std::mutex																			m_CallbackMutex;
+		OverBudgetCallback																	m_OverBudgetCallback;
+		float																				m_OverBudgetThreshold = kDefaultOverBudgetThreshold;
+		std::vector<bool>																	m_IsHeapOverBudget;
+
+		uint32_t																			m_DumpIntervalInFrame = 0;
+		uint32_t																			m_FrameCounter = 0;
+	};
+}
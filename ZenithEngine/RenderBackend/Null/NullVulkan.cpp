@@ -0,0 +1,1882 @@
+#include "NullVulkan.h"
+
+#if ZENITH_NULL_RENDER_BACKEND
+
+#include "Core/Assertion.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <deque>
+#include <optional>
+#include <vector>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+// Expose operator""sv()
+using namespace std::string_view_literals;
+
+namespace ZE::RenderBackend::Null
+{
+	namespace
+	{
+		constexpr uint32_t kGraphicQueueFamilyIndex = 0;
+		constexpr uint32_t kTransferQueueFamilyIndex = 1;
+		constexpr uint32_t kQueueCountPerFamily = 4;
+		constexpr uint32_t kDefaultSurfaceWidth = 1280;
+		constexpr uint32_t kDefaultSurfaceHeight = 720;
+		constexpr VkDeviceSize kDeviceLocalHeapSize = 8ull * 1024 * 1024 * 1024;
+		constexpr VkDeviceSize kHostHeapSize = 16ull * 1024 * 1024 * 1024;
+
+		// memory type 0: device local, 1: device local and host visible (resizable BAR), 2: host cached
+		constexpr uint32_t kAllMemoryTypeBits = 0b111;
+
+		struct Object
+		{
+			Object();
+			virtual ~Object();
+		};
+
+		struct PhysicalDevice : public Object {};
+
+		struct Instance : public Object
+		{
+			PhysicalDevice									m_PhysicalDevice;
+		};
+
+		struct Surface : public Object {};
+		struct DebugMessenger : public Object {};
+		struct Queue : public Object {};
+
+		struct Device : public Object
+		{
+			std::mutex										m_QueueMutex;
+			std::unordered_map<uint64_t, std::unique_ptr<Queue>>	m_Queues;
+		};
+
+		struct DeviceMemory : public Object
+		{
+			VkDeviceSize									m_Size = 0;
+			uint32_t										m_HeapIndex = 0;
+			// host backing is allocated on first map, device only memory never touches host memory
+			std::unique_ptr<std::byte[]>					m_HostMemory;
+		};
+
+		struct Buffer : public Object
+		{
+			VkDeviceSize									m_Size = 0;
+		};
+
+		struct Image : public Object
+		{
+			VkImageCreateInfo								m_CreateInfo = {};
+		};
+
+		struct ImageView : public Object {};
+		struct Sampler : public Object {};
+		struct ShaderModule : public Object {};
+		struct PipelineLayout : public Object {};
+		struct Pipeline : public Object {};
+		struct DescriptorSetLayout : public Object {};
+
+		struct DescriptorPool;
+		struct DescriptorSet : public Object
+		{
+			DescriptorPool*									m_Pool = nullptr;
+			// buffer descriptors written by binding, images and samplers are only counted
+			std::unordered_map<uint32_t, VkDescriptorBufferInfo>	m_BufferInfos;
+		};
+
+		struct DescriptorPool : public Object
+		{
+			uint32_t										m_MaxSetCount = 0;
+			std::vector<DescriptorSet*>						m_Sets;
+		};
+
+		struct CommandPool;
+		struct CommandBuffer : public Object
+		{
+			CommandPool*									m_Pool = nullptr;
+			std::vector<NullCommand>						m_Commands;
+			bool											m_IsRecording = false;
+			// query commands are executed on submission, so they are only looked for when there are some
+			bool											m_HasQueryCommands = false;
+		};
+
+		struct CommandPool : public Object
+		{
+			std::vector<CommandBuffer*>						m_CommandBuffers;
+		};
+
+		struct QueryPool : public Object
+		{
+			VkQueryType										m_Type = VK_QUERY_TYPE_TIMESTAMP;
+			// one value per enabled pipeline statistic, one otherwise
+			uint32_t										m_ValueCountPerQuery = 1;
+			std::vector<uint64_t>							m_Values;
+			std::vector<bool>								m_IsAvailable;
+		};
+
+		struct Semaphore : public Object
+		{
+			bool											m_IsTimeline = false;
+			// binary semaphores are 0 (unsignaled) or 1 (signaled)
+			uint64_t										m_Value = 0;
+		};
+
+		struct Fence : public Object
+		{
+			bool											m_IsSignaled = false;
+		};
+
+		struct Swapchain : public Object
+		{
+			std::vector<std::unique_ptr<Image>>				m_Images;
+			uint32_t										m_NextImageIndex = 0;
+		};
+
+		struct Driver
+		{
+			// guards all the mutable object states, the null driver is never a bottleneck worth a finer lock
+			std::mutex										m_Mutex;
+			std::deque<NullCommand>							m_SubmittedCommands;
+			std::optional<VkPhysicalDeviceDescriptorIndexingProperties>	m_DescriptorIndexingPropertiesOverride;
+
+			std::atomic<uint32_t>							m_LiveObjectCount = 0;
+			std::atomic<uint64_t>							m_CreatedObjectCount = 0;
+			std::atomic<uint64_t>							m_LiveDeviceMemoryInByte = 0;
+			std::array<std::atomic<uint64_t>, 2>			m_HeapUsageInByte = {};
+
+			std::atomic<uint64_t>							m_QueueSubmitCount = 0;
+			std::atomic<uint64_t>							m_SubmittedCommandBufferCount = 0;
+			std::atomic<uint64_t>							m_RecordedCommandCount = 0;
+			std::atomic<uint64_t>							m_DescriptorWriteCount = 0;
+			std::atomic<uint64_t>							m_PresentCount = 0;
+		};
+
+		Driver& GetDriver()
+		{
+			static Driver sDriver;
+			return sDriver;
+		}
+
+		Object::Object()
+		{
+			GetDriver().m_LiveObjectCount.fetch_add(1, std::memory_order_relaxed);
+			GetDriver().m_CreatedObjectCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		Object::~Object()
+		{
+			GetDriver().m_LiveObjectCount.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		template <typename TObject, typename THandle>
+		TObject* FromHandle(THandle handle)
+		{
+			return reinterpret_cast<TObject*>(handle);
+		}
+
+		template <typename THandle, typename TObject>
+		THandle ToHandle(TObject* pObject)
+		{
+			return reinterpret_cast<THandle>(pObject);
+		}
+
+		template <typename TObject, typename THandle>
+		VkResult CreateObject(THandle* pHandle)
+		{
+			*pHandle = ToHandle<THandle>(new TObject());
+			return VK_SUCCESS;
+		}
+
+		template <typename TObject, typename THandle>
+		void DestroyObject(THandle handle)
+		{
+			delete FromHandle<TObject>(handle);
+		}
+
+		template <typename T, size_t N>
+		VkResult Enumerate(const std::array<T, N>& source, uint32_t* pCount, T* pOut)
+		{
+			if (!pOut)
+			{
+				*pCount = static_cast<uint32_t>(N);
+				return VK_SUCCESS;
+			}
+
+			const uint32_t count = std::min(*pCount, static_cast<uint32_t>(N));
+			std::copy_n(source.begin(), count, pOut);
+			*pCount = count;
+			return count < N ? VK_INCOMPLETE : VK_SUCCESS;
+		}
+
+		VkExtensionProperties MakeExtension(std::string_view name, uint32_t specVersion)
+		{
+			VkExtensionProperties props = {};
+			std::copy_n(name.data(), std::min(name.size(), static_cast<size_t>(VK_MAX_EXTENSION_NAME_SIZE - 1)), props.extensionName);
+			props.specVersion = specVersion;
+			return props;
+		}
+
+		VkLayerProperties MakeLayer(std::string_view name)
+		{
+			VkLayerProperties props = {};
+			std::copy_n(name.data(), std::min(name.size(), static_cast<size_t>(VK_MAX_EXTENSION_NAME_SIZE - 1)), props.layerName);
+			props.specVersion = VK_API_VERSION_1_3;
+			props.implementationVersion = 1;
+			return props;
+		}
+
+		// everything the engine may require is reported as supported
+		const std::array gInstanceExtensions = {
+			MakeExtension(VK_KHR_SURFACE_EXTENSION_NAME, 25),
+			MakeExtension("VK_KHR_win32_surface", 6),
+			MakeExtension(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME, 1),
+			MakeExtension(VK_EXT_DEBUG_UTILS_EXTENSION_NAME, 2),
+			MakeExtension(VK_EXT_DEBUG_REPORT_EXTENSION_NAME, 10),
+		};
+
+		const std::array gDeviceExtensions = {
+			MakeExtension(VK_KHR_SWAPCHAIN_EXTENSION_NAME, 70),
+			MakeExtension(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME, 1),
+			MakeExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, 1),
+		};
+
+		const std::array gLayers = {
+			MakeLayer("VK_LAYER_KHRONOS_validation"),
+		};
+
+		const std::array gSurfaceFormats = {
+			VkSurfaceFormatKHR{ VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+			VkSurfaceFormatKHR{ VK_FORMAT_R8G8B8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+			VkSurfaceFormatKHR{ VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+		};
+
+		const std::array gPresentModes = {
+			VK_PRESENT_MODE_MAILBOX_KHR,
+			VK_PRESENT_MODE_IMMEDIATE_KHR,
+			VK_PRESENT_MODE_FIFO_KHR,
+		};
+
+		const std::array gQueueFamilies = {
+			VkQueueFamilyProperties{ VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT, kQueueCountPerFamily, 64, { 1, 1, 1 } },
+			VkQueueFamilyProperties{ VK_QUEUE_TRANSFER_BIT, kQueueCountPerFamily, 64, { 1, 1, 1 } },
+		};
+
+		VkPhysicalDeviceProperties MakePhysicalDeviceProperties()
+		{
+			VkPhysicalDeviceProperties props = {};
+			props.apiVersion = VK_API_VERSION_1_3;
+			props.driverVersion = 1;
+			props.vendorID = 0;
+			props.deviceID = 0;
+			props.deviceType = VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU;
+			constexpr auto kDeviceName = "Zenith Null Device"sv;
+			std::copy_n(kDeviceName.data(), kDeviceName.size(), props.deviceName);
+
+			// roughly a current desktop GPU, so the engine takes the same paths as on real hardware
+			auto& limits = props.limits;
+			limits.maxImageDimension1D = 16384;
+			limits.maxImageDimension2D = 16384;
+			limits.maxImageDimension3D = 2048;
+			limits.maxImageDimensionCube = 16384;
+			limits.maxImageArrayLayers = 2048;
+			limits.maxTexelBufferElements = 1u << 27;
+			limits.maxUniformBufferRange = 65536;
+			limits.maxStorageBufferRange = 1u << 30;
+			limits.maxPushConstantsSize = 256;
+			limits.maxMemoryAllocationCount = 4096;
+			limits.maxSamplerAllocationCount = 4000;
+			limits.bufferImageGranularity = 1024;
+			limits.maxBoundDescriptorSets = 8;
+			limits.maxPerStageDescriptorSamplers = 1u << 20;
+			limits.maxPerStageDescriptorUniformBuffers = 1u << 20;
+			limits.maxPerStageDescriptorStorageBuffers = 1u << 20;
+			limits.maxPerStageDescriptorSampledImages = 1u << 20;
+			limits.maxPerStageDescriptorStorageImages = 1u << 20;
+			limits.maxPerStageResources = 1u << 22;
+			limits.maxDescriptorSetSamplers = 1u << 20;
+			limits.maxDescriptorSetUniformBuffers = 1u << 20;
+			limits.maxDescriptorSetUniformBuffersDynamic = 16;
+			limits.maxDescriptorSetStorageBuffers = 1u << 20;
+			limits.maxDescriptorSetStorageBuffersDynamic = 16;
+			limits.maxDescriptorSetSampledImages = 1u << 20;
+			limits.maxDescriptorSetStorageImages = 1u << 20;
+			limits.maxVertexInputAttributes = 32;
+			limits.maxVertexInputBindings = 32;
+			limits.maxVertexInputAttributeOffset = 2047;
+			limits.maxVertexInputBindingStride = 2048;
+			limits.maxColorAttachments = 8;
+			limits.maxFramebufferWidth = 16384;
+			limits.maxFramebufferHeight = 16384;
+			limits.maxFramebufferLayers = 2048;
+			limits.maxViewports = 16;
+			limits.maxViewportDimensions[0] = 16384;
+			limits.maxViewportDimensions[1] = 16384;
+			limits.maxComputeWorkGroupCount[0] = 65535;
+			limits.maxComputeWorkGroupCount[1] = 65535;
+			limits.maxComputeWorkGroupCount[2] = 65535;
+			limits.maxComputeWorkGroupInvocations = 1024;
+			limits.maxComputeWorkGroupSize[0] = 1024;
+			limits.maxComputeWorkGroupSize[1] = 1024;
+			limits.maxComputeWorkGroupSize[2] = 64;
+			limits.maxComputeSharedMemorySize = 49152;
+			limits.maxSamplerAnisotropy = 16.0f;
+			limits.maxSamplerLodBias = 15.0f;
+			limits.minMemoryMapAlignment = 64;
+			limits.minTexelBufferOffsetAlignment = 16;
+			limits.minUniformBufferOffsetAlignment = 256;
+			limits.minStorageBufferOffsetAlignment = 64;
+			limits.timestampComputeAndGraphics = VK_TRUE;
+			limits.timestampPeriod = 1.0f;
+			limits.optimalBufferCopyOffsetAlignment = 1;
+			limits.optimalBufferCopyRowPitchAlignment = 1;
+			limits.nonCoherentAtomSize = 64;
+			limits.framebufferColorSampleCounts = VK_SAMPLE_COUNT_1_BIT | VK_SAMPLE_COUNT_4_BIT | VK_SAMPLE_COUNT_8_BIT;
+			limits.framebufferDepthSampleCounts = limits.framebufferColorSampleCounts;
+			limits.sampledImageColorSampleCounts = limits.framebufferColorSampleCounts;
+			limits.sampledImageDepthSampleCounts = limits.framebufferColorSampleCounts;
+			return props;
+		}
+
+		VkPhysicalDeviceMemoryProperties MakePhysicalDeviceMemoryProperties()
+		{
+			VkPhysicalDeviceMemoryProperties props = {};
+			props.memoryHeapCount = 2;
+			props.memoryHeaps[0] = { kDeviceLocalHeapSize, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT };
+			props.memoryHeaps[1] = { kHostHeapSize, 0 };
+
+			props.memoryTypeCount = 3;
+			props.memoryTypes[0] = { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0 };
+			props.memoryTypes[1] = { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0 };
+			props.memoryTypes[2] = { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, 1 };
+			return props;
+		}
+
+		const VkPhysicalDeviceProperties gPhysicalDeviceProperties = MakePhysicalDeviceProperties();
+		const VkPhysicalDeviceMemoryProperties gPhysicalDeviceMemoryProperties = MakePhysicalDeviceMemoryProperties();
+
+		// set every VkBool32 member of a feature struct after its sType and pNext
+		template <typename TFeatures>
+		void EnableAllFeatures(TFeatures* pFeatures)
+		{
+			constexpr size_t kHeaderSize = sizeof(VkBaseOutStructure);
+			static_assert((sizeof(TFeatures) - kHeaderSize) % sizeof(VkBool32) == 0);
+
+			auto* pBegin = reinterpret_cast<std::byte*>(pFeatures) + kHeaderSize;
+			const VkBool32 enabled = VK_TRUE;
+			for (size_t offset = 0; offset < sizeof(TFeatures) - kHeaderSize; offset += sizeof(VkBool32))
+			{
+				memcpy(pBegin + offset, &enabled, sizeof(VkBool32));
+			}
+
+		}
+
+		void EnableAllCoreFeatures(VkPhysicalDeviceFeatures* pFeatures)
+		{
+			auto* pBegin = reinterpret_cast<std::byte*>(pFeatures);
+			const VkBool32 enabled = VK_TRUE;
+			for (size_t offset = 0; offset < sizeof(VkPhysicalDeviceFeatures); offset += sizeof(VkBool32))
+			{
+				memcpy(pBegin + offset, &enabled, sizeof(VkBool32));
+			}
+		}
+
+		// update-after-bind limits as high as the regular descriptor limits, e.g. a desktop GPU, unless a test had overridden them
+		void FillDescriptorIndexingProperties(VkPhysicalDeviceDescriptorIndexingProperties* pProps)
+		{
+			{
+				auto& driver = GetDriver();
+				std::scoped_lock lock(driver.m_Mutex);
+				if (driver.m_DescriptorIndexingPropertiesOverride)
+				{
+					void* pNext = pProps->pNext;
+					*pProps = *driver.m_DescriptorIndexingPropertiesOverride;
+					pProps->sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+					pProps->pNext = pNext;
+					return;
+				}
+			}
+
+			const auto& limits = gPhysicalDeviceProperties.limits;
+			pProps->maxUpdateAfterBindDescriptorsInAllPools = 1u << 22;
+			pProps->shaderUniformBufferArrayNonUniformIndexingNative = VK_TRUE;
+			pProps->shaderSampledImageArrayNonUniformIndexingNative = VK_TRUE;
+			pProps->shaderStorageBufferArrayNonUniformIndexingNative = VK_TRUE;
+			pProps->shaderStorageImageArrayNonUniformIndexingNative = VK_TRUE;
+			pProps->shaderInputAttachmentArrayNonUniformIndexingNative = VK_TRUE;
+			pProps->robustBufferAccessUpdateAfterBind = VK_TRUE;
+			pProps->quadDivergentImplicitLod = VK_TRUE;
+			pProps->maxPerStageDescriptorUpdateAfterBindSamplers = limits.maxPerStageDescriptorSamplers;
+			pProps->maxPerStageDescriptorUpdateAfterBindUniformBuffers = limits.maxPerStageDescriptorUniformBuffers;
+			pProps->maxPerStageDescriptorUpdateAfterBindStorageBuffers = limits.maxPerStageDescriptorStorageBuffers;
+			pProps->maxPerStageDescriptorUpdateAfterBindSampledImages = limits.maxPerStageDescriptorSampledImages;
+			pProps->maxPerStageDescriptorUpdateAfterBindStorageImages = limits.maxPerStageDescriptorStorageImages;
+			pProps->maxPerStageDescriptorUpdateAfterBindInputAttachments = limits.maxPerStageDescriptorInputAttachments;
+			pProps->maxPerStageUpdateAfterBindResources = limits.maxPerStageResources;
+			pProps->maxDescriptorSetUpdateAfterBindSamplers = limits.maxDescriptorSetSamplers;
+			pProps->maxDescriptorSetUpdateAfterBindUniformBuffers = limits.maxDescriptorSetUniformBuffers;
+			pProps->maxDescriptorSetUpdateAfterBindUniformBuffersDynamic = limits.maxDescriptorSetUniformBuffersDynamic;
+			pProps->maxDescriptorSetUpdateAfterBindStorageBuffers = limits.maxDescriptorSetStorageBuffers;
+			pProps->maxDescriptorSetUpdateAfterBindStorageBuffersDynamic = limits.maxDescriptorSetStorageBuffersDynamic;
+			pProps->maxDescriptorSetUpdateAfterBindSampledImages = limits.maxDescriptorSetSampledImages;
+			pProps->maxDescriptorSetUpdateAfterBindStorageImages = limits.maxDescriptorSetStorageImages;
+			pProps->maxDescriptorSetUpdateAfterBindInputAttachments = limits.maxDescriptorSetInputAttachments;
+		}
+
+		VkMemoryRequirements GetBufferMemoryRequirements(const VkBufferCreateInfo& createInfo)
+		{
+			VkMemoryRequirements requirements = {};
+			requirements.alignment = 256;
+			requirements.size = (createInfo.size + requirements.alignment - 1) & ~(requirements.alignment - 1);
+			requirements.memoryTypeBits = kAllMemoryTypeBits;
+			return requirements;
+		}
+
+		VkMemoryRequirements GetImageMemoryRequirements(const VkImageCreateInfo& createInfo)
+		{
+			// no format table, assume the worst case of 16 bytes per texel, mip chain is bounded by 4/3 of the top mip
+			VkDeviceSize size = VkDeviceSize(createInfo.extent.width) * createInfo.extent.height * createInfo.extent.depth * createInfo.arrayLayers * 16u;
+			if (createInfo.mipLevels > 1)
+			{
+				size = size * 4u / 3u;
+			}
+
+			VkMemoryRequirements requirements = {};
+			requirements.alignment = 64u * 1024u;
+			requirements.size = (std::max<VkDeviceSize>(size, 1u) + requirements.alignment - 1) & ~(requirements.alignment - 1);
+			requirements.memoryTypeBits = kAllMemoryTypeBits;
+			return requirements;
+		}
+
+		void FillMemoryRequirements2(const VkMemoryRequirements& requirements, VkMemoryRequirements2* pRequirements)
+		{
+			pRequirements->memoryRequirements = requirements;
+			for (auto* pNext = static_cast<VkBaseOutStructure*>(pRequirements->pNext); pNext; pNext = pNext->pNext)
+			{
+				if (pNext->sType == VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS)
+				{
+					auto* pDedicated = reinterpret_cast<VkMemoryDedicatedRequirements*>(pNext);
+					pDedicated->prefersDedicatedAllocation = VK_FALSE;
+					pDedicated->requiresDedicatedAllocation = VK_FALSE;
+				}
+			}
+		}
+
+		template <typename TInfo>
+		const TInfo* FindInChain(const void* pNext, VkStructureType sType)
+		{
+			for (auto* pStruct = static_cast<const VkBaseInStructure*>(pNext); pStruct; pStruct = pStruct->pNext)
+			{
+				if (pStruct->sType == sType)
+				{
+					return reinterpret_cast<const TInfo*>(pStruct);
+				}
+			}
+			return nullptr;
+		}
+
+		void Record(VkCommandBuffer commandBuffer, std::string_view name, uint64_t arg0 = 0, uint64_t arg1 = 0, uint64_t arg2 = 0, uint64_t arg3 = 0)
+		{
+			auto* pCommandBuffer = FromHandle<CommandBuffer>(commandBuffer);
+			ZE_ASSERT_LOG(pCommandBuffer->m_IsRecording, "Null backend: vkCmd{} is recorded into a command buffer which is not recording!", name);
+
+			pCommandBuffer->m_Commands.push_back({ name, commandBuffer, { arg0, arg1, arg2, arg3 } });
+			GetDriver().m_RecordedCommandCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		uint64_t FloatBits(float value)
+		{
+			uint32_t bits = 0;
+			memcpy(&bits, &value, sizeof(float));
+			return bits;
+		}
+
+		uint64_t HandleBits(const void* pHandle)
+		{
+			return reinterpret_cast<uintptr_t>(pHandle);
+		}
+
+		void SignalSemaphoreLocked(VkSemaphore semaphore, uint64_t value)
+		{
+			auto* pSemaphore = FromHandle<Semaphore>(semaphore);
+			if (pSemaphore->m_IsTimeline)
+			{
+				ZE_ASSERT_LOG(value > pSemaphore->m_Value, "Null backend: timeline semaphore is signaled with {} which is not greater than its current value {}!", value, pSemaphore->m_Value);
+				pSemaphore->m_Value = value;
+			}
+			else
+			{
+				pSemaphore->m_Value = 1;
+			}
+		}
+
+		// every submission completes at once, so queries resolve with the submission time and zero statistics
+		void ExecuteQueryCommandsLocked(const CommandBuffer& commandBuffer)
+		{
+			for (const auto& command : commandBuffer.m_Commands)
+			{
+				if (command.m_Name == "ResetQueryPool"sv)
+				{
+					auto* pPool = reinterpret_cast<QueryPool*>(command.m_Args[0]);
+					std::fill_n(pPool->m_IsAvailable.begin() + command.m_Args[1], command.m_Args[2], false);
+				}
+				else if (command.m_Name == "WriteTimestamp"sv)
+				{
+					auto* pPool = reinterpret_cast<QueryPool*>(command.m_Args[0]);
+					const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch());
+					pPool->m_Values[command.m_Args[1]] = static_cast<uint64_t>(now.count());
+					pPool->m_IsAvailable[command.m_Args[1]] = true;
+				}
+				else if (command.m_Name == "EndQuery"sv)
+				{
+					auto* pPool = reinterpret_cast<QueryPool*>(command.m_Args[0]);
+					std::fill_n(pPool->m_Values.begin() + command.m_Args[1] * pPool->m_ValueCountPerQuery, pPool->m_ValueCountPerQuery, 0ull);
+					pPool->m_IsAvailable[command.m_Args[1]] = true;
+				}
+			}
+		}
+
+		void WaitSemaphoreLocked(VkSemaphore semaphore, uint64_t value)
+		{
+			auto* pSemaphore = FromHandle<Semaphore>(semaphore);
+			if (pSemaphore->m_IsTimeline)
+			{
+				// every submission completes at once, a wait on a value nobody signaled yet would hang a real GPU
+				if (pSemaphore->m_Value < value)
+				{
+					ZE_LOG_ERROR("Null backend: queue waits on timeline value {} but the semaphore is only at {}, this would deadlock on GPU!", value, pSemaphore->m_Value);
+				}
+			}
+			else
+			{
+				if (pSemaphore->m_Value == 0)
+				{
+					ZE_LOG_ERROR("Null backend: queue waits on a binary semaphore which has no pending signal, this would deadlock on GPU!");
+				}
+				pSemaphore->m_Value = 0;
+			}
+		}
+	}
+
+	std::vector<NullCommand> GetSubmittedCommands()
+	{
+		auto& driver = GetDriver();
+		std::scoped_lock lock(driver.m_Mutex);
+		return { driver.m_SubmittedCommands.begin(), driver.m_SubmittedCommands.end() };
+	}
+
+	void ClearSubmittedCommands()
+	{
+		auto& driver = GetDriver();
+		std::scoped_lock lock(driver.m_Mutex);
+		driver.m_SubmittedCommands.clear();
+	}
+
+	std::vector<NullCommand> GetRecordedCommands(VkCommandBuffer commandBuffer)
+	{
+		auto& driver = GetDriver();
+		std::scoped_lock lock(driver.m_Mutex);
+		return FromHandle<CommandBuffer>(commandBuffer)->m_Commands;
+	}
+
+	void SetDescriptorIndexingProperties(const VkPhysicalDeviceDescriptorIndexingProperties* pProperties)
+	{
+		auto& driver = GetDriver();
+		std::scoped_lock lock(driver.m_Mutex);
+		driver.m_DescriptorIndexingPropertiesOverride.reset();
+		if (pProperties)
+		{
+			driver.m_DescriptorIndexingPropertiesOverride = *pProperties;
+		}
+	}
+
+	VkDescriptorBufferInfo GetDescriptorBufferInfo(VkDescriptorSet set, uint32_t binding)
+	{
+		auto& driver = GetDriver();
+		std::scoped_lock lock(driver.m_Mutex);
+
+		const auto* pSet = FromHandle<DescriptorSet>(set);
+		if (auto iter = pSet->m_BufferInfos.find(binding); iter != pSet->m_BufferInfos.end())
+		{
+			return iter->second;
+		}
+		return {};
+	}
+
+	NullStatistics GetStatistics()
+	{
+		const auto& driver = GetDriver();
+
+		NullStatistics statistics;
+		statistics.m_LiveObjectCount = driver.m_LiveObjectCount.load(std::memory_order_relaxed);
+		statistics.m_CreatedObjectCount = driver.m_CreatedObjectCount.load(std::memory_order_relaxed);
+		statistics.m_LiveDeviceMemoryInByte = driver.m_LiveDeviceMemoryInByte.load(std::memory_order_relaxed);
+		statistics.m_QueueSubmitCount = driver.m_QueueSubmitCount.load(std::memory_order_relaxed);
+		statistics.m_SubmittedCommandBufferCount = driver.m_SubmittedCommandBufferCount.load(std::memory_order_relaxed);
+		statistics.m_RecordedCommandCount = driver.m_RecordedCommandCount.load(std::memory_order_relaxed);
+		statistics.m_DescriptorWriteCount = driver.m_DescriptorWriteCount.load(std::memory_order_relaxed);
+		statistics.m_PresentCount = driver.m_PresentCount.load(std::memory_order_relaxed);
+		return statistics;
+	}
+}
+
+//-------------------------------------------------------------------------
+// Vulkan entry points, they keep the C linkage of their declarations in vulkan_core.h
+//-------------------------------------------------------------------------
+
+using namespace ZE::RenderBackend::Null;
+
+//-------------------------------------------------------------------------
+// Instance and physical device
+//-------------------------------------------------------------------------
+
+VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceExtensionProperties(const char* pLayerName, uint32_t* pPropertyCount, VkExtensionProperties* pProperties)
+{
+	return Enumerate(gInstanceExtensions, pPropertyCount, pProperties);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceLayerProperties(uint32_t* pPropertyCount, VkLayerProperties* pProperties)
+{
+	return Enumerate(gLayers, pPropertyCount, pProperties);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceVersion(uint32_t* pApiVersion)
+{
+	*pApiVersion = VK_API_VERSION_1_3;
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkInstance* pInstance)
+{
+	return CreateObject<Instance>(pInstance);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyInstance(VkInstance instance, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<Instance>(instance);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDevices(VkInstance instance, uint32_t* pPhysicalDeviceCount, VkPhysicalDevice* pPhysicalDevices)
+{
+	const std::array physicalDevices = { ToHandle<VkPhysicalDevice>(&FromHandle<Instance>(instance)->m_PhysicalDevice) };
+	return Enumerate(physicalDevices, pPhysicalDeviceCount, pPhysicalDevices);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceProperties(VkPhysicalDevice physicalDevice, VkPhysicalDeviceProperties* pProperties)
+{
+	*pProperties = gPhysicalDeviceProperties;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceProperties2(VkPhysicalDevice physicalDevice, VkPhysicalDeviceProperties2* pProperties)
+{
+	pProperties->properties = gPhysicalDeviceProperties;
+
+	for (auto* pNext = static_cast<VkBaseOutStructure*>(pProperties->pNext); pNext; pNext = pNext->pNext)
+	{
+		switch (pNext->sType)
+		{
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES: FillDescriptorIndexingProperties(reinterpret_cast<VkPhysicalDeviceDescriptorIndexingProperties*>(pNext)); break;
+		default: break;
+		}
+	}
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceFeatures(VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures* pFeatures)
+{
+	EnableAllCoreFeatures(pFeatures);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceFeatures2(VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures2* pFeatures)
+{
+	EnableAllCoreFeatures(&pFeatures->features);
+
+	for (auto* pNext = static_cast<VkBaseOutStructure*>(pFeatures->pNext); pNext; pNext = pNext->pNext)
+	{
+		switch (pNext->sType)
+		{
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES: EnableAllFeatures(reinterpret_cast<VkPhysicalDeviceVulkan11Features*>(pNext)); break;
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES: EnableAllFeatures(reinterpret_cast<VkPhysicalDeviceVulkan12Features*>(pNext)); break;
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES: EnableAllFeatures(reinterpret_cast<VkPhysicalDeviceVulkan13Features*>(pNext)); break;
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES: EnableAllFeatures(reinterpret_cast<VkPhysicalDeviceDescriptorIndexingFeatures*>(pNext)); break;
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES: EnableAllFeatures(reinterpret_cast<VkPhysicalDeviceDynamicRenderingFeatures*>(pNext)); break;
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES: EnableAllFeatures(reinterpret_cast<VkPhysicalDeviceTimelineSemaphoreFeatures*>(pNext)); break;
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES: EnableAllFeatures(reinterpret_cast<VkPhysicalDeviceBufferDeviceAddressFeatures*>(pNext)); break;
+		case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES: EnableAllFeatures(reinterpret_cast<VkPhysicalDeviceSynchronization2Features*>(pNext)); break;
+		default: break;
+		}
+	}
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceMemoryProperties(VkPhysicalDevice physicalDevice, VkPhysicalDeviceMemoryProperties* pMemoryProperties)
+{
+	*pMemoryProperties = gPhysicalDeviceMemoryProperties;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceMemoryProperties2(VkPhysicalDevice physicalDevice, VkPhysicalDeviceMemoryProperties2* pMemoryProperties)
+{
+	pMemoryProperties->memoryProperties = gPhysicalDeviceMemoryProperties;
+
+	for (auto* pNext = static_cast<VkBaseOutStructure*>(pMemoryProperties->pNext); pNext; pNext = pNext->pNext)
+	{
+		if (pNext->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT)
+		{
+			auto* pBudget = reinterpret_cast<VkPhysicalDeviceMemoryBudgetPropertiesEXT*>(pNext);
+			for (uint32_t i = 0; i < gPhysicalDeviceMemoryProperties.memoryHeapCount; ++i)
+			{
+				pBudget->heapBudget[i] = gPhysicalDeviceMemoryProperties.memoryHeaps[i].size;
+				pBudget->heapUsage[i] = GetDriver().m_HeapUsageInByte[i].load(std::memory_order_relaxed);
+			}
+		}
+	}
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceQueueFamilyProperties(VkPhysicalDevice physicalDevice, uint32_t* pQueueFamilyPropertyCount, VkQueueFamilyProperties* pQueueFamilyProperties)
+{
+	Enumerate(gQueueFamilies, pQueueFamilyPropertyCount, pQueueFamilyProperties);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateDeviceExtensionProperties(VkPhysicalDevice physicalDevice, const char* pLayerName, uint32_t* pPropertyCount, VkExtensionProperties* pProperties)
+{
+	return Enumerate(gDeviceExtensions, pPropertyCount, pProperties);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateDeviceLayerProperties(VkPhysicalDevice physicalDevice, uint32_t* pPropertyCount, VkLayerProperties* pProperties)
+{
+	return Enumerate(gLayers, pPropertyCount, pProperties);
+}
+
+//-------------------------------------------------------------------------
+// Debug utils
+//-------------------------------------------------------------------------
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateDebugUtilsMessengerEXT(VkInstance instance, const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDebugUtilsMessengerEXT* pMessenger)
+{
+	return CreateObject<DebugMessenger>(pMessenger);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMessengerEXT messenger, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<DebugMessenger>(messenger);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkSetDebugUtilsObjectNameEXT(VkDevice device, const VkDebugUtilsObjectNameInfoEXT* pNameInfo)
+{
+	return VK_SUCCESS;
+}
+
+//-------------------------------------------------------------------------
+// Surface and swapchain
+//-------------------------------------------------------------------------
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateHeadlessSurfaceEXT(VkInstance instance, const VkHeadlessSurfaceCreateInfoEXT* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkSurfaceKHR* pSurface)
+{
+	return CreateObject<Surface>(pSurface);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroySurfaceKHR(VkInstance instance, VkSurfaceKHR surface, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<Surface>(surface);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetPhysicalDeviceSurfaceSupportKHR(VkPhysicalDevice physicalDevice, uint32_t queueFamilyIndex, VkSurfaceKHR surface, VkBool32* pSupported)
+{
+	*pSupported = queueFamilyIndex == kGraphicQueueFamilyIndex ? VK_TRUE : VK_FALSE;
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetPhysicalDeviceSurfaceCapabilitiesKHR(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, VkSurfaceCapabilitiesKHR* pSurfaceCapabilities)
+{
+	*pSurfaceCapabilities = {};
+	pSurfaceCapabilities->minImageCount = 2;
+	pSurfaceCapabilities->maxImageCount = 8;
+	pSurfaceCapabilities->currentExtent = { kDefaultSurfaceWidth, kDefaultSurfaceHeight };
+	pSurfaceCapabilities->minImageExtent = { 1, 1 };
+	pSurfaceCapabilities->maxImageExtent = { gPhysicalDeviceProperties.limits.maxImageDimension2D, gPhysicalDeviceProperties.limits.maxImageDimension2D };
+	pSurfaceCapabilities->maxImageArrayLayers = 1;
+	pSurfaceCapabilities->supportedTransforms = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+	pSurfaceCapabilities->currentTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+	pSurfaceCapabilities->supportedCompositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+	pSurfaceCapabilities->supportedUsageFlags = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetPhysicalDeviceSurfaceFormatsKHR(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, uint32_t* pSurfaceFormatCount, VkSurfaceFormatKHR* pSurfaceFormats)
+{
+	return Enumerate(gSurfaceFormats, pSurfaceFormatCount, pSurfaceFormats);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetPhysicalDeviceSurfacePresentModesKHR(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, uint32_t* pPresentModeCount, VkPresentModeKHR* pPresentModes)
+{
+	return Enumerate(gPresentModes, pPresentModeCount, pPresentModes);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateSwapchainKHR(VkDevice device, const VkSwapchainCreateInfoKHR* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkSwapchainKHR* pSwapchain)
+{
+	auto* pNewSwapchain = new Swapchain();
+	for (uint32_t i = 0; i < std::max(pCreateInfo->minImageCount, 1u); ++i)
+	{
+		auto& pImage = pNewSwapchain->m_Images.emplace_back(std::make_unique<Image>());
+		pImage->m_CreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		pImage->m_CreateInfo.imageType = VK_IMAGE_TYPE_2D;
+		pImage->m_CreateInfo.format = pCreateInfo->imageFormat;
+		pImage->m_CreateInfo.extent = { pCreateInfo->imageExtent.width, pCreateInfo->imageExtent.height, 1 };
+		pImage->m_CreateInfo.mipLevels = 1;
+		pImage->m_CreateInfo.arrayLayers = pCreateInfo->imageArrayLayers;
+		pImage->m_CreateInfo.usage = pCreateInfo->imageUsage;
+	}
+
+	*pSwapchain = ToHandle<VkSwapchainKHR>(pNewSwapchain);
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroySwapchainKHR(VkDevice device, VkSwapchainKHR swapchain, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<Swapchain>(swapchain);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetSwapchainImagesKHR(VkDevice device, VkSwapchainKHR swapchain, uint32_t* pSwapchainImageCount, VkImage* pSwapchainImages)
+{
+	const auto& images = FromHandle<Swapchain>(swapchain)->m_Images;
+	if (!pSwapchainImages)
+	{
+		*pSwapchainImageCount = static_cast<uint32_t>(images.size());
+		return VK_SUCCESS;
+	}
+
+	const uint32_t count = std::min(*pSwapchainImageCount, static_cast<uint32_t>(images.size()));
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		pSwapchainImages[i] = ToHandle<VkImage>(images[i].get());
+	}
+	*pSwapchainImageCount = count;
+	return count < images.size() ? VK_INCOMPLETE : VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAcquireNextImageKHR(VkDevice device, VkSwapchainKHR swapchain, uint64_t timeout, VkSemaphore semaphore, VkFence fence, uint32_t* pImageIndex)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	auto* pSwapchain = FromHandle<Swapchain>(swapchain);
+	*pImageIndex = pSwapchain->m_NextImageIndex;
+	pSwapchain->m_NextImageIndex = (pSwapchain->m_NextImageIndex + 1) % static_cast<uint32_t>(pSwapchain->m_Images.size());
+
+	// the image is available at once
+	if (semaphore)
+	{
+		SignalSemaphoreLocked(semaphore, 1);
+	}
+	if (fence)
+	{
+		FromHandle<Fence>(fence)->m_IsSignaled = true;
+	}
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR* pPresentInfo)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	for (uint32_t i = 0; i < pPresentInfo->waitSemaphoreCount; ++i)
+	{
+		WaitSemaphoreLocked(pPresentInfo->pWaitSemaphores[i], 1);
+	}
+
+	if (pPresentInfo->pResults)
+	{
+		std::fill_n(pPresentInfo->pResults, pPresentInfo->swapchainCount, VK_SUCCESS);
+	}
+	driver.m_PresentCount.fetch_add(pPresentInfo->swapchainCount, std::memory_order_relaxed);
+	return VK_SUCCESS;
+}
+
+//-------------------------------------------------------------------------
+// Device and queues
+//-------------------------------------------------------------------------
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateDevice(VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDevice* pDevice)
+{
+	return CreateObject<Device>(pDevice);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyDevice(VkDevice device, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<Device>(device);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkDeviceWaitIdle(VkDevice device)
+{
+	// every submission had completed when it was submitted
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetDeviceQueue(VkDevice device, uint32_t queueFamilyIndex, uint32_t queueIndex, VkQueue* pQueue)
+{
+	ZE_ASSERT(queueFamilyIndex < gQueueFamilies.size() && queueIndex < kQueueCountPerFamily);
+
+	auto* pDevice = FromHandle<Device>(device);
+	std::scoped_lock lock(pDevice->m_QueueMutex);
+
+	auto& pQueueObject = pDevice->m_Queues[(uint64_t(queueFamilyIndex) << 32) | queueIndex];
+	if (!pQueueObject)
+	{
+		pQueueObject = std::make_unique<Queue>();
+	}
+	*pQueue = ToHandle<VkQueue>(pQueueObject.get());
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo* pSubmits, VkFence fence)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	for (uint32_t i = 0; i < submitCount; ++i)
+	{
+		const VkSubmitInfo& submit = pSubmits[i];
+		const auto* pTimelineInfo = FindInChain<VkTimelineSemaphoreSubmitInfo>(submit.pNext, VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO);
+
+		for (uint32_t w = 0; w < submit.waitSemaphoreCount; ++w)
+		{
+			const bool bHasValue = pTimelineInfo && pTimelineInfo->pWaitSemaphoreValues && w < pTimelineInfo->waitSemaphoreValueCount;
+			WaitSemaphoreLocked(submit.pWaitSemaphores[w], bHasValue ? pTimelineInfo->pWaitSemaphoreValues[w] : 1);
+		}
+
+		for (uint32_t c = 0; c < submit.commandBufferCount; ++c)
+		{
+			auto* pCommandBuffer = FromHandle<CommandBuffer>(submit.pCommandBuffers[c]);
+			ZE_ASSERT_LOG(!pCommandBuffer->m_IsRecording, "Null backend: command buffer is submitted while it is still recording!");
+
+			driver.m_SubmittedCommands.insert(driver.m_SubmittedCommands.end(), pCommandBuffer->m_Commands.begin(), pCommandBuffer->m_Commands.end());
+			if (pCommandBuffer->m_HasQueryCommands)
+			{
+				ExecuteQueryCommandsLocked(*pCommandBuffer);
+			}
+		}
+		driver.m_SubmittedCommandBufferCount.fetch_add(submit.commandBufferCount, std::memory_order_relaxed);
+
+		for (uint32_t s = 0; s < submit.signalSemaphoreCount; ++s)
+		{
+			const bool bHasValue = pTimelineInfo && pTimelineInfo->pSignalSemaphoreValues && s < pTimelineInfo->signalSemaphoreValueCount;
+			SignalSemaphoreLocked(submit.pSignalSemaphores[s], bHasValue ? pTimelineInfo->pSignalSemaphoreValues[s] : 1);
+		}
+	}
+
+	if (driver.m_SubmittedCommands.size() > kMaxSubmittedCommandCount)
+	{
+		driver.m_SubmittedCommands.erase(driver.m_SubmittedCommands.begin(), driver.m_SubmittedCommands.end() - kMaxSubmittedCommandCount);
+	}
+
+	if (fence)
+	{
+		FromHandle<Fence>(fence)->m_IsSignaled = true;
+	}
+
+	driver.m_QueueSubmitCount.fetch_add(1, std::memory_order_relaxed);
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkQueueWaitIdle(VkQueue queue)
+{
+	return VK_SUCCESS;
+}
+
+//-------------------------------------------------------------------------
+// Synchronization
+//-------------------------------------------------------------------------
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateSemaphore(VkDevice device, const VkSemaphoreCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkSemaphore* pSemaphore)
+{
+	auto* pNewSemaphore = new Semaphore();
+	if (const auto* pTypeInfo = FindInChain<VkSemaphoreTypeCreateInfo>(pCreateInfo->pNext, VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO))
+	{
+		pNewSemaphore->m_IsTimeline = pTypeInfo->semaphoreType == VK_SEMAPHORE_TYPE_TIMELINE;
+		pNewSemaphore->m_Value = pNewSemaphore->m_IsTimeline ? pTypeInfo->initialValue : 0;
+	}
+
+	*pSemaphore = ToHandle<VkSemaphore>(pNewSemaphore);
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroySemaphore(VkDevice device, VkSemaphore semaphore, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<Semaphore>(semaphore);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetSemaphoreCounterValue(VkDevice device, VkSemaphore semaphore, uint64_t* pValue)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	*pValue = FromHandle<Semaphore>(semaphore)->m_Value;
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkSignalSemaphore(VkDevice device, const VkSemaphoreSignalInfo* pSignalInfo)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	SignalSemaphoreLocked(pSignalInfo->semaphore, pSignalInfo->value);
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkWaitSemaphores(VkDevice device, const VkSemaphoreWaitInfo* pWaitInfo, uint64_t timeout)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	// nothing is in flight, so a value which is not reached now will never be reached
+	const bool bWaitAny = (pWaitInfo->flags & VK_SEMAPHORE_WAIT_ANY_BIT) != 0;
+	uint32_t reachedCount = 0;
+	for (uint32_t i = 0; i < pWaitInfo->semaphoreCount; ++i)
+	{
+		if (FromHandle<Semaphore>(pWaitInfo->pSemaphores[i])->m_Value >= pWaitInfo->pValues[i])
+		{
+			++reachedCount;
+		}
+	}
+
+	const bool bReached = bWaitAny ? reachedCount > 0 : reachedCount == pWaitInfo->semaphoreCount;
+	return bReached ? VK_SUCCESS : VK_TIMEOUT;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateFence(VkDevice device, const VkFenceCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkFence* pFence)
+{
+	auto* pNewFence = new Fence();
+	pNewFence->m_IsSignaled = (pCreateInfo->flags & VK_FENCE_CREATE_SIGNALED_BIT) != 0;
+
+	*pFence = ToHandle<VkFence>(pNewFence);
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyFence(VkDevice device, VkFence fence, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<Fence>(fence);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetFenceStatus(VkDevice device, VkFence fence)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	return FromHandle<Fence>(fence)->m_IsSignaled ? VK_SUCCESS : VK_NOT_READY;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkWaitForFences(VkDevice device, uint32_t fenceCount, const VkFence* pFences, VkBool32 waitAll, uint64_t timeout)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	const auto signaledCount = std::ranges::count_if(pFences, pFences + fenceCount, [](VkFence fence)
+	{
+		return FromHandle<Fence>(fence)->m_IsSignaled;
+	});
+
+	const bool bReached = waitAll ? signaledCount == fenceCount : signaledCount > 0;
+	return bReached ? VK_SUCCESS : VK_TIMEOUT;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkResetFences(VkDevice device, uint32_t fenceCount, const VkFence* pFences)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	for (uint32_t i = 0; i < fenceCount; ++i)
+	{
+		FromHandle<Fence>(pFences[i])->m_IsSignaled = false;
+	}
+	return VK_SUCCESS;
+}
+
+//-------------------------------------------------------------------------
+// Memory and resources
+//-------------------------------------------------------------------------
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateMemory(VkDevice device, const VkMemoryAllocateInfo* pAllocateInfo, const VkAllocationCallbacks* pAllocator, VkDeviceMemory* pMemory)
+{
+	ZE_ASSERT(pAllocateInfo->memoryTypeIndex < gPhysicalDeviceMemoryProperties.memoryTypeCount);
+
+	auto* pNewMemory = new DeviceMemory();
+	pNewMemory->m_Size = pAllocateInfo->allocationSize;
+	pNewMemory->m_HeapIndex = gPhysicalDeviceMemoryProperties.memoryTypes[pAllocateInfo->memoryTypeIndex].heapIndex;
+
+	auto& driver = GetDriver();
+	driver.m_LiveDeviceMemoryInByte.fetch_add(pNewMemory->m_Size, std::memory_order_relaxed);
+	driver.m_HeapUsageInByte[pNewMemory->m_HeapIndex].fetch_add(pNewMemory->m_Size, std::memory_order_relaxed);
+
+	*pMemory = ToHandle<VkDeviceMemory>(pNewMemory);
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkFreeMemory(VkDevice device, VkDeviceMemory memory, const VkAllocationCallbacks* pAllocator)
+{
+	if (!memory)
+	{
+		return;
+	}
+
+	auto* pMemory = FromHandle<DeviceMemory>(memory);
+	auto& driver = GetDriver();
+	driver.m_LiveDeviceMemoryInByte.fetch_sub(pMemory->m_Size, std::memory_order_relaxed);
+	driver.m_HeapUsageInByte[pMemory->m_HeapIndex].fetch_sub(pMemory->m_Size, std::memory_order_relaxed);
+
+	delete pMemory;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkMapMemory(VkDevice device, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize size, VkMemoryMapFlags flags, void** ppData)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	auto* pMemory = FromHandle<DeviceMemory>(memory);
+	if (!pMemory->m_HostMemory)
+	{
+		pMemory->m_HostMemory = std::make_unique_for_overwrite<std::byte[]>(pMemory->m_Size);
+	}
+
+	*ppData = pMemory->m_HostMemory.get() + offset;
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkUnmapMemory(VkDevice device, VkDeviceMemory memory)
+{
+	// keep the host backing, the content must survive the next map
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkFlushMappedMemoryRanges(VkDevice device, uint32_t memoryRangeCount, const VkMappedMemoryRange* pMemoryRanges)
+{
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkInvalidateMappedMemoryRanges(VkDevice device, uint32_t memoryRangeCount, const VkMappedMemoryRange* pMemoryRanges)
+{
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateBuffer(VkDevice device, const VkBufferCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkBuffer* pBuffer)
+{
+	auto* pNewBuffer = new Buffer();
+	pNewBuffer->m_Size = pCreateInfo->size;
+
+	*pBuffer = ToHandle<VkBuffer>(pNewBuffer);
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyBuffer(VkDevice device, VkBuffer buffer, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<Buffer>(buffer);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateImage(VkDevice device, const VkImageCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkImage* pImage)
+{
+	auto* pNewImage = new Image();
+	pNewImage->m_CreateInfo = *pCreateInfo;
+	pNewImage->m_CreateInfo.pNext = nullptr;
+	pNewImage->m_CreateInfo.pQueueFamilyIndices = nullptr;
+
+	*pImage = ToHandle<VkImage>(pNewImage);
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyImage(VkDevice device, VkImage image, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<Image>(image);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetBufferMemoryRequirements(VkDevice device, VkBuffer buffer, VkMemoryRequirements* pMemoryRequirements)
+{
+	VkBufferCreateInfo createInfo = {};
+	createInfo.size = FromHandle<Buffer>(buffer)->m_Size;
+	*pMemoryRequirements = GetBufferMemoryRequirements(createInfo);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetBufferMemoryRequirements2(VkDevice device, const VkBufferMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements)
+{
+	VkMemoryRequirements requirements = {};
+	vkGetBufferMemoryRequirements(device, pInfo->buffer, &requirements);
+	FillMemoryRequirements2(requirements, pMemoryRequirements);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetDeviceBufferMemoryRequirements(VkDevice device, const VkDeviceBufferMemoryRequirements* pInfo, VkMemoryRequirements2* pMemoryRequirements)
+{
+	FillMemoryRequirements2(GetBufferMemoryRequirements(*pInfo->pCreateInfo), pMemoryRequirements);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetImageMemoryRequirements(VkDevice device, VkImage image, VkMemoryRequirements* pMemoryRequirements)
+{
+	*pMemoryRequirements = GetImageMemoryRequirements(FromHandle<Image>(image)->m_CreateInfo);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetImageMemoryRequirements2(VkDevice device, const VkImageMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements)
+{
+	FillMemoryRequirements2(GetImageMemoryRequirements(FromHandle<Image>(pInfo->image)->m_CreateInfo), pMemoryRequirements);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetDeviceImageMemoryRequirements(VkDevice device, const VkDeviceImageMemoryRequirements* pInfo, VkMemoryRequirements2* pMemoryRequirements)
+{
+	FillMemoryRequirements2(GetImageMemoryRequirements(*pInfo->pCreateInfo), pMemoryRequirements);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkBindBufferMemory(VkDevice device, VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize memoryOffset)
+{
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkBindBufferMemory2(VkDevice device, uint32_t bindInfoCount, const VkBindBufferMemoryInfo* pBindInfos)
+{
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkBindImageMemory(VkDevice device, VkImage image, VkDeviceMemory memory, VkDeviceSize memoryOffset)
+{
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkBindImageMemory2(VkDevice device, uint32_t bindInfoCount, const VkBindImageMemoryInfo* pBindInfos)
+{
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateImageView(VkDevice device, const VkImageViewCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkImageView* pView)
+{
+	return CreateObject<ImageView>(pView);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyImageView(VkDevice device, VkImageView imageView, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<ImageView>(imageView);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateSampler(VkDevice device, const VkSamplerCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkSampler* pSampler)
+{
+	return CreateObject<Sampler>(pSampler);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroySampler(VkDevice device, VkSampler sampler, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<Sampler>(sampler);
+}
+
+//-------------------------------------------------------------------------
+// Pipelines and descriptors
+//-------------------------------------------------------------------------
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkShaderModule* pShaderModule)
+{
+	return CreateObject<ShaderModule>(pShaderModule);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyShaderModule(VkDevice device, VkShaderModule shaderModule, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<ShaderModule>(shaderModule);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreatePipelineLayout(VkDevice device, const VkPipelineLayoutCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkPipelineLayout* pPipelineLayout)
+{
+	return CreateObject<PipelineLayout>(pPipelineLayout);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyPipelineLayout(VkDevice device, VkPipelineLayout pipelineLayout, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<PipelineLayout>(pipelineLayout);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCache, uint32_t createInfoCount, const VkGraphicsPipelineCreateInfo* pCreateInfos, const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines)
+{
+	for (uint32_t i = 0; i < createInfoCount; ++i)
+	{
+		CreateObject<Pipeline>(&pPipelines[i]);
+	}
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyPipeline(VkDevice device, VkPipeline pipeline, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<Pipeline>(pipeline);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateDescriptorSetLayout(VkDevice device, const VkDescriptorSetLayoutCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDescriptorSetLayout* pSetLayout)
+{
+	return CreateObject<DescriptorSetLayout>(pSetLayout);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyDescriptorSetLayout(VkDevice device, VkDescriptorSetLayout descriptorSetLayout, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<DescriptorSetLayout>(descriptorSetLayout);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateDescriptorPool(VkDevice device, const VkDescriptorPoolCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDescriptorPool* pDescriptorPool)
+{
+	auto* pNewPool = new DescriptorPool();
+	pNewPool->m_MaxSetCount = pCreateInfo->maxSets;
+
+	*pDescriptorPool = ToHandle<VkDescriptorPool>(pNewPool);
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkResetDescriptorPool(VkDevice device, VkDescriptorPool descriptorPool, VkDescriptorPoolResetFlags flags)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	auto* pPool = FromHandle<DescriptorPool>(descriptorPool);
+	for (auto* pSet : pPool->m_Sets)
+	{
+		delete pSet;
+	}
+	pPool->m_Sets.clear();
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyDescriptorPool(VkDevice device, VkDescriptorPool descriptorPool, const VkAllocationCallbacks* pAllocator)
+{
+	if (!descriptorPool)
+	{
+		return;
+	}
+
+	vkResetDescriptorPool(device, descriptorPool, 0);
+	DestroyObject<DescriptorPool>(descriptorPool);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateDescriptorSets(VkDevice device, const VkDescriptorSetAllocateInfo* pAllocateInfo, VkDescriptorSet* pDescriptorSets)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	auto* pPool = FromHandle<DescriptorPool>(pAllocateInfo->descriptorPool);
+	if (pPool->m_Sets.size() + pAllocateInfo->descriptorSetCount > pPool->m_MaxSetCount)
+	{
+		return VK_ERROR_OUT_OF_POOL_MEMORY;
+	}
+
+	for (uint32_t i = 0; i < pAllocateInfo->descriptorSetCount; ++i)
+	{
+		auto* pSet = new DescriptorSet();
+		pSet->m_Pool = pPool;
+		pPool->m_Sets.push_back(pSet);
+		pDescriptorSets[i] = ToHandle<VkDescriptorSet>(pSet);
+	}
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkFreeDescriptorSets(VkDevice device, VkDescriptorPool descriptorPool, uint32_t descriptorSetCount, const VkDescriptorSet* pDescriptorSets)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	auto* pPool = FromHandle<DescriptorPool>(descriptorPool);
+	for (uint32_t i = 0; i < descriptorSetCount; ++i)
+	{
+		auto* pSet = FromHandle<DescriptorSet>(pDescriptorSets[i]);
+		if (!pSet)
+		{
+			continue;
+		}
+
+		std::erase(pPool->m_Sets, pSet);
+		delete pSet;
+	}
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkUpdateDescriptorSets(VkDevice device, uint32_t descriptorWriteCount, const VkWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const VkCopyDescriptorSet* pDescriptorCopies)
+{
+	auto& driver = GetDriver();
+	driver.m_DescriptorWriteCount.fetch_add(descriptorWriteCount, std::memory_order_relaxed);
+
+	std::scoped_lock lock(driver.m_Mutex);
+	for (uint32_t i = 0; i < descriptorWriteCount; ++i)
+	{
+		const auto& write = pDescriptorWrites[i];
+		if (!write.pBufferInfo)
+		{
+			continue;
+		}
+
+		auto* pSet = FromHandle<DescriptorSet>(write.dstSet);
+		for (uint32_t j = 0; j < write.descriptorCount; ++j)
+		{
+			pSet->m_BufferInfos[write.dstBinding + write.dstArrayElement + j] = write.pBufferInfo[j];
+		}
+	}
+}
+
+//-------------------------------------------------------------------------
+// Command pools and buffers
+//-------------------------------------------------------------------------
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateCommandPool(VkDevice device, const VkCommandPoolCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkCommandPool* pCommandPool)
+{
+	return CreateObject<CommandPool>(pCommandPool);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyCommandPool(VkDevice device, VkCommandPool commandPool, const VkAllocationCallbacks* pAllocator)
+{
+	if (!commandPool)
+	{
+		return;
+	}
+
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	auto* pPool = FromHandle<CommandPool>(commandPool);
+	for (auto* pCommandBuffer : pPool->m_CommandBuffers)
+	{
+		delete pCommandBuffer;
+	}
+	delete pPool;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkResetCommandPool(VkDevice device, VkCommandPool commandPool, VkCommandPoolResetFlags flags)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	for (auto* pCommandBuffer : FromHandle<CommandPool>(commandPool)->m_CommandBuffers)
+	{
+		pCommandBuffer->m_Commands.clear();
+		pCommandBuffer->m_HasQueryCommands = false;
+		pCommandBuffer->m_IsRecording = false;
+	}
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateCommandBuffers(VkDevice device, const VkCommandBufferAllocateInfo* pAllocateInfo, VkCommandBuffer* pCommandBuffers)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	auto* pPool = FromHandle<CommandPool>(pAllocateInfo->commandPool);
+	for (uint32_t i = 0; i < pAllocateInfo->commandBufferCount; ++i)
+	{
+		auto* pCommandBuffer = new CommandBuffer();
+		pCommandBuffer->m_Pool = pPool;
+		pPool->m_CommandBuffers.push_back(pCommandBuffer);
+		pCommandBuffers[i] = ToHandle<VkCommandBuffer>(pCommandBuffer);
+	}
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkFreeCommandBuffers(VkDevice device, VkCommandPool commandPool, uint32_t commandBufferCount, const VkCommandBuffer* pCommandBuffers)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	auto* pPool = FromHandle<CommandPool>(commandPool);
+	for (uint32_t i = 0; i < commandBufferCount; ++i)
+	{
+		auto* pCommandBuffer = FromHandle<CommandBuffer>(pCommandBuffers[i]);
+		if (!pCommandBuffer)
+		{
+			continue;
+		}
+
+		std::erase(pPool->m_CommandBuffers, pCommandBuffer);
+		delete pCommandBuffer;
+	}
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkBeginCommandBuffer(VkCommandBuffer commandBuffer, const VkCommandBufferBeginInfo* pBeginInfo)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	// begin implicitly resets the command buffer
+	auto* pCommandBuffer = FromHandle<CommandBuffer>(commandBuffer);
+	pCommandBuffer->m_Commands.clear();
+	pCommandBuffer->m_HasQueryCommands = false;
+	pCommandBuffer->m_IsRecording = true;
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkEndCommandBuffer(VkCommandBuffer commandBuffer)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	FromHandle<CommandBuffer>(commandBuffer)->m_IsRecording = false;
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkResetCommandBuffer(VkCommandBuffer commandBuffer, VkCommandBufferResetFlags flags)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	auto* pCommandBuffer = FromHandle<CommandBuffer>(commandBuffer);
+	pCommandBuffer->m_Commands.clear();
+	pCommandBuffer->m_HasQueryCommands = false;
+	pCommandBuffer->m_IsRecording = false;
+	return VK_SUCCESS;
+}
+
+//-------------------------------------------------------------------------
+// Queries
+//-------------------------------------------------------------------------
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateQueryPool(VkDevice device, const VkQueryPoolCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkQueryPool* pQueryPool)
+{
+	auto* pNewPool = new QueryPool();
+	pNewPool->m_Type = pCreateInfo->queryType;
+	pNewPool->m_ValueCountPerQuery = pCreateInfo->queryType == VK_QUERY_TYPE_PIPELINE_STATISTICS ? std::max(std::popcount(pCreateInfo->pipelineStatistics), 1) : 1u;
+	pNewPool->m_Values.resize(static_cast<size_t>(pCreateInfo->queryCount) * pNewPool->m_ValueCountPerQuery);
+	pNewPool->m_IsAvailable.resize(pCreateInfo->queryCount);
+
+	*pQueryPool = ToHandle<VkQueryPool>(pNewPool);
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyQueryPool(VkDevice device, VkQueryPool queryPool, const VkAllocationCallbacks* pAllocator)
+{
+	DestroyObject<QueryPool>(queryPool);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetQueryPoolResults(VkDevice device, VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount, size_t dataSize, void* pData, VkDeviceSize stride, VkQueryResultFlags flags)
+{
+	auto& driver = GetDriver();
+	std::scoped_lock lock(driver.m_Mutex);
+
+	const auto* pPool = FromHandle<QueryPool>(queryPool);
+	ZE_ASSERT(firstQuery + queryCount <= pPool->m_IsAvailable.size());
+
+	const bool b64Bit = (flags & VK_QUERY_RESULT_64_BIT) != 0;
+	const bool bWithAvailability = (flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) != 0;
+	const size_t valueSize = b64Bit ? sizeof(uint64_t) : sizeof(uint32_t);
+
+	VkResult result = VK_SUCCESS;
+	for (uint32_t i = 0; i < queryCount; ++i)
+	{
+		const uint32_t query = firstQuery + i;
+		auto* pDst = static_cast<std::byte*>(pData) + i * stride;
+		ZE_ASSERT(i * stride + (pPool->m_ValueCountPerQuery + (bWithAvailability ? 1u : 0u)) * valueSize <= dataSize);
+
+		const bool bAvailable = pPool->m_IsAvailable[query];
+		if (!bAvailable)
+		{
+			// nothing is ever in flight, an unavailable query had never been written
+			result = VK_NOT_READY;
+		}
+
+		for (uint32_t v = 0; v <= pPool->m_ValueCountPerQuery; ++v)
+		{
+			uint64_t value = 0;
+			if (v < pPool->m_ValueCountPerQuery)
+			{
+				if (!bAvailable && !(flags & VK_QUERY_RESULT_PARTIAL_BIT))
+				{
+					continue;
+				}
+				value = pPool->m_Values[static_cast<size_t>(query) * pPool->m_ValueCountPerQuery + v];
+			}
+			else if (bWithAvailability)
+			{
+				value = bAvailable ? 1u : 0u;
+			}
+			else
+			{
+				break;
+			}
+
+			if (b64Bit)
+			{
+				memcpy(pDst + v * valueSize, &value, sizeof(uint64_t));
+			}
+			else
+			{
+				const auto value32 = static_cast<uint32_t>(value);
+				memcpy(pDst + v * valueSize, &value32, sizeof(uint32_t));
+			}
+		}
+	}
+	return result;
+}
+
+//-------------------------------------------------------------------------
+// Commands, a command buffer is only recorded by one thread at a time, so they go without the driver lock
+//-------------------------------------------------------------------------
+
+// args: bind point, pipeline
+VKAPI_ATTR void VKAPI_CALL vkCmdBindPipeline(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipeline pipeline)
+{
+	Record(commandBuffer, "BindPipeline"sv, pipelineBindPoint, HandleBits(pipeline));
+}
+
+// args: bind point, first set index, set count, first set
+VKAPI_ATTR void VKAPI_CALL vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout layout, uint32_t firstSet, uint32_t descriptorSetCount, const VkDescriptorSet* pDescriptorSets, uint32_t dynamicOffsetCount, const uint32_t* pDynamicOffsets)
+{
+	Record(commandBuffer, "BindDescriptorSets"sv, pipelineBindPoint, firstSet, descriptorSetCount, descriptorSetCount > 0 ? HandleBits(pDescriptorSets[0]) : 0);
+}
+
+// args: first binding, binding count, first buffer, first offset
+VKAPI_ATTR void VKAPI_CALL vkCmdBindVertexBuffers(VkCommandBuffer commandBuffer, uint32_t firstBinding, uint32_t bindingCount, const VkBuffer* pBuffers, const VkDeviceSize* pOffsets)
+{
+	Record(commandBuffer, "BindVertexBuffers"sv, firstBinding, bindingCount, bindingCount > 0 ? HandleBits(pBuffers[0]) : 0, bindingCount > 0 ? pOffsets[0] : 0);
+}
+
+// args: buffer, offset, index type
+VKAPI_ATTR void VKAPI_CALL vkCmdBindIndexBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType)
+{
+	Record(commandBuffer, "BindIndexBuffer"sv, HandleBits(buffer), offset, indexType);
+}
+
+// args: vertex count, instance count, first vertex, first instance
+VKAPI_ATTR void VKAPI_CALL vkCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+{
+	Record(commandBuffer, "Draw"sv, vertexCount, instanceCount, firstVertex, firstInstance);
+}
+
+// args: index count, instance count, first index, vertex offset (two's complement)
+VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndexed(VkCommandBuffer commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
+{
+	Record(commandBuffer, "DrawIndexed"sv, indexCount, instanceCount, firstIndex, static_cast<uint64_t>(static_cast<int64_t>(vertexOffset)));
+}
+
+// args: first viewport, viewport count, width bits, height bits of the first viewport
+VKAPI_ATTR void VKAPI_CALL vkCmdSetViewport(VkCommandBuffer commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const VkViewport* pViewports)
+{
+	Record(commandBuffer, "SetViewport"sv, firstViewport, viewportCount, viewportCount > 0 ? FloatBits(pViewports[0].width) : 0, viewportCount > 0 ? FloatBits(pViewports[0].height) : 0);
+}
+
+// args: first scissor, scissor count, width, height of the first scissor
+VKAPI_ATTR void VKAPI_CALL vkCmdSetScissor(VkCommandBuffer commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const VkRect2D* pScissors)
+{
+	Record(commandBuffer, "SetScissor"sv, firstScissor, scissorCount, scissorCount > 0 ? pScissors[0].extent.width : 0, scissorCount > 0 ? pScissors[0].extent.height : 0);
+}
+
+// args: src stage mask, dst stage mask, buffer barrier count, image barrier count
+VKAPI_ATTR void VKAPI_CALL vkCmdPipelineBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkDependencyFlags dependencyFlags, uint32_t memoryBarrierCount, const VkMemoryBarrier* pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const VkBufferMemoryBarrier* pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount, const VkImageMemoryBarrier* pImageMemoryBarriers)
+{
+	Record(commandBuffer, "PipelineBarrier"sv, srcStageMask, dstStageMask, bufferMemoryBarrierCount, imageMemoryBarrierCount);
+}
+
+// args: color attachment count, has depth attachment, render area width, render area height
+VKAPI_ATTR void VKAPI_CALL vkCmdBeginRendering(VkCommandBuffer commandBuffer, const VkRenderingInfo* pRenderingInfo)
+{
+	Record(commandBuffer, "BeginRendering"sv, pRenderingInfo->colorAttachmentCount, pRenderingInfo->pDepthAttachment != nullptr, pRenderingInfo->renderArea.extent.width, pRenderingInfo->renderArea.extent.height);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdEndRendering(VkCommandBuffer commandBuffer)
+{
+	Record(commandBuffer, "EndRendering"sv);
+}
+
+// args: src buffer, dst buffer, region count, total copied bytes
+VKAPI_ATTR void VKAPI_CALL vkCmdCopyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, uint32_t regionCount, const VkBufferCopy* pRegions)
+{
+	VkDeviceSize totalSize = 0;
+	for (uint32_t i = 0; i < regionCount; ++i)
+	{
+		totalSize += pRegions[i].size;
+	}
+	Record(commandBuffer, "CopyBuffer"sv, HandleBits(srcBuffer), HandleBits(dstBuffer), regionCount, totalSize);
+}
+
+// args: src image, dst buffer, region count, total copied texels
+VKAPI_ATTR void VKAPI_CALL vkCmdCopyImageToBuffer(VkCommandBuffer commandBuffer, VkImage srcImage, VkImageLayout srcImageLayout, VkBuffer dstBuffer, uint32_t regionCount, const VkBufferImageCopy* pRegions)
+{
+	uint64_t totalTexelCount = 0;
+	for (uint32_t i = 0; i < regionCount; ++i)
+	{
+		totalTexelCount += static_cast<uint64_t>(pRegions[i].imageExtent.width) * pRegions[i].imageExtent.height * pRegions[i].imageExtent.depth;
+	}
+	Record(commandBuffer, "CopyImageToBuffer"sv, HandleBits(srcImage), HandleBits(dstBuffer), regionCount, totalTexelCount);
+}
+
+// args: query pool, first query, query count
+VKAPI_ATTR void VKAPI_CALL vkCmdResetQueryPool(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount)
+{
+	Record(commandBuffer, "ResetQueryPool"sv, HandleBits(queryPool), firstQuery, queryCount);
+	FromHandle<CommandBuffer>(commandBuffer)->m_HasQueryCommands = true;
+}
+
+// args: query pool, query, pipeline stage
+VKAPI_ATTR void VKAPI_CALL vkCmdWriteTimestamp(VkCommandBuffer commandBuffer, VkPipelineStageFlagBits pipelineStage, VkQueryPool queryPool, uint32_t query)
+{
+	Record(commandBuffer, "WriteTimestamp"sv, HandleBits(queryPool), query, pipelineStage);
+	FromHandle<CommandBuffer>(commandBuffer)->m_HasQueryCommands = true;
+}
+
+// args: query pool, query, flags
+VKAPI_ATTR void VKAPI_CALL vkCmdBeginQuery(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t query, VkQueryControlFlags flags)
+{
+	Record(commandBuffer, "BeginQuery"sv, HandleBits(queryPool), query, flags);
+	FromHandle<CommandBuffer>(commandBuffer)->m_HasQueryCommands = true;
+}
+
+// args: query pool, query
+VKAPI_ATTR void VKAPI_CALL vkCmdEndQuery(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t query)
+{
+	Record(commandBuffer, "EndQuery"sv, HandleBits(queryPool), query);
+	FromHandle<CommandBuffer>(commandBuffer)->m_HasQueryCommands = true;
+}
+
+//-------------------------------------------------------------------------
+// Proc addresses, only entry points implemented above are exposed
+//-------------------------------------------------------------------------
+
+namespace
+{
+	PFN_vkVoidFunction FindProcAddr(const char* pName)
+	{
+#define ZE_NULL_PROC(name) { std::string_view(#name), reinterpret_cast<PFN_vkVoidFunction>(&name) }
+		static const std::unordered_map<std::string_view, PFN_vkVoidFunction> sProcTable = {
+			ZE_NULL_PROC(vkEnumerateInstanceExtensionProperties),
+			ZE_NULL_PROC(vkEnumerateInstanceLayerProperties),
+			ZE_NULL_PROC(vkEnumerateInstanceVersion),
+			ZE_NULL_PROC(vkCreateInstance),
+			ZE_NULL_PROC(vkDestroyInstance),
+			ZE_NULL_PROC(vkEnumeratePhysicalDevices),
+			ZE_NULL_PROC(vkGetPhysicalDeviceProperties),
+			ZE_NULL_PROC(vkGetPhysicalDeviceProperties2),
+			ZE_NULL_PROC(vkGetPhysicalDeviceFeatures),
+			ZE_NULL_PROC(vkGetPhysicalDeviceFeatures2),
+			ZE_NULL_PROC(vkGetPhysicalDeviceMemoryProperties),
+			ZE_NULL_PROC(vkGetPhysicalDeviceMemoryProperties2),
+			ZE_NULL_PROC(vkGetPhysicalDeviceQueueFamilyProperties),
+			ZE_NULL_PROC(vkEnumerateDeviceExtensionProperties),
+			ZE_NULL_PROC(vkEnumerateDeviceLayerProperties),
+			ZE_NULL_PROC(vkCreateDebugUtilsMessengerEXT),
+			ZE_NULL_PROC(vkDestroyDebugUtilsMessengerEXT),
+			ZE_NULL_PROC(vkSetDebugUtilsObjectNameEXT),
+			ZE_NULL_PROC(vkCreateHeadlessSurfaceEXT),
+			ZE_NULL_PROC(vkDestroySurfaceKHR),
+			ZE_NULL_PROC(vkGetPhysicalDeviceSurfaceSupportKHR),
+			ZE_NULL_PROC(vkGetPhysicalDeviceSurfaceCapabilitiesKHR),
+			ZE_NULL_PROC(vkGetPhysicalDeviceSurfaceFormatsKHR),
+			ZE_NULL_PROC(vkGetPhysicalDeviceSurfacePresentModesKHR),
+			ZE_NULL_PROC(vkCreateSwapchainKHR),
+			ZE_NULL_PROC(vkDestroySwapchainKHR),
+			ZE_NULL_PROC(vkGetSwapchainImagesKHR),
+			ZE_NULL_PROC(vkAcquireNextImageKHR),
+			ZE_NULL_PROC(vkQueuePresentKHR),
+			ZE_NULL_PROC(vkCreateDevice),
+			ZE_NULL_PROC(vkDestroyDevice),
+			ZE_NULL_PROC(vkDeviceWaitIdle),
+			ZE_NULL_PROC(vkGetDeviceQueue),
+			ZE_NULL_PROC(vkQueueSubmit),
+			ZE_NULL_PROC(vkQueueWaitIdle),
+			ZE_NULL_PROC(vkCreateSemaphore),
+			ZE_NULL_PROC(vkDestroySemaphore),
+			ZE_NULL_PROC(vkGetSemaphoreCounterValue),
+			ZE_NULL_PROC(vkSignalSemaphore),
+			ZE_NULL_PROC(vkWaitSemaphores),
+			ZE_NULL_PROC(vkCreateFence),
+			ZE_NULL_PROC(vkDestroyFence),
+			ZE_NULL_PROC(vkGetFenceStatus),
+			ZE_NULL_PROC(vkWaitForFences),
+			ZE_NULL_PROC(vkResetFences),
+			ZE_NULL_PROC(vkAllocateMemory),
+			ZE_NULL_PROC(vkFreeMemory),
+			ZE_NULL_PROC(vkMapMemory),
+			ZE_NULL_PROC(vkUnmapMemory),
+			ZE_NULL_PROC(vkFlushMappedMemoryRanges),
+			ZE_NULL_PROC(vkInvalidateMappedMemoryRanges),
+			ZE_NULL_PROC(vkCreateBuffer),
+			ZE_NULL_PROC(vkDestroyBuffer),
+			ZE_NULL_PROC(vkCreateImage),
+			ZE_NULL_PROC(vkDestroyImage),
+			ZE_NULL_PROC(vkGetBufferMemoryRequirements),
+			ZE_NULL_PROC(vkGetBufferMemoryRequirements2),
+			ZE_NULL_PROC(vkGetDeviceBufferMemoryRequirements),
+			ZE_NULL_PROC(vkGetImageMemoryRequirements),
+			ZE_NULL_PROC(vkGetImageMemoryRequirements2),
+			ZE_NULL_PROC(vkGetDeviceImageMemoryRequirements),
+			ZE_NULL_PROC(vkBindBufferMemory),
+			ZE_NULL_PROC(vkBindBufferMemory2),
+			ZE_NULL_PROC(vkBindImageMemory),
+			ZE_NULL_PROC(vkBindImageMemory2),
+			ZE_NULL_PROC(vkCreateImageView),
+			ZE_NULL_PROC(vkDestroyImageView),
+			ZE_NULL_PROC(vkCreateSampler),
+			ZE_NULL_PROC(vkDestroySampler),
+			ZE_NULL_PROC(vkCreateShaderModule),
+			ZE_NULL_PROC(vkDestroyShaderModule),
+			ZE_NULL_PROC(vkCreatePipelineLayout),
+			ZE_NULL_PROC(vkDestroyPipelineLayout),
+			ZE_NULL_PROC(vkCreateGraphicsPipelines),
+			ZE_NULL_PROC(vkDestroyPipeline),
+			ZE_NULL_PROC(vkCreateDescriptorSetLayout),
+			ZE_NULL_PROC(vkDestroyDescriptorSetLayout),
+			ZE_NULL_PROC(vkCreateDescriptorPool),
+			ZE_NULL_PROC(vkResetDescriptorPool),
+			ZE_NULL_PROC(vkDestroyDescriptorPool),
+			ZE_NULL_PROC(vkAllocateDescriptorSets),
+			ZE_NULL_PROC(vkFreeDescriptorSets),
+			ZE_NULL_PROC(vkUpdateDescriptorSets),
+			ZE_NULL_PROC(vkCreateCommandPool),
+			ZE_NULL_PROC(vkDestroyCommandPool),
+			ZE_NULL_PROC(vkResetCommandPool),
+			ZE_NULL_PROC(vkAllocateCommandBuffers),
+			ZE_NULL_PROC(vkFreeCommandBuffers),
+			ZE_NULL_PROC(vkBeginCommandBuffer),
+			ZE_NULL_PROC(vkEndCommandBuffer),
+			ZE_NULL_PROC(vkResetCommandBuffer),
+			ZE_NULL_PROC(vkCmdBindPipeline),
+			ZE_NULL_PROC(vkCmdBindDescriptorSets),
+			ZE_NULL_PROC(vkCmdBindVertexBuffers),
+			ZE_NULL_PROC(vkCmdBindIndexBuffer),
+			ZE_NULL_PROC(vkCmdDraw),
+			ZE_NULL_PROC(vkCmdDrawIndexed),
+			ZE_NULL_PROC(vkCmdSetViewport),
+			ZE_NULL_PROC(vkCmdSetScissor),
+			ZE_NULL_PROC(vkCmdPipelineBarrier),
+			ZE_NULL_PROC(vkCmdBeginRendering),
+			ZE_NULL_PROC(vkCmdEndRendering),
+			ZE_NULL_PROC(vkCmdCopyBuffer),
+			ZE_NULL_PROC(vkCmdCopyImageToBuffer),
+			ZE_NULL_PROC(vkCreateQueryPool),
+			ZE_NULL_PROC(vkDestroyQueryPool),
+			ZE_NULL_PROC(vkGetQueryPoolResults),
+			ZE_NULL_PROC(vkCmdResetQueryPool),
+			ZE_NULL_PROC(vkCmdWriteTimestamp),
+			ZE_NULL_PROC(vkCmdBeginQuery),
+			ZE_NULL_PROC(vkCmdEndQuery),
+		};
+#undef ZE_NULL_PROC
+
+		if (!pName)
+		{
+			return nullptr;
+		}
+
+		std::string_view name = pName;
+		if (auto iter = sProcTable.find(name); iter != sProcTable.end())
+		{
+			return iter->second;
+		}
+
+		// promoted entry points are queried with their extension suffix as well
+		for (auto suffix : { "KHR"sv, "EXT"sv })
+		{
+			if (name.ends_with(suffix))
+			{
+				if (auto iter = sProcTable.find(name.substr(0, name.size() - suffix.size())); iter != sProcTable.end())
+				{
+					return iter->second;
+				}
+			}
+		}
+		return nullptr;
+	}
+}
+
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetInstanceProcAddr(VkInstance instance, const char* pName)
+{
+	return FindProcAddr(pName);
+}
+
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetDeviceProcAddr(VkDevice device, const char* pName)
+{
+	return FindProcAddr(pName);
+}
+
+#endif
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <string_view>
+
+/* Null render backend: a CPU-only implementation of every Vulkan entry point the engine (and VMA) calls.
+ * It is linked instead of the Vulkan loader when the engine is configured with the null_render_backend option,
+ * so the render device, render graph, descriptor and pipeline paths run unchanged on machines without a GPU.
+ *
+ * - Handles are fake objects, device memory is backed by host memory once it is mapped.
+ * - vkCmd* calls are recorded into an inspectable CPU log instead of being executed.
+ * - Queue submissions complete immediately, semaphores and fences are signaled on submission.
+ */
+#if ZENITH_NULL_RENDER_BACKEND
+
+namespace ZE::RenderBackend::Null
+{
+	struct NullCommand
+	{
+		// name of the vkCmd* function without the "vkCmd" prefix
+		std::string_view					m_Name;
+		VkCommandBuffer						m_CommandBuffer = nullptr;
+		// command specific arguments, see NullVulkan.cpp
+		std::array<uint64_t, 4>				m_Args = {};
+	};
+
+	struct NullStatistics
+	{
+		uint32_t							m_LiveObjectCount = 0;
+		uint64_t							m_CreatedObjectCount = 0;
+		uint64_t							m_LiveDeviceMemoryInByte = 0;
+
+		uint64_t							m_QueueSubmitCount = 0;
+		uint64_t							m_SubmittedCommandBufferCount = 0;
+		uint64_t							m_RecordedCommandCount = 0;
+		uint64_t							m_DescriptorWriteCount = 0;
+		uint64_t							m_PresentCount = 0;
+	};
+
+	/* Commands of submitted command buffers in submission order, only the latest kMaxSubmittedCommandCount are kept. */
+	static constexpr uint32_t kMaxSubmittedCommandCount = 1u << 20;
+	std::vector<NullCommand> GetSubmittedCommands();
+	void ClearSubmittedCommands();
+
+	/* Commands recorded into the command buffer since it had begun, it is empty once the command buffer is reset. */
+	std::vector<NullCommand> GetRecordedCommands(VkCommandBuffer commandBuffer);
+
+	/* Report other descriptor indexing properties than the default desktop-like ones, e.g. to test low update-after-bind limits.
+	 * Null restores the defaults. Devices created before keep the properties they had queried.
+	 */
+	void SetDescriptorIndexingProperties(const VkPhysicalDeviceDescriptorIndexingProperties* pProperties);
+
+	/* Buffer descriptor the set holds at the binding, it is empty (null buffer) when the binding was never written. */
+	VkDescriptorBufferInfo GetDescriptorBufferInfo(VkDescriptorSet set, uint32_t binding);
+
+	NullStatistics GetStatistics();
+}
+
+#endif
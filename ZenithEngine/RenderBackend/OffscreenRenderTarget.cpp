@@ -0,0 +1,127 @@
+#include "OffscreenRenderTarget.h"
+
+#include "Core/Assertion.h"
+#include "RenderDevice.h"
+#include "VulkanHelper.h"
+
+#include <algorithm>
+#include <format>
+
+namespace ZE::RenderBackend
+{
+	OffscreenRenderTarget::OffscreenRenderTarget(RenderDevice& renderDevice, const Settings& settings)
+		: m_Settings(settings)
+	{
+		SetRenderDevice(&renderDevice);
+	}
+
+	OffscreenRenderTarget::~OffscreenRenderTarget()
+	{
+		ZE_ASSERT(m_Images.empty());
+	}
+
+	bool OffscreenRenderTarget::Initialize()
+	{
+		// image of a frame slot must not be reused before the slot itself
+		const uint32_t imageCount = std::max(m_Settings.m_ImageCount, RenderDevice::kSwapBufferCount);
+
+		m_RenderTargetDesc.m_Size = { m_Settings.m_Width, m_Settings.m_Height };
+		m_RenderTargetDesc.m_Format = m_Settings.m_Format;
+		m_RenderTargetDesc.m_Usage = (1 << static_cast<uint8_t>(ETextureUsage::Color)) | (1 << static_cast<uint8_t>(ETextureUsage::TransferSrc));
+
+		if (!m_RenderTargetDesc.IsValid())
+		{
+			ZE_LOG_ERROR("Invalid offscreen render target size {}x{}!", m_Settings.m_Width, m_Settings.m_Height);
+			return false;
+		}
+
+		// fences start unsignaled, they are only waited once the image is in flight
+		VulkanZeroStruct(VkFenceCreateInfo, fenceCI);
+		fenceCI.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+		m_Images.resize(imageCount);
+		for (uint32_t i = 0; i < imageCount; ++i)
+		{
+			auto& image = m_Images[i];
+
+			TextureDesc desc = m_RenderTargetDesc;
+			desc.m_DebugName = std::format("{} {}", m_RenderTargetDesc.m_DebugName, i);
+			image.m_Texture = std::shared_ptr<Texture>(Texture::Create(GetRenderDevice(), desc));
+			if (!image.m_Texture)
+			{
+				ZE_LOG_ERROR("Failed to create offscreen render target image {}!", i);
+				return false;
+			}
+
+			VulkanCheckSucceed(vkCreateFence(GetRenderDevice().GetNativeDevice(), &fenceCI, nullptr, &image.m_Fence));
+		}
+
+		// the first BeginFrame() advances to image 0
+		m_ImageIndex = imageCount - 1u;
+		return true;
+	}
+
+	void OffscreenRenderTarget::Shutdown()
+	{
+		for (auto& image : m_Images)
+		{
+			if (image.m_IsInFlight)
+			{
+				VulkanCheckSucceed(vkWaitForFences(GetRenderDevice().GetNativeDevice(), 1, &image.m_Fence, VK_TRUE, RenderDevice::kInfiniteWaitTime));
+			}
+
+			if (image.m_Fence)
+			{
+				vkDestroyFence(GetRenderDevice().GetNativeDevice(), image.m_Fence, nullptr);
+			}
+			image.m_Texture.reset();
+		}
+		m_Images.clear();
+	}
+
+	void OffscreenRenderTarget::BeginFrame()
+	{
+		ZE_ASSERT(!m_HadBeganRendering);
+		ZE_ASSERT(!m_Images.empty());
+
+		// semaphores and command lists of this frame slot are reused, same as a window
+		GetRenderDevice().WaitForFrame(GetRenderDevice().GetFrameIndex());
+
+		m_ImageIndex = (m_ImageIndex + 1u) % static_cast<uint32_t>(m_Images.size());
+
+		// the image can only be written again once GPU had finished the frame which wrote it
+		auto& image = m_Images[m_ImageIndex];
+		if (image.m_IsInFlight)
+		{
+			VulkanCheckSucceed(vkWaitForFences(GetRenderDevice().GetNativeDevice(), 1, &image.m_Fence, VK_TRUE, RenderDevice::kInfiniteWaitTime));
+			VulkanCheckSucceed(vkResetFences(GetRenderDevice().GetNativeDevice(), 1, &image.m_Fence));
+			image.m_IsInFlight = false;
+		}
+
+		m_HadBeganRendering = true;
+	}
+
+	void OffscreenRenderTarget::EndFrame()
+	{
+		ZE_ASSERT(m_HadBeganRendering);
+		m_HadBeganRendering = false;
+	}
+
+	void OffscreenRenderTarget::Present()
+	{
+		ZE_ASSERT(m_HadBeganRendering);
+
+		// the frame submission had been given the fence of this image
+		auto& image = m_Images[m_ImageIndex];
+		image.m_State = GetFrameRenderTargetFinalState();
+		image.m_IsInFlight = true;
+		++m_PresentedFrameCount;
+	}
+
+	RenderOutputSubmitInfo OffscreenRenderTarget::GetFrameSubmitInfo() const
+	{
+		RenderOutputSubmitInfo submitInfo;
+		submitInfo.m_Fence = m_Images[m_ImageIndex].m_Fence;
+		return submitInfo;
+	}
+}
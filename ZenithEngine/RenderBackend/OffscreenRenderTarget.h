@@ -0,0 +1,80 @@
+#pragma once
+
+#include "RenderDevice.h"
+#include "RenderBackend/IRenderOutput.h"
+#include "RenderBackend/RenderDeviceChild.h"
+#include "Core/ClassProperty.h"
+
+#include <vulkan/vulkan_core.h>
+
+#include <memory>
+#include <vector>
+
+namespace ZE::RenderBackend
+{
+	class Texture;
+
+	/* Render output without a window or swapchain, frames are rendered into a ring of device images.
+	 * Each image has a fence signaled by the frame submission which wrote it, the image is reused once its fence is signaled,
+	 * so frames are paced by GPU completion instead of presentation.
+	 * Render targets are left in transfer read state, ready to be copied out.
+	 */
+	class OffscreenRenderTarget : public IRenderOutput, public RenderDeviceChild
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(OffscreenRenderTarget);
+
+	public:
+
+		struct Settings
+		{
+			uint32_t						m_Width = 1920u;
+			uint32_t						m_Height = 1080u;
+			VkFormat						m_Format = VK_FORMAT_B8G8R8A8_UNORM;
+			// at least RenderDevice::kSwapBufferCount, more images let the CPU read back older frames without stalling
+			uint32_t						m_ImageCount = RenderDevice::kSwapBufferCount;
+		};
+
+		OffscreenRenderTarget(RenderDevice& renderDevice, const Settings& settings);
+		virtual ~OffscreenRenderTarget() override;
+
+		bool Initialize();
+		void Shutdown();
+
+		virtual void BeginFrame() override;
+		virtual void EndFrame() override;
+
+		/* No presentation engine, marks the frame image in flight until its fence is signaled. */
+		virtual void Present() override;
+
+		virtual const std::shared_ptr<Texture>& GetFrameRenderTarget() const override { return m_Images[m_ImageIndex].m_Texture; }
+		virtual ERenderResourceState GetFrameRenderTargetState() const override { return m_Images[m_ImageIndex].m_State; }
+		virtual ERenderResourceState GetFrameRenderTargetFinalState() const override { return ERenderResourceState::TransferRead; }
+
+		virtual RenderOutputSubmitInfo GetFrameSubmitInfo() const override;
+
+		const TextureDesc& GetRenderTargetDesc() const { return m_RenderTargetDesc; }
+		uint32_t GetImageCount() const { return static_cast<uint32_t>(m_Images.size()); }
+		uint32_t GetFrameImageIndex() const { return m_ImageIndex; }
+		uint64_t GetPresentedFrameCount() const { return m_PresentedFrameCount; }
+
+	private:
+
+		struct RingImage
+		{
+			std::shared_ptr<Texture>		m_Texture;
+			VkFence							m_Fence = nullptr;
+			// state the image was left in by its last frame
+			ERenderResourceState			m_State = ERenderResourceState::Undefined;
+			bool							m_IsInFlight = false;
+		};
+
+		Settings								m_Settings;
+		TextureDesc								m_RenderTargetDesc = {"offscreen render target"};
+
+		std::vector<RingImage>					m_Images;
+		uint32_t								m_ImageIndex = 0u;
+
+		uint64_t								m_PresentedFrameCount = 0u;
+		bool									m_HadBeganRendering = false;
+	};
+}
@@ -6,10 +6,12 @@
 #include "Render/Shader.h"
 #include "VulkanHelper.h"
 #include "DescriptorCache.h"
+#include "BindlessResourceTable.h"
 
 #include <refl.hpp>
 
 #include <unordered_map>
+#include <algorithm>
 
 namespace ZE::RenderBackend
 {
@@ -18,9 +20,11 @@ namespace ZE::RenderBackend
 		switch (type)
 		{
 		case Render::EShaderBindingResourceType::Unknown: return VK_DESCRIPTOR_TYPE_MAX_ENUM;
-		case Render::EShaderBindingResourceType::UniformBuffer: return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		// uniform data is suballocated from the uniform ring, bound with a dynamic offset
+		case Render::EShaderBindingResourceType::UniformBuffer: return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 		case Render::EShaderBindingResourceType::StorageBuffer: return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 		case Render::EShaderBindingResourceType::Texture2D: return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+		case Render::EShaderBindingResourceType::Sampler: return VK_DESCRIPTOR_TYPE_SAMPLER;
 		default:
 			break;
 		}
@@ -112,37 +116,64 @@ namespace ZE::RenderBackend
 			}
 		}
 
+		// dynamic offsets are consumed in the order of set and then binding
+		std::vector<std::pair<std::pair<uint32_t, uint32_t>, std::string>> dynamicBindings;
+		for (const auto& [name, location] : pPipelineState->m_AllocatedSetBindingMap)
+		{
+			if (ToVkDescriptorType(pPipelineState->m_AllocatedResourceTypeMap.at(name)) == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+			{
+				dynamicBindings.emplace_back(location, name);
+			}
+		}
+		std::ranges::sort(dynamicBindings);
+		for (uint32_t i = 0; i < dynamicBindings.size(); ++i)
+		{
+			pPipelineState->m_DynamicOffsetIndexMap.emplace(dynamicBindings[i].second, i);
+		}
+
 		for (uint32_t set = 0; set < setLayoutBindingArray.size(); ++set)
 		{
 			VulkanZeroStruct(VkDescriptorSetLayoutCreateInfo, setLayoutCI);
 			setLayoutCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
 			setLayoutCI.bindingCount = static_cast<uint32_t>(setLayoutBindingArray[set].size());
 			setLayoutCI.pBindings = setLayoutBindingArray[set].data();
-			setLayoutCI.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+
+			// dynamic descriptors can NOT be updated after bind, these sets must be written before they are bound
+			const bool bHasDynamicBinding = std::ranges::any_of(setLayoutBindingArray[set], [](const VkDescriptorSetLayoutBinding& binding)
+			{
+				return binding.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+			});
+			setLayoutCI.flags = bHasDynamicBinding ? 0 : VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
 
 			VulkanCheckSucceed(vkCreateDescriptorSetLayout(pPipelineState->GetRenderDevice().GetNativeDevice(), &setLayoutCI, nullptr, &pPipelineState->m_DescriptorSetLayouts[set]));
 		}
 
-		std::vector<VkDescriptorPoolSize> poolSizeArray;
-		poolSizeArray.reserve(resourceCountMap.size());
+		// pools are created on demand, each of them holds kDescriptorPoolSetGroupCount sets of every layout
+		pPipelineState->m_DescriptorPoolSizes.reserve(resourceCountMap.size());
 		for (const auto& [type, count] : resourceCountMap)
 		{
-			poolSizeArray.emplace_back(ToVkDescriptorType(type), count);
+			pPipelineState->m_DescriptorPoolSizes.emplace_back(ToVkDescriptorType(type), count * kDescriptorPoolSetGroupCount);
 		}
 
-		VulkanZeroStruct(VkDescriptorPoolCreateInfo, poolCreateInfo);
-		poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-		poolCreateInfo.maxSets = static_cast<uint32_t>(pPipelineState->m_DescriptorSetLayouts.size()) * RenderDevice::kSwapBufferCount;
-		poolCreateInfo.poolSizeCount = static_cast<uint32_t>(poolSizeArray.size());
-		poolCreateInfo.pPoolSizes = poolSizeArray.data();
-		poolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+		// Bindless set is shared by all pipelines, append it at the reserved set index.
+		std::vector<VkDescriptorSetLayout> pipelineSetLayouts = pPipelineState->m_DescriptorSetLayouts;
+		if (auto* pBindlessTable = pPipelineState->GetRenderDevice().GetBindlessResourceTable())
+		{
+			if (pipelineSetLayouts.size() > BindlessResourceTable::kBindlessSetIndex)
+			{
+				ZE_LOG_ERROR("Shader layout uses set {} which is reserved by bindless resource table!", BindlessResourceTable::kBindlessSetIndex);
+				return false;
+			}
 
-		VulkanCheckSucceed(vkCreateDescriptorPool(pPipelineState->GetRenderDevice().GetNativeDevice(), &poolCreateInfo, nullptr, &pPipelineState->m_DescriptorPool));
+			pipelineSetLayouts.resize(BindlessResourceTable::kBindlessSetIndex, pBindlessTable->GetEmptyDescriptorSetLayout());
+			pipelineSetLayouts.push_back(pBindlessTable->GetDescriptorSetLayout());
+			pPipelineState->m_UseBindlessSet = true;
+		}
 
 		VulkanZeroStruct(VkPipelineLayoutCreateInfo, pipelineLayoutCI);
 		pipelineLayoutCI.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		pipelineLayoutCI.setLayoutCount = static_cast<uint32_t>(pPipelineState->m_DescriptorSetLayouts.size());
-		pipelineLayoutCI.pSetLayouts = pPipelineState->m_DescriptorSetLayouts.data();
+		pipelineLayoutCI.setLayoutCount = static_cast<uint32_t>(pipelineSetLayouts.size());
+		pipelineLayoutCI.pSetLayouts = pipelineSetLayouts.data();
 
 		VulkanCheckSucceed(vkCreatePipelineLayout(pPipelineState->GetRenderDevice().GetNativeDevice(), &pipelineLayoutCI, nullptr, &pPipelineState->m_Layout));
 
@@ -169,6 +200,70 @@ namespace ZE::RenderBackend
 		return Render::EShaderBindingResourceType::Unknown;
 	}
 
+	uint32_t PipelineState::FindDynamicOffsetIndex(const std::string& name) const
+	{
+		if (auto iter = m_DynamicOffsetIndexMap.find(name); iter != m_DynamicOffsetIndexMap.end())
+		{
+			return iter->second;
+		}
+
+		return BoundShaderResourceLocation::kInvalidIndex;
+	}
+
+	VkDescriptorSet PipelineState::AllocateDescriptorSet(uint32_t setIndex)
+	{
+		ZE_ASSERT(setIndex < m_DescriptorSetLayouts.size());
+
+		VulkanZeroStruct(VkDescriptorSetAllocateInfo, descriptorAllocInfo);
+		descriptorAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		descriptorAllocInfo.descriptorSetCount = 1u;
+		descriptorAllocInfo.pSetLayouts = &m_DescriptorSetLayouts[setIndex];
+
+		VkDescriptorSet set = nullptr;
+		if (!m_DescriptorPools.empty())
+		{
+			descriptorAllocInfo.descriptorPool = m_DescriptorPools.back();
+			const VkResult result = vkAllocateDescriptorSets(GetRenderDevice().GetNativeDevice(), &descriptorAllocInfo, &set);
+			if (result == VK_SUCCESS)
+			{
+				return set;
+			}
+			if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+			{
+				VulkanCheckSucceed(result);
+				return nullptr;
+			}
+		}
+
+		// the last pool is full, sets are never freed, so the older ones are full as well
+		if (!AddDescriptorPool())
+		{
+			return nullptr;
+		}
+		descriptorAllocInfo.descriptorPool = m_DescriptorPools.back();
+		VulkanCheckSucceed(vkAllocateDescriptorSets(GetRenderDevice().GetNativeDevice(), &descriptorAllocInfo, &set));
+		return set;
+	}
+
+	bool PipelineState::AddDescriptorPool()
+	{
+		VulkanZeroStruct(VkDescriptorPoolCreateInfo, poolCreateInfo);
+		poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolCreateInfo.maxSets = static_cast<uint32_t>(m_DescriptorSetLayouts.size()) * kDescriptorPoolSetGroupCount;
+		poolCreateInfo.poolSizeCount = static_cast<uint32_t>(m_DescriptorPoolSizes.size());
+		poolCreateInfo.pPoolSizes = m_DescriptorPoolSizes.data();
+		poolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+
+		VkDescriptorPool pool = nullptr;
+		if (vkCreateDescriptorPool(GetRenderDevice().GetNativeDevice(), &poolCreateInfo, nullptr, &pool) != VK_SUCCESS)
+		{
+			ZE_LOG_ERROR("Failed to create descriptor pool, {} pools are created so far!", m_DescriptorPools.size());
+			return false;
+		}
+		m_DescriptorPools.push_back(pool);
+		return true;
+	}
+
 	PipelineState::~PipelineState()
 	{
 		for (auto& setLayout : m_DescriptorSetLayouts)
@@ -176,12 +271,19 @@ namespace ZE::RenderBackend
 			vkDestroyDescriptorSetLayout(GetRenderDevice().GetNativeDevice(), setLayout, nullptr);
 		}
 		m_DescriptorSetLayouts.clear();
-		vkDestroyDescriptorPool(GetRenderDevice().GetNativeDevice(), m_DescriptorPool, nullptr);
-		m_DescriptorPool = nullptr;
+		for (auto& pool : m_DescriptorPools)
+		{
+			vkDestroyDescriptorPool(GetRenderDevice().GetNativeDevice(), pool, nullptr);
+		}
+		m_DescriptorPools.clear();
 		vkDestroyPipelineLayout(GetRenderDevice().GetNativeDevice(), m_Layout, nullptr);
 		m_Layout = nullptr;
 
-		GetRenderDevice().GetFrameDescriptorCache()->MarkDirty(this);
+		// every frame may still hold sets of the pools
+		for (uint32_t frameIndex = 0; frameIndex < RenderDevice::kSwapBufferCount; ++frameIndex)
+		{
+			GetRenderDevice().GetFrameDescriptorCache(frameIndex)->MarkDirty(this);
+		}
 	}
 
 	// GraphicPipelineState* GraphicPipelineState::Builder::Build(RenderDevice& renderDevice)
@@ -330,7 +432,11 @@ namespace ZE::RenderBackend
 		
 		for (auto& pShader : pGraphicPSO->m_CreateDesc.m_Shaders)
 		{
-			pShader->ReleaseGPUShaderObject();
+			// the pixel shader is optional
+			if (pShader)
+			{
+				pShader->ReleaseGPUShaderObject();
+			}
 		}
 
 		return pGraphicPSO;
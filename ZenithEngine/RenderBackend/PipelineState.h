@@ -39,6 +39,7 @@ namespace ZE::RenderBackend
 	{
 		friend class GraphicPipelineState;
 		friend class RenderCommandList;
+		friend class RenderCommandStream;
 		friend class DescriptorCache;
 
 	public:
@@ -71,6 +72,11 @@ namespace ZE::RenderBackend
 
 		BoundShaderResourceLocation FindBoundResourceLocation(const std::string& name);
 		Render::EShaderBindingResourceType FindBoundResourceType(const std::string& name);
+		/* Index into the dynamic offsets passed when binding descriptor sets, kInvalidIndex if the resource is NOT dynamic. */
+		uint32_t FindDynamicOffsetIndex(const std::string& name) const;
+		uint32_t GetDynamicOffsetCount() const { return static_cast<uint32_t>(m_DynamicOffsetIndexMap.size()); }
+		/* Number of descriptor sets of the pipeline's own, the bindless set is excluded. */
+		uint32_t GetDescriptorSetCount() const { return static_cast<uint32_t>(m_DescriptorSetLayouts.size()); }
 
 		virtual EPipelineStateType GetPipelineType() const { return EPipelineStateType::Unknown; }
 		
@@ -83,15 +89,27 @@ namespace ZE::RenderBackend
 		
 		std::unordered_map<std::string, std::pair<uint32_t, uint32_t>>			m_AllocatedSetBindingMap;
 		std::unordered_map<std::string, Render::EShaderBindingResourceType>		m_AllocatedResourceTypeMap;
+		std::unordered_map<std::string, uint32_t>								m_DynamicOffsetIndexMap;
+
+		// Pipeline layout contains the global bindless set.
+		bool										m_UseBindlessSet = false;
 
 	private:
 
-		VkDescriptorPool							m_DescriptorPool = nullptr;
+		// sets of every layout fit into a pool this many times
+		static constexpr uint32_t kDescriptorPoolSetGroupCount = 64u;
+
+		// allocated by the descriptor caches of frames, a new pool is added once the others are full
+		std::vector<VkDescriptorPool>				m_DescriptorPools;
+		std::vector<VkDescriptorPoolSize>			m_DescriptorPoolSizes;
 		std::vector<VkDescriptorSetLayout>			m_DescriptorSetLayouts;
 
 	private:
 
 		PipelineState(RenderDevice& renderDevice);
+
+		VkDescriptorSet AllocateDescriptorSet(uint32_t setIndex);
+		bool AddDescriptorPool();
 	};
 
 	struct GraphicPipelineStateCreateDesc : public PipelineStateCreateDesc
@@ -0,0 +1,248 @@
+#include "ReadbackManager.h"
+
+#include "Core/Assertion.h"
+#include "RenderDevice.h"
+#include "RenderResource.h"
+#include "TimelineSemaphore.h"
+#include "VulkanHelper.h"
+#include "Math/Math.h"
+#include "TaskSystem/TaskManager.h"
+
+#include <algorithm>
+
+namespace ZE::RenderBackend
+{
+	void ReadbackFuture::Wait() const
+	{
+		if (!m_Payload || IsReady())
+		{
+			return;
+		}
+
+		m_Payload->m_Manager->Wait(*this);
+	}
+
+	std::span<const std::byte> ReadbackFuture::GetData() const
+	{
+		ZE_ASSERT_LOG(IsReady(), "Readback data is accessed before it is on CPU!");
+		return m_Payload->m_Data;
+	}
+
+	ReadbackManager::ReadbackManager(RenderDevice& renderDevice, uint32_t readbackRingSizeInByte)
+		: m_ReadbackRingSizeInByte(Math::AlignTo(readbackRingSizeInByte, kReadbackAlignment))
+	{
+		SetRenderDevice(&renderDevice);
+
+		BufferDesc readbackRingDesc("readback ring");
+		readbackRingDesc.m_Size = m_ReadbackRingSizeInByte;
+		readbackRingDesc.m_Usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		readbackRingDesc.m_MemoryUsage = BufferMemoryUsage::GpuToCpu;
+		readbackRingDesc.m_MemoryCategory = EMemoryCategory::Readback;
+
+		m_ReadbackRing = std::shared_ptr<Buffer>(Buffer::Create(renderDevice, readbackRingDesc));
+		ZE_ASSERT(m_ReadbackRing);
+
+		// keep it mapped during the whole lifetime
+		void* pMappedMemory = nullptr;
+		VulkanCheckSucceed(vmaMapMemory(renderDevice.m_GlobalAllocator, m_ReadbackRing->m_Allocation, &pMappedMemory));
+		m_ReadbackRingMappedMemory = static_cast<const std::byte*>(pMappedMemory);
+	}
+
+	ReadbackManager::~ReadbackManager()
+	{
+		WaitUntilIdle();
+
+		// readbacks of a frame which is never submitted are never resolved
+		m_InFlightReadbacks.clear();
+
+		vmaUnmapMemory(GetRenderDevice().m_GlobalAllocator, m_ReadbackRing->m_Allocation);
+		m_ReadbackRingMappedMemory = nullptr;
+		m_ReadbackRing.reset();
+	}
+
+	ReadbackFuture ReadbackManager::Allocate(uint32_t sizeInByte, ReadbackCallback callback)
+	{
+		ZE_ASSERT(sizeInByte != 0);
+
+		auto pPayload = std::make_shared<ReadbackPayload>();
+		pPayload->m_Manager = this;
+		pPayload->m_SizeInByte = sizeInByte;
+
+		InFlightReadback readback;
+		readback.m_Payload = pPayload;
+		readback.m_Callback = std::move(callback);
+
+		std::unique_lock lock(m_Mutex);
+
+		uint32_t ringOffset = 0;
+		bool bAllocatedFromRing = sizeInByte <= m_ReadbackRingSizeInByte && TryAllocateFromRing(sizeInByte, ringOffset, readback.m_ConsumedRingSizeInByte);
+		while (sizeInByte <= m_ReadbackRingSizeInByte && !bAllocatedFromRing)
+		{
+			// ring is full, wait for the oldest readback to retire unless it is recorded in the current frame as well
+			const uint64_t oldestTimelineValue = m_InFlightReadbacks.empty() ? 0u : m_InFlightReadbacks.front().m_Payload->m_TimelineValue;
+			if (oldestTimelineValue == 0)
+			{
+				break;
+			}
+
+			WaitLocked(lock, oldestTimelineValue);
+			bAllocatedFromRing = TryAllocateFromRing(sizeInByte, ringOffset, readback.m_ConsumedRingSizeInByte);
+		}
+
+		if (bAllocatedFromRing)
+		{
+			pPayload->m_DstBuffer = m_ReadbackRing.get();
+			pPayload->m_DstOffset = ringOffset;
+		}
+		else
+		{
+			// too large to be hold by the ring, fallback to a dedicated readback buffer
+			BufferDesc readbackBufferDesc("dedicated readback buffer");
+			readbackBufferDesc.m_Size = sizeInByte;
+			readbackBufferDesc.m_Usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+			readbackBufferDesc.m_MemoryUsage = BufferMemoryUsage::GpuToCpu;
+			readbackBufferDesc.m_MemoryCategory = EMemoryCategory::Readback;
+
+			readback.m_DedicatedBuffer = std::shared_ptr<Buffer>(Buffer::Create(GetRenderDevice(), readbackBufferDesc));
+			ZE_ASSERT(readback.m_DedicatedBuffer);
+			pPayload->m_DstBuffer = readback.m_DedicatedBuffer.get();
+			pPayload->m_DstOffset = 0;
+		}
+
+		m_InFlightReadbacks.emplace_back(std::move(readback));
+		return ReadbackFuture(std::move(pPayload));
+	}
+
+	void ReadbackManager::Seal(uint64_t timelineValue)
+	{
+		std::scoped_lock lock(m_Mutex);
+		for (auto iter = m_InFlightReadbacks.rbegin(); iter != m_InFlightReadbacks.rend() && iter->m_Payload->m_TimelineValue == 0; ++iter)
+		{
+			iter->m_Payload->m_TimelineValue = timelineValue;
+		}
+	}
+
+	void ReadbackManager::Update()
+	{
+		std::scoped_lock lock(m_Mutex);
+		RetireLocked(GetCompletedValue());
+	}
+
+	void ReadbackManager::Wait(const ReadbackFuture& future)
+	{
+		if (!future.IsValid())
+		{
+			return;
+		}
+
+		std::unique_lock lock(m_Mutex);
+		ZE_ASSERT_LOG(future.m_Payload->m_TimelineValue != 0, "Wait for a readback which is not submitted yet!");
+		WaitLocked(lock, future.m_Payload->m_TimelineValue);
+	}
+
+	void ReadbackManager::WaitUntilIdle()
+	{
+		std::unique_lock lock(m_Mutex);
+
+		uint64_t lastTimelineValue = 0;
+		for (const auto& readback : m_InFlightReadbacks)
+		{
+			lastTimelineValue = std::max(lastTimelineValue, readback.m_Payload->m_TimelineValue);
+		}
+		WaitLocked(lock, lastTimelineValue);
+	}
+
+	uint32_t ReadbackManager::GetPendingReadbackCount() const
+	{
+		std::scoped_lock lock(m_Mutex);
+		return static_cast<uint32_t>(m_InFlightReadbacks.size());
+	}
+
+	uint64_t ReadbackManager::GetCompletedValue() const
+	{
+		return GetRenderDevice().GetGraphicTimeline().GetCompletedValue();
+	}
+
+	bool ReadbackManager::TryAllocateFromRing(uint32_t sizeInByte, uint32_t& outOffset, uint32_t& outConsumedSize)
+	{
+		const uint32_t alignedSize = Math::AlignTo(sizeInByte, kReadbackAlignment);
+
+		if (m_ReadbackRingUsedSizeInByte == 0)
+		{
+			m_ReadbackRingHead = 0;
+		}
+
+		// the tail of the ring is wasted if the allocation can NOT fit in
+		const uint32_t wrapPadding = (m_ReadbackRingHead + alignedSize > m_ReadbackRingSizeInByte) ? m_ReadbackRingSizeInByte - m_ReadbackRingHead : 0u;
+		const uint32_t consumedSize = wrapPadding + alignedSize;
+
+		if (m_ReadbackRingUsedSizeInByte + consumedSize > m_ReadbackRingSizeInByte)
+		{
+			return false;
+		}
+
+		outOffset = wrapPadding != 0 ? 0u : m_ReadbackRingHead;
+		outConsumedSize = consumedSize;
+		m_ReadbackRingHead = (outOffset + alignedSize) % m_ReadbackRingSizeInByte;
+		m_ReadbackRingUsedSizeInByte += consumedSize;
+		return true;
+	}
+
+	void ReadbackManager::RetireLocked(uint64_t completedValue)
+	{
+		while (!m_InFlightReadbacks.empty())
+		{
+			auto& readback = m_InFlightReadbacks.front();
+			auto& payload = *readback.m_Payload;
+			if (payload.m_TimelineValue == 0 || payload.m_TimelineValue > completedValue)
+			{
+				break;
+			}
+
+			if (readback.m_DedicatedBuffer)
+			{
+				auto mappedMemory = readback.m_DedicatedBuffer->Map();
+				const auto* pData = static_cast<const std::byte*>(mappedMemory.m_pMappedMemory);
+				payload.m_Data.assign(pData, pData + payload.m_SizeInByte);
+			}
+			else
+			{
+				// readback memory may be non-coherent
+				VulkanCheckSucceed(vmaInvalidateAllocation(GetRenderDevice().m_GlobalAllocator, m_ReadbackRing->m_Allocation, payload.m_DstOffset, payload.m_SizeInByte));
+				const auto* pData = m_ReadbackRingMappedMemory + payload.m_DstOffset;
+				payload.m_Data.assign(pData, pData + payload.m_SizeInByte);
+
+				ZE_ASSERT(m_ReadbackRingUsedSizeInByte >= readback.m_ConsumedRingSizeInByte);
+				m_ReadbackRingUsedSizeInByte -= readback.m_ConsumedRingSizeInByte;
+			}
+
+			payload.m_IsReady.store(true, std::memory_order_release);
+
+			if (readback.m_Callback)
+			{
+				// encoding or reduction of the data must NOT block the render thread
+				TaskSystem::TaskManager::Get().RunTask([pPayload = readback.m_Payload, callback = std::move(readback.m_Callback)]
+				{
+					callback(pPayload->m_Data);
+				});
+			}
+
+			m_InFlightReadbacks.pop_front();
+		}
+	}
+
+	void ReadbackManager::WaitLocked(std::unique_lock<std::mutex>& lock, uint64_t timelineValue)
+	{
+		if (timelineValue == 0)
+		{
+			return;
+		}
+
+		// do NOT block other readbacks while waiting on GPU
+		lock.unlock();
+		GetRenderDevice().GetGraphicTimeline().Wait(timelineValue);
+		lock.lock();
+
+		RetireLocked(GetCompletedValue());
+	}
+}
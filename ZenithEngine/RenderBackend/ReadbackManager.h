@@ -0,0 +1,136 @@
+#pragma once
+
+#include "RenderDeviceChild.h"
+#include "Core/ClassProperty.h"
+
+#include <vulkan/vulkan_core.h>
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace ZE::RenderBackend
+{
+	class RenderDevice;
+	class Buffer;
+	class ReadbackManager;
+
+	/* Called on a task thread once the readback data is on CPU, the data is only valid during the call. */
+	using ReadbackCallback = std::function<void(std::span<const std::byte>)>;
+
+	struct ReadbackPayload
+	{
+		ReadbackManager*					m_Manager = nullptr;
+
+		// where GPU copies into, the ring or a dedicated buffer
+		Buffer*								m_DstBuffer = nullptr;
+		uint32_t							m_DstOffset = 0;
+		uint32_t							m_SizeInByte = 0;
+
+		// graphic timeline value of the frame which records the copy, 0 until the frame is submitted
+		uint64_t							m_TimelineValue = 0;
+
+		std::vector<std::byte>				m_Data;
+		std::atomic<bool>					m_IsReady = false;
+	};
+
+	/* Non-blocking handle of a readback, it resolves once GPU had finished the frame which copied it. */
+	class ReadbackFuture
+	{
+		friend class ReadbackManager;
+
+	public:
+
+		ReadbackFuture() = default;
+
+		bool IsValid() const { return m_Payload != nullptr; }
+		bool IsReady() const { return m_Payload && m_Payload->m_IsReady.load(std::memory_order_acquire); }
+
+		/* Block until the data is on CPU, the frame which copies it must had been submitted. */
+		void Wait() const;
+
+		/* Only valid once ready. */
+		std::span<const std::byte> GetData() const;
+
+		Buffer* GetDstBuffer() const { return m_Payload ? m_Payload->m_DstBuffer : nullptr; }
+		uint32_t GetDstOffset() const { return m_Payload ? m_Payload->m_DstOffset : 0u; }
+		uint32_t GetSizeInByte() const { return m_Payload ? m_Payload->m_SizeInByte : 0u; }
+
+	private:
+
+		explicit ReadbackFuture(std::shared_ptr<ReadbackPayload> pPayload)
+			: m_Payload(std::move(pPayload))
+		{}
+
+	private:
+
+		std::shared_ptr<ReadbackPayload>	m_Payload;
+	};
+
+	/* Read GPU data back through a persistently mapped readback ring without stalling the render thread.
+	 * Allocate() reserves ring memory for a copy recorded into the current frame, e.g. by RenderGraph::AddReadbackNode().
+	 * Allocations are sealed with the graphic timeline value of the frame submission, once the timeline passes it
+	 * the data is copied out of the ring, the future resolves and its callback runs on the task thread pool.
+	 * Allocate() and Wait() are thread-safe, the others must be called on the render thread only.
+	 */
+	class ReadbackManager : public RenderDeviceChild
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(ReadbackManager);
+
+	public:
+
+		static constexpr uint32_t kDefaultReadbackRingSizeInByte = 32u * 1024u * 1024u;
+		static constexpr uint32_t kReadbackAlignment = 16u;
+
+		ReadbackManager(RenderDevice& renderDevice, uint32_t readbackRingSizeInByte = kDefaultReadbackRingSizeInByte);
+		~ReadbackManager();
+
+		ReadbackFuture Allocate(uint32_t sizeInByte, ReadbackCallback callback = {});
+
+		/* Assign the timeline value of the frame submission to all allocations since last submission. */
+		void Seal(uint64_t timelineValue);
+
+		// Resolve readbacks GPU had finished and reclaim their ring memory. Called by render device each frame.
+		void Update();
+
+		void Wait(const ReadbackFuture& future);
+		void WaitUntilIdle();
+
+		uint32_t GetPendingReadbackCount() const;
+
+	private:
+
+		struct InFlightReadback
+		{
+			std::shared_ptr<ReadbackPayload>		m_Payload;
+			uint32_t								m_ConsumedRingSizeInByte = 0;
+			// dedicated buffer of a readback which can NOT fit into the ring
+			std::shared_ptr<Buffer>					m_DedicatedBuffer;
+			ReadbackCallback						m_Callback;
+		};
+
+		uint64_t GetCompletedValue() const;
+
+		bool TryAllocateFromRing(uint32_t sizeInByte, uint32_t& outOffset, uint32_t& outConsumedSize);
+		void RetireLocked(uint64_t completedValue);
+		void WaitLocked(std::unique_lock<std::mutex>& lock, uint64_t timelineValue);
+
+	private:
+
+		mutable std::mutex							m_Mutex;
+
+		std::shared_ptr<Buffer>						m_ReadbackRing;
+		const std::byte*							m_ReadbackRingMappedMemory = nullptr;
+		uint32_t									m_ReadbackRingSizeInByte = 0;
+		uint32_t									m_ReadbackRingHead = 0;
+		uint32_t									m_ReadbackRingUsedSizeInByte = 0;
+
+		// ordered by allocation, so the unsealed ones are at the back
+		std::deque<InFlightReadback>				m_InFlightReadbacks;
+	};
+}
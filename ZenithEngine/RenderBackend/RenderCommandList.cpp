@@ -4,6 +4,7 @@
 #include "RenderDevice.h"
 #include "RenderResource.h"
 #include "VulkanHelper.h"
+#include "BindlessResourceTable.h"
 
 namespace ZE::RenderBackend
 {
@@ -588,38 +589,16 @@ namespace ZE::RenderBackend
 		return {};
 	}
 
-	RenderCommandList::RenderCommandList(RenderDevice& renderDevice)
+	RenderCommandList::RenderCommandList(RenderDevice& renderDevice, VkCommandBuffer commandBuffer, uint32_t queueFamilyIndex)
+		: m_CommandBuffer(commandBuffer), m_QueueIndex(queueFamilyIndex)
 	{
 		SetRenderDevice(&renderDevice);
-		
-		VulkanZeroStruct(VkCommandPoolCreateInfo, commandPoolCI);
-		commandPoolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-		// TODO: sepecify command list type
-		commandPoolCI.queueFamilyIndex = GetRenderDevice().m_GraphicQueueFamilyIndex;
-		commandPoolCI.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-		m_QueueIndex = commandPoolCI.queueFamilyIndex;
-
-		VulkanCheckSucceed(vkCreateCommandPool(GetRenderDevice().GetNativeDevice(), &commandPoolCI, nullptr, &m_CommandPool));
-		
-		VulkanZeroStruct(VkCommandBufferAllocateInfo, allocateInfo);
-		allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		allocateInfo.commandBufferCount = 1;
-		allocateInfo.commandPool = m_CommandPool;
-		allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-
-		vkAllocateCommandBuffers(GetRenderDevice().GetNativeDevice(), &allocateInfo, &m_CommandBuffer);
 
 		sTempMemoryBarriers.reserve(1);
 		sTempBufferBarriers.reserve(16);
 		sTempTextureBarriers.reserve(16);
 	}
 
-	RenderCommandList::~RenderCommandList()
-	{
-		vkDestroyCommandPool(GetRenderDevice().GetNativeDevice(), m_CommandPool, nullptr);
-		m_CommandPool = nullptr;
-	}
-
 	bool RenderCommandList::BeginRecord()
 	{
 		ZE_ASSERT(!m_IsCommandRecording);
@@ -640,12 +619,7 @@ namespace ZE::RenderBackend
 		m_IsCommandRecording = false;
 	}
 	
-	void RenderCommandList::Reset() const
-	{
-		VulkanCheckSucceed(vkResetCommandBuffer(m_CommandBuffer, 0));
-	}
-
-	void RenderCommandList::CmdBeginDynamicRendering(const glm::uvec2& viewportSize, std::span<Texture*> renderTargets, std::span<RenderPassRenderTargetBinding> colorBindings) const
+	void RenderCommandList::CmdBeginDynamicRendering(const glm::uvec2& viewportSize, std::span<Texture* const> renderTargets, std::span<const RenderPassRenderTargetBinding> colorBindings) const
 	{
 		ZE_ASSERT(m_IsCommandRecording);
 		ZE_ASSERT(renderTargets.size() == colorBindings.size());
@@ -770,28 +744,58 @@ namespace ZE::RenderBackend
 		vkCmdBindPipeline(m_CommandBuffer, bindPoint, pPipelineState->m_Pipeline);
 	}
 	
-	void RenderCommandList::CmdBindShaderResource(VkPipelineBindPoint bindPoint, PipelineState* pPipelineState, const std::vector<VkDescriptorSet>& sets) const
+	void RenderCommandList::CmdBindShaderResource(VkPipelineBindPoint bindPoint, PipelineState* pPipelineState, const std::vector<VkDescriptorSet>& sets, std::span<const uint32_t> dynamicOffsets) const
 	{
 		ZE_ASSERT(m_IsCommandRecording);
+		ZE_ASSERT_LOG(dynamicOffsets.size() == pPipelineState->GetDynamicOffsetCount(), "Pipeline expects {} dynamic offsets, but {} are given!", pPipelineState->GetDynamicOffsetCount(), dynamicOffsets.size());
 
-		vkCmdBindDescriptorSets(m_CommandBuffer, bindPoint, pPipelineState->m_Layout,
-			0, static_cast<uint32_t>(sets.size()), sets.data(),
-			0, nullptr);
+		if (!sets.empty())
+		{
+			vkCmdBindDescriptorSets(m_CommandBuffer, bindPoint, pPipelineState->m_Layout,
+				0, static_cast<uint32_t>(sets.size()), sets.data(),
+				static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.data());
+		}
+
+		if (pPipelineState->m_UseBindlessSet)
+		{
+			VkDescriptorSet bindlessSet = GetRenderDevice().GetBindlessResourceTable()->GetDescriptorSet();
+			vkCmdBindDescriptorSets(m_CommandBuffer, bindPoint, pPipelineState->m_Layout,
+				BindlessResourceTable::kBindlessSetIndex, 1u, &bindlessSet,
+				0, nullptr);
+		}
 	}
 	
 	void RenderCommandList::CmdBindVertexInput(const Buffer* pVertexBuffer, const Buffer* pIndexBuffer) const
 	{
-		ZE_ASSERT(m_IsCommandRecording);
 		ZE_ASSERT(pVertexBuffer);
 
+		BufferRange vertexRange;
+		vertexRange.m_pBuffer = const_cast<Buffer*>(pVertexBuffer);
+		vertexRange.m_Size = pVertexBuffer->GetDesc().m_Size;
+
+		BufferRange indexRange;
+		if (pIndexBuffer)
+		{
+			indexRange.m_pBuffer = const_cast<Buffer*>(pIndexBuffer);
+			indexRange.m_Size = pIndexBuffer->GetDesc().m_Size;
+		}
+
+		CmdBindVertexInput(vertexRange, indexRange);
+	}
+
+	void RenderCommandList::CmdBindVertexInput(const BufferRange& vertexRange, const BufferRange& indexRange) const
+	{
+		ZE_ASSERT(m_IsCommandRecording);
+		ZE_ASSERT(vertexRange.IsValid());
+
 		// TODO: support vertex batch
-		const VkBuffer vertexBuffers[1] = { pVertexBuffer->GetNativeHandle() };
-		constexpr VkDeviceSize offsets[1] = { 0ull };
+		const VkBuffer vertexBuffers[1] = { vertexRange.GetNativeHandle() };
+		const VkDeviceSize offsets[1] = { vertexRange.m_Offset };
 		vkCmdBindVertexBuffers(m_CommandBuffer, 0, 1, vertexBuffers, offsets);
-		if (pIndexBuffer)
+		if (indexRange.IsValid())
 		{
 			// TODO: uint16 index type
-			vkCmdBindIndexBuffer(m_CommandBuffer, pIndexBuffer->GetNativeHandle(), 0, VK_INDEX_TYPE_UINT32);
+			vkCmdBindIndexBuffer(m_CommandBuffer, indexRange.GetNativeHandle(), indexRange.m_Offset, VK_INDEX_TYPE_UINT32);
 		}
 	}
 
@@ -851,4 +855,49 @@ namespace ZE::RenderBackend
 
 		vkCmdCopyBuffer(m_CommandBuffer, pSrcBuffer->GetNativeHandle(), pDstBuffer->GetNativeHandle(), 1, &bufferCopy);
 	}
-}
\ No newline at end of file
+
+	void RenderCommandList::CmdCopyBuffer(Buffer* pSrcBuffer, Buffer* pDstBuffer, uint32_t srcOffset, uint32_t dstOffset, uint32_t sizeInByte) const
+	{
+		ZE_ASSERT(m_IsCommandRecording);
+		ZE_ASSERT(srcOffset + sizeInByte <= pSrcBuffer->GetDesc().m_Size && dstOffset + sizeInByte <= pDstBuffer->GetDesc().m_Size);
+
+		VkBufferCopy bufferCopy;
+		bufferCopy.size = sizeInByte;
+		bufferCopy.srcOffset = srcOffset;
+		bufferCopy.dstOffset = dstOffset;
+
+		vkCmdCopyBuffer(m_CommandBuffer, pSrcBuffer->GetNativeHandle(), pDstBuffer->GetNativeHandle(), 1, &bufferCopy);
+	}
+
+	void RenderCommandList::CmdCopyTextureToBuffer(Texture* pSrcTexture, Buffer* pDstBuffer, uint32_t dstOffset) const
+	{
+		ZE_ASSERT(m_IsCommandRecording);
+
+		const VkBufferImageCopy region = GetTextureToBufferCopyRegion(pSrcTexture->GetDesc(), dstOffset);
+		vkCmdCopyImageToBuffer(m_CommandBuffer, pSrcTexture->GetNativeHandle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, pDstBuffer->GetNativeHandle(), 1, &region);
+	}
+
+	void RenderCommandList::CmdResetQueryPool(VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount) const
+	{
+		ZE_ASSERT(m_IsCommandRecording);
+		vkCmdResetQueryPool(m_CommandBuffer, queryPool, firstQuery, queryCount);
+	}
+
+	void RenderCommandList::CmdWriteTimestamp(VkPipelineStageFlagBits stage, VkQueryPool queryPool, uint32_t query) const
+	{
+		ZE_ASSERT(m_IsCommandRecording);
+		vkCmdWriteTimestamp(m_CommandBuffer, stage, queryPool, query);
+	}
+
+	void RenderCommandList::CmdBeginQuery(VkQueryPool queryPool, uint32_t query) const
+	{
+		ZE_ASSERT(m_IsCommandRecording);
+		vkCmdBeginQuery(m_CommandBuffer, queryPool, query, 0);
+	}
+
+	void RenderCommandList::CmdEndQuery(VkQueryPool queryPool, uint32_t query) const
+	{
+		ZE_ASSERT(m_IsCommandRecording);
+		vkCmdEndQuery(m_CommandBuffer, queryPool, query);
+	}
+}
@@ -4,6 +4,8 @@
 #include "RenderResourceState.h"
 #include "PipelineState.h"
 #include "RenderPass.h"
+#include "CommandListPool.h"
+#include "BufferHeap.h"
 
 #include <vulkan/vulkan_core.h>
 #include <glm/vec2.hpp>
@@ -62,23 +64,25 @@ namespace ZE::RenderBackend
 		std::vector<RenderPassRenderTargetBinding>			m_Attachments;
 	};
 	
+	/* Command lists are owned and recycled by CommandListPool, acquire them from RenderDevice. */
 	class RenderCommandList : public RenderDeviceChild
 	{
 		friend class RenderDevice;
+		friend class CommandListPool;
+		friend class RenderCommandStream;
 
 	public:
 
-		RenderCommandList(RenderDevice& renderDevice);
-		virtual ~RenderCommandList();
+		RenderCommandList(RenderDevice& renderDevice, VkCommandBuffer commandBuffer, uint32_t queueFamilyIndex);
+		virtual ~RenderCommandList() = default;
 
 		uint32_t GetQueueIndex() const { return m_QueueIndex; }
 		
 		bool BeginRecord();
 		void EndRecord();
-		void Reset() const;
 
 		// state commands
-		void CmdBeginDynamicRendering(const glm::uvec2& viewportSize, std::span<Texture*> renderTargets, std::span<RenderPassRenderTargetBinding> colorBindings) const;
+		void CmdBeginDynamicRendering(const glm::uvec2& viewportSize, std::span<Texture* const> renderTargets, std::span<const RenderPassRenderTargetBinding> colorBindings) const;
 		void CmdEndDynamicRendering() const;
 		void CmdSetViewport(const glm::uvec2& viewportSize) const;
 		// TODO: multi-scissors and offsets
@@ -90,21 +94,35 @@ namespace ZE::RenderBackend
 		
 		// pipeline resource commands
 		void CmdBindPipeline(VkPipelineBindPoint bindPoint, PipelineState* pPipelineState) const;
-		void CmdBindShaderResource(VkPipelineBindPoint bindPoint, PipelineState* pPipelineState, const std::vector<VkDescriptorSet>& sets) const;
+		/* Dynamic offsets are ordered by set and then binding, see PipelineState::FindDynamicOffsetIndex(). */
+		void CmdBindShaderResource(VkPipelineBindPoint bindPoint, PipelineState* pPipelineState, const std::vector<VkDescriptorSet>& sets, std::span<const uint32_t> dynamicOffsets = {}) const;
 		void CmdBindVertexInput(const Buffer* pVertexBuffer, const Buffer* pIndexBuffer = nullptr) const;
+		void CmdBindVertexInput(const BufferRange& vertexRange, const BufferRange& indexRange = {}) const;
 
 		// barrier commands
 		void CmdResourceBarrier(const GlobalMemoryBarrier* pMemoryBarrier, std::span<const BufferBarrier> pBufferBarriers, std::span<const TextureBarrier> pTextureBarriers) const;
 		
 		// transfer commands
 		void CmdCopyBuffer(Buffer* pSrcBuffer, Buffer* pDstBuffer, uint32_t srcOffset = 0) const;
+		void CmdCopyBuffer(Buffer* pSrcBuffer, Buffer* pDstBuffer, uint32_t srcOffset, uint32_t dstOffset, uint32_t sizeInByte) const;
+		/* Texture must be in transfer read state, mip 0 is copied as tightly packed rows. */
+		void CmdCopyTextureToBuffer(Texture* pSrcTexture, Buffer* pDstBuffer, uint32_t dstOffset = 0) const;
+
+		// query commands
+		void CmdResetQueryPool(VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount) const;
+		void CmdWriteTimestamp(VkPipelineStageFlagBits stage, VkQueryPool queryPool, uint32_t query) const;
+		void CmdBeginQuery(VkQueryPool queryPool, uint32_t query) const;
+		void CmdEndQuery(VkQueryPool queryPool, uint32_t query) const;
 
 	private:
 		
-		VkCommandPool					m_CommandPool = nullptr;
 		VkCommandBuffer					m_CommandBuffer = nullptr;
 		bool							m_IsCommandRecording = false;
 
 		uint32_t						m_QueueIndex = std::numeric_limits<uint32_t>::max();
+
+		// pool which this command list is allocated from
+		CommandListPool::ThreadPools*	m_OwnerThreadPools = nullptr;
+		uint32_t						m_OwnerFrameIndex = 0;
 	};
 }
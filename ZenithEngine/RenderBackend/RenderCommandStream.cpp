@@ -0,0 +1,971 @@
+#include "RenderCommandStream.h"
+
+#include "Core/Assertion.h"
+#include "RenderCommandList.h"
+#include "RenderDevice.h"
+#include "RenderResource.h"
+#include "PipelineState.h"
+#include "BindlessResourceTable.h"
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+#include "Math/Math.h"
+
+namespace ZE::RenderBackend
+{
+	namespace
+	{
+		constexpr uint32_t kCommandAlignment = 8u;
+		constexpr uint32_t kSerializationMagic = 0x5343525Au; // "ZRCS"
+		constexpr uint32_t kSerializationVersion = 2u;
+
+		static_assert(std::is_trivially_copyable_v<RenderPassRenderTargetBinding>);
+		static_assert(std::is_trivially_copyable_v<DescriptorWrite>);
+
+		struct CommandHeader
+		{
+			ERenderCommandType					m_Type = ERenderCommandType::Count;
+			// size of the whole command including header and trailing arrays
+			uint32_t							m_SizeInByte = 0;
+		};
+
+		struct SerializationHeader
+		{
+			uint32_t							m_Magic = kSerializationMagic;
+			uint32_t							m_Version = kSerializationVersion;
+			uint32_t							m_CommandCount = 0;
+			uint32_t							m_SizeInByte = 0;
+		};
+
+		// trailing: Texture* [attachment count], RenderPassRenderTargetBinding [attachment count]
+		struct BeginDynamicRenderingCommand
+		{
+			static constexpr auto kType = ERenderCommandType::BeginDynamicRendering;
+			CommandHeader						m_Header;
+			uint32_t							m_ViewportWidth = 0;
+			uint32_t							m_ViewportHeight = 0;
+			uint32_t							m_AttachmentCount = 0;
+		};
+
+		struct EndDynamicRenderingCommand
+		{
+			static constexpr auto kType = ERenderCommandType::EndDynamicRendering;
+			CommandHeader						m_Header;
+		};
+
+		struct SetViewportCommand
+		{
+			static constexpr auto kType = ERenderCommandType::SetViewport;
+			CommandHeader						m_Header;
+			VkViewport							m_Viewport;
+		};
+
+		struct SetScissorCommand
+		{
+			static constexpr auto kType = ERenderCommandType::SetScissor;
+			CommandHeader						m_Header;
+			VkRect2D							m_Scissor;
+		};
+
+		struct DrawCommand
+		{
+			static constexpr auto kType = ERenderCommandType::Draw;
+			CommandHeader						m_Header;
+			uint32_t							m_VertexCount = 0;
+			uint32_t							m_InstanceCount = 0;
+			uint32_t							m_FirstVertex = 0;
+			uint32_t							m_FirstInstance = 0;
+		};
+
+		struct DrawIndexedCommand
+		{
+			static constexpr auto kType = ERenderCommandType::DrawIndexed;
+			CommandHeader						m_Header;
+			uint32_t							m_IndexCount = 0;
+			uint32_t							m_InstanceCount = 0;
+			uint32_t							m_FirstIndex = 0;
+			int32_t								m_VertexOffset = 0;
+			uint32_t							m_FirstInstance = 0;
+		};
+
+		struct BindPipelineCommand
+		{
+			static constexpr auto kType = ERenderCommandType::BindPipeline;
+			CommandHeader						m_Header;
+			VkPipelineBindPoint					m_BindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+			VkPipeline							m_Pipeline = nullptr;
+		};
+
+		// trailing: DescriptorWrite [write count]
+		struct UpdateDescriptorSetCommand
+		{
+			static constexpr auto kType = ERenderCommandType::UpdateDescriptorSet;
+			CommandHeader						m_Header;
+			VkDescriptorSet						m_Set = nullptr;
+			uint32_t							m_WriteCount = 0;
+		};
+
+		// trailing: VkDescriptorSet [set count], uint32_t [dynamic offset count]
+		struct BindDescriptorSetsCommand
+		{
+			static constexpr auto kType = ERenderCommandType::BindDescriptorSets;
+			CommandHeader						m_Header;
+			VkPipelineBindPoint					m_BindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+			VkPipelineLayout					m_Layout = nullptr;
+			uint32_t							m_FirstSet = 0;
+			uint32_t							m_SetCount = 0;
+			uint32_t							m_DynamicOffsetCount = 0;
+		};
+
+		// the bindless set is resolved while replaying
+		struct BindBindlessSetCommand
+		{
+			static constexpr auto kType = ERenderCommandType::BindBindlessSet;
+			CommandHeader						m_Header;
+			VkPipelineBindPoint					m_BindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+			VkPipelineLayout					m_Layout = nullptr;
+		};
+
+		struct BindVertexBufferCommand
+		{
+			static constexpr auto kType = ERenderCommandType::BindVertexBuffer;
+			CommandHeader						m_Header;
+			VkBuffer							m_Buffer = nullptr;
+			VkDeviceSize						m_Offset = 0;
+		};
+
+		struct BindIndexBufferCommand
+		{
+			static constexpr auto kType = ERenderCommandType::BindIndexBuffer;
+			CommandHeader						m_Header;
+			VkBuffer							m_Buffer = nullptr;
+			VkDeviceSize						m_Offset = 0;
+			VkIndexType							m_IndexType = VK_INDEX_TYPE_UINT32;
+		};
+
+		// trailing: VkMemoryBarrier [memory barrier count], VkBufferMemoryBarrier [buffer barrier count], VkImageMemoryBarrier [image barrier count]
+		struct PipelineBarrierCommand
+		{
+			static constexpr auto kType = ERenderCommandType::PipelineBarrier;
+			CommandHeader						m_Header;
+			VkPipelineStageFlags				m_SrcStage = 0;
+			VkPipelineStageFlags				m_DstStage = 0;
+			uint32_t							m_MemoryBarrierCount = 0;
+			uint32_t							m_BufferBarrierCount = 0;
+			uint32_t							m_ImageBarrierCount = 0;
+		};
+
+		struct CopyBufferCommand
+		{
+			static constexpr auto kType = ERenderCommandType::CopyBuffer;
+			CommandHeader						m_Header;
+			VkBuffer							m_SrcBuffer = nullptr;
+			VkBuffer							m_DstBuffer = nullptr;
+			VkBufferCopy						m_Region;
+		};
+
+		struct CopyTextureToBufferCommand
+		{
+			static constexpr auto kType = ERenderCommandType::CopyTextureToBuffer;
+			CommandHeader						m_Header;
+			VkImage								m_SrcImage = nullptr;
+			VkBuffer							m_DstBuffer = nullptr;
+			VkBufferImageCopy					m_Region;
+		};
+
+		struct ResetQueryPoolCommand
+		{
+			static constexpr auto kType = ERenderCommandType::ResetQueryPool;
+			CommandHeader						m_Header;
+			VkQueryPool							m_QueryPool = nullptr;
+			uint32_t							m_FirstQuery = 0;
+			uint32_t							m_QueryCount = 0;
+		};
+
+		struct WriteTimestampCommand
+		{
+			static constexpr auto kType = ERenderCommandType::WriteTimestamp;
+			CommandHeader						m_Header;
+			VkQueryPool							m_QueryPool = nullptr;
+			VkPipelineStageFlagBits				m_Stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			uint32_t							m_Query = 0;
+		};
+
+		struct BeginQueryCommand
+		{
+			static constexpr auto kType = ERenderCommandType::BeginQuery;
+			CommandHeader						m_Header;
+			VkQueryPool							m_QueryPool = nullptr;
+			uint32_t							m_Query = 0;
+		};
+
+		struct EndQueryCommand
+		{
+			static constexpr auto kType = ERenderCommandType::EndQuery;
+			CommandHeader						m_Header;
+			VkQueryPool							m_QueryPool = nullptr;
+			uint32_t							m_Query = 0;
+		};
+
+		uint32_t AlignedSize(size_t size)
+		{
+			return Math::AlignTo(static_cast<uint32_t>(size), kCommandAlignment);
+		}
+
+		// trailing arrays start after the command and each of them is aligned
+		template <typename T>
+		uint32_t TrailingArraySize(uint32_t count)
+		{
+			static_assert(alignof(T) <= kCommandAlignment);
+			return AlignedSize(sizeof(T) * count);
+		}
+
+		template <typename TCommand>
+		const std::byte* GetTrailingData(const TCommand& command)
+		{
+			return reinterpret_cast<const std::byte*>(&command) + AlignedSize(sizeof(TCommand));
+		}
+
+		template <typename TCommand>
+		std::byte* GetTrailingData(TCommand& command)
+		{
+			return reinterpret_cast<std::byte*>(&command) + AlignedSize(sizeof(TCommand));
+		}
+
+		template <typename T>
+		void WriteTrailingArray(std::byte*& pCursor, std::span<const T> elements)
+		{
+			if (!elements.empty())
+			{
+				memcpy(pCursor, elements.data(), elements.size_bytes());
+			}
+			pCursor += TrailingArraySize<T>(static_cast<uint32_t>(elements.size()));
+		}
+
+		template <typename T>
+		std::span<const T> ReadTrailingArray(const std::byte*& pCursor, uint32_t count)
+		{
+			const auto* pElements = reinterpret_cast<const T*>(pCursor);
+			pCursor += TrailingArraySize<T>(count);
+			return { pElements, count };
+		}
+
+		constexpr uint32_t GetBindPointIndex(VkPipelineBindPoint bindPoint)
+		{
+			switch (bindPoint)
+			{
+				case VK_PIPELINE_BIND_POINT_GRAPHICS: return 0;
+				case VK_PIPELINE_BIND_POINT_COMPUTE: return 1;
+				default: return 2;
+			}
+		}
+
+		// what is currently bound on the command buffer, so identical binds can be dropped
+		struct ReplayState
+		{
+			std::array<VkPipeline, 3>							m_Pipelines = {};
+			std::array<const BindDescriptorSetsCommand*, 3>		m_DescriptorSets = {};
+			std::array<VkPipelineLayout, 3>						m_BindlessSetLayouts = {};
+
+			bool												m_HasViewport = false;
+			VkViewport											m_Viewport;
+			bool												m_HasScissor = false;
+			VkRect2D											m_Scissor;
+
+			bool												m_HasVertexBuffer = false;
+			VkBuffer											m_VertexBuffer = nullptr;
+			VkDeviceSize										m_VertexBufferOffset = 0;
+			bool												m_HasIndexBuffer = false;
+			VkBuffer											m_IndexBuffer = nullptr;
+			VkDeviceSize										m_IndexBufferOffset = 0;
+			VkIndexType											m_IndexType = VK_INDEX_TYPE_UINT32;
+		};
+
+		template <typename TCommand>
+		bool ReadCommand(std::span<const std::byte> data, TCommand& command)
+		{
+			if (data.size() < AlignedSize(sizeof(TCommand)))
+			{
+				return false;
+			}
+			memcpy(&command, data.data(), sizeof(TCommand));
+			return true;
+		}
+
+		// size the command must have for its own counts, 0 if the command is truncated
+		uint32_t GetExpectedCommandSize(std::span<const std::byte> data, ERenderCommandType type)
+		{
+			switch (type)
+			{
+				case ERenderCommandType::BeginDynamicRendering:
+				{
+					BeginDynamicRenderingCommand command;
+					return ReadCommand(data, command) ? AlignedSize(sizeof(command)) + TrailingArraySize<Texture*>(command.m_AttachmentCount) + TrailingArraySize<RenderPassRenderTargetBinding>(command.m_AttachmentCount) : 0u;
+				}
+				case ERenderCommandType::EndDynamicRendering: return AlignedSize(sizeof(EndDynamicRenderingCommand));
+				case ERenderCommandType::SetViewport: return AlignedSize(sizeof(SetViewportCommand));
+				case ERenderCommandType::SetScissor: return AlignedSize(sizeof(SetScissorCommand));
+				case ERenderCommandType::Draw: return AlignedSize(sizeof(DrawCommand));
+				case ERenderCommandType::DrawIndexed: return AlignedSize(sizeof(DrawIndexedCommand));
+				case ERenderCommandType::BindPipeline: return AlignedSize(sizeof(BindPipelineCommand));
+				case ERenderCommandType::UpdateDescriptorSet:
+				{
+					UpdateDescriptorSetCommand command;
+					return ReadCommand(data, command) ? AlignedSize(sizeof(command)) + TrailingArraySize<DescriptorWrite>(command.m_WriteCount) : 0u;
+				}
+				case ERenderCommandType::BindDescriptorSets:
+				{
+					BindDescriptorSetsCommand command;
+					return ReadCommand(data, command) ? AlignedSize(sizeof(command)) + TrailingArraySize<VkDescriptorSet>(command.m_SetCount) + TrailingArraySize<uint32_t>(command.m_DynamicOffsetCount) : 0u;
+				}
+				case ERenderCommandType::BindBindlessSet: return AlignedSize(sizeof(BindBindlessSetCommand));
+				case ERenderCommandType::BindVertexBuffer: return AlignedSize(sizeof(BindVertexBufferCommand));
+				case ERenderCommandType::BindIndexBuffer: return AlignedSize(sizeof(BindIndexBufferCommand));
+				case ERenderCommandType::PipelineBarrier:
+				{
+					PipelineBarrierCommand command;
+					return ReadCommand(data, command) ? AlignedSize(sizeof(command)) + TrailingArraySize<VkMemoryBarrier>(command.m_MemoryBarrierCount)
+						+ TrailingArraySize<VkBufferMemoryBarrier>(command.m_BufferBarrierCount) + TrailingArraySize<VkImageMemoryBarrier>(command.m_ImageBarrierCount) : 0u;
+				}
+				case ERenderCommandType::CopyBuffer: return AlignedSize(sizeof(CopyBufferCommand));
+				case ERenderCommandType::CopyTextureToBuffer: return AlignedSize(sizeof(CopyTextureToBufferCommand));
+				case ERenderCommandType::ResetQueryPool: return AlignedSize(sizeof(ResetQueryPoolCommand));
+				case ERenderCommandType::WriteTimestamp: return AlignedSize(sizeof(WriteTimestampCommand));
+				case ERenderCommandType::BeginQuery: return AlignedSize(sizeof(BeginQueryCommand));
+				case ERenderCommandType::EndQuery: return AlignedSize(sizeof(EndQueryCommand));
+				default: return 0u;
+			}
+		}
+
+		bool IsSameDescriptorSets(const BindDescriptorSetsCommand* pBound, const BindDescriptorSetsCommand& command)
+		{
+			// trailing arrays are packed with padding zeroed, so equal commands compare equal byte-wise
+			return pBound
+				&& pBound->m_Header.m_SizeInByte == command.m_Header.m_SizeInByte
+				&& pBound->m_Layout == command.m_Layout
+				&& pBound->m_FirstSet == command.m_FirstSet
+				&& pBound->m_SetCount == command.m_SetCount
+				&& pBound->m_DynamicOffsetCount == command.m_DynamicOffsetCount
+				&& memcmp(GetTrailingData(*pBound), GetTrailingData(command), command.m_Header.m_SizeInByte - AlignedSize(sizeof(BindDescriptorSetsCommand))) == 0;
+		}
+	}
+
+	template <typename TCommand>
+	TCommand& RenderCommandStream::Push(uint32_t trailingSizeInByte)
+	{
+		static_assert(std::is_trivially_copyable_v<TCommand> && alignof(TCommand) <= kCommandAlignment);
+
+		const uint32_t sizeInByte = AlignedSize(sizeof(TCommand)) + trailingSizeInByte;
+		const size_t offset = m_Data.size();
+		// zero filled, so the padding never holds garbage
+		m_Data.resize(offset + sizeInByte);
+
+		auto* pCommand = std::construct_at(reinterpret_cast<TCommand*>(m_Data.data() + offset));
+		pCommand->m_Header.m_Type = TCommand::kType;
+		pCommand->m_Header.m_SizeInByte = sizeInByte;
+		++m_CommandCount;
+		return *pCommand;
+	}
+
+	void RenderCommandStream::CmdBeginDynamicRendering(const glm::uvec2& viewportSize, std::span<Texture* const> renderTargets, std::span<const RenderPassRenderTargetBinding> colorBindings)
+	{
+		ZE_ASSERT(renderTargets.size() == colorBindings.size());
+
+		if (renderTargets.empty())
+		{
+			return;
+		}
+
+		const auto attachmentCount = static_cast<uint32_t>(renderTargets.size());
+		auto& command = Push<BeginDynamicRenderingCommand>(TrailingArraySize<Texture*>(attachmentCount) + TrailingArraySize<RenderPassRenderTargetBinding>(attachmentCount));
+		command.m_ViewportWidth = viewportSize.x;
+		command.m_ViewportHeight = viewportSize.y;
+		command.m_AttachmentCount = attachmentCount;
+
+		std::byte* pCursor = GetTrailingData(command);
+		WriteTrailingArray(pCursor, renderTargets);
+		WriteTrailingArray(pCursor, colorBindings);
+	}
+
+	void RenderCommandStream::CmdEndDynamicRendering()
+	{
+		Push<EndDynamicRenderingCommand>();
+	}
+
+	void RenderCommandStream::CmdSetViewport(const glm::uvec2& viewportSize)
+	{
+		auto& command = Push<SetViewportCommand>();
+		command.m_Viewport.x = 0.0f;
+		command.m_Viewport.y = 0.0f;
+		command.m_Viewport.width = static_cast<float>(viewportSize.x);
+		command.m_Viewport.height = static_cast<float>(viewportSize.y);
+		command.m_Viewport.minDepth = 0.0f;
+		command.m_Viewport.maxDepth = 1.0f;
+	}
+
+	void RenderCommandStream::CmdSetScissor(const glm::uvec2& viewportSize)
+	{
+		auto& command = Push<SetScissorCommand>();
+		command.m_Scissor.offset = { 0, 0 };
+		command.m_Scissor.extent = { viewportSize.x, viewportSize.y };
+	}
+
+	void RenderCommandStream::CmdDraw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+	{
+		auto& command = Push<DrawCommand>();
+		command.m_VertexCount = vertexCount;
+		command.m_InstanceCount = instanceCount;
+		command.m_FirstVertex = firstVertex;
+		command.m_FirstInstance = firstInstance;
+	}
+
+	void RenderCommandStream::CmdDrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
+	{
+		auto& command = Push<DrawIndexedCommand>();
+		command.m_IndexCount = indexCount;
+		command.m_InstanceCount = instanceCount;
+		command.m_FirstIndex = firstIndex;
+		command.m_VertexOffset = vertexOffset;
+		command.m_FirstInstance = firstInstance;
+	}
+
+	void RenderCommandStream::CmdBindPipeline(VkPipelineBindPoint bindPoint, PipelineState* pPipelineState)
+	{
+		ZE_ASSERT(pPipelineState);
+
+		auto& command = Push<BindPipelineCommand>();
+		command.m_BindPoint = bindPoint;
+		command.m_Pipeline = pPipelineState->m_Pipeline;
+	}
+
+	void RenderCommandStream::CmdUpdateDescriptorSet(VkDescriptorSet set, std::span<const DescriptorWrite> writes)
+	{
+		ZE_ASSERT(set);
+
+		if (writes.empty())
+		{
+			return;
+		}
+
+		const auto writeCount = static_cast<uint32_t>(writes.size());
+		auto& command = Push<UpdateDescriptorSetCommand>(TrailingArraySize<DescriptorWrite>(writeCount));
+		command.m_Set = set;
+		command.m_WriteCount = writeCount;
+
+		std::byte* pCursor = GetTrailingData(command);
+		WriteTrailingArray(pCursor, writes);
+	}
+
+	void RenderCommandStream::CmdBindShaderResource(VkPipelineBindPoint bindPoint, PipelineState* pPipelineState, std::span<const VkDescriptorSet> sets, std::span<const uint32_t> dynamicOffsets)
+	{
+		ZE_ASSERT(pPipelineState);
+		ZE_ASSERT_LOG(dynamicOffsets.size() == pPipelineState->GetDynamicOffsetCount(), "Pipeline expects {} dynamic offsets, but {} are given!", pPipelineState->GetDynamicOffsetCount(), dynamicOffsets.size());
+
+		if (!sets.empty())
+		{
+			const auto setCount = static_cast<uint32_t>(sets.size());
+			const auto dynamicOffsetCount = static_cast<uint32_t>(dynamicOffsets.size());
+
+			auto& command = Push<BindDescriptorSetsCommand>(TrailingArraySize<VkDescriptorSet>(setCount) + TrailingArraySize<uint32_t>(dynamicOffsetCount));
+			command.m_BindPoint = bindPoint;
+			command.m_Layout = pPipelineState->m_Layout;
+			command.m_FirstSet = 0;
+			command.m_SetCount = setCount;
+			command.m_DynamicOffsetCount = dynamicOffsetCount;
+
+			std::byte* pCursor = GetTrailingData(command);
+			WriteTrailingArray(pCursor, sets);
+			WriteTrailingArray(pCursor, dynamicOffsets);
+		}
+
+		if (pPipelineState->m_UseBindlessSet)
+		{
+			auto& command = Push<BindBindlessSetCommand>();
+			command.m_BindPoint = bindPoint;
+			command.m_Layout = pPipelineState->m_Layout;
+		}
+	}
+
+	void RenderCommandStream::CmdBindVertexInput(const Buffer* pVertexBuffer, const Buffer* pIndexBuffer)
+	{
+		ZE_ASSERT(pVertexBuffer);
+
+		BufferRange vertexRange;
+		vertexRange.m_pBuffer = const_cast<Buffer*>(pVertexBuffer);
+		vertexRange.m_Size = pVertexBuffer->GetDesc().m_Size;
+
+		BufferRange indexRange;
+		if (pIndexBuffer)
+		{
+			indexRange.m_pBuffer = const_cast<Buffer*>(pIndexBuffer);
+			indexRange.m_Size = pIndexBuffer->GetDesc().m_Size;
+		}
+
+		CmdBindVertexInput(vertexRange, indexRange);
+	}
+
+	void RenderCommandStream::CmdBindVertexInput(const BufferRange& vertexRange, const BufferRange& indexRange)
+	{
+		ZE_ASSERT(vertexRange.IsValid());
+
+		auto& vertexCommand = Push<BindVertexBufferCommand>();
+		vertexCommand.m_Buffer = vertexRange.GetNativeHandle();
+		vertexCommand.m_Offset = vertexRange.m_Offset;
+
+		if (indexRange.IsValid())
+		{
+			// TODO: uint16 index type
+			auto& indexCommand = Push<BindIndexBufferCommand>();
+			indexCommand.m_Buffer = indexRange.GetNativeHandle();
+			indexCommand.m_Offset = indexRange.m_Offset;
+			indexCommand.m_IndexType = VK_INDEX_TYPE_UINT32;
+		}
+	}
+
+	void RenderCommandStream::CmdResourceBarrier(const GlobalMemoryBarrier* pMemoryBarrier, std::span<const BufferBarrier> pBufferBarriers, std::span<const TextureBarrier> pTextureBarriers)
+	{
+		const uint32_t memoryBarrierCount = pMemoryBarrier ? 1u : 0u;
+		const auto bufferBarrierCount = static_cast<uint32_t>(pBufferBarriers.size());
+		const auto imageBarrierCount = static_cast<uint32_t>(pTextureBarriers.size());
+
+		// an empty barrier is a no-op, the graph issues one for every node
+		if (memoryBarrierCount + bufferBarrierCount + imageBarrierCount == 0)
+		{
+			return;
+		}
+
+		auto& command = Push<PipelineBarrierCommand>(TrailingArraySize<VkMemoryBarrier>(memoryBarrierCount)
+			+ TrailingArraySize<VkBufferMemoryBarrier>(bufferBarrierCount)
+			+ TrailingArraySize<VkImageMemoryBarrier>(imageBarrierCount));
+		command.m_SrcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		command.m_DstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+		command.m_MemoryBarrierCount = memoryBarrierCount;
+		command.m_BufferBarrierCount = bufferBarrierCount;
+		command.m_ImageBarrierCount = imageBarrierCount;
+
+		std::byte* pCursor = GetTrailingData(command);
+		if (pMemoryBarrier)
+		{
+			const auto transition = GetMemoryBarrierTransition(*pMemoryBarrier);
+			command.m_SrcStage |= transition.m_SrcStage;
+			command.m_DstStage |= transition.m_DstStage;
+			WriteTrailingArray(pCursor, std::span(&transition.m_Barrier, 1));
+		}
+
+		auto* pVkBufferBarriers = reinterpret_cast<VkBufferMemoryBarrier*>(pCursor);
+		for (uint32_t i = 0; i < bufferBarrierCount; ++i)
+		{
+			const auto transition = GetBufferBarrierTransition(pBufferBarriers[i]);
+			command.m_SrcStage |= transition.m_SrcStage;
+			command.m_DstStage |= transition.m_DstStage;
+			pVkBufferBarriers[i] = transition.m_Barrier;
+		}
+		pCursor += TrailingArraySize<VkBufferMemoryBarrier>(bufferBarrierCount);
+
+		auto* pVkImageBarriers = reinterpret_cast<VkImageMemoryBarrier*>(pCursor);
+		for (uint32_t i = 0; i < imageBarrierCount; ++i)
+		{
+			const auto transition = GetTextureBarrierTransition(pTextureBarriers[i]);
+			command.m_SrcStage |= transition.m_SrcStage;
+			command.m_DstStage |= transition.m_DstStage;
+			pVkImageBarriers[i] = transition.m_Barrier;
+		}
+	}
+
+	void RenderCommandStream::CmdCopyBuffer(Buffer* pSrcBuffer, Buffer* pDstBuffer, uint32_t srcOffset)
+	{
+		auto& command = Push<CopyBufferCommand>();
+		command.m_SrcBuffer = pSrcBuffer->GetNativeHandle();
+		command.m_DstBuffer = pDstBuffer->GetNativeHandle();
+		command.m_Region.size = pDstBuffer->GetDesc().m_Size;
+		command.m_Region.srcOffset = srcOffset;
+		command.m_Region.dstOffset = 0;
+	}
+
+	void RenderCommandStream::CmdCopyBuffer(Buffer* pSrcBuffer, Buffer* pDstBuffer, uint32_t srcOffset, uint32_t dstOffset, uint32_t sizeInByte)
+	{
+		auto& command = Push<CopyBufferCommand>();
+		command.m_SrcBuffer = pSrcBuffer->GetNativeHandle();
+		command.m_DstBuffer = pDstBuffer->GetNativeHandle();
+		command.m_Region.size = sizeInByte;
+		command.m_Region.srcOffset = srcOffset;
+		command.m_Region.dstOffset = dstOffset;
+	}
+
+	void RenderCommandStream::CmdCopyTextureToBuffer(Texture* pSrcTexture, Buffer* pDstBuffer, uint32_t dstOffset)
+	{
+		auto& command = Push<CopyTextureToBufferCommand>();
+		command.m_SrcImage = pSrcTexture->GetNativeHandle();
+		command.m_DstBuffer = pDstBuffer->GetNativeHandle();
+		command.m_Region = GetTextureToBufferCopyRegion(pSrcTexture->GetDesc(), dstOffset);
+	}
+
+	void RenderCommandStream::CmdResetQueryPool(VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount)
+	{
+		auto& command = Push<ResetQueryPoolCommand>();
+		command.m_QueryPool = queryPool;
+		command.m_FirstQuery = firstQuery;
+		command.m_QueryCount = queryCount;
+	}
+
+	void RenderCommandStream::CmdWriteTimestamp(VkPipelineStageFlagBits stage, VkQueryPool queryPool, uint32_t query)
+	{
+		auto& command = Push<WriteTimestampCommand>();
+		command.m_QueryPool = queryPool;
+		command.m_Stage = stage;
+		command.m_Query = query;
+	}
+
+	void RenderCommandStream::CmdBeginQuery(VkQueryPool queryPool, uint32_t query)
+	{
+		auto& command = Push<BeginQueryCommand>();
+		command.m_QueryPool = queryPool;
+		command.m_Query = query;
+	}
+
+	void RenderCommandStream::CmdEndQuery(VkQueryPool queryPool, uint32_t query)
+	{
+		auto& command = Push<EndQueryCommand>();
+		command.m_QueryPool = queryPool;
+		command.m_Query = query;
+	}
+
+	RenderCommandReplayStatistics RenderCommandStream::Replay(RenderCommandList& commandList) const
+	{
+		ZE_ASSERT(commandList.m_IsCommandRecording);
+
+		const VkCommandBuffer commandBuffer = commandList.m_CommandBuffer;
+		RenderCommandReplayStatistics statistics;
+		ReplayState state;
+		// reused by all descriptor updates of the stream
+		std::vector<VkWriteDescriptorSet> descriptorWrites;
+
+		for (size_t offset = 0; offset < m_Data.size();)
+		{
+			const auto& header = *reinterpret_cast<const CommandHeader*>(m_Data.data() + offset);
+			const std::byte* pCommand = m_Data.data() + offset;
+			offset += header.m_SizeInByte;
+			++statistics.m_CommandCount;
+
+			switch (header.m_Type)
+			{
+				case ERenderCommandType::BeginDynamicRendering:
+				{
+					const auto& command = *reinterpret_cast<const BeginDynamicRenderingCommand*>(pCommand);
+					const std::byte* pCursor = GetTrailingData(command);
+					const auto renderTargets = ReadTrailingArray<Texture*>(pCursor, command.m_AttachmentCount);
+					const auto bindings = ReadTrailingArray<RenderPassRenderTargetBinding>(pCursor, command.m_AttachmentCount);
+
+					// views are created while replaying, recording stays free of Vulkan calls
+					commandList.CmdBeginDynamicRendering({ command.m_ViewportWidth, command.m_ViewportHeight }, renderTargets, bindings);
+					break;
+				}
+				case ERenderCommandType::EndDynamicRendering:
+				{
+					vkCmdEndRendering(commandBuffer);
+					break;
+				}
+				case ERenderCommandType::SetViewport:
+				{
+					const auto& command = *reinterpret_cast<const SetViewportCommand*>(pCommand);
+					if (state.m_HasViewport && memcmp(&state.m_Viewport, &command.m_Viewport, sizeof(VkViewport)) == 0)
+					{
+						++statistics.m_FilteredCommandCount;
+						break;
+					}
+
+					vkCmdSetViewport(commandBuffer, 0, 1, &command.m_Viewport);
+					state.m_HasViewport = true;
+					state.m_Viewport = command.m_Viewport;
+					break;
+				}
+				case ERenderCommandType::SetScissor:
+				{
+					const auto& command = *reinterpret_cast<const SetScissorCommand*>(pCommand);
+					if (state.m_HasScissor && memcmp(&state.m_Scissor, &command.m_Scissor, sizeof(VkRect2D)) == 0)
+					{
+						++statistics.m_FilteredCommandCount;
+						break;
+					}
+
+					vkCmdSetScissor(commandBuffer, 0, 1, &command.m_Scissor);
+					state.m_HasScissor = true;
+					state.m_Scissor = command.m_Scissor;
+					break;
+				}
+				case ERenderCommandType::Draw:
+				{
+					const auto& command = *reinterpret_cast<const DrawCommand*>(pCommand);
+					vkCmdDraw(commandBuffer, command.m_VertexCount, command.m_InstanceCount, command.m_FirstVertex, command.m_FirstInstance);
+					++statistics.m_DrawCount;
+					break;
+				}
+				case ERenderCommandType::DrawIndexed:
+				{
+					const auto& command = *reinterpret_cast<const DrawIndexedCommand*>(pCommand);
+					vkCmdDrawIndexed(commandBuffer, command.m_IndexCount, command.m_InstanceCount, command.m_FirstIndex, command.m_VertexOffset, command.m_FirstInstance);
+					++statistics.m_DrawCount;
+					break;
+				}
+				case ERenderCommandType::BindPipeline:
+				{
+					const auto& command = *reinterpret_cast<const BindPipelineCommand*>(pCommand);
+					auto& boundPipeline = state.m_Pipelines[GetBindPointIndex(command.m_BindPoint)];
+					if (boundPipeline == command.m_Pipeline)
+					{
+						++statistics.m_FilteredCommandCount;
+						break;
+					}
+
+					vkCmdBindPipeline(commandBuffer, command.m_BindPoint, command.m_Pipeline);
+					boundPipeline = command.m_Pipeline;
+					break;
+				}
+				case ERenderCommandType::UpdateDescriptorSet:
+				{
+					const auto& command = *reinterpret_cast<const UpdateDescriptorSetCommand*>(pCommand);
+					const std::byte* pCursor = GetTrailingData(command);
+					const auto writes = ReadTrailingArray<DescriptorWrite>(pCursor, command.m_WriteCount);
+
+					// infos are pointed into the stream, it outlives the update
+					descriptorWrites.resize(writes.size());
+					for (uint32_t i = 0; i < writes.size(); ++i)
+					{
+						const bool bIsBuffer = writes[i].m_Type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+							|| writes[i].m_Type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC
+							|| writes[i].m_Type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+							|| writes[i].m_Type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+
+						auto& descriptorWrite = descriptorWrites[i];
+						descriptorWrite = {};
+						descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+						descriptorWrite.dstSet = command.m_Set;
+						descriptorWrite.dstBinding = writes[i].m_Binding;
+						descriptorWrite.descriptorCount = 1u;
+						descriptorWrite.descriptorType = writes[i].m_Type;
+						descriptorWrite.pBufferInfo = bIsBuffer ? &writes[i].m_BufferInfo : nullptr;
+						descriptorWrite.pImageInfo = bIsBuffer ? nullptr : &writes[i].m_ImageInfo;
+					}
+					vkUpdateDescriptorSets(commandList.GetRenderDevice().GetNativeDevice(), static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+					break;
+				}
+				case ERenderCommandType::BindDescriptorSets:
+				{
+					const auto& command = *reinterpret_cast<const BindDescriptorSetsCommand*>(pCommand);
+					const uint32_t bindPointIndex = GetBindPointIndex(command.m_BindPoint);
+					if (IsSameDescriptorSets(state.m_DescriptorSets[bindPointIndex], command))
+					{
+						++statistics.m_FilteredCommandCount;
+						break;
+					}
+
+					const std::byte* pCursor = GetTrailingData(command);
+					const auto sets = ReadTrailingArray<VkDescriptorSet>(pCursor, command.m_SetCount);
+					const auto dynamicOffsets = ReadTrailingArray<uint32_t>(pCursor, command.m_DynamicOffsetCount);
+					vkCmdBindDescriptorSets(commandBuffer, command.m_BindPoint, command.m_Layout,
+						command.m_FirstSet, command.m_SetCount, sets.data(),
+						command.m_DynamicOffsetCount, dynamicOffsets.data());
+
+					state.m_DescriptorSets[bindPointIndex] = &command;
+					// binding with an incompatible layout may disturb the other sets
+					if (state.m_BindlessSetLayouts[bindPointIndex] != command.m_Layout)
+					{
+						state.m_BindlessSetLayouts[bindPointIndex] = nullptr;
+					}
+					break;
+				}
+				case ERenderCommandType::BindBindlessSet:
+				{
+					const auto& command = *reinterpret_cast<const BindBindlessSetCommand*>(pCommand);
+					const uint32_t bindPointIndex = GetBindPointIndex(command.m_BindPoint);
+					if (state.m_BindlessSetLayouts[bindPointIndex] == command.m_Layout)
+					{
+						++statistics.m_FilteredCommandCount;
+						break;
+					}
+
+					const VkDescriptorSet bindlessSet = commandList.GetRenderDevice().GetBindlessResourceTable()->GetDescriptorSet();
+					vkCmdBindDescriptorSets(commandBuffer, command.m_BindPoint, command.m_Layout,
+						BindlessResourceTable::kBindlessSetIndex, 1u, &bindlessSet,
+						0, nullptr);
+
+					state.m_BindlessSetLayouts[bindPointIndex] = command.m_Layout;
+					if (state.m_DescriptorSets[bindPointIndex] && state.m_DescriptorSets[bindPointIndex]->m_Layout != command.m_Layout)
+					{
+						state.m_DescriptorSets[bindPointIndex] = nullptr;
+					}
+					break;
+				}
+				case ERenderCommandType::BindVertexBuffer:
+				{
+					const auto& command = *reinterpret_cast<const BindVertexBufferCommand*>(pCommand);
+					if (state.m_HasVertexBuffer && state.m_VertexBuffer == command.m_Buffer && state.m_VertexBufferOffset == command.m_Offset)
+					{
+						++statistics.m_FilteredCommandCount;
+						break;
+					}
+
+					vkCmdBindVertexBuffers(commandBuffer, 0, 1, &command.m_Buffer, &command.m_Offset);
+					state.m_HasVertexBuffer = true;
+					state.m_VertexBuffer = command.m_Buffer;
+					state.m_VertexBufferOffset = command.m_Offset;
+					break;
+				}
+				case ERenderCommandType::BindIndexBuffer:
+				{
+					const auto& command = *reinterpret_cast<const BindIndexBufferCommand*>(pCommand);
+					if (state.m_HasIndexBuffer && state.m_IndexBuffer == command.m_Buffer && state.m_IndexBufferOffset == command.m_Offset && state.m_IndexType == command.m_IndexType)
+					{
+						++statistics.m_FilteredCommandCount;
+						break;
+					}
+
+					vkCmdBindIndexBuffer(commandBuffer, command.m_Buffer, command.m_Offset, command.m_IndexType);
+					state.m_HasIndexBuffer = true;
+					state.m_IndexBuffer = command.m_Buffer;
+					state.m_IndexBufferOffset = command.m_Offset;
+					state.m_IndexType = command.m_IndexType;
+					break;
+				}
+				case ERenderCommandType::PipelineBarrier:
+				{
+					const auto& command = *reinterpret_cast<const PipelineBarrierCommand*>(pCommand);
+					const std::byte* pCursor = GetTrailingData(command);
+					const auto memoryBarriers = ReadTrailingArray<VkMemoryBarrier>(pCursor, command.m_MemoryBarrierCount);
+					const auto bufferBarriers = ReadTrailingArray<VkBufferMemoryBarrier>(pCursor, command.m_BufferBarrierCount);
+					const auto imageBarriers = ReadTrailingArray<VkImageMemoryBarrier>(pCursor, command.m_ImageBarrierCount);
+
+					vkCmdPipelineBarrier(commandBuffer, command.m_SrcStage, command.m_DstStage, 0,
+						command.m_MemoryBarrierCount, memoryBarriers.data(),
+						command.m_BufferBarrierCount, bufferBarriers.data(),
+						command.m_ImageBarrierCount, imageBarriers.data());
+					break;
+				}
+				case ERenderCommandType::CopyBuffer:
+				{
+					const auto& command = *reinterpret_cast<const CopyBufferCommand*>(pCommand);
+					vkCmdCopyBuffer(commandBuffer, command.m_SrcBuffer, command.m_DstBuffer, 1, &command.m_Region);
+					break;
+				}
+				case ERenderCommandType::CopyTextureToBuffer:
+				{
+					const auto& command = *reinterpret_cast<const CopyTextureToBufferCommand*>(pCommand);
+					vkCmdCopyImageToBuffer(commandBuffer, command.m_SrcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, command.m_DstBuffer, 1, &command.m_Region);
+					break;
+				}
+				case ERenderCommandType::ResetQueryPool:
+				{
+					const auto& command = *reinterpret_cast<const ResetQueryPoolCommand*>(pCommand);
+					vkCmdResetQueryPool(commandBuffer, command.m_QueryPool, command.m_FirstQuery, command.m_QueryCount);
+					break;
+				}
+				case ERenderCommandType::WriteTimestamp:
+				{
+					const auto& command = *reinterpret_cast<const WriteTimestampCommand*>(pCommand);
+					vkCmdWriteTimestamp(commandBuffer, command.m_Stage, command.m_QueryPool, command.m_Query);
+					break;
+				}
+				case ERenderCommandType::BeginQuery:
+				{
+					const auto& command = *reinterpret_cast<const BeginQueryCommand*>(pCommand);
+					vkCmdBeginQuery(commandBuffer, command.m_QueryPool, command.m_Query, 0);
+					break;
+				}
+				case ERenderCommandType::EndQuery:
+				{
+					const auto& command = *reinterpret_cast<const EndQueryCommand*>(pCommand);
+					vkCmdEndQuery(commandBuffer, command.m_QueryPool, command.m_Query);
+					break;
+				}
+				default:
+				{
+					ZE_LOG_ERROR("Render command stream holds an invalid command type {}!", static_cast<uint32_t>(header.m_Type));
+					ZE_ASSERT(false);
+					return statistics;
+				}
+			}
+		}
+
+		return statistics;
+	}
+
+	void RenderCommandStream::Reset()
+	{
+		// keep the capacity for the next recording
+		m_Data.clear();
+		m_CommandCount = 0;
+	}
+
+	std::vector<std::byte> RenderCommandStream::Serialize() const
+	{
+		SerializationHeader header;
+		header.m_CommandCount = m_CommandCount;
+		header.m_SizeInByte = static_cast<uint32_t>(m_Data.size());
+
+		std::vector<std::byte> data(sizeof(SerializationHeader) + m_Data.size());
+		memcpy(data.data(), &header, sizeof(SerializationHeader));
+		if (!m_Data.empty())
+		{
+			memcpy(data.data() + sizeof(SerializationHeader), m_Data.data(), m_Data.size());
+		}
+		return data;
+	}
+
+	bool RenderCommandStream::Deserialize(std::span<const std::byte> data)
+	{
+		if (data.size() < sizeof(SerializationHeader))
+		{
+			ZE_LOG_ERROR("Failed to deserialize render command stream, data is too small ({} bytes).", data.size());
+			return false;
+		}
+
+		SerializationHeader header;
+		memcpy(&header, data.data(), sizeof(SerializationHeader));
+		if (header.m_Magic != kSerializationMagic || header.m_Version != kSerializationVersion)
+		{
+			ZE_LOG_ERROR("Failed to deserialize render command stream, unknown format (magic: {:#x}, version: {}).", header.m_Magic, header.m_Version);
+			return false;
+		}
+		if (header.m_SizeInByte != data.size() - sizeof(SerializationHeader))
+		{
+			ZE_LOG_ERROR("Failed to deserialize render command stream, size mismatch (header: {} bytes, data: {} bytes).", header.m_SizeInByte, data.size() - sizeof(SerializationHeader));
+			return false;
+		}
+
+		const auto commandData = data.subspan(sizeof(SerializationHeader));
+
+		// walk the commands before accepting them, Replay() trusts the layout
+		uint32_t commandCount = 0;
+		for (size_t offset = 0; offset < commandData.size(); ++commandCount)
+		{
+			if (commandData.size() - offset < sizeof(CommandHeader))
+			{
+				ZE_LOG_ERROR("Failed to deserialize render command stream, truncated command at {}.", offset);
+				return false;
+			}
+
+			CommandHeader commandHeader;
+			memcpy(&commandHeader, commandData.data() + offset, sizeof(CommandHeader));
+			if (commandHeader.m_SizeInByte > commandData.size() - offset
+				|| commandHeader.m_SizeInByte != GetExpectedCommandSize(commandData.subspan(offset, commandHeader.m_SizeInByte), commandHeader.m_Type))
+			{
+				ZE_LOG_ERROR("Failed to deserialize render command stream, invalid command at {}.", offset);
+				return false;
+			}
+			offset += commandHeader.m_SizeInByte;
+		}
+
+		if (commandCount != header.m_CommandCount)
+		{
+			ZE_LOG_ERROR("Failed to deserialize render command stream, command count mismatch (header: {}, data: {}).", header.m_CommandCount, commandCount);
+			return false;
+		}
+
+		m_Data.assign(commandData.begin(), commandData.end());
+		m_CommandCount = commandCount;
+		return true;
+	}
+}
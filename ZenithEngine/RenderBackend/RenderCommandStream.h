@@ -0,0 +1,139 @@
+#pragma once
+
+#include "RenderResourceState.h"
+#include "RenderPass.h"
+#include "BufferHeap.h"
+
+#include <vulkan/vulkan_core.h>
+#include <glm/vec2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <span>
+
+namespace ZE::RenderBackend
+{
+	class RenderCommandList;
+	class PipelineState;
+	class Texture;
+	class Buffer;
+
+	enum class ERenderCommandType : uint8_t
+	{
+		BeginDynamicRendering = 0,
+		EndDynamicRendering,
+		SetViewport,
+		SetScissor,
+		Draw,
+		DrawIndexed,
+		BindPipeline,
+		UpdateDescriptorSet,
+		BindDescriptorSets,
+		BindBindlessSet,
+		BindVertexBuffer,
+		BindIndexBuffer,
+		PipelineBarrier,
+		CopyBuffer,
+		CopyTextureToBuffer,
+		ResetQueryPool,
+		WriteTimestamp,
+		BeginQuery,
+		EndQuery,
+
+		Count,
+	};
+
+	struct RenderCommandReplayStatistics
+	{
+		uint32_t					m_CommandCount = 0;
+		// state commands dropped because the same state was already bound
+		uint32_t					m_FilteredCommandCount = 0;
+		uint32_t					m_DrawCount = 0;
+	};
+
+	/* Descriptor written by RenderCommandStream::CmdUpdateDescriptorSet(), buffer types use the buffer info and the others use the image info. */
+	struct DescriptorWrite
+	{
+		uint32_t					m_Binding = 0;
+		VkDescriptorType			m_Type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+		VkDescriptorBufferInfo		m_BufferInfo = {};
+		VkDescriptorImageInfo		m_ImageInfo = {};
+	};
+
+	/* Deferred command recording. Commands are packed as POD into one linear block without any Vulkan call,
+	 * then translated into a command list by Replay(), which drops redundant pipeline, descriptor set, vertex input, viewport and scissor binds.
+	 * Cmd* functions mirror RenderCommandList. A stream is recorded by one thread at a time, different streams can be recorded in parallel.
+	 * Everything referenced by the recorded commands must be alive until the stream is replayed.
+	 */
+	class RenderCommandStream
+	{
+	public:
+
+		RenderCommandStream() = default;
+		~RenderCommandStream() = default;
+
+		RenderCommandStream(const RenderCommandStream&) = delete;
+		RenderCommandStream& operator=(const RenderCommandStream&) = delete;
+		RenderCommandStream(RenderCommandStream&&) = default;
+		RenderCommandStream& operator=(RenderCommandStream&&) = default;
+
+		// state commands
+		void CmdBeginDynamicRendering(const glm::uvec2& viewportSize, std::span<Texture* const> renderTargets, std::span<const RenderPassRenderTargetBinding> colorBindings);
+		void CmdEndDynamicRendering();
+		void CmdSetViewport(const glm::uvec2& viewportSize);
+		void CmdSetScissor(const glm::uvec2& viewportSize);
+
+		// draw commands
+		void CmdDraw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance);
+		void CmdDrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance);
+
+		// pipeline resource commands
+		void CmdBindPipeline(VkPipelineBindPoint bindPoint, PipelineState* pPipelineState);
+		/* Descriptors are written into the set while replaying, so the set must NOT be used by any other recording or pending command list. */
+		void CmdUpdateDescriptorSet(VkDescriptorSet set, std::span<const DescriptorWrite> writes);
+		/* Dynamic offsets are ordered by set and then binding, see PipelineState::FindDynamicOffsetIndex(). */
+		void CmdBindShaderResource(VkPipelineBindPoint bindPoint, PipelineState* pPipelineState, std::span<const VkDescriptorSet> sets, std::span<const uint32_t> dynamicOffsets = {});
+		void CmdBindVertexInput(const Buffer* pVertexBuffer, const Buffer* pIndexBuffer = nullptr);
+		void CmdBindVertexInput(const BufferRange& vertexRange, const BufferRange& indexRange = {});
+
+		// barrier commands, barriers are translated while recording, so access spans need not outlive the call
+		void CmdResourceBarrier(const GlobalMemoryBarrier* pMemoryBarrier, std::span<const BufferBarrier> pBufferBarriers, std::span<const TextureBarrier> pTextureBarriers);
+
+		// transfer commands
+		void CmdCopyBuffer(Buffer* pSrcBuffer, Buffer* pDstBuffer, uint32_t srcOffset = 0);
+		void CmdCopyBuffer(Buffer* pSrcBuffer, Buffer* pDstBuffer, uint32_t srcOffset, uint32_t dstOffset, uint32_t sizeInByte);
+		void CmdCopyTextureToBuffer(Texture* pSrcTexture, Buffer* pDstBuffer, uint32_t dstOffset = 0);
+
+		// query commands
+		void CmdResetQueryPool(VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount);
+		void CmdWriteTimestamp(VkPipelineStageFlagBits stage, VkQueryPool queryPool, uint32_t query);
+		void CmdBeginQuery(VkQueryPool queryPool, uint32_t query);
+		void CmdEndQuery(VkQueryPool queryPool, uint32_t query);
+
+		/* Translate all commands into the recording command list, the stream is kept and can be replayed again. */
+		RenderCommandReplayStatistics Replay(RenderCommandList& commandList) const;
+
+		void Reset();
+
+		bool IsEmpty() const { return m_CommandCount == 0; }
+		uint32_t GetCommandCount() const { return m_CommandCount; }
+		uint32_t GetSizeInByte() const { return static_cast<uint32_t>(m_Data.size()); }
+
+		/* Streams hold native handles and pointers of the recording process as-is.
+		 * A deserialized stream can only be replayed while those objects are alive, or against the null render backend for benchmarking.
+		 */
+		std::vector<std::byte> Serialize() const;
+		bool Deserialize(std::span<const std::byte> data);
+
+	private:
+
+		template <typename TCommand>
+		TCommand& Push(uint32_t trailingSizeInByte = 0);
+
+	private:
+
+		std::vector<std::byte>				m_Data;
+		uint32_t							m_CommandCount = 0;
+	};
+}
@@ -3,14 +3,26 @@
 #include "Render/Render.h"
 #include "Platform/Window.h"
 #include "RenderWindow.h"
+#include "IRenderOutput.h"
 #include "VulkanHelper.h"
 #include "RenderCommandList.h"
 #include "DescriptorCache.h"
+#include "BindlessResourceTable.h"
+#include "UploadManager.h"
+#include "ReadbackManager.h"
+#include "GpuProfiler.h"
+#include "TimelineSemaphore.h"
+#include "MemoryTracker.h"
+#include "BufferHeap.h"
+#include "UniformRingBuffer.h"
+#include "SamplerCache.h"
 
 #include <GLFW/glfw3.h>
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#undef WIN32_LEAN_AND_MEAN
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#	undef WIN32_LEAN_AND_MEAN
+#endif
 // Uncomment to debug memory leaking
 // #define VMA_DEBUG_LOG(format, ...) do { char buffer[256]; std::sprintf(buffer, format, __VA_ARGS__); ZE_LOG_INFO("{}", buffer); } while(false);
 #define VMA_IMPLEMENTATION
@@ -163,33 +175,43 @@ namespace ZE::RenderBackend
 			ZE_LOG_INFO("Required instance extension: {}", extension); 
 		});
 
-		ZE_EXEC_ASSERT(IsGLFWInitialized());
-		
-		uint32_t glfwRequiredInstanceExtensionCount = 0;
-		const char** pGLFWRequiredExtensions = glfwGetRequiredInstanceExtensions(&glfwRequiredInstanceExtensionCount);
-		if (!pGLFWRequiredExtensions)
-		{
-			ZE_LOG_ERROR("Failed to get GLFW required instance extensions");
-			return false;
-		}
-
-		for (uint32_t i = 0; i < glfwRequiredInstanceExtensionCount; ++i)
+		// offscreen rendering needs no surface at all
+		if (!m_Settings.m_Offscreen)
 		{
-			ZE_LOG_INFO("GLFW required instance extension: {}", pGLFWRequiredExtensions[i]);
-			auto iter = std::ranges::find_if(requiredInstanceExtensionArray, [pGLFWRequiredExtensions, i](auto extension)
+#if ZENITH_NULL_RENDER_BACKEND
+			// glfw loads the real Vulkan loader on its own, the null backend presents to a headless surface instead
+			requiredInstanceExtensionArray.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+			requiredInstanceExtensionArray.push_back(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
+#else
+			ZE_EXEC_ASSERT(IsGLFWInitialized());
+			
+			uint32_t glfwRequiredInstanceExtensionCount = 0;
+			const char** pGLFWRequiredExtensions = glfwGetRequiredInstanceExtensions(&glfwRequiredInstanceExtensionCount);
+			if (!pGLFWRequiredExtensions)
 			{
-				std::string_view glfwExtension = pGLFWRequiredExtensions[i];
-				if (glfwExtension == extension)
-				{
-					return true;
-				}
+				ZE_LOG_ERROR("Failed to get GLFW required instance extensions");
 				return false;
-			});
+			}
 
-			if (iter == requiredInstanceExtensionArray.end())
+			for (uint32_t i = 0; i < glfwRequiredInstanceExtensionCount; ++i)
 			{
-				requiredInstanceExtensionArray.push_back(pGLFWRequiredExtensions[i]);
+				ZE_LOG_INFO("GLFW required instance extension: {}", pGLFWRequiredExtensions[i]);
+				auto iter = std::ranges::find_if(requiredInstanceExtensionArray, [pGLFWRequiredExtensions, i](auto extension)
+				{
+					std::string_view glfwExtension = pGLFWRequiredExtensions[i];
+					if (glfwExtension == extension)
+					{
+						return true;
+					}
+					return false;
+				});
+
+				if (iter == requiredInstanceExtensionArray.end())
+				{
+					requiredInstanceExtensionArray.push_back(pGLFWRequiredExtensions[i]);
+				}
 			}
+#endif
 		}
 
 		//-------------------------------------------------------------------------
@@ -253,12 +275,18 @@ namespace ZE::RenderBackend
 
 	bool RenderDevice::CreateWin32Surface()
 	{
+#if ZENITH_NULL_RENDER_BACKEND
+		VulkanZeroStruct(VkHeadlessSurfaceCreateInfoEXT, headlessSurfaceCI);
+		headlessSurfaceCI.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+		VulkanCheckSucceed(vkCreateHeadlessSurfaceEXT(m_Inst, &headlessSurfaceCI, nullptr, &m_Surface));
+#else
 		// TODO: verify glfw
 
 		auto pMainWindow = std::static_pointer_cast<Platform::Window>(m_RenderModule.get().GetMainRenderWindow());
 		GLFWwindow* pGLFWWindow = reinterpret_cast<GLFWwindow*>(pMainWindow->GetNativeHandle());
 
 		VulkanCheckSucceed(glfwCreateWindowSurface(m_Inst, pGLFWWindow, nullptr, &m_Surface));
+#endif
 
 		return true;
 	}
@@ -312,8 +340,12 @@ namespace ZE::RenderBackend
 		{
 			return std::ranges::any_of(phyDevice.m_QueueArray, [&](const auto& queue)
 			{
-				VkBool32 supported = false;
-				VulkanCheckSucceed(vkGetPhysicalDeviceSurfaceSupportKHR(phyDevice.m_Handle, queue.m_Index, m_Surface, &supported));
+				// any graphic queue will do without a surface to present to
+				VkBool32 supported = m_Surface == nullptr;
+				if (m_Surface)
+				{
+					VulkanCheckSucceed(vkGetPhysicalDeviceSurfaceSupportKHR(phyDevice.m_Handle, queue.m_Index, m_Surface, &supported));
+				}
 
 				return queue.m_Props.queueCount > 0 && queue.IsGraphicQueue() && supported;
 			});
@@ -331,6 +363,11 @@ namespace ZE::RenderBackend
 			{
 				phyDevice.m_PickScore = 1u;
 			}
+			else if (phyDevice.m_Props.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU)
+			{
+				// software rasterizers (e.g. lavapipe), only picked if there is no GPU
+				phyDevice.m_PickScore = 1u;
+			}
 			else
 			{
 				ZE_LOG_ERROR("Found invalid physical device type: {}", static_cast<uint32_t>(phyDevice.m_Props.deviceType));
@@ -380,6 +417,10 @@ namespace ZE::RenderBackend
 
 		for (auto extension : gEngineRequiredDeviceExtensions)
 		{
+			if (m_Settings.m_Offscreen && std::string_view(extension) == VK_KHR_SWAPCHAIN_EXTENSION_NAME)
+			{
+				continue;
+			}
 			requiredDeviceExtensionArray.push_back(extension);
 		}
 
@@ -393,6 +434,20 @@ namespace ZE::RenderBackend
 			return false;
 		}
 
+		// optional, VMA estimates budgets from heap sizes without it
+		m_SupportMemoryBudget = std::ranges::any_of(m_DeviceProps.m_ExtensionPropArray, [](const VkExtensionProperties& ext)
+		{
+			return std::string_view(ext.extensionName) == VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+		});
+		if (m_SupportMemoryBudget)
+		{
+			requiredDeviceExtensionArray.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		}
+		else
+		{
+			ZE_LOG_WARNING("Device extension {} is not supported, GPU memory budgets are estimated.", VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		}
+
 		// Device queue creation info population
 		std::vector<VkDeviceQueueCreateInfo> deviceQueueCIs = {};
 		std::vector<QueueFamily> deviceQueueFamilies = {};
@@ -435,8 +490,8 @@ namespace ZE::RenderBackend
 		}
 
 		// Physical device features2 validation
-		//auto descriptor_indexing = VkPhysicalDeviceDescriptorIndexingFeaturesEXT{};
-		//descriptor_indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+		auto descriptorIndexingFeature = VkPhysicalDeviceDescriptorIndexingFeatures{};
+		descriptorIndexingFeature.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
 
 		//auto imageless_framebuffer = VkPhysicalDeviceImagelessFramebufferFeaturesKHR{};
 		//imageless_framebuffer.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGELESS_FRAMEBUFFER_FEATURES_KHR;
@@ -446,20 +501,46 @@ namespace ZE::RenderBackend
 
 		auto dynamicRenderingFeature = VkPhysicalDeviceDynamicRenderingFeaturesKHR{};
 		dynamicRenderingFeature.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+		auto timelineSemaphoreFeature = VkPhysicalDeviceTimelineSemaphoreFeatures{};
+		timelineSemaphoreFeature.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
 		
 		VkPhysicalDeviceFeatures2 physicalDeviceFeatures2 = {};
 		physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
 
-		physicalDeviceFeatures2.pNext = &dynamicRenderingFeature;
+		physicalDeviceFeatures2.pNext = &timelineSemaphoreFeature;
+		timelineSemaphoreFeature.pNext = &dynamicRenderingFeature;
+		if (m_Settings.m_EnableBindless)
+		{
+			// descriptor indexing is core since Vulkan 1.2, no extension needed
+			dynamicRenderingFeature.pNext = &descriptorIndexingFeature;
+		}
 		// descriptor_indexing.pNext = &imageless_framebuffer;
 		// imageless_framebuffer.pNext = &buffer_address;
 
 		vkGetPhysicalDeviceFeatures2(GetPhysicalDevice().m_Handle, &physicalDeviceFeatures2);
 
 		ZE_ASSERT(dynamicRenderingFeature.dynamicRendering);
-		//ZE_ASSERT(descriptor_indexing.descriptorBindingPartiallyBound);
+		ZE_ASSERT(timelineSemaphoreFeature.timelineSemaphore);
 		//ZE_ASSERT(buffer_address.bufferDeviceAddress);
 
+		if (m_Settings.m_EnableBindless)
+		{
+			const bool bSupportBindless = descriptorIndexingFeature.runtimeDescriptorArray
+				&& descriptorIndexingFeature.descriptorBindingPartiallyBound
+				&& descriptorIndexingFeature.descriptorBindingSampledImageUpdateAfterBind
+				&& descriptorIndexingFeature.descriptorBindingStorageBufferUpdateAfterBind
+				&& descriptorIndexingFeature.shaderSampledImageArrayNonUniformIndexing
+				&& descriptorIndexingFeature.shaderStorageBufferArrayNonUniformIndexing;
+
+			if (!bSupportBindless)
+			{
+				ZE_LOG_WARNING("Physical device does NOT support required descriptor indexing features, bindless mode is disabled.");
+				m_Settings.m_EnableBindless = false;
+				dynamicRenderingFeature.pNext = nullptr;
+			}
+		}
+
 		// Device creation
 		VkDeviceCreateInfo deviceCI = {};
 		deviceCI.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -506,7 +587,9 @@ namespace ZE::RenderBackend
 			{
 				if (deviceQueueFamily.IsGraphicQueue())
 				{
-					vkGetDeviceQueue(m_Device, deviceQueueFamily.m_Index, 0, &m_TransferQueue);
+					// prefer a different queue of the same family to not contend with graphic submissions
+					const uint32_t queueIndex = std::min(1u, deviceQueueFamily.m_Props.queueCount - 1u);
+					vkGetDeviceQueue(m_Device, deviceQueueFamily.m_Index, queueIndex, &m_TransferQueue);
 					m_TransferQueueFamilyIndex = deviceQueueFamily.m_Index;
 					break;
 				}
@@ -546,12 +629,20 @@ namespace ZE::RenderBackend
 		vulkanFunctions.vkFlushMappedMemoryRanges = vkFlushMappedMemoryRanges;
 		vulkanFunctions.vkInvalidateMappedMemoryRanges = vkInvalidateMappedMemoryRanges;
 		vulkanFunctions.vkCmdCopyBuffer = vkCmdCopyBuffer;
+		vulkanFunctions.vkGetPhysicalDeviceMemoryProperties2KHR = vkGetPhysicalDeviceMemoryProperties2;
 
 		allocatorCI.pVulkanFunctions = &vulkanFunctions;
 		allocatorCI.pAllocationCallbacks = nullptr;
+		if (m_SupportMemoryBudget)
+		{
+			allocatorCI.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+		}
 
 		VulkanCheckSucceed(vmaCreateAllocator(&allocatorCI, &m_GlobalAllocator));
 
+		m_MemoryTracker = new MemoryTracker(*this, m_SupportMemoryBudget);
+		m_MemoryTracker->SetDumpInterval(m_Settings.m_MemoryStatisticsDumpInterval);
+
 		return true;
 	}
 
@@ -715,7 +806,7 @@ namespace ZE::RenderBackend
 			return false;
 		}
 		
-		if (!CreateWin32Surface())
+		if (!m_Settings.m_Offscreen && !CreateWin32Surface())
 		{
 			return false;
 		}
@@ -735,15 +826,64 @@ namespace ZE::RenderBackend
 			return false;
 		}
 
-		for (auto& cmdList : m_FrameCommandLists)
-		{
-			cmdList = new RenderCommandList(*this);
-		}
+		m_GraphicTimeline = new TimelineSemaphore(*this);
+		m_TransferTimeline = new TimelineSemaphore(*this);
+
+		// frame command lists are acquired at the beginning of each frame
+		m_GraphicCommandListPool = new CommandListPool(*this, m_GraphicQueueFamilyIndex);
 
 		for (auto& cache : m_FrameDescriptorCaches)
 		{
 			cache = new DescriptorCache(*this);
 		}
+
+		if (m_Settings.m_EnableBindless)
+		{
+			m_BindlessResourceTable = new BindlessResourceTable(*this);
+			if (m_BindlessResourceTable->IsValid())
+			{
+				ZE_LOG_INFO("Bindless resource table created");
+			}
+			else
+			{
+				ZE_LOG_WARNING("Bindless resource table does NOT fit the update-after-bind limits of the device, bindless mode is disabled.");
+				delete m_BindlessResourceTable;
+				m_BindlessResourceTable = nullptr;
+				m_Settings.m_EnableBindless = false;
+			}
+		}
+
+		m_UploadManager = new UploadManager(*this);
+		m_ReadbackManager = new ReadbackManager(*this);
+
+		if (m_Settings.m_EnableGpuProfiler)
+		{
+			const auto& physicalDevice = GetPhysicalDevice();
+			const auto iter = std::ranges::find(physicalDevice.m_QueueArray, m_GraphicQueueFamilyIndex, &QueueFamily::m_Index);
+			if (iter != physicalDevice.m_QueueArray.end() && iter->m_Props.timestampValidBits != 0)
+			{
+				const bool bEnablePipelineStatistics = m_Settings.m_EnableGpuPipelineStatistics && physicalDevice.m_Features.pipelineStatisticsQuery;
+				if (m_Settings.m_EnableGpuPipelineStatistics && !bEnablePipelineStatistics)
+				{
+					ZE_LOG_WARNING("GPU pipeline statistics are NOT supported by the device");
+				}
+				m_GpuProfiler = new GpuProfiler(*this, bEnablePipelineStatistics);
+				ZE_LOG_INFO("GPU profiler created");
+			}
+			else
+			{
+				ZE_LOG_WARNING("GPU profiler is disabled, timestamps are NOT supported by the graphic queue");
+			}
+		}
+
+		BufferDesc geometryPageDesc("geometry buffer heap");
+		geometryPageDesc.m_Size = BufferHeap::kDefaultPageSizeInByte;
+		geometryPageDesc.m_Usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		geometryPageDesc.m_MemoryUsage = BufferMemoryUsage::GpuOnly;
+		m_GeometryBufferHeap = new BufferHeap(*this, geometryPageDesc);
+
+		m_UniformRingBuffer = new UniformRingBuffer(*this, m_Settings.m_UniformRingFrameSizeInByte);
+		m_SamplerCache = new SamplerCache(*this);
 		
 		return true;
 	}
@@ -751,6 +891,21 @@ namespace ZE::RenderBackend
 	void RenderDevice::Shutdown()
 	{
 		vkDeviceWaitIdle(m_Device);
+
+		delete m_UploadManager;
+		m_UploadManager = nullptr;
+
+		delete m_ReadbackManager;
+		m_ReadbackManager = nullptr;
+
+		delete m_GpuProfiler;
+		m_GpuProfiler = nullptr;
+
+		delete m_UniformRingBuffer;
+		m_UniformRingBuffer = nullptr;
+
+		delete m_SamplerCache;
+		m_SamplerCache = nullptr;
 		
 		for (auto& cache : m_FrameDescriptorCaches)
 		{
@@ -760,15 +915,41 @@ namespace ZE::RenderBackend
 		
 		for (auto& pCmdList : m_FrameCommandLists)
 		{
-			delete pCmdList;
+			m_GraphicCommandListPool->Release(pCmdList);
 			pCmdList = nullptr;
 		}
-
-		for (auto& queue : m_FrameDeferReleaseQueues)
+		for (auto& submittedCmdLists : m_SubmittedFrameCommandLists)
 		{
-			queue.ReleaseAllImmediately();
+			for (auto* pCmdList : submittedCmdLists)
+			{
+				m_GraphicCommandListPool->Release(pCmdList);
+			}
+			submittedCmdLists.clear();
 		}
+		delete m_GraphicCommandListPool;
+		m_GraphicCommandListPool = nullptr;
+
+		m_DeferReleaseQueue.ReleaseAllImmediately();
+
+		// ranges defer freed are given back above
+		delete m_GeometryBufferHeap;
+		m_GeometryBufferHeap = nullptr;
+
+		delete m_BindlessResourceTable;
+		m_BindlessResourceTable = nullptr;
+
+		delete m_TransferTimeline;
+		m_TransferTimeline = nullptr;
+		delete m_GraphicTimeline;
+		m_GraphicTimeline = nullptr;
 		
+		if (m_MemoryTracker)
+		{
+			m_MemoryTracker->Dump();
+			delete m_MemoryTracker;
+			m_MemoryTracker = nullptr;
+		}
+
 		if (m_GlobalAllocator)
 		{
 			vmaDestroyAllocator(m_GlobalAllocator);
@@ -799,77 +980,209 @@ namespace ZE::RenderBackend
 
 	std::shared_ptr<RenderCommandList> RenderDevice::GetImmediateCommandList()
 	{
-		return std::make_shared<RenderCommandList>(*this);
+		auto* pCmdList = m_GraphicCommandListPool->Acquire(m_FrameIndex);
+		return std::shared_ptr<RenderCommandList>(pCmdList, [pPool = m_GraphicCommandListPool](RenderCommandList* pCmdList)
+		{
+			pPool->Release(pCmdList);
+		});
+	}
+
+	CommandListPoolStatistics RenderDevice::GetCommandListPoolStatistics() const
+	{
+		return m_GraphicCommandListPool->GetStatistics();
 	}
 
-	void RenderDevice::SubmitCommandListAndWaitUntilFinish(RenderCommandList* pCmdList) const
+	void RenderDevice::SubmitCommandListAndWaitUntilFinish(RenderCommandList* pCmdList)
 	{
+		const VkSemaphore timelineSemaphore = m_GraphicTimeline->GetNativeHandle();
+		uint64_t signalValue = 0;
+
+		VulkanZeroStruct(VkTimelineSemaphoreSubmitInfo, timelineSubmitInfo);
+		timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineSubmitInfo.signalSemaphoreValueCount = 1u;
+		timelineSubmitInfo.pSignalSemaphoreValues = &signalValue;
+
 		VulkanZeroStruct(VkSubmitInfo, submitInfo);
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineSubmitInfo;
 		submitInfo.pCommandBuffers = &pCmdList->m_CommandBuffer;
 		submitInfo.commandBufferCount = 1;
-		
-		VulkanZeroStruct(VkFenceCreateInfo, fenceCI);
-		fenceCI.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-		
-		VkFence fence;
-		VulkanCheckSucceed(vkCreateFence(m_Device, &fenceCI, nullptr, &fence));
+		submitInfo.pSignalSemaphores = &timelineSemaphore;
+		submitInfo.signalSemaphoreCount = 1u;
 
-		VulkanCheckSucceed(vkQueueSubmit(m_GraphicQueue, 1, &submitInfo, fence));
-		VulkanCheckSucceed(vkWaitForFences(m_Device, 1, &fence, VK_TRUE, kInfiniteWaitTime));
-		vkDestroyFence(m_Device, fence, nullptr);
+		{
+			std::scoped_lock lock(m_QueueSubmitMutex);
+			signalValue = m_GraphicTimeline->AcquireSignalValue();
+			VulkanCheckSucceed(vkQueueSubmit(m_GraphicQueue, 1, &submitInfo, nullptr));
+		}
+		m_GraphicTimeline->Wait(signalValue);
 	}
 	
-	void RenderDevice::SubmitCommandList(RenderCommandList* pCmdList, const RenderWindow& renderWindow) const
+	uint64_t RenderDevice::SubmitCommandList(RenderCommandList* pCmdList, const IRenderOutput& renderOutput)
 	{
-		constexpr VkPipelineStageFlags waitStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		return SubmitCommandList(pCmdList, renderOutput, {});
+	}
+
+	uint64_t RenderDevice::SubmitCommandList(RenderCommandList* pCmdList, const IRenderOutput& renderOutput, UploadHandle waitUpload)
+	{
+		return SubmitFrameCommandList(pCmdList, renderOutput.GetFrameSubmitInfo(), waitUpload);
+	}
+
+	uint64_t RenderDevice::SubmitCommandList(RenderCommandList* pCmdList, UploadHandle waitUpload)
+	{
+		return SubmitFrameCommandList(pCmdList, {}, waitUpload);
+	}
+
+	uint64_t RenderDevice::SubmitFrameCommandList(RenderCommandList* pCmdList, const RenderOutputSubmitInfo& outputSubmitInfo, UploadHandle waitUpload)
+	{
+		std::array<VkSemaphore, 2> waitSemaphores = {};
+		std::array<VkPipelineStageFlags, 2> waitStageMasks = {};
+		// value of binary semaphore is ignored
+		std::array<uint64_t, 2> waitValues = { 0 };
+		uint32_t waitCount = 0u;
+
+		if (outputSubmitInfo.m_WaitSemaphore)
+		{
+			waitSemaphores[waitCount] = outputSubmitInfo.m_WaitSemaphore;
+			waitStageMasks[waitCount] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			++waitCount;
+		}
+
+		if (waitUpload.IsValid() && !m_UploadManager->IsFinished(waitUpload))
+		{
+			// make sure the upload had been submitted before GPU waits on it
+			m_UploadManager->Flush();
+
+			waitSemaphores[waitCount] = m_TransferTimeline->GetNativeHandle();
+			waitStageMasks[waitCount] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+			waitValues[waitCount] = waitUpload.m_TimelineValue;
+			++waitCount;
+		}
+
+		// retire the frame by the graphic timeline, a fence of the output only paces the output images
+		std::array<VkSemaphore, 2> signalSemaphores = { m_GraphicTimeline->GetNativeHandle() };
+		std::array<uint64_t, 2> signalValues = { 0 };
+		uint32_t signalCount = 1u;
+
+		if (outputSubmitInfo.m_SignalSemaphore)
+		{
+			signalSemaphores[signalCount] = outputSubmitInfo.m_SignalSemaphore;
+			++signalCount;
+		}
+
+		VulkanZeroStruct(VkTimelineSemaphoreSubmitInfo, timelineSubmitInfo);
+		timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineSubmitInfo.waitSemaphoreValueCount = waitCount;
+		timelineSubmitInfo.pWaitSemaphoreValues = waitValues.data();
+		timelineSubmitInfo.signalSemaphoreValueCount = signalCount;
+		timelineSubmitInfo.pSignalSemaphoreValues = signalValues.data();
 
 		VulkanZeroStruct(VkSubmitInfo, submitInfo);
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineSubmitInfo;
 		submitInfo.pCommandBuffers = &pCmdList->m_CommandBuffer;
 		submitInfo.commandBufferCount = 1u;
-		submitInfo.pWaitSemaphores = &renderWindow.m_PresentCompleteSemaphores[m_FrameIndex];
-		submitInfo.waitSemaphoreCount = 1u;
-		submitInfo.pSignalSemaphores = &renderWindow.m_RenderCompleteSemaphores[m_FrameIndex];
-		submitInfo.signalSemaphoreCount = 1u;
-		submitInfo.pWaitDstStageMask = &waitStageMask;
+		submitInfo.pWaitSemaphores = waitSemaphores.data();
+		submitInfo.waitSemaphoreCount = waitCount;
+		submitInfo.pSignalSemaphores = signalSemaphores.data();
+		submitInfo.signalSemaphoreCount = signalCount;
+		submitInfo.pWaitDstStageMask = waitStageMasks.data();
 		
-		VulkanCheckSucceed(vkQueueSubmit(m_GraphicQueue, 1, &submitInfo, renderWindow.m_Fences[m_FrameIndex]));
+		m_UniformRingBuffer->FlushFrame();
+		// read before the submit mutex, flushing uploads takes both locks in the other order
+		const UploadHandle latestUpload = m_UploadManager->GetLatestUpload();
+
+		std::scoped_lock lock(m_QueueSubmitMutex);
+		signalValues[0] = m_GraphicTimeline->AcquireSignalValue();
+		VulkanCheckSucceed(vkQueueSubmit(m_GraphicQueue, 1, &submitInfo, outputSubmitInfo.m_Fence));
+
+		m_FrameTimelineValues[m_FrameIndex] = signalValues[0];
+		// resources deferred so far may be used by this submission
+		m_DeferReleaseQueue.Seal(signalValues[0], latestUpload.m_TimelineValue);
+		// readbacks copied by this submission resolve once it is finished
+		m_ReadbackManager->Seal(signalValues[0]);
+		if (pCmdList == m_FrameCommandLists[m_FrameIndex])
+		{
+			// a pending command list can't be recorded again, the next render graph of the frame records into a new one
+			m_SubmittedFrameCommandLists[m_FrameIndex].push_back(pCmdList);
+			m_FrameCommandLists[m_FrameIndex] = m_GraphicCommandListPool->Acquire(m_FrameIndex);
+		}
+		if (m_GpuProfiler)
+		{
+			m_GpuProfiler->OnFrameSubmitted(m_FrameIndex);
+		}
+		return signalValues[0];
 	}
 
 	void RenderDevice::DeferRelease(IDeferReleaseResource* pDeferReleaseResource)
 	{
-		ZE_ASSERT(m_HadBeganFrame);
-		m_FrameDeferReleaseQueues[m_FrameIndex].DeferRelease(pDeferReleaseResource);
+		m_DeferReleaseQueue.DeferRelease(pDeferReleaseResource);
 	}
 	
 	void RenderDevice::DeferRelease(const DeferReleaseLifetimeResource<Buffer>& deferReleaseResource)
 	{
-		ZE_ASSERT(m_HadBeganFrame);
-		m_FrameDeferReleaseQueues[m_FrameIndex].DeferRelease(deferReleaseResource);
+		m_DeferReleaseQueue.DeferRelease(deferReleaseResource);
 	}
 	
 	void RenderDevice::DeferRelease(const DeferReleaseLifetimeResource<Texture>& deferReleaseResource)
 	{
-		ZE_ASSERT(m_HadBeganFrame);
-		m_FrameDeferReleaseQueues[m_FrameIndex].DeferRelease(deferReleaseResource);
+		m_DeferReleaseQueue.DeferRelease(deferReleaseResource);
 	}
 
 	inline const std::shared_ptr<Texture>& RenderDevice::GetSwapchainRenderTarget() const
 	{
-		return m_RenderModule.get().GetMainRenderWindow()->GetFrameSwapchainRenderTarget();
+		const auto pMainWindow = m_RenderModule.get().GetMainRenderWindow();
+		ZE_ASSERT_LOG(pMainWindow, "There is no swapchain in offscreen mode, use RenderModule::GetMainRenderOutput() instead!");
+		if (!pMainWindow)
+		{
+			static const std::shared_ptr<Texture> kNullRenderTarget;
+			return kNullRenderTarget;
+		}
+		return pMainWindow->GetFrameSwapchainRenderTarget();
 	}
 
 	void RenderDevice::WaitUntilIdle() const
 	{
 		vkDeviceWaitIdle(m_Device);
 	}
+
+	void RenderDevice::WaitForFrame(uint32_t frameIndex) const
+	{
+		ZE_ASSERT(frameIndex < kSwapBufferCount);
+		m_GraphicTimeline->Wait(m_FrameTimelineValues[frameIndex]);
+	}
 	
 	void RenderDevice::BeginFrame()
 	{
 		ZE_ASSERT(!m_HadBeganFrame);
-		m_FrameDeferReleaseQueues[m_FrameIndex].ReleaseAllImmediately();
-		m_FrameCommandLists[m_FrameIndex]->Reset();
+		// release whatever GPU had finished with, not only the resources of the frame being reused
+		m_DeferReleaseQueue.ReleaseCompleted(m_GraphicTimeline->GetCompletedValue(), m_TransferTimeline->GetCompletedValue());
+
+		// GPU had finished this frame, recycle all command lists of it in bulk
+		m_GraphicCommandListPool->Release(m_FrameCommandLists[m_FrameIndex]);
+		for (auto* pCmdList : m_SubmittedFrameCommandLists[m_FrameIndex])
+		{
+			m_GraphicCommandListPool->Release(pCmdList);
+		}
+		m_SubmittedFrameCommandLists[m_FrameIndex].clear();
+		m_GraphicCommandListPool->ResetFrame(m_FrameIndex);
+		m_FrameCommandLists[m_FrameIndex] = m_GraphicCommandListPool->Acquire(m_FrameIndex);
+
+		// GPU had finished this frame, so are the descriptor sets allocated in it
+		m_FrameDescriptorCaches[m_FrameIndex]->Reset();
+		// GPU had finished this frame, so does the uniform data written in it
+		m_UniformRingBuffer->BeginFrame(m_FrameIndex);
+		// kick uploads requested since last frame and reclaim staging memory
+		m_UploadManager->Flush();
+		m_UploadManager->Update();
+		// resolve readbacks of finished frames
+		m_ReadbackManager->Update();
+		if (m_GpuProfiler)
+		{
+			// GPU had finished this frame, so are its queries
+			m_GpuProfiler->BeginFrame(m_FrameIndex);
+		}
+		m_MemoryTracker->Update();
 		m_HadBeganFrame = true;
 	}
 	
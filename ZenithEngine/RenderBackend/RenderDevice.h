@@ -4,6 +4,7 @@
 #include "Core/Assertion.h"
 #include "RenderBackend/RenderResource.h"
 #include "RenderBackend/DeferReleaseQueue.h"
+#include "RenderBackend/CommandListPool.h"
 
 #include <vulkan/vulkan_core.h>
 #include <vma/vk_mem_alloc.h>
@@ -12,6 +13,7 @@
 #include <limits>
 #include <memory>
 #include <functional>
+#include <mutex>
 
 namespace ZE::Render { class RenderModule; }
 
@@ -19,6 +21,18 @@ namespace ZE::RenderBackend
 {
 	class RenderCommandList;
 	class DescriptorCache;
+	class BindlessResourceTable;
+	class UploadManager;
+	class TimelineSemaphore;
+	class MemoryTracker;
+	class BufferHeap;
+	class UniformRingBuffer;
+	class ReadbackManager;
+	class GpuProfiler;
+	class SamplerCache;
+	class IRenderOutput;
+	struct RenderOutputSubmitInfo;
+	struct UploadHandle;
 
 	class RenderDevice : public IRenderDevice
 	{
@@ -30,6 +44,18 @@ namespace ZE::RenderBackend
 		struct Settings
 		{
 			bool									m_EnableValidationLayer = true;
+			// Opt-in global descriptor arrays, fall back to per-pipeline descriptor sets if the device can NOT support it.
+			bool									m_EnableBindless = false;
+			// Dump GPU memory statistics to log every N frames, 0 to disable.
+			uint32_t								m_MemoryStatisticsDumpInterval = 0;
+			// Size of the uniform ring region of each frame.
+			uint32_t								m_UniformRingFrameSizeInByte = 4u * 1024u * 1024u;
+			// Render without any window, surface or swapchain, frames are rendered into an OffscreenRenderTarget.
+			bool									m_Offscreen = false;
+			// Time each render graph node with GPU timestamp queries, see GpuProfiler.
+			bool									m_EnableGpuProfiler = false;
+			// Also collect pipeline statistics of each node if the device supports it.
+			bool									m_EnableGpuPipelineStatistics = false;
 		};
 
 		struct InstanceProperties
@@ -83,11 +109,20 @@ namespace ZE::RenderBackend
 		virtual bool Initialize() override;
 		virtual void Shutdown() override;
 
+		/* Command list recycled from the calling thread's pool, it is given back to the pool when the last reference is dropped. */
 		std::shared_ptr<RenderCommandList> GetImmediateCommandList();
-
-		void SubmitCommandList(RenderCommandList* pCmdList, const RenderWindow& renderWindow) const;
-		void SubmitCommandListAndWaitUntilFinish(RenderCommandList* pCmdList) const;
-
+		CommandListPoolStatistics GetCommandListPoolStatistics() const;
+
+		/* Submit frame command list, GPU will wait until the upload is finished if waitUpload is valid.
+		 * Return the graphic timeline value signaled once GPU had finished it.
+		 */
+		uint64_t SubmitCommandList(RenderCommandList* pCmdList, const IRenderOutput& renderOutput, UploadHandle waitUpload);
+		uint64_t SubmitCommandList(RenderCommandList* pCmdList, const IRenderOutput& renderOutput);
+		/* Submit frame command list of a frame without any output, e.g. a frame only rendering into readback buffers. */
+		uint64_t SubmitCommandList(RenderCommandList* pCmdList, UploadHandle waitUpload);
+		void SubmitCommandListAndWaitUntilFinish(RenderCommandList* pCmdList);
+
+		/* Resources are released once GPU had finished the next frame submission. Thread-safe, can be called from any thread at any time. */
 		void DeferRelease(IDeferReleaseResource* pDeferReleaseResource);
 		void DeferRelease(const DeferReleaseLifetimeResource<Buffer>& deferReleaseResource);
 		void DeferRelease(const DeferReleaseLifetimeResource<Texture>& deferReleaseResource);
@@ -97,9 +132,27 @@ namespace ZE::RenderBackend
 		uint32_t GetFrameIndex() const { return m_FrameIndex; }
 		RenderCommandList* GetFrameCommandList() const { return m_FrameCommandLists[m_FrameIndex]; }
 		DescriptorCache* GetFrameDescriptorCache() const { return m_FrameDescriptorCaches[m_FrameIndex]; }
+		DescriptorCache* GetFrameDescriptorCache(uint32_t frameIndex) const { return m_FrameDescriptorCaches[frameIndex]; }
+		BindlessResourceTable* GetBindlessResourceTable() const { return m_BindlessResourceTable; }
+		UploadManager& GetUploadManager() const { ZE_ASSERT(m_UploadManager); return *m_UploadManager; }
+		ReadbackManager& GetReadbackManager() const { ZE_ASSERT(m_ReadbackManager); return *m_ReadbackManager; }
+		/* Null unless the GPU profiler is enabled and the device supports timestamps. */
+		GpuProfiler* GetGpuProfiler() const { return m_GpuProfiler; }
+		bool IsBindlessEnabled() const { return m_BindlessResourceTable != nullptr; }
+		TimelineSemaphore& GetGraphicTimeline() const { ZE_ASSERT(m_GraphicTimeline); return *m_GraphicTimeline; }
+		TimelineSemaphore& GetTransferTimeline() const { ZE_ASSERT(m_TransferTimeline); return *m_TransferTimeline; }
+		MemoryTracker& GetMemoryTracker() const { ZE_ASSERT(m_MemoryTracker); return *m_MemoryTracker; }
+		/* Shared heap of static vertex and index buffers, ranges are uploaded through the upload manager. */
+		BufferHeap& GetGeometryBufferHeap() const { ZE_ASSERT(m_GeometryBufferHeap); return *m_GeometryBufferHeap; }
+		/* Per-frame uniform data, bound as dynamic uniform buffers. */
+		UniformRingBuffer& GetUniformRingBuffer() const { ZE_ASSERT(m_UniformRingBuffer); return *m_UniformRingBuffer; }
+		SamplerCache& GetSamplerCache() const { ZE_ASSERT(m_SamplerCache); return *m_SamplerCache; }
 		VkDevice GetNativeDevice() const { return m_Device; }
+		bool IsOffscreen() const { return m_Settings.m_Offscreen; }
 
 		void WaitUntilIdle() const;
+		/* Block until GPU had finished the last submission of the frame. */
+		void WaitForFrame(uint32_t frameIndex) const;
 		
 		void BeginFrame();
 		void EndFrame();
@@ -117,6 +170,8 @@ namespace ZE::RenderBackend
 		bool CreateDevice();
 		bool CreateGlobalMemoryAllocator();
 
+		uint64_t SubmitFrameCommandList(RenderCommandList* pCmdList, const RenderOutputSubmitInfo& outputSubmitInfo, UploadHandle waitUpload);
+
 		bool CollectInstanceLayerProps(const std::vector<const char*>& requiredLayers);
 		bool CollectInstanceExtensionProps(const std::vector<const char*>& requiredExtensions);
 
@@ -132,6 +187,14 @@ namespace ZE::RenderBackend
 
 		friend class Buffer;
 		friend class Texture;
+		friend class UploadManager;
+		friend class ReadbackManager;
+		friend class GpuProfiler;
+		friend class MemoryTracker;
+		friend class BufferHeap;
+		friend class UniformRingBuffer;
+		friend class SamplerCache;
+		friend class BindlessResourceTable;
 		
 		friend struct SubmittedCommandHandle;
 
@@ -154,6 +217,8 @@ namespace ZE::RenderBackend
 		DeviceProperties								m_DeviceProps;
 														
 		VmaAllocator									m_GlobalAllocator = nullptr;
+		MemoryTracker*									m_MemoryTracker = nullptr;
+		bool											m_SupportMemoryBudget = false;
 														
 		VkQueue											m_GraphicQueue = nullptr;
 		uint32_t										m_GraphicQueueFamilyIndex = std::numeric_limits<uint32_t>::max();
@@ -161,12 +226,30 @@ namespace ZE::RenderBackend
 		uint32_t										m_ComputeQueueFamilyIndex = std::numeric_limits<uint32_t>::max();
 		VkQueue											m_TransferQueue = nullptr;
 		uint32_t										m_TransferQueueFamilyIndex = std::numeric_limits<uint32_t>::max();
+		// transfer queue may share the same VkQueue with graphic queue, and queue access must be externally synchronized
+		mutable std::mutex								m_QueueSubmitMutex;
+		// each queue has its own timeline, values of different queues are NOT comparable
+		TimelineSemaphore*								m_GraphicTimeline = nullptr;
+		TimelineSemaphore*								m_TransferTimeline = nullptr;
 			
 		uint32_t												m_FrameIndex = 0;
+		CommandListPool*										m_GraphicCommandListPool = nullptr;
 		std::array<RenderCommandList*, kSwapBufferCount>		m_FrameCommandLists = {};
+		// a frame may be submitted several times, the command lists already submitted are kept until the frame is retired
+		std::array<std::vector<RenderCommandList*>, kSwapBufferCount>	m_SubmittedFrameCommandLists;
+		// graphic timeline value signaled by the submission of each frame
+		std::array<uint64_t, kSwapBufferCount>					m_FrameTimelineValues = {};
 
 		std::array<DescriptorCache*, kSwapBufferCount>			m_FrameDescriptorCaches = {};
-		std::array<DeferReleaseQueue, kSwapBufferCount>			m_FrameDeferReleaseQueues = {};
+		DeferReleaseQueue										m_DeferReleaseQueue;
+
+		BindlessResourceTable*									m_BindlessResourceTable = nullptr;
+		UploadManager*											m_UploadManager = nullptr;
+		ReadbackManager*										m_ReadbackManager = nullptr;
+		GpuProfiler*											m_GpuProfiler = nullptr;
+		BufferHeap*												m_GeometryBufferHeap = nullptr;
+		UniformRingBuffer*										m_UniformRingBuffer = nullptr;
+		SamplerCache*											m_SamplerCache = nullptr;
 
 		bool													m_HadBeganFrame = false;
 	};
@@ -4,6 +4,11 @@
 #include "RenderDevice.h"
 #include "RenderCommandList.h"
 #include "VulkanHelper.h"
+#include "BindlessResourceTable.h"
+#include "UploadManager.h"
+#include "MemoryTracker.h"
+
+#include <ranges>
 
 namespace ZE::RenderBackend
 {
@@ -13,6 +18,7 @@ namespace ZE::RenderBackend
 		{
 		case ZE::RenderBackend::BufferMemoryUsage::CpuToGpu: return VMA_MEMORY_USAGE_CPU_TO_GPU;
 		case ZE::RenderBackend::BufferMemoryUsage::GpuOnly: return VMA_MEMORY_USAGE_GPU_ONLY;
+		case ZE::RenderBackend::BufferMemoryUsage::GpuToCpu: return VMA_MEMORY_USAGE_GPU_TO_CPU;
 		default:
 			break;
 		}
@@ -63,6 +69,11 @@ namespace ZE::RenderBackend
 		: m_pBuffer(pBuffer)
 	{
 		VulkanCheckSucceed(vmaMapMemory(m_pBuffer->GetRenderDevice().m_GlobalAllocator, m_pBuffer->m_Allocation, &m_pMappedMemory));
+		if (m_pBuffer->GetDesc().m_MemoryUsage == BufferMemoryUsage::GpuToCpu)
+		{
+			// readback memory may be cached but not coherent, no-op otherwise
+			VulkanCheckSucceed(vmaInvalidateAllocation(m_pBuffer->GetRenderDevice().m_GlobalAllocator, m_pBuffer->m_Allocation, 0, VK_WHOLE_SIZE));
+		}
 	}
 	Buffer::MappedMemoryScope::~MappedMemoryScope()
 	{
@@ -89,6 +100,15 @@ namespace ZE::RenderBackend
 		bufferCI.size = bufferSize;
 		bufferCI.usage = desc.m_Usage;
 		bufferCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		// buffer written by transfer queue is shared with graphic queue to avoid queue ownership transfer
+		const uint32_t queueFamilyIndices[] = { renderDevice.m_GraphicQueueFamilyIndex, renderDevice.m_TransferQueueFamilyIndex };
+		if ((desc.m_Usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT) != 0 && queueFamilyIndices[0] != queueFamilyIndices[1])
+		{
+			bufferCI.sharingMode = VK_SHARING_MODE_CONCURRENT;
+			bufferCI.queueFamilyIndexCount = 2u;
+			bufferCI.pQueueFamilyIndices = queueFamilyIndices;
+		}
 		
 		VmaAllocationCreateInfo vmaAllocationCI = {};
 		vmaAllocationCI.usage = ToVmaMemoryUsage(desc.m_MemoryUsage);
@@ -105,11 +125,17 @@ namespace ZE::RenderBackend
 		// vkSetDebugUtilsObjectNameEXT(renderDevice.GetNativeDevice(), &debugNameInfo);
 		
 		pBuffer->m_AllocatedSizeInByte = static_cast<uint32_t>(allocInfo.size);
+		renderDevice.GetMemoryTracker().OnAllocated(desc.m_MemoryCategory, allocInfo.size);
+
+		if (auto* pBindlessTable = renderDevice.GetBindlessResourceTable(); pBindlessTable && (desc.m_Usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) != 0)
+		{
+			pBuffer->m_BindlessIndex = pBindlessTable->RegisterBuffer(pBuffer);
+		}
 
 		return pBuffer;
 	}
 
-	Buffer* Buffer::Create(RenderDevice& renderDevice, const BufferDesc& desc, const void* pUploadData, uint32_t uploadDataSizeInByte)
+	Buffer* Buffer::Create(RenderDevice& renderDevice, const BufferDesc& desc, const void* pUploadData, uint32_t uploadDataSizeInByte, UploadHandle& outUploadHandle)
 	{
 		if (!desc.IsValid())
 		{
@@ -122,32 +148,17 @@ namespace ZE::RenderBackend
 			return nullptr;
 		}
 
-		BufferDesc stagingBufferDesc("staging buffer");
-		stagingBufferDesc.m_Size = desc.m_Size;
-		stagingBufferDesc.m_Usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-		stagingBufferDesc.m_MemoryUsage = BufferMemoryUsage::CpuToGpu;
-		
-		auto pStagingBuffer = std::shared_ptr<Buffer>(Create(renderDevice, stagingBufferDesc));
-
-		// copy to staging buffer
-		{
-			auto mappedMemory = pStagingBuffer->Map();
-			memcpy(mappedMemory.m_pMappedMemory, pUploadData, uploadDataSizeInByte);
-		}
-
-		// copy to VRAM
-		{
-			auto pCmdList = pBuffer->GetRenderDevice().GetImmediateCommandList();
-			pCmdList->BeginRecord();
-			pCmdList->CmdCopyBuffer(pStagingBuffer.get(), pBuffer);
-			pCmdList->EndRecord();
-
-			pBuffer->GetRenderDevice().SubmitCommandListAndWaitUntilFinish(pCmdList.get());
-		}
+		// copy to VRAM through the staging ring, batched with other uploads and waited by whoever reads the buffer on GPU
+		outUploadHandle = renderDevice.GetUploadManager().Upload(pBuffer, pUploadData, uploadDataSizeInByte);
 
 		return pBuffer;
 	}
 
+	UploadHandle Buffer::GetPendingUpload() const
+	{
+		return { m_PendingUploadTimelineValue.load(std::memory_order_acquire) };
+	}
+
 	Buffer::Buffer(RenderDevice& renderDevice, const BufferDesc& desc)
 		: m_Desc(desc)
 	{
@@ -156,7 +167,13 @@ namespace ZE::RenderBackend
 	
 	Buffer::~Buffer()
 	{
+		if (auto* pBindlessTable = GetRenderDevice().GetBindlessResourceTable())
+		{
+			pBindlessTable->Unregister(EBindlessResourceType::StorageBuffer, m_BindlessIndex);
+		}
+
 		vmaDestroyBuffer(GetRenderDevice().m_GlobalAllocator, m_Handle, m_Allocation);
+		GetRenderDevice().GetMemoryTracker().OnFreed(m_Desc.m_MemoryCategory, m_AllocatedSizeInByte);
 		m_Handle = nullptr;
 	}
 
@@ -215,6 +232,47 @@ namespace ZE::RenderBackend
 		return VK_IMAGE_LAYOUT_UNDEFINED;
 	}
 
+	uint32_t GetFormatSizeInByte(VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_R8_UNORM: return 1u;
+		case VK_FORMAT_R8G8_UNORM:
+		case VK_FORMAT_R16_SFLOAT: return 2u;
+		case VK_FORMAT_R8G8B8A8_UNORM:
+		case VK_FORMAT_R8G8B8A8_SRGB:
+		case VK_FORMAT_B8G8R8A8_UNORM:
+		case VK_FORMAT_B8G8R8A8_SRGB:
+		case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+		case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+		case VK_FORMAT_R16G16_SFLOAT:
+		case VK_FORMAT_R32_SFLOAT:
+		case VK_FORMAT_R32_UINT:
+		case VK_FORMAT_D32_SFLOAT: return 4u;
+		case VK_FORMAT_R16G16B16A16_SFLOAT:
+		case VK_FORMAT_R32G32_SFLOAT: return 8u;
+		case VK_FORMAT_R32G32B32A32_SFLOAT: return 16u;
+		default:
+			break;
+		}
+		return 0u;
+	}
+
+	VkBufferImageCopy GetTextureToBufferCopyRegion(const TextureDesc& desc, VkDeviceSize bufferOffset)
+	{
+		VkBufferImageCopy region = {};
+		region.bufferOffset = bufferOffset;
+		// zero means tightly packed
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = SpeculateVkImageAspectFlagsFromDesc(desc);
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageExtent = { desc.m_Size.x, desc.m_Size.y, 1 };
+		return region;
+	}
+
 	Texture* Texture::Create(RenderDevice& renderDevice, const TextureDesc& desc)
 	{
 		if (!desc.IsValid())
@@ -229,8 +287,8 @@ namespace ZE::RenderBackend
 		imageCI.imageType = VK_IMAGE_TYPE_2D;
 		imageCI.format = desc.m_Format;
 		imageCI.extent = { desc.m_Size[0], desc.m_Size[1], 1 };
-		imageCI.mipLevels = 1;
-		imageCI.arrayLayers = 1;
+		imageCI.mipLevels = desc.m_MipCount;
+		imageCI.arrayLayers = desc.m_ArrayLayerCount;
 		imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
 		imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
 		imageCI.usage = ToVkImageUsageFlags(desc.m_Usage);
@@ -246,31 +304,71 @@ namespace ZE::RenderBackend
 		vmaSetAllocationName(pTex->GetRenderDevice().m_GlobalAllocator, pTex->m_Allocation, desc.m_DebugName.c_str());
 		
 		pTex->m_AllocatedSizeInByte = static_cast<uint32_t>(allocationInfo.size);
+		renderDevice.GetMemoryTracker().OnAllocated(desc.m_MemoryCategory, allocationInfo.size);
+
+		if (auto* pBindlessTable = renderDevice.GetBindlessResourceTable(); pBindlessTable && (desc.m_Usage & (1 << static_cast<uint8_t>(ETextureUsage::Sampled))) != 0)
+		{
+			pTex->m_BindlessIndex = pBindlessTable->RegisterTexture(pTex);
+		}
 
 		return pTex;
 	}
 
-	VkImageView Texture::GetOrCreateView()
+	size_t TextureViewDesc::Hasher::operator()(const TextureViewDesc& desc) const
 	{
-		if (m_View)
+		uint64_t hash = static_cast<uint64_t>(desc.m_Format);
+		hash = hash * 31u + desc.m_AspectMask;
+		hash = hash * 31u + static_cast<uint64_t>(desc.m_ViewType);
+		hash = hash * 31u + ((static_cast<uint64_t>(desc.m_BaseMip) << 48) | (static_cast<uint64_t>(desc.m_MipCount) << 32)
+			| (static_cast<uint64_t>(desc.m_BaseLayer) << 16) | desc.m_LayerCount);
+		return std::hash<uint64_t>{}(hash);
+	}
+
+	VkImageView Texture::GetOrCreateView(const TextureViewDesc& viewDesc)
+	{
+		// resolve default values
+		TextureViewDesc key = viewDesc;
+		key.m_Format = key.m_Format == VK_FORMAT_UNDEFINED ? m_Desc.m_Format : key.m_Format;
+		key.m_AspectMask = key.m_AspectMask == 0 ? SpeculateVkImageAspectFlagsFromDesc(m_Desc) : key.m_AspectMask;
+		key.m_MipCount = key.m_MipCount == TextureViewDesc::kRemaining ? static_cast<uint16_t>(m_Desc.m_MipCount - key.m_BaseMip) : key.m_MipCount;
+		key.m_LayerCount = key.m_LayerCount == TextureViewDesc::kRemaining ? static_cast<uint16_t>(m_Desc.m_ArrayLayerCount - key.m_BaseLayer) : key.m_LayerCount;
+		if (key.m_ViewType == VK_IMAGE_VIEW_TYPE_2D && key.m_LayerCount > 1)
+		{
+			key.m_ViewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+		}
+
+		ZE_ASSERT_LOG(key.m_BaseMip + key.m_MipCount <= m_Desc.m_MipCount, "View mip range [{}, {}) exceeds texture {} ({} mips)!", key.m_BaseMip, key.m_BaseMip + key.m_MipCount, m_Desc.m_DebugName, m_Desc.m_MipCount);
+		ZE_ASSERT_LOG(key.m_BaseLayer + key.m_LayerCount <= m_Desc.m_ArrayLayerCount, "View layer range [{}, {}) exceeds texture {} ({} layers)!", key.m_BaseLayer, key.m_BaseLayer + key.m_LayerCount, m_Desc.m_DebugName, m_Desc.m_ArrayLayerCount);
+
+		std::scoped_lock lock(m_ViewMutex);
+
+		if (auto iter = m_Views.find(key); iter != m_Views.end())
 		{
-			return m_View;
+			return iter->second;
 		}
 		
 		VulkanZeroStruct(VkImageViewCreateInfo, createInfo);
 		createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-		createInfo.format = m_Desc.m_Format;
+		createInfo.format = key.m_Format;
 		createInfo.components = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
-		createInfo.subresourceRange.aspectMask = SpeculateVkImageAspectFlagsFromDesc(m_Desc);
-		createInfo.subresourceRange.baseMipLevel = 0;
-		createInfo.subresourceRange.levelCount = m_Desc.m_MipCount;
-		createInfo.subresourceRange.baseArrayLayer = 0;
-		createInfo.subresourceRange.layerCount = 1;
-		createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		createInfo.subresourceRange.aspectMask = key.m_AspectMask;
+		createInfo.subresourceRange.baseMipLevel = key.m_BaseMip;
+		createInfo.subresourceRange.levelCount = key.m_MipCount;
+		createInfo.subresourceRange.baseArrayLayer = key.m_BaseLayer;
+		createInfo.subresourceRange.layerCount = key.m_LayerCount;
+		createInfo.viewType = key.m_ViewType;
 		createInfo.image = m_Handle;
 		
-		VulkanCheckSucceed(vkCreateImageView(GetRenderDevice().GetNativeDevice(), &createInfo, nullptr, &m_View));
-		return m_View;
+		VkImageView view = nullptr;
+		VulkanCheckSucceed(vkCreateImageView(GetRenderDevice().GetNativeDevice(), &createInfo, nullptr, &view));
+		m_Views.emplace(key, view);
+		return view;
+	}
+
+	uint32_t Texture::GetViewCount() const
+	{
+		std::scoped_lock lock(m_ViewMutex);
+		return static_cast<uint32_t>(m_Views.size());
 	}
 	
 	Texture::Texture(RenderDevice& renderDevice, const TextureDesc& desc)
@@ -281,15 +379,21 @@ namespace ZE::RenderBackend
 
 	Texture::~Texture()
 	{
-		if (m_View)
+		if (auto* pBindlessTable = GetRenderDevice().GetBindlessResourceTable())
+		{
+			pBindlessTable->Unregister(EBindlessResourceType::SampledImage, m_BindlessIndex);
+		}
+
+		for (const auto view : m_Views | std::views::values)
 		{
-			vkDestroyImageView(GetRenderDevice().GetNativeDevice(), m_View, nullptr);
-			m_View = nullptr;
+			vkDestroyImageView(GetRenderDevice().GetNativeDevice(), view, nullptr);
 		}
+		m_Views.clear();
 
 		if (m_Handle)
 		{
 			vmaDestroyImage(GetRenderDevice().m_GlobalAllocator, m_Handle, m_Allocation);
+			GetRenderDevice().GetMemoryTracker().OnFreed(m_Desc.m_MemoryCategory, m_AllocatedSizeInByte);
 			m_Handle = nullptr;	
 		}
 	}
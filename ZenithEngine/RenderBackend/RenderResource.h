@@ -9,16 +9,35 @@
 #include <glm/vec4.hpp>
 
 #include <memory>
+#include <atomic>
+#include <limits>
 #include <string_view>
+#include <mutex>
+#include <unordered_map>
 
 namespace ZE::RenderBackend
 {
 	class RenderDevice;
+	struct UploadHandle;
 
 	enum class BufferMemoryUsage
 	{
 		CpuToGpu,
-		GpuOnly
+		GpuOnly,
+		// host readable, GPU writes it and CPU reads it back
+		GpuToCpu
+	};
+
+	// Used to report where GPU memory goes
+	enum class EMemoryCategory : uint8_t
+	{
+		GraphTransient = 0,
+		StaticBuffer,
+		Texture,
+		Staging,
+		Uniform,
+		Readback,
+		Count
 	};
 
 	struct BufferDesc
@@ -32,6 +51,7 @@ namespace ZE::RenderBackend
 
 		VkBufferUsageFlags			m_Usage = 0;
 		BufferMemoryUsage			m_MemoryUsage = BufferMemoryUsage::CpuToGpu;
+		EMemoryCategory				m_MemoryCategory = EMemoryCategory::StaticBuffer;
 
 		// TODO: debug build only
 		std::string					m_DebugName = "Unknown";
@@ -42,15 +62,22 @@ namespace ZE::RenderBackend
 	class Buffer : public std::enable_shared_from_this<Buffer>, public RenderDeviceChild
 	{
 		friend class RenderDevice;
+		friend class UploadManager;
+		friend class ReadbackManager;
+		friend class UniformRingBuffer;
 
 		friend struct MappedMemoryScope;
 
 	public:
 
 		static Buffer* Create(RenderDevice& renderDevice, const BufferDesc& desc);
-		static Buffer* Create(RenderDevice& renderDevice, const BufferDesc& desc, const void* pUploadData, uint32_t uploadDataSizeInByte);
+		/* Create buffer and queue the upload data without blocking.
+		 * The upload is tracked by the buffer, a render graph binding it waits for it on GPU.
+		 * Submissions outside of render graphs must wait outUploadHandle themselves.
+		 */
+		static Buffer* Create(RenderDevice& renderDevice, const BufferDesc& desc, const void* pUploadData, uint32_t uploadDataSizeInByte, UploadHandle& outUploadHandle);
 		template <typename T>
-		static Buffer* Create(RenderDevice& renderDevice, const BufferDesc& desc, const T& uploadData);
+		static Buffer* Create(RenderDevice& renderDevice, const BufferDesc& desc, const T& uploadData, UploadHandle& outUploadHandle);
 
 		virtual ~Buffer();
 
@@ -76,6 +103,12 @@ namespace ZE::RenderBackend
 
 		const BufferDesc& GetDesc() const { return m_Desc; }
 		VkBuffer GetNativeHandle() const { return m_Handle; }
+		
+		// Stable slot in the bindless storage buffer array, invalid if bindless is disabled or it is not a storage buffer.
+		uint32_t GetBindlessIndex() const { return m_BindlessIndex; }
+
+		// Latest upload into the buffer, GPU must NOT read it before the upload is finished.
+		UploadHandle GetPendingUpload() const;
 
 	private:
 
@@ -88,12 +121,17 @@ namespace ZE::RenderBackend
 
 		VmaAllocation			m_Allocation = nullptr;
 		uint32_t				m_AllocatedSizeInByte = 0;
+
+		uint32_t				m_BindlessIndex = std::numeric_limits<uint32_t>::max();
+
+		// written by the upload manager, uploads can be requested from any thread
+		std::atomic<uint64_t>	m_PendingUploadTimelineValue = 0;
 	};
 
 	template <typename T>
-	Buffer* Buffer::Create(RenderDevice& renderDevice, const BufferDesc& desc, const T& uploadData)
+	Buffer* Buffer::Create(RenderDevice& renderDevice, const BufferDesc& desc, const T& uploadData, UploadHandle& outUploadHandle)
 	{
-		return Create(renderDevice, desc, &uploadData, sizeof(T));
+		return Create(renderDevice, desc, &uploadData, sizeof(T), outUploadHandle);
 	}
 
 	enum class ETextureUsage : uint8_t
@@ -120,6 +158,8 @@ namespace ZE::RenderBackend
 		// TODO: enum bit flags
 		uint8_t					m_Usage = 0;
 		uint16_t				m_MipCount = 1u;
+		uint16_t				m_ArrayLayerCount = 1u;
+		EMemoryCategory			m_MemoryCategory = EMemoryCategory::Texture;
 		
 		// TODO: debug build only
 		std::string					m_DebugName = "Unknown";
@@ -129,6 +169,41 @@ namespace ZE::RenderBackend
 
 	VkFlags SpeculateVkImageAspectFlagsFromDesc(const TextureDesc& desc);
 	VkImageLayout SpeculateVkImageLayoutFromDesc(const TextureDesc& desc);
+	/* Size of one texel, 0 if the format is not supported for copies. */
+	uint32_t GetFormatSizeInByte(VkFormat format);
+	/* Region copying mip 0 of the first layer into tightly packed rows at the buffer offset. */
+	VkBufferImageCopy GetTextureToBufferCopyRegion(const TextureDesc& desc, VkDeviceSize bufferOffset);
+
+	/* Subresource view of a texture. Default values view the whole texture with its own format. */
+	struct TextureViewDesc
+	{
+		static constexpr uint16_t kRemaining = std::numeric_limits<uint16_t>::max();
+
+		// VK_FORMAT_UNDEFINED to use the format of the texture
+		VkFormat				m_Format = VK_FORMAT_UNDEFINED;
+		// 0 to speculate from the texture desc
+		VkImageAspectFlags		m_AspectMask = 0;
+		VkImageViewType			m_ViewType = VK_IMAGE_VIEW_TYPE_2D;
+		uint16_t				m_BaseMip = 0u;
+		uint16_t				m_MipCount = kRemaining;
+		uint16_t				m_BaseLayer = 0u;
+		uint16_t				m_LayerCount = kRemaining;
+
+		static TextureViewDesc SingleMip(uint16_t mip)
+		{
+			TextureViewDesc desc;
+			desc.m_BaseMip = mip;
+			desc.m_MipCount = 1u;
+			return desc;
+		}
+
+		bool operator==(const TextureViewDesc&) const = default;
+
+		struct Hasher
+		{
+			size_t operator()(const TextureViewDesc& desc) const;
+		};
+	};
 	
 	class Texture : public std::enable_shared_from_this<Texture>, public RenderDeviceChild
 	{
@@ -144,7 +219,12 @@ namespace ZE::RenderBackend
 		const TextureDesc& GetDesc() const { return m_Desc; }
 		VkImage GetNativeHandle() const { return m_Handle; }
 
-		VkImageView GetOrCreateView();
+		/* Views are cached by their desc and live as long as the texture. Thread-safe. */
+		VkImageView GetOrCreateView(const TextureViewDesc& viewDesc = {});
+		uint32_t GetViewCount() const;
+
+		// Stable slot in the bindless sampled image array, invalid if bindless is disabled or it is not a sampled texture.
+		uint32_t GetBindlessIndex() const { return m_BindlessIndex; }
 
 	private:
 		
@@ -156,11 +236,14 @@ namespace ZE::RenderBackend
 		
 		VkImage					m_Handle = nullptr;
 
-		VmaAllocation			m_Allocation;
+		VmaAllocation			m_Allocation = nullptr;
 		uint32_t				m_AllocatedSizeInByte = 0;
 
-		// TODO: multi-view cache
-		VkImageView				m_View = nullptr;
+		mutable std::mutex																m_ViewMutex;
+		// keyed by the resolved desc, so defaulted and explicit descs of the same subresources share one view
+		std::unordered_map<TextureViewDesc, VkImageView, TextureViewDesc::Hasher>		m_Views;
+
+		uint32_t				m_BindlessIndex = std::numeric_limits<uint32_t>::max();
 	};
 
 	enum class ERenderPassOperation : uint8_t
@@ -31,16 +31,6 @@ namespace ZE::RenderBackend
 
 	void RenderWindow::Shutdown()
 	{
-		for (auto& fence : m_Fences)
-		{
-			if (!fence)
-			{
-				continue;
-			}
-			
-			vkDestroyFence(GetRenderDevice().GetNativeDevice(), fence, nullptr);
-		}
-
 		for (auto& swapchainTex : m_SwapchainTextures)
 		{
 			swapchainTex->m_Handle = nullptr;
@@ -99,9 +89,8 @@ namespace ZE::RenderBackend
 
 		const uint32_t frameIndex = GetRenderDevice().GetFrameIndex(); 
 		
-		// Wait for until command buffer had finished execution
-		VulkanCheckSucceed(vkWaitForFences(GetRenderDevice().GetNativeDevice(), 1, &m_Fences[frameIndex], VK_TRUE, RenderDevice::kInfiniteWaitTime));
-		VulkanCheckSucceed(vkResetFences(GetRenderDevice().GetNativeDevice(), 1, &m_Fences[frameIndex]));
+		// Wait for until command buffer had finished execution, semaphores of this frame can be reused after that
+		GetRenderDevice().WaitForFrame(frameIndex);
 		
 		//-------------------------------------------------------------------------
 		
@@ -137,7 +126,11 @@ namespace ZE::RenderBackend
 		presentInfo.pSwapchains = &m_Swapchain;
 		presentInfo.pImageIndices = &m_SwapchainPresentImageIndex;
 
-		VkResult result = vkQueuePresentKHR(GetRenderDevice().m_GraphicQueue, &presentInfo);
+		VkResult result;
+		{
+			std::scoped_lock lock(GetRenderDevice().m_QueueSubmitMutex);
+			result = vkQueuePresentKHR(GetRenderDevice().m_GraphicQueue, &presentInfo);
+		}
 		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
 		{
 			CreateOrRecreateSwapchain();
@@ -148,6 +141,16 @@ namespace ZE::RenderBackend
 		}
 	}
 
+	RenderOutputSubmitInfo RenderWindow::GetFrameSubmitInfo() const
+	{
+		const uint32_t frameIndex = GetRenderDevice().GetFrameIndex();
+
+		RenderOutputSubmitInfo submitInfo;
+		submitInfo.m_WaitSemaphore = m_PresentCompleteSemaphores[frameIndex];
+		submitInfo.m_SignalSemaphore = m_RenderCompleteSemaphores[frameIndex];
+		return submitInfo;
+	}
+
 	bool RenderWindow::CreateOrRecreateSwapchain()
 	{
 		GetRenderDevice().WaitUntilIdle();
@@ -289,6 +292,12 @@ namespace ZE::RenderBackend
 
 		swapchainCI.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
 		swapchainCI.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		// backbuffer can be read back, e.g. for screenshots
+		const bool bSupportTransferSrc = (surfaceCaps.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) != 0;
+		if (bSupportTransferSrc)
+		{
+			swapchainCI.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		}
 		swapchainCI.imageExtent = { static_cast<uint32_t>(extent.x), static_cast<uint32_t>(extent.y) };
 		swapchainCI.imageFormat = pickFormat.format;
 		swapchainCI.imageColorSpace = pickFormat.colorSpace;
@@ -301,6 +310,10 @@ namespace ZE::RenderBackend
 		m_SwapchainBackbufferDesc.m_Size = { swapchainCI.imageExtent.width, swapchainCI.imageExtent.height };
 		m_SwapchainBackbufferDesc.m_Format = pickFormat.format;
 		m_SwapchainBackbufferDesc.m_Usage = 1 << static_cast<uint8_t>(ETextureUsage::Color);
+		if (bSupportTransferSrc)
+		{
+			m_SwapchainBackbufferDesc.m_Usage |= 1 << static_cast<uint8_t>(ETextureUsage::TransferSrc);
+		}
 
 		// delete old swapchain
 		//-------------------------------------------------------------------------
@@ -324,11 +337,6 @@ namespace ZE::RenderBackend
 				semaphore = nullptr;
 			}
 
-			for (auto& fence : m_Fences)
-			{
-				vkDestroyFence(GetRenderDevice().GetNativeDevice(), fence, nullptr);
-			}
-
 			for (auto& swapchainTex : m_SwapchainTextures)
 			{
 				swapchainTex->m_Handle = nullptr;
@@ -376,18 +384,6 @@ namespace ZE::RenderBackend
 			VulkanCheckSucceed(vkCreateSemaphore(GetRenderDevice().GetNativeDevice(), &semaphoreCI, nullptr, &m_PresentCompleteSemaphores[i]));
 		}
 
-		// create new fences
-		//-------------------------------------------------------------------------
-
-		VulkanZeroStruct(VkFenceCreateInfo, fenceCI);
-		fenceCI.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-		fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-		for (auto& fence : m_Fences)
-		{
-			vkCreateFence(GetRenderDevice().GetNativeDevice(), &fenceCI, nullptr, &fence);
-		}
-
 		return true;
 	}
 }
@@ -4,6 +4,7 @@
 #include "RenderDevice.h"
 #include "RenderBackend/RenderResource.h"
 #include "RenderBackend/RenderDeviceChild.h"
+#include "RenderBackend/IRenderOutput.h"
 
 #include <vulkan/vulkan_core.h>
 
@@ -14,7 +15,7 @@ namespace ZE::RenderBackend
 {
 	class RenderCommandList;
 
-	class RenderWindow : public Platform::Window, public std::enable_shared_from_this<RenderWindow>, public RenderDeviceChild
+	class RenderWindow : public Platform::Window, public IRenderOutput, public std::enable_shared_from_this<RenderWindow>, public RenderDeviceChild
 	{
 		friend class RenderDevice;
 		
@@ -28,12 +29,17 @@ namespace ZE::RenderBackend
 
 		virtual bool Resize(uint32_t width, uint32_t height) override;
 
-		void BeginFrame();
-		void EndFrame();
+		virtual void BeginFrame() override;
+		virtual void EndFrame() override;
 
-		void Present();
+		virtual void Present() override;
 
 		const std::shared_ptr<Texture>& GetFrameSwapchainRenderTarget() const { return m_SwapchainTextures[m_SwapchainPresentImageIndex]; }
+		virtual const std::shared_ptr<Texture>& GetFrameRenderTarget() const override { return GetFrameSwapchainRenderTarget(); }
+		virtual ERenderResourceState GetFrameRenderTargetState() const override { return ERenderResourceState::Present; }
+		virtual ERenderResourceState GetFrameRenderTargetFinalState() const override { return ERenderResourceState::Present; }
+
+		virtual RenderOutputSubmitInfo GetFrameSubmitInfo() const override;
 		const TextureDesc& GetSwapchainTextureDesc() const { return m_SwapchainBackbufferDesc; }
 
 	private:
@@ -50,7 +56,6 @@ namespace ZE::RenderBackend
 		std::array<VkSemaphore, RenderDevice::kSwapBufferCount>					m_RenderCompleteSemaphores = {};
 
 		std::array<VkImage, RenderDevice::kSwapBufferCount>						m_Images = {};
-		std::array<VkFence, RenderDevice::kSwapBufferCount>						m_Fences = {};
 
 		uint32_t																m_SwapchainPresentImageIndex = 0u;
 
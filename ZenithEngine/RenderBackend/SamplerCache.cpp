@@ -0,0 +1,122 @@
+#include "SamplerCache.h"
+
+#include "Core/Assertion.h"
+#include "RenderDevice.h"
+#include "VulkanHelper.h"
+
+#include <algorithm>
+#include <bit>
+#include <ranges>
+
+namespace ZE::RenderBackend
+{
+	SamplerDesc SamplerDesc::PointClamp()
+	{
+		SamplerDesc desc;
+		desc.m_MagFilter = VK_FILTER_NEAREST;
+		desc.m_MinFilter = VK_FILTER_NEAREST;
+		desc.m_MipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		return desc;
+	}
+
+	SamplerDesc SamplerDesc::LinearClamp()
+	{
+		return {};
+	}
+
+	SamplerDesc SamplerDesc::LinearWrap()
+	{
+		SamplerDesc desc;
+		desc.m_AddressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		desc.m_AddressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		desc.m_AddressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		return desc;
+	}
+
+	size_t SamplerDesc::Hasher::operator()(const SamplerDesc& desc) const
+	{
+		// +0.0f folds -0.0f into 0.0f, they compare equal so they must hash equal
+		auto fHashFloat = [](float value) { return static_cast<uint64_t>(std::bit_cast<uint32_t>(value + 0.0f)); };
+
+		uint64_t hash = static_cast<uint64_t>(desc.m_MagFilter);
+		hash = hash * 31u + static_cast<uint64_t>(desc.m_MinFilter);
+		hash = hash * 31u + static_cast<uint64_t>(desc.m_MipmapMode);
+		hash = hash * 31u + static_cast<uint64_t>(desc.m_AddressModeU);
+		hash = hash * 31u + static_cast<uint64_t>(desc.m_AddressModeV);
+		hash = hash * 31u + static_cast<uint64_t>(desc.m_AddressModeW);
+		hash = hash * 31u + static_cast<uint64_t>(desc.m_BorderColor);
+		hash = hash * 31u + static_cast<uint64_t>(desc.m_CompareOp);
+		hash = hash * 31u + fHashFloat(desc.m_MaxAnisotropy);
+		hash = hash * 31u + fHashFloat(desc.m_MipLodBias);
+		hash = hash * 31u + fHashFloat(desc.m_MinLod);
+		hash = hash * 31u + fHashFloat(desc.m_MaxLod);
+		return std::hash<uint64_t>{}(hash);
+	}
+
+	SamplerCache::SamplerCache(RenderDevice& renderDevice)
+	{
+		SetRenderDevice(&renderDevice);
+	}
+
+	SamplerCache::~SamplerCache()
+	{
+		std::scoped_lock lock(m_Mutex);
+
+		for (const auto sampler : m_Samplers | std::views::values)
+		{
+			vkDestroySampler(GetRenderDevice().GetNativeDevice(), sampler, nullptr);
+		}
+		m_Samplers.clear();
+	}
+
+	VkSampler SamplerCache::GetOrCreate(const SamplerDesc& desc)
+	{
+		// resolve anisotropy against the device, so descs which end up with the same sampler share it
+		const auto& physicalDevice = GetRenderDevice().GetPhysicalDevice();
+		SamplerDesc key = desc;
+		if (!physicalDevice.m_Features.samplerAnisotropy || key.m_MaxAnisotropy <= 1.0f)
+		{
+			key.m_MaxAnisotropy = 1.0f;
+		}
+		else
+		{
+			key.m_MaxAnisotropy = std::min(key.m_MaxAnisotropy, physicalDevice.m_Props.limits.maxSamplerAnisotropy);
+		}
+
+		std::scoped_lock lock(m_Mutex);
+
+		if (auto iter = m_Samplers.find(key); iter != m_Samplers.end())
+		{
+			return iter->second;
+		}
+
+		VulkanZeroStruct(VkSamplerCreateInfo, samplerCI);
+		samplerCI.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerCI.magFilter = key.m_MagFilter;
+		samplerCI.minFilter = key.m_MinFilter;
+		samplerCI.mipmapMode = key.m_MipmapMode;
+		samplerCI.addressModeU = key.m_AddressModeU;
+		samplerCI.addressModeV = key.m_AddressModeV;
+		samplerCI.addressModeW = key.m_AddressModeW;
+		samplerCI.mipLodBias = key.m_MipLodBias;
+		samplerCI.anisotropyEnable = key.m_MaxAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+		samplerCI.maxAnisotropy = key.m_MaxAnisotropy;
+		samplerCI.compareEnable = key.m_CompareOp != VK_COMPARE_OP_NEVER ? VK_TRUE : VK_FALSE;
+		samplerCI.compareOp = key.m_CompareOp;
+		samplerCI.minLod = key.m_MinLod;
+		samplerCI.maxLod = key.m_MaxLod;
+		samplerCI.borderColor = key.m_BorderColor;
+		samplerCI.unnormalizedCoordinates = VK_FALSE;
+
+		VkSampler sampler = nullptr;
+		VulkanCheckSucceed(vkCreateSampler(GetRenderDevice().GetNativeDevice(), &samplerCI, nullptr, &sampler));
+		m_Samplers.emplace(key, sampler);
+		return sampler;
+	}
+
+	uint32_t SamplerCache::GetSamplerCount() const
+	{
+		std::scoped_lock lock(m_Mutex);
+		return static_cast<uint32_t>(m_Samplers.size());
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "RenderDeviceChild.h"
+#include "Core/ClassProperty.h"
+
+#include <vulkan/vulkan_core.h>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace ZE::RenderBackend
+{
+	class RenderDevice;
+
+	struct SamplerDesc
+	{
+		VkFilter					m_MagFilter = VK_FILTER_LINEAR;
+		VkFilter					m_MinFilter = VK_FILTER_LINEAR;
+		VkSamplerMipmapMode			m_MipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+		VkSamplerAddressMode		m_AddressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		VkSamplerAddressMode		m_AddressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		VkSamplerAddressMode		m_AddressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		VkBorderColor				m_BorderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+		// compare is disabled if it is VK_COMPARE_OP_NEVER
+		VkCompareOp					m_CompareOp = VK_COMPARE_OP_NEVER;
+		// anisotropy is disabled if it is less or equal than 1
+		float						m_MaxAnisotropy = 1.0f;
+		float						m_MipLodBias = 0.0f;
+		float						m_MinLod = 0.0f;
+		float						m_MaxLod = VK_LOD_CLAMP_NONE;
+
+		static SamplerDesc PointClamp();
+		static SamplerDesc LinearClamp();
+		static SamplerDesc LinearWrap();
+
+		bool operator==(const SamplerDesc&) const = default;
+
+		struct Hasher
+		{
+			size_t operator()(const SamplerDesc& desc) const;
+		};
+	};
+
+	/* Device-wide deduplicated samplers. Samplers live until the cache is destroyed with the device. Thread-safe. */
+	class SamplerCache : public RenderDeviceChild
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(SamplerCache);
+
+	public:
+
+		SamplerCache(RenderDevice& renderDevice);
+		~SamplerCache();
+
+		VkSampler GetOrCreate(const SamplerDesc& desc);
+
+		uint32_t GetSamplerCount() const;
+
+	private:
+
+		mutable std::mutex														m_Mutex;
+		std::unordered_map<SamplerDesc, VkSampler, SamplerDesc::Hasher>			m_Samplers;
+	};
+}
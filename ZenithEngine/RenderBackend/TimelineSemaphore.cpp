@@ -0,0 +1,80 @@
+#include "TimelineSemaphore.h"
+
+#include "Core/Assertion.h"
+#include "RenderDevice.h"
+#include "VulkanHelper.h"
+
+namespace ZE::RenderBackend
+{
+	static void UpdateCompletedValue(std::atomic<uint64_t>& cachedValue, uint64_t value)
+	{
+		// completed value can only grow, other threads may had observed a larger one
+		uint64_t prevValue = cachedValue.load(std::memory_order_relaxed);
+		while (prevValue < value && !cachedValue.compare_exchange_weak(prevValue, value, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	TimelineSemaphore::TimelineSemaphore(RenderDevice& renderDevice)
+	{
+		SetRenderDevice(&renderDevice);
+
+		VulkanZeroStruct(VkSemaphoreTypeCreateInfo, semaphoreTypeCI);
+		semaphoreTypeCI.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		semaphoreTypeCI.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		semaphoreTypeCI.initialValue = 0;
+
+		VulkanZeroStruct(VkSemaphoreCreateInfo, semaphoreCI);
+		semaphoreCI.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreCI.pNext = &semaphoreTypeCI;
+
+		VulkanCheckSucceed(vkCreateSemaphore(renderDevice.GetNativeDevice(), &semaphoreCI, nullptr, &m_Semaphore));
+	}
+
+	TimelineSemaphore::~TimelineSemaphore()
+	{
+		vkDestroySemaphore(GetRenderDevice().GetNativeDevice(), m_Semaphore, nullptr);
+		m_Semaphore = nullptr;
+	}
+
+	uint64_t TimelineSemaphore::AcquireSignalValue()
+	{
+		return m_LastSignaledValue.fetch_add(1, std::memory_order_acq_rel) + 1;
+	}
+
+	uint64_t TimelineSemaphore::GetCompletedValue() const
+	{
+		uint64_t value = 0;
+		VulkanCheckSucceed(vkGetSemaphoreCounterValue(GetRenderDevice().GetNativeDevice(), m_Semaphore, &value));
+		UpdateCompletedValue(m_CachedCompletedValue, value);
+		return value;
+	}
+
+	bool TimelineSemaphore::IsCompleted(uint64_t value) const
+	{
+		if (value <= m_CachedCompletedValue.load(std::memory_order_acquire))
+		{
+			return true;
+		}
+		return value <= GetCompletedValue();
+	}
+
+	void TimelineSemaphore::Wait(uint64_t value) const
+	{
+		if (value == 0 || IsCompleted(value))
+		{
+			return;
+		}
+
+		ZE_ASSERT_LOG(value <= GetLastSignaledValue(), "Wait for a timeline value which will never be signaled!");
+
+		VulkanZeroStruct(VkSemaphoreWaitInfo, waitInfo);
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1u;
+		waitInfo.pSemaphores = &m_Semaphore;
+		waitInfo.pValues = &value;
+
+		VulkanCheckSucceed(vkWaitSemaphores(GetRenderDevice().GetNativeDevice(), &waitInfo, RenderDevice::kInfiniteWaitTime));
+		UpdateCompletedValue(m_CachedCompletedValue, value);
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "RenderDeviceChild.h"
+#include "Core/ClassProperty.h"
+
+#include <vulkan/vulkan_core.h>
+
+#include <atomic>
+
+namespace ZE::RenderBackend
+{
+	class RenderDevice;
+
+	/* Monotonic GPU timeline of one queue.
+	 * Each submission to the queue signals a new value, so CPU can tell how far the queue had gone without per-submission fences.
+	 * Values of different queues are NOT comparable, GPU may execute them in any order.
+	 * Work touching a resource on both queues is tracked by one value per queue, see DeferReleaseQueue.
+	 */
+	class TimelineSemaphore : public RenderDeviceChild
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(TimelineSemaphore);
+
+	public:
+
+		TimelineSemaphore(RenderDevice& renderDevice);
+		~TimelineSemaphore();
+
+		/* Reserve the value signaled by the next submission.
+		 * Must be called with the queue submit mutex held, so values are signaled in submission order.
+		 */
+		uint64_t AcquireSignalValue();
+
+		uint64_t GetLastSignaledValue() const { return m_LastSignaledValue.load(std::memory_order_acquire); }
+
+		uint64_t GetCompletedValue() const;
+		bool IsCompleted(uint64_t value) const;
+		void Wait(uint64_t value) const;
+
+		VkSemaphore GetNativeHandle() const { return m_Semaphore; }
+
+	private:
+
+		VkSemaphore								m_Semaphore = nullptr;
+
+		std::atomic<uint64_t>					m_LastSignaledValue = 0;
+		// avoid querying the driver when the value is known to be reached
+		mutable std::atomic<uint64_t>			m_CachedCompletedValue = 0;
+	};
+}
@@ -0,0 +1,95 @@
+#include "UniformRingBuffer.h"
+
+#include "Core/Assertion.h"
+#include "RenderDevice.h"
+#include "RenderResource.h"
+#include "VulkanHelper.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Math/Math.h"
+
+namespace ZE::RenderBackend
+{
+	UniformRingBuffer::UniformRingBuffer(RenderDevice& renderDevice, uint32_t frameSizeInByte)
+	{
+		SetRenderDevice(&renderDevice);
+
+		const auto& limits = renderDevice.GetPhysicalDevice().m_Props.limits;
+		m_Alignment = std::max(16u, static_cast<uint32_t>(limits.minUniformBufferOffsetAlignment));
+		m_MaxRangeInByte = limits.maxUniformBufferRange;
+		// every region starts at an aligned offset
+		m_FrameSizeInByte = Math::AlignTo(frameSizeInByte, m_Alignment);
+
+		BufferDesc ringDesc("uniform ring buffer");
+		ringDesc.m_Size = m_FrameSizeInByte * RenderDevice::kSwapBufferCount;
+		ringDesc.m_Usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+		ringDesc.m_MemoryUsage = BufferMemoryUsage::CpuToGpu;
+		ringDesc.m_MemoryCategory = EMemoryCategory::Uniform;
+
+		m_Buffer = std::shared_ptr<Buffer>(Buffer::Create(renderDevice, ringDesc));
+		ZE_ASSERT(m_Buffer);
+
+		// keep it mapped during the whole lifetime
+		void* pMappedMemory = nullptr;
+		VulkanCheckSucceed(vmaMapMemory(renderDevice.m_GlobalAllocator, m_Buffer->m_Allocation, &pMappedMemory));
+		m_MappedMemory = static_cast<std::byte*>(pMappedMemory);
+	}
+
+	UniformRingBuffer::~UniformRingBuffer()
+	{
+		vmaUnmapMemory(GetRenderDevice().m_GlobalAllocator, m_Buffer->m_Allocation);
+		m_MappedMemory = nullptr;
+		m_Buffer.reset();
+	}
+
+	BufferRange UniformRingBuffer::Write(const void* pData, uint32_t sizeInByte)
+	{
+		ZE_ASSERT(pData && sizeInByte != 0);
+		ZE_ASSERT_LOG(sizeInByte <= m_MaxRangeInByte, "Uniform data ({} bytes) exceeds maxUniformBufferRange ({} bytes)!", sizeInByte, m_MaxRangeInByte);
+
+		const uint32_t alignedSize = Math::AlignTo(sizeInByte, m_Alignment);
+
+		uint32_t head = m_FrameHead.load(std::memory_order_relaxed);
+		do
+		{
+			if (head + alignedSize > m_FrameSizeInByte)
+			{
+				ZE_LOG_ERROR("Uniform ring buffer is exhausted in this frame! (request: {} bytes, frame size: {} bytes)", sizeInByte, m_FrameSizeInByte);
+				return {};
+			}
+		} while (!m_FrameHead.compare_exchange_weak(head, head + alignedSize, std::memory_order_relaxed));
+
+		const uint32_t offset = m_FrameIndex * m_FrameSizeInByte + head;
+		memcpy(m_MappedMemory + offset, pData, sizeInByte);
+		m_BytesWritten.fetch_add(sizeInByte, std::memory_order_relaxed);
+
+		BufferRange range;
+		range.m_pBuffer = m_Buffer.get();
+		range.m_Offset = offset;
+		range.m_Size = sizeInByte;
+		return range;
+	}
+
+	void UniformRingBuffer::BeginFrame(uint32_t frameIndex)
+	{
+		ZE_ASSERT(frameIndex < RenderDevice::kSwapBufferCount);
+
+		m_BytesWrittenLastFrame = m_BytesWritten.exchange(0, std::memory_order_relaxed);
+		m_FrameHead.store(0, std::memory_order_relaxed);
+		m_FrameIndex = frameIndex;
+	}
+
+	void UniformRingBuffer::FlushFrame()
+	{
+		const uint32_t usedSize = m_FrameHead.load(std::memory_order_relaxed);
+		if (usedSize == 0)
+		{
+			return;
+		}
+
+		// memory may be non-coherent
+		VulkanCheckSucceed(vmaFlushAllocation(GetRenderDevice().m_GlobalAllocator, m_Buffer->m_Allocation, m_FrameIndex * m_FrameSizeInByte, usedSize));
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "RenderDeviceChild.h"
+#include "BufferHeap.h"
+#include "Core/ClassProperty.h"
+
+#include <atomic>
+#include <memory>
+
+namespace ZE::RenderBackend
+{
+	class RenderDevice;
+	class Buffer;
+
+	/* Persistently mapped uniform memory split into one region per frame.
+	 * Writes bump through the region of current frame, which is recycled as a whole once GPU had finished the frame.
+	 * Returned ranges share one VkBuffer, so they are bound as dynamic uniform buffers with their offset as the dynamic offset.
+	 * Write() is thread-safe.
+	 */
+	class UniformRingBuffer : public RenderDeviceChild
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(UniformRingBuffer);
+
+	public:
+
+		static constexpr uint32_t kDefaultFrameSizeInByte = 4u * 1024u * 1024u;
+
+		UniformRingBuffer(RenderDevice& renderDevice, uint32_t frameSizeInByte = kDefaultFrameSizeInByte);
+		~UniformRingBuffer();
+
+		/* Copy data into the region of current frame. Range is invalid if the region is exhausted. */
+		BufferRange Write(const void* pData, uint32_t sizeInByte);
+
+		/* Recycle the region of the frame. Must be called after GPU finished the frame. */
+		void BeginFrame(uint32_t frameIndex);
+		/* Make writes of current frame visible to GPU, must be called before the frame is submitted. */
+		void FlushFrame();
+
+		uint32_t GetBytesWrittenThisFrame() const { return m_BytesWritten.load(std::memory_order_relaxed); }
+		uint32_t GetBytesWrittenLastFrame() const { return m_BytesWrittenLastFrame; }
+		uint32_t GetFrameSizeInByte() const { return m_FrameSizeInByte; }
+
+	private:
+
+		std::shared_ptr<Buffer>						m_Buffer;
+		std::byte*									m_MappedMemory = nullptr;
+		uint32_t									m_FrameSizeInByte = 0;
+		uint32_t									m_Alignment = 0;
+		uint32_t									m_MaxRangeInByte = 0;
+
+		uint32_t									m_FrameIndex = 0;
+		// consumed size of the region of current frame, including alignment padding
+		std::atomic<uint32_t>						m_FrameHead = 0;
+		std::atomic<uint32_t>						m_BytesWritten = 0;
+		uint32_t									m_BytesWrittenLastFrame = 0;
+	};
+}
@@ -0,0 +1,326 @@
+#include "UploadManager.h"
+
+#include "Core/Assertion.h"
+#include "RenderDevice.h"
+#include "RenderResource.h"
+#include "TimelineSemaphore.h"
+#include "VulkanHelper.h"
+#include "Math/Math.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace ZE::RenderBackend
+{
+	UploadManager::UploadManager(RenderDevice& renderDevice, uint32_t stagingRingSizeInByte)
+		: m_StagingRingSizeInByte(Math::AlignTo(stagingRingSizeInByte, kStagingAlignment))
+	{
+		SetRenderDevice(&renderDevice);
+
+		BufferDesc stagingRingDesc("upload staging ring");
+		stagingRingDesc.m_Size = m_StagingRingSizeInByte;
+		stagingRingDesc.m_Usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		stagingRingDesc.m_MemoryUsage = BufferMemoryUsage::CpuToGpu;
+		stagingRingDesc.m_MemoryCategory = EMemoryCategory::Staging;
+
+		m_StagingRing = std::shared_ptr<Buffer>(Buffer::Create(renderDevice, stagingRingDesc));
+		ZE_ASSERT(m_StagingRing);
+
+		// keep it mapped during the whole lifetime
+		void* pMappedMemory = nullptr;
+		VulkanCheckSucceed(vmaMapMemory(renderDevice.m_GlobalAllocator, m_StagingRing->m_Allocation, &pMappedMemory));
+		m_StagingRingMappedMemory = static_cast<std::byte*>(pMappedMemory);
+
+		VulkanZeroStruct(VkCommandPoolCreateInfo, poolCI);
+		poolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolCI.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolCI.queueFamilyIndex = renderDevice.m_TransferQueueFamilyIndex;
+
+		VulkanCheckSucceed(vkCreateCommandPool(renderDevice.GetNativeDevice(), &poolCI, nullptr, &m_CommandPool));
+	}
+
+	UploadManager::~UploadManager()
+	{
+		WaitUntilIdle();
+
+		vkDestroyCommandPool(GetRenderDevice().GetNativeDevice(), m_CommandPool, nullptr);
+		m_CommandPool = nullptr;
+		m_FreeCommandBuffers.clear();
+
+		vmaUnmapMemory(GetRenderDevice().m_GlobalAllocator, m_StagingRing->m_Allocation);
+		m_StagingRingMappedMemory = nullptr;
+		m_StagingRing.reset();
+	}
+
+	UploadHandle UploadManager::Upload(Buffer* pDstBuffer, const void* pData, uint32_t sizeInByte, uint32_t dstOffset)
+	{
+		ZE_ASSERT(pDstBuffer && pData);
+		ZE_ASSERT((pDstBuffer->GetDesc().m_Usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT) != 0);
+		ZE_ASSERT(dstOffset + sizeInByte <= pDstBuffer->GetDesc().m_Size);
+
+		if (sizeInByte == 0)
+		{
+			return {};
+		}
+
+		std::unique_lock lock(m_Mutex);
+
+		PendingCopy copy;
+		copy.m_DstBuffer = pDstBuffer->GetNativeHandle();
+		copy.m_Region.dstOffset = dstOffset;
+		copy.m_Region.size = sizeInByte;
+
+		if (sizeInByte > m_StagingRingSizeInByte)
+		{
+			// too large to be hold by the ring, fallback to a dedicated staging buffer
+			BufferDesc stagingBufferDesc("dedicated staging buffer");
+			stagingBufferDesc.m_Size = sizeInByte;
+			stagingBufferDesc.m_Usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+			stagingBufferDesc.m_MemoryUsage = BufferMemoryUsage::CpuToGpu;
+			stagingBufferDesc.m_MemoryCategory = EMemoryCategory::Staging;
+
+			auto pStagingBuffer = std::shared_ptr<Buffer>(Buffer::Create(GetRenderDevice(), stagingBufferDesc));
+			{
+				auto mappedMemory = pStagingBuffer->Map();
+				memcpy(mappedMemory.m_pMappedMemory, pData, sizeInByte);
+			}
+
+			copy.m_SrcBuffer = pStagingBuffer->GetNativeHandle();
+			copy.m_Region.srcOffset = 0;
+			m_PendingDedicatedStagingBuffers.emplace_back(std::move(pStagingBuffer));
+		}
+		else
+		{
+			uint32_t ringOffset = 0;
+			while (!TryAllocateFromRing(sizeInByte, ringOffset))
+			{
+				// ring is full, kick the pending batch and wait for the oldest one to retire
+				FlushLocked();
+				ZE_ASSERT(!m_InFlightBatches.empty());
+				WaitLocked(lock, m_InFlightBatches.front().m_TimelineValue);
+			}
+
+			memcpy(m_StagingRingMappedMemory + ringOffset, pData, sizeInByte);
+
+			copy.m_SrcBuffer = m_StagingRing->GetNativeHandle();
+			copy.m_Region.srcOffset = ringOffset;
+		}
+
+		if (m_PendingCopies.empty())
+		{
+			// upload manager is the only one submitting to the transfer timeline, so each batch signals the value after the previous one
+			m_PendingTimelineValue = m_SubmittedTimelineValue + 1;
+		}
+		m_PendingCopies.emplace_back(copy);
+		// batches are reserved in order under the lock, so the buffer always keeps its latest upload
+		pDstBuffer->m_PendingUploadTimelineValue.store(m_PendingTimelineValue, std::memory_order_release);
+		return { m_PendingTimelineValue };
+	}
+
+	void UploadManager::Flush()
+	{
+		std::scoped_lock lock(m_Mutex);
+		FlushLocked();
+	}
+
+	UploadHandle UploadManager::GetLatestUpload() const
+	{
+		std::scoped_lock lock(m_Mutex);
+		return { m_PendingCopies.empty() ? m_SubmittedTimelineValue : m_PendingTimelineValue };
+	}
+
+	bool UploadManager::IsFinished(UploadHandle handle) const
+	{
+		return GetRenderDevice().GetTransferTimeline().IsCompleted(handle.m_TimelineValue);
+	}
+
+	void UploadManager::Wait(UploadHandle handle)
+	{
+		if (!handle.IsValid())
+		{
+			return;
+		}
+
+		std::unique_lock lock(m_Mutex);
+		if (handle.m_TimelineValue > m_SubmittedTimelineValue)
+		{
+			ZE_ASSERT(handle.m_TimelineValue == m_PendingTimelineValue);
+			FlushLocked();
+		}
+		WaitLocked(lock, handle.m_TimelineValue);
+	}
+
+	void UploadManager::WaitUntilIdle()
+	{
+		std::unique_lock lock(m_Mutex);
+		FlushLocked();
+		WaitLocked(lock, m_SubmittedTimelineValue);
+	}
+
+	void UploadManager::Update()
+	{
+		std::scoped_lock lock(m_Mutex);
+		RetireLocked(GetCompletedValue());
+	}
+
+	uint64_t UploadManager::GetCompletedValue() const
+	{
+		return GetRenderDevice().GetTransferTimeline().GetCompletedValue();
+	}
+
+	bool UploadManager::TryAllocateFromRing(uint32_t sizeInByte, uint32_t& outOffset)
+	{
+		const uint32_t alignedSize = Math::AlignTo(sizeInByte, kStagingAlignment);
+
+		if (m_StagingRingUsedSizeInByte == 0)
+		{
+			m_StagingRingHead = 0;
+		}
+
+		// the tail of the ring is wasted if the allocation can NOT fit in
+		const uint32_t wrapPadding = (m_StagingRingHead + alignedSize > m_StagingRingSizeInByte) ? m_StagingRingSizeInByte - m_StagingRingHead : 0u;
+		const uint32_t consumedSize = wrapPadding + alignedSize;
+
+		if (m_StagingRingUsedSizeInByte + consumedSize > m_StagingRingSizeInByte)
+		{
+			return false;
+		}
+
+		outOffset = wrapPadding != 0 ? 0u : m_StagingRingHead;
+		m_StagingRingHead = (outOffset + alignedSize) % m_StagingRingSizeInByte;
+		m_StagingRingUsedSizeInByte += consumedSize;
+		m_PendingRingSizeInByte += consumedSize;
+		return true;
+	}
+
+	void UploadManager::FlushLocked()
+	{
+		if (m_PendingCopies.empty())
+		{
+			return;
+		}
+
+		auto& renderDevice = GetRenderDevice();
+
+		// merge copies with the same src and dst into one command
+		std::ranges::stable_sort(m_PendingCopies, {}, [](const PendingCopy& copy) { return std::tie(copy.m_DstBuffer, copy.m_SrcBuffer); });
+
+		VkCommandBuffer commandBuffer = AcquireCommandBuffer();
+
+		VulkanZeroStruct(VkCommandBufferBeginInfo, beginInfo);
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		VulkanCheckSucceed(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+
+		std::vector<VkBufferCopy> regions;
+		for (size_t i = 0; i < m_PendingCopies.size();)
+		{
+			const auto& first = m_PendingCopies[i];
+			regions.clear();
+
+			size_t j = i;
+			for (; j < m_PendingCopies.size() && m_PendingCopies[j].m_DstBuffer == first.m_DstBuffer && m_PendingCopies[j].m_SrcBuffer == first.m_SrcBuffer; ++j)
+			{
+				regions.push_back(m_PendingCopies[j].m_Region);
+			}
+
+			vkCmdCopyBuffer(commandBuffer, first.m_SrcBuffer, first.m_DstBuffer, static_cast<uint32_t>(regions.size()), regions.data());
+			i = j;
+		}
+
+		VulkanCheckSucceed(vkEndCommandBuffer(commandBuffer));
+
+		// staging memory may be non-coherent
+		VulkanCheckSucceed(vmaFlushAllocation(renderDevice.m_GlobalAllocator, m_StagingRing->m_Allocation, 0, VK_WHOLE_SIZE));
+		for (const auto& pStagingBuffer : m_PendingDedicatedStagingBuffers)
+		{
+			VulkanCheckSucceed(vmaFlushAllocation(renderDevice.m_GlobalAllocator, pStagingBuffer->m_Allocation, 0, VK_WHOLE_SIZE));
+		}
+
+		auto& timeline = renderDevice.GetTransferTimeline();
+		const VkSemaphore timelineSemaphore = timeline.GetNativeHandle();
+		uint64_t signalValue = 0;
+
+		VulkanZeroStruct(VkTimelineSemaphoreSubmitInfo, timelineSubmitInfo);
+		timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineSubmitInfo.signalSemaphoreValueCount = 1u;
+		timelineSubmitInfo.pSignalSemaphoreValues = &signalValue;
+
+		VulkanZeroStruct(VkSubmitInfo, submitInfo);
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineSubmitInfo;
+		submitInfo.commandBufferCount = 1u;
+		submitInfo.pCommandBuffers = &commandBuffer;
+		submitInfo.signalSemaphoreCount = 1u;
+		submitInfo.pSignalSemaphores = &timelineSemaphore;
+
+		{
+			std::scoped_lock queueLock(renderDevice.m_QueueSubmitMutex);
+			signalValue = timeline.AcquireSignalValue();
+			ZE_ASSERT_LOG(signalValue == m_PendingTimelineValue, "Transfer timeline is signaled outside the upload manager, upload handles are invalid!");
+			VulkanCheckSucceed(vkQueueSubmit(renderDevice.m_TransferQueue, 1, &submitInfo, nullptr));
+		}
+		m_SubmittedTimelineValue = signalValue;
+
+		auto& batch = m_InFlightBatches.emplace_back();
+		batch.m_TimelineValue = signalValue;
+		batch.m_ConsumedRingSizeInByte = m_PendingRingSizeInByte;
+		batch.m_CommandBuffer = commandBuffer;
+		batch.m_DedicatedStagingBuffers = std::move(m_PendingDedicatedStagingBuffers);
+
+		m_PendingCopies.clear();
+		m_PendingDedicatedStagingBuffers.clear();
+		m_PendingRingSizeInByte = 0;
+	}
+
+	void UploadManager::RetireLocked(uint64_t completedValue)
+	{
+		while (!m_InFlightBatches.empty() && m_InFlightBatches.front().m_TimelineValue <= completedValue)
+		{
+			auto& batch = m_InFlightBatches.front();
+
+			ZE_ASSERT(m_StagingRingUsedSizeInByte >= batch.m_ConsumedRingSizeInByte);
+			m_StagingRingUsedSizeInByte -= batch.m_ConsumedRingSizeInByte;
+
+			VulkanCheckSucceed(vkResetCommandBuffer(batch.m_CommandBuffer, 0));
+			m_FreeCommandBuffers.push_back(batch.m_CommandBuffer);
+
+			m_InFlightBatches.pop_front();
+		}
+	}
+
+	void UploadManager::WaitLocked(std::unique_lock<std::mutex>& lock, uint64_t timelineValue)
+	{
+		if (timelineValue == 0)
+		{
+			return;
+		}
+
+		// do NOT block other uploaders while waiting on GPU
+		lock.unlock();
+		GetRenderDevice().GetTransferTimeline().Wait(timelineValue);
+		lock.lock();
+
+		RetireLocked(GetCompletedValue());
+	}
+
+	VkCommandBuffer UploadManager::AcquireCommandBuffer()
+	{
+		if (!m_FreeCommandBuffers.empty())
+		{
+			VkCommandBuffer commandBuffer = m_FreeCommandBuffers.back();
+			m_FreeCommandBuffers.pop_back();
+			return commandBuffer;
+		}
+
+		VulkanZeroStruct(VkCommandBufferAllocateInfo, allocInfo);
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = m_CommandPool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1u;
+
+		VkCommandBuffer commandBuffer = nullptr;
+		VulkanCheckSucceed(vkAllocateCommandBuffers(GetRenderDevice().GetNativeDevice(), &allocInfo, &commandBuffer));
+		return commandBuffer;
+	}
+}
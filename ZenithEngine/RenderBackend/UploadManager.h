@@ -0,0 +1,110 @@
+#pragma once
+
+#include "RenderDeviceChild.h"
+#include "Core/ClassProperty.h"
+
+#include <vulkan/vulkan_core.h>
+
+#include <memory>
+#include <vector>
+#include <deque>
+#include <mutex>
+
+namespace ZE::RenderBackend
+{
+	class RenderDevice;
+	class Buffer;
+
+	/* Non-blocking handle of a batched upload.
+	 * The upload is finished on GPU when the transfer timeline of the render device reaches m_TimelineValue.
+	 */
+	struct UploadHandle
+	{
+		uint64_t					m_TimelineValue = 0;
+
+		bool IsValid() const { return m_TimelineValue != 0; }
+	};
+
+	/* Batch buffer uploads through a persistently mapped staging ring and submit them on the transfer queue.
+	 * Uploads can be requested from any thread, all uploads requested between two flushes share one submission.
+	 */
+	class UploadManager : public RenderDeviceChild
+	{
+		ZE_NON_COPYABLE_AND_NON_MOVABLE_CLASS(UploadManager);
+
+	public:
+
+		static constexpr uint32_t kDefaultStagingRingSizeInByte = 64u * 1024u * 1024u;
+		static constexpr uint32_t kStagingAlignment = 16u;
+
+		UploadManager(RenderDevice& renderDevice, uint32_t stagingRingSizeInByte = kDefaultStagingRingSizeInByte);
+		~UploadManager();
+
+		UploadHandle Upload(Buffer* pDstBuffer, const void* pData, uint32_t sizeInByte, uint32_t dstOffset = 0);
+
+		/* Submit all pending uploads in one transfer queue submission. */
+		void Flush();
+
+		/* Latest upload requested so far, whether its batch had been submitted or not. */
+		UploadHandle GetLatestUpload() const;
+
+		bool IsFinished(UploadHandle handle) const;
+		/* Block until the upload is finished on GPU, the pending batch is flushed if necessary. */
+		void Wait(UploadHandle handle);
+		void WaitUntilIdle();
+
+		// Retire finished batches and reclaim their staging memory. Called by render device each frame.
+		void Update();
+
+	private:
+
+		struct PendingCopy
+		{
+			VkBuffer					m_SrcBuffer = nullptr;
+			VkBuffer					m_DstBuffer = nullptr;
+			VkBufferCopy				m_Region = {};
+		};
+
+		struct InFlightBatch
+		{
+			uint64_t									m_TimelineValue = 0;
+			uint32_t									m_ConsumedRingSizeInByte = 0;
+			VkCommandBuffer								m_CommandBuffer = nullptr;
+			// staging buffers of uploads which can NOT fit into the ring
+			std::vector<std::shared_ptr<Buffer>>		m_DedicatedStagingBuffers;
+		};
+
+		uint64_t GetCompletedValue() const;
+
+		bool TryAllocateFromRing(uint32_t sizeInByte, uint32_t& outOffset);
+		void FlushLocked();
+		void RetireLocked(uint64_t completedValue);
+		void WaitLocked(std::unique_lock<std::mutex>& lock, uint64_t timelineValue);
+
+		VkCommandBuffer AcquireCommandBuffer();
+
+	private:
+
+		mutable std::mutex							m_Mutex;
+
+		std::shared_ptr<Buffer>						m_StagingRing;
+		std::byte*									m_StagingRingMappedMemory = nullptr;
+		uint32_t									m_StagingRingSizeInByte = 0;
+		uint32_t									m_StagingRingHead = 0;
+		uint32_t									m_StagingRingUsedSizeInByte = 0;
+
+		// transfer timeline value of the last submitted batch
+		uint64_t									m_SubmittedTimelineValue = 0;
+
+		// current batch which is not submitted yet, its value is reserved by its first upload
+		uint64_t									m_PendingTimelineValue = 0;
+		std::vector<PendingCopy>					m_PendingCopies;
+		uint32_t									m_PendingRingSizeInByte = 0;
+		std::vector<std::shared_ptr<Buffer>>		m_PendingDedicatedStagingBuffers;
+
+		std::deque<InFlightBatch>					m_InFlightBatches;
+
+		VkCommandPool								m_CommandPool = nullptr;
+		std::vector<VkCommandBuffer>				m_FreeCommandBuffers;
+	};
+}
@@ -2,13 +2,17 @@
 
 #include "Core/Reflection.h"
 #include "Render/RenderGraph.h"
+#include "Render/ViewBatch.h"
 #include "RenderBackend/RenderResource.h"
+#include "RenderBackend/BufferHeap.h"
+#include "RenderBackend/UploadManager.h"
 
 #include <glm/mat4x4.hpp>
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_transform.hpp>
 
 #include <array>
+#include <vector>
 
 namespace ZE::Renderer
 {
@@ -48,28 +52,19 @@ namespace ZE::Renderer
 			Asset::AssetManager::Get().WaitUntilAllRequestsFinished();
 		}
 
-		// Create static GPU resources
-		RenderBackend::BufferDesc bufferDesc("triangle vertex buffer");
-		bufferDesc.m_Size = static_cast<uint32_t>(sizeof(Vertex)) * kTriangleVertices.size();
-		bufferDesc.m_Usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-		bufferDesc.m_MemoryUsage = RenderBackend::BufferMemoryUsage::GpuOnly;
-
-		m_VertexBuffer = std::shared_ptr<RenderBackend::Buffer>(RenderBackend::Buffer::Create(renderDevice, bufferDesc, kTriangleVertices.data(), bufferDesc.m_Size));
-		if (!m_VertexBuffer)
+		// Suballocate static GPU resources from the shared geometry heap
+		auto& geometryHeap = renderDevice.GetGeometryBufferHeap();
+		m_VertexRange = geometryHeap.Allocate(static_cast<uint32_t>(sizeof(Vertex) * kTriangleVertices.size()));
+		m_IndexRange = geometryHeap.Allocate(static_cast<uint32_t>(sizeof(uint32_t) * kTriangleIndices.size()));
+		if (!m_VertexRange.IsValid() || !m_IndexRange.IsValid())
 		{
 			return false;
 		}
 
-		bufferDesc.m_DebugName = "triangle index buffer";
-		bufferDesc.m_Size = static_cast<uint32_t>(kTriangleIndices.size()) * sizeof(uint32_t);
-		bufferDesc.m_Usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-		bufferDesc.m_MemoryUsage = RenderBackend::BufferMemoryUsage::GpuOnly;
-
-		m_IndexBuffer = std::shared_ptr<RenderBackend::Buffer>(RenderBackend::Buffer::Create(renderDevice, bufferDesc, kTriangleIndices.data(), bufferDesc.m_Size));
-		if (!m_IndexBuffer)
-		{
-			return false;
-		}
+		// both uploads share one batch, graphs binding the ranges wait for it on GPU instead of blocking here
+		auto& uploadManager = renderDevice.GetUploadManager();
+		uploadManager.Upload(m_VertexRange.m_pBuffer, kTriangleVertices.data(), m_VertexRange.m_Size, m_VertexRange.m_Offset);
+		uploadManager.Upload(m_IndexRange.m_pBuffer, kTriangleIndices.data(), m_IndexRange.m_Size, m_IndexRange.m_Offset);
 
 		// Fill shader layout
 		Render::Shader::LayoutBuilder vsBuilder(m_TriangleVS.GetAsset());
@@ -91,17 +86,17 @@ namespace ZE::Renderer
 
 			RenderBackend::BufferBarrier bufferBarriers[2];
 
-			bufferBarriers[0].m_Buffer = m_VertexBuffer->GetNativeHandle();
-			bufferBarriers[0].m_Size = m_VertexBuffer->GetDesc().m_Size;
-			bufferBarriers[0].m_Offset = 0;
+			bufferBarriers[0].m_Buffer = m_VertexRange.GetNativeHandle();
+			bufferBarriers[0].m_Size = m_VertexRange.m_Size;
+			bufferBarriers[0].m_Offset = m_VertexRange.m_Offset;
 			bufferBarriers[0].m_SrcQueueFamilyIndex = pCmdList->GetQueueIndex();
 			bufferBarriers[0].m_DstQueueFamilyIndex = pCmdList->GetQueueIndex();
 			bufferBarriers[0].m_PrevAccesses = prevAccess;
 			bufferBarriers[0].m_NextAccesses = nextVBAccess;
 
-			bufferBarriers[1].m_Buffer = m_IndexBuffer->GetNativeHandle();
-			bufferBarriers[1].m_Size = m_IndexBuffer->GetDesc().m_Size;
-			bufferBarriers[1].m_Offset = 0;
+			bufferBarriers[1].m_Buffer = m_IndexRange.GetNativeHandle();
+			bufferBarriers[1].m_Size = m_IndexRange.m_Size;
+			bufferBarriers[1].m_Offset = m_IndexRange.m_Offset;
 			bufferBarriers[1].m_SrcQueueFamilyIndex = pCmdList->GetQueueIndex();
 			bufferBarriers[1].m_DstQueueFamilyIndex = pCmdList->GetQueueIndex();
 			bufferBarriers[1].m_PrevAccesses = prevAccess;
@@ -119,8 +114,11 @@ namespace ZE::Renderer
 	
 	void TriangleRenderer::Release(RenderBackend::RenderDevice& renderDevice)
 	{
-		m_VertexBuffer.reset();
-		m_IndexBuffer.reset();
+		// GPU is idle when renderer is released
+		renderDevice.GetGeometryBufferHeap().Free(m_VertexRange);
+		renderDevice.GetGeometryBufferHeap().Free(m_IndexRange);
+		m_VertexRange = {};
+		m_IndexRange = {};
 	}
 
 	void TriangleRenderer::Render(Render::RenderGraph& renderGraph, Render::GraphResourceHandle outputColorRT, Render::GraphResourceHandle outputDepthRT)
@@ -128,26 +126,14 @@ namespace ZE::Renderer
 		using namespace ZE::Render;
 		using namespace ZE::RenderBackend;
 
-		auto vbHandle = renderGraph.ImportResource(m_VertexBuffer, ERenderResourceState::VertexBuffer);
-		auto idHandle = renderGraph.ImportResource(m_IndexBuffer, ERenderResourceState::IndexBuffer);
-		
 		auto& matrices = renderGraph.AllocateNodeResource<Matrices>();
 		matrices.m_ModelMat = glm::mat4(1.0f);
 		matrices.m_ViewMat = glm::lookAtRH(glm::vec3(0.0f, 0.0f, -5.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
 		matrices.m_ProjectionMat = glm::infinitePerspectiveRH_ZO(glm::radians(45.0f), 1.0f, 1.0f);
 
-		BufferDesc uniformBufferDesc;
-		uniformBufferDesc.m_Size = sizeof(Matrices);
-		uniformBufferDesc.m_Usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-		uniformBufferDesc.m_MemoryUsage = BufferMemoryUsage::CpuToGpu;
-		auto matrixBufferHandle = renderGraph.CreateResource(uniformBufferDesc);
-
 		auto& drawTriangleNode = renderGraph.AddNode("Draw Triangle");
 
-		drawTriangleNode.Read(vbHandle, ERenderResourceState::VertexBuffer);
-		drawTriangleNode.Read(idHandle, ERenderResourceState::IndexBuffer);
-		drawTriangleNode.Read(matrixBufferHandle, ERenderResourceState::VertexShaderReadUniformBuffer);
-		
+		// vertex and index ranges are static and had been transitioned in Prepare(), matrices are written into the uniform ring
 		drawTriangleNode.Write(outputColorRT, ERenderResourceState::ColorAttachmentWrite);
 		drawTriangleNode.Write(outputDepthRT, ERenderResourceState::DepthStencilAttachmentWrite);
 		
@@ -156,16 +142,47 @@ namespace ZE::Renderer
 			.BindDepthStencilRenderTarget(outputDepthRT, ERenderTargetLoadOperation::DontCare, ERenderTargetStoreOperation::Store)
 			.BindVertexShader(m_TriangleVS.GetAsset())
 			.BindPixelShader(m_TrianglePS.GetAsset())
-			.Execute([matrixBufferHandle, vbHandle, idHandle, outputColorRT, &matrices](GraphExecutionContext& context)
+			.Execute([vertexRange = m_VertexRange, indexRange = m_IndexRange, outputColorRT, &matrices](GraphExecutionContext& context)
 		{
 			const auto& desc = context.GetDesc<GraphResourceType::Texture>(outputColorRT);
 			context.SetViewportSize(desc.m_Size.x, desc.m_Size.y);
 				
-			context.UpdateUniformBuffer(matrixBufferHandle, matrices);
-			context.BindResource("view", matrixBufferHandle);
+			context.UpdateUniformBuffer("view", matrices);
+			context.BindPipeline();
+
+			context.BindVertexInput(vertexRange, indexRange);
+			context.DrawIndexed(3u, 1u, 0, 0, 0);
+		});
+	}
+
+	void TriangleRenderer::RenderViews(Render::RenderGraph& renderGraph, const Render::ViewBatch& viewBatch)
+	{
+		using namespace ZE::Render;
+		using namespace ZE::RenderBackend;
+
+		// matrices of all views are allocated up front, the job picks the one of the view being rendered
+		std::vector<const Matrices*> viewMatrices;
+		viewMatrices.reserve(viewBatch.GetViewCount());
+		for (uint32_t i = 0; i < viewBatch.GetViewCount(); ++i)
+		{
+			auto& matrices = renderGraph.AllocateNodeResource<Matrices>();
+			matrices.m_ModelMat = glm::mat4(1.0f);
+			matrices.m_ViewMat = viewBatch.GetView(i).m_ViewMat;
+			matrices.m_ProjectionMat = viewBatch.GetView(i).m_ProjectionMat;
+			viewMatrices.push_back(&matrices);
+		}
+
+		viewBatch.AddViewNode(renderGraph, "Draw Triangle Views")
+			.BindVertexShader(m_TriangleVS.GetAsset())
+			.BindPixelShader(m_TrianglePS.GetAsset())
+			.Execute([vertexRange = m_VertexRange, indexRange = m_IndexRange, viewSize = viewBatch.GetSettings().m_ViewSize, viewMatrices = std::move(viewMatrices)](GraphExecutionContext& context)
+		{
+			context.SetViewportSize(viewSize.x, viewSize.y);
+
+			context.UpdateUniformBuffer("view", *viewMatrices[context.GetViewIndex()]);
 			context.BindPipeline();
 
-			context.BindVertexInput(vbHandle, idHandle);
+			context.BindVertexInput(vertexRange, indexRange);
 			context.DrawIndexed(3u, 1u, 0, 0, 0);
 		});
 	}
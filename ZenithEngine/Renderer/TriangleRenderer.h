@@ -4,11 +4,14 @@
 
 #include "Render/StaticMesh.h"
 #include "Render/Shader.h"
+#include "RenderBackend/BufferHeap.h"
+#include "RenderBackend/UploadManager.h"
 
 namespace ZE::Render
 {
 	class RenderGraph;
 	class GraphResourceHandle;
+	class ViewBatch;
 }
 
 namespace ZE::RenderBackend
@@ -27,6 +30,8 @@ namespace ZE::Renderer
 		void Release(RenderBackend::RenderDevice& renderDevice);
 		
 		void Render(Render::RenderGraph& renderGraph, Render::GraphResourceHandle outputColorRT, Render::GraphResourceHandle outputDepthRT);
+		/* Draw into every view of the batch with one node, the batch must be set up. */
+		void RenderViews(Render::RenderGraph& renderGraph, const Render::ViewBatch& viewBatch);
 	
 	private:
 
@@ -34,8 +39,8 @@ namespace ZE::Renderer
 		Asset::AssetPtr<Render::PixelShader>				m_TrianglePS{"Content/Shader/Triangle.psdr"};
 
 		// TODO: make static mesh asset
-		std::shared_ptr<RenderBackend::Buffer>				m_VertexBuffer = nullptr;			
-		std::shared_ptr<RenderBackend::Buffer>				m_IndexBuffer = nullptr;
+		RenderBackend::BufferRange							m_VertexRange;
+		RenderBackend::BufferRange							m_IndexRange;
 
 		Asset::AssetPtr<Render::StaticMesh>					m_TestAsset{"Content/Mesh/Cerberus/scene.gltf"};
 	};
@@ -2,6 +2,7 @@
 
 #include "Core/Assertion.h"
 
+#include <algorithm>
 #include <ranges>
 #include <thread>
 
@@ -42,7 +43,8 @@ namespace ZE::TaskSystem
 
 	TaskManager::TaskManager()
 	{
-		uint32_t numThreads = std::thread::hardware_concurrency();
+		// the pool keeps at least one thread besides the render thread, e.g. on a single core machine or when the count is unknown (0)
+		uint32_t numThreads = std::max(std::thread::hardware_concurrency(), 2u);
 
 		InitThreadExecutor(EDedicatedThread::RenderThread, 1);
 		numThreads -= 1u;
@@ -17,7 +17,8 @@ namespace ZE
 
 	//-------------------------------------------------------------------------
 
-	RunEngineScoped::RunEngineScoped()
+	RunEngineScoped::RunEngineScoped(const Core::Engine::Settings& settings)
+		: m_Engine(settings)
 	{
 		ZE_EXEC_ASSERT(m_Engine.PreInitialize());
 		ZE_EXEC_ASSERT(m_Engine.Initialize());
@@ -11,7 +11,7 @@ namespace ZE
 	{
 	public:
 
-		RunEngineScoped();
+		explicit RunEngineScoped(const Core::Engine::Settings& settings = {});
 		~RunEngineScoped();
 		
 		RunEngineScoped(const RunEngineScoped&) = delete;
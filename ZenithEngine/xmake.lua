@@ -8,6 +8,12 @@ add_packagedirs("ThirdParty/")
 add_requires("taskflow", "spdlog", "glm", "glfw", "assimp")
 add_requires("assimp")
 
+option("null_render_backend")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Link the CPU-only null Vulkan backend instead of the Vulkan loader, for benchmarking and testing without GPU.")
+option_end()
+
 target("ZenithEngine")
     set_kind("shared")
     add_defines("ZENITH_ENGINE_DLL_EXPORT=1", "GLFW_VULKAN_STATIC")
@@ -22,8 +28,17 @@ target("ZenithEngine")
     add_includedirs("$(projectdir)/ZenithEngine/ThirdParty/vulkan/Include/")
     
     -- vulkan
-    add_linkdirs("$(projectdir)/ZenithEngine/ThirdParty/vulkan/Lib")
-    add_links("vulkan-1.lib")
+    if has_config("null_render_backend") then
+        add_defines("ZENITH_NULL_RENDER_BACKEND=1")
+    else
+        add_defines("ZENITH_NULL_RENDER_BACKEND=0")
+        if is_plat("windows") then
+            add_linkdirs("$(projectdir)/ZenithEngine/ThirdParty/vulkan/Lib")
+            add_links("vulkan-1.lib")
+        else
+            add_links("vulkan")
+        end
+    end
 
     -- Debug
     if is_mode("debug") then
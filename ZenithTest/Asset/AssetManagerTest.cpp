@@ -0,0 +1,437 @@
+#include "Test.h"
+
+#include "Asset/Asset.h"
+#include "Asset/AssetLoader.h"
+#include "Asset/AssetManager.h"
+#include "Core/Timer.h"
+#include "Log/Log.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ZE::Test
+{
+	class TestBlob : public Asset::Asset
+	{
+		ZE_CLASS_REFL(TestBlob)
+
+	public:
+
+		virtual uint64_t GetMemorySizeInByte() const override { return m_SizeInByte; }
+
+		uint64_t						m_SizeInByte = 0;
+	};
+}
+
+REFL_AUTO(type(ZE::Test::TestBlob, bases<ZE::Asset::Asset>))
+
+using namespace ZE;
+
+namespace
+{
+	constexpr uint64_t kBlobSizeInByte = 64u;
+
+	std::atomic<uint32_t> gBlobLoadCount = 0;
+	// loads which ran before all of their dependencies were loaded
+	std::atomic<uint32_t> gBlobDependencyOrderViolationCount = 0;
+
+	// dependencies of a blob by its path, set by the tests before requesting it
+	std::mutex gBlobDependencyMutex;
+	std::unordered_map<std::string, std::vector<std::string>> gBlobDependencies;
+
+	// paths of the loaded blobs in load order, blobs whose path starts with kFailingBlobPrefix fail to load instead
+	constexpr std::string_view kFailingBlobPrefix = "FailingBlob";
+	std::mutex gBlobLoadOrderMutex;
+	std::vector<std::string> gBlobLoadOrder;
+
+	Asset::AssetId MakeBlobId(const std::string& path)
+	{
+		return Asset::AssetId(Core::FilePath(std::filesystem::path(path)), Core::GetTypeName_Direct<Test::TestBlob>());
+	}
+
+	// blobs are made up in memory, no file is read
+	class TestBlobLoader : public Asset::IAssetLoader
+	{
+	public:
+
+		virtual bool GatherDependencies(const Core::FilePath& filePath, Asset::AssetRequest& request, std::vector<Asset::AssetId>& outDependencies) override
+		{
+			std::scoped_lock lock(gBlobDependencyMutex);
+			if (const auto iter = gBlobDependencies.find(filePath.ToString()); iter != gBlobDependencies.end())
+			{
+				for (const auto& dependency : iter->second)
+				{
+					outDependencies.push_back(MakeBlobId(dependency));
+				}
+			}
+			return true;
+		}
+
+		virtual bool Load(const Core::FilePath& filePath, Asset::AssetRequest& request) override
+		{
+			const auto path = filePath.ToString();
+			if (path.starts_with(kFailingBlobPrefix))
+			{
+				return false;
+			}
+
+			if (!std::ranges::all_of(request.GetDependencies(), &Asset::AssetRequest::IsLoaded))
+			{
+				gBlobDependencyOrderViolationCount.fetch_add(1, std::memory_order::relaxed);
+			}
+
+			auto* pBlob = new Test::TestBlob;
+			pBlob->m_SizeInByte = kBlobSizeInByte;
+			request.SetAsset(pBlob);
+
+			{
+				std::scoped_lock lock(gBlobLoadOrderMutex);
+				gBlobLoadOrder.push_back(path);
+			}
+			gBlobLoadCount.fetch_add(1, std::memory_order::relaxed);
+			return true;
+		}
+	};
+
+	void SetBlobDependencies(const std::string& path, std::vector<std::string> dependencies)
+	{
+		std::scoped_lock lock(gBlobDependencyMutex);
+		gBlobDependencies[path] = std::move(dependencies);
+	}
+
+	/* Chain of diamonds, each level's two blobs depend on the top of the next level, 2^levelCount paths lead to the bottom. */
+	std::string BuildDiamondChain(std::string_view prefix, uint32_t levelCount)
+	{
+		const auto LevelName = [prefix](uint32_t level, std::string_view side)
+		{
+			return std::string(prefix) + std::to_string(level) + std::string(side);
+		};
+
+		for (uint32_t level = 0; level < levelCount; ++level)
+		{
+			const auto nextTop = LevelName(level + 1u, "Top");
+			SetBlobDependencies(LevelName(level, "Top"), { LevelName(level, "Left"), LevelName(level, "Right") });
+			SetBlobDependencies(LevelName(level, "Left"), { nextTop });
+			SetBlobDependencies(LevelName(level, "Right"), { nextTop });
+		}
+		return LevelName(0, "Top");
+	}
+
+	Asset::AssetManager& GetAssetManager()
+	{
+		// the asset manager is global, tests of it share one loader and use their own asset names
+		static std::once_flag sRegisterOnce;
+		std::call_once(sRegisterOnce, []
+		{
+			Asset::AssetManager::Get().RegisterAssetLoader<Test::TestBlob>(new TestBlobLoader);
+		});
+		return Asset::AssetManager::Get();
+	}
+
+	Core::FilePath MakeBlobPath(std::string_view prefix, uint32_t index)
+	{
+		return Core::FilePath(std::filesystem::path(std::string(prefix) + std::to_string(index)));
+	}
+
+	constexpr uint32_t kRequestThreadCount = 32u;
+
+	/* Each thread requests every asset, starting at a different one, odd threads one by one and even ones in a batch. */
+	void RequestFromThreads(Asset::AssetManager& assetManager, std::vector<std::vector<Asset::AssetPtr<Test::TestBlob>>>& threadPtrs,
+		std::string_view prefix, uint32_t assetCount, std::atomic<uint32_t>* pLoadedCallbackCount)
+	{
+		threadPtrs.assign(kRequestThreadCount, {});
+
+		std::atomic<uint32_t> finishedThreadCount = 0;
+		std::vector<std::thread> threads;
+		threads.reserve(kRequestThreadCount);
+		for (uint32_t t = 0; t < kRequestThreadCount; ++t)
+		{
+			threads.emplace_back([&, t]
+			{
+				auto& ptrs = threadPtrs[t];
+				ptrs.reserve(assetCount);
+				for (uint32_t i = 0; i < assetCount; ++i)
+				{
+					ptrs.emplace_back(MakeBlobPath(prefix, (i + t * 7u) % assetCount));
+				}
+
+				if (t % 2u == 0)
+				{
+					std::vector<Asset::AssetPtrBase*> batch;
+					batch.reserve(assetCount + 1u);
+					for (auto& ptr : ptrs)
+					{
+						batch.push_back(&ptr);
+					}
+					// the same ptr twice in a batch is requested once
+					batch.push_back(&ptrs.front());
+					assetManager.RequestLoadBatch(batch);
+				}
+				else
+				{
+					for (auto& ptr : ptrs)
+					{
+						if (pLoadedCallbackCount)
+						{
+							assetManager.RequestLoad(ptr, [pLoadedCallbackCount](const Asset::AssetRequest& request)
+							{
+								if (request.IsLoaded())
+								{
+									pLoadedCallbackCount->fetch_add(1, std::memory_order::relaxed);
+								}
+							});
+						}
+						else
+						{
+							assetManager.RequestLoad(ptr);
+						}
+					}
+				}
+				finishedThreadCount.fetch_add(1, std::memory_order::release);
+			});
+		}
+
+		// the main thread dispatches while the requests keep coming
+		while (finishedThreadCount.load(std::memory_order::acquire) < kRequestThreadCount)
+		{
+			assetManager.Update();
+			std::this_thread::yield();
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+		assetManager.WaitUntilAllRequestsFinished();
+		// callbacks added to requests which were already finished are fired by the next update
+		assetManager.Update();
+	}
+}
+
+ZE_TEST(AssetManagerConcurrentRequests)
+{
+	constexpr uint32_t kAssetCount = 512u;
+
+	auto& assetManager = GetAssetManager();
+	const uint32_t loadCountBefore = gBlobLoadCount.load();
+	const uint64_t residentSizeBefore = assetManager.GetResidentSizeInByte();
+
+	std::vector<std::vector<Asset::AssetPtr<Test::TestBlob>>> threadPtrs;
+	std::atomic<uint32_t> loadedCallbackCount = 0;
+	RequestFromThreads(assetManager, threadPtrs, "ConcurrentBlob", kAssetCount, &loadedCallbackCount);
+
+	// every asset is loaded exactly once, whichever threads raced for it
+	ZE_CHECK(gBlobLoadCount.load() - loadCountBefore == kAssetCount);
+	ZE_CHECK(assetManager.GetResidentSizeInByte() - residentSizeBefore == kAssetCount * kBlobSizeInByte);
+	ZE_CHECK(loadedCallbackCount.load() == kRequestThreadCount / 2u * kAssetCount);
+
+	for (uint32_t t = 0; t < kRequestThreadCount; ++t)
+	{
+		for (uint32_t i = 0; i < kAssetCount; ++i)
+		{
+			const auto& ptr = threadPtrs[t][i];
+			ZE_CHECK(ptr.IsLoaded());
+			// all threads share the asset of the same path
+			const auto& firstThreadPtr = threadPtrs[0][(i + t * 7u) % kAssetCount];
+			ZE_CHECK(ptr.GetAsset() == firstThreadPtr.GetAsset());
+		}
+	}
+
+	threadPtrs.clear();
+	assetManager.UnloadUnreferencedAssets();
+	ZE_CHECK(assetManager.GetResidentSizeInByte() == residentSizeBefore);
+}
+
+ZE_BENCHMARK(AssetManagerRequestThroughput)
+{
+	constexpr uint32_t kAssetCount = 4096u;
+	constexpr uint32_t kRequestCount = kRequestThreadCount * kAssetCount;
+
+	auto& assetManager = GetAssetManager();
+
+	// the first round creates and loads the requests, the second one only finds them, e.g. many objects sharing the same meshes
+	std::vector<std::vector<Asset::AssetPtr<Test::TestBlob>>> threadPtrs;
+	double coldTime = 0.0;
+	{
+		Core::ScopedTimer<Core::ETimeUnit::MilliSecond> scopedTimer(coldTime);
+		RequestFromThreads(assetManager, threadPtrs, "BenchmarkBlob", kAssetCount, nullptr);
+	}
+
+	std::vector<std::vector<Asset::AssetPtr<Test::TestBlob>>> residentThreadPtrs;
+	double residentTime = 0.0;
+	{
+		Core::ScopedTimer<Core::ETimeUnit::MilliSecond> scopedTimer(residentTime);
+		RequestFromThreads(assetManager, residentThreadPtrs, "BenchmarkBlob", kAssetCount, nullptr);
+	}
+
+	threadPtrs.clear();
+	residentThreadPtrs.clear();
+	assetManager.UnloadUnreferencedAssets();
+
+	ZE_LOG_INFO("{} requests of {} assets from {} threads, loading: {:.3f} ms, {:.1f} ns per request, resident: {:.3f} ms, {:.1f} ns per request",
+		kRequestCount, kAssetCount, kRequestThreadCount, coldTime, coldTime * 1e6 / kRequestCount, residentTime, residentTime * 1e6 / kRequestCount);
+}
+
+ZE_TEST(AssetManagerDependencyGraph)
+{
+	constexpr uint32_t kLevelCount = 40u;
+	// blobs of the chain, the top ones of each level plus both sides of it, and the bottom one
+	constexpr uint32_t kChainBlobCount = kLevelCount * 3u + 1u;
+
+	auto& assetManager = GetAssetManager();
+	const uint32_t loadCountBefore = gBlobLoadCount.load();
+	const uint32_t violationCountBefore = gBlobDependencyOrderViolationCount.load();
+	const uint64_t residentSizeBefore = assetManager.GetResidentSizeInByte();
+
+	// priorities are only compared when not every ready request can be dispatched, they are inherited along all the 2^40 paths
+	assetManager.SetMaxInFlightRequestCount(1u);
+	{
+		std::scoped_lock lock(gBlobLoadOrderMutex);
+		gBlobLoadOrder.clear();
+	}
+
+	Asset::AssetPtr<Test::TestBlob> chain(MakeBlobId(BuildDiamondChain("DependencyChain", kLevelCount)));
+	Asset::AssetPtr<Test::TestBlob> other(MakeBlobId("DependencyOther"));
+	assetManager.RequestLoad(chain);
+	assetManager.RequestLoad(other);
+	assetManager.SetLoadPriority(chain, 1);
+	assetManager.WaitUntilAllRequestsFinished();
+
+	ZE_CHECK(chain.IsLoaded() && other.IsLoaded());
+	// shared dependencies are loaded once, always before their dependents
+	ZE_CHECK(gBlobLoadCount.load() - loadCountBefore == kChainBlobCount + 1u);
+	ZE_CHECK(gBlobDependencyOrderViolationCount.load() == violationCountBefore);
+	{
+		// the whole prioritized chain goes first, though the other blob was ready before any of its dependencies
+		std::scoped_lock lock(gBlobLoadOrderMutex);
+		ZE_CHECK(gBlobLoadOrder.size() == kChainBlobCount + 1u);
+		ZE_CHECK(!gBlobLoadOrder.empty() && gBlobLoadOrder.back() == "DependencyOther");
+	}
+
+	SetBlobDependencies("DependencyCycleA", { "DependencyCycleB" });
+	SetBlobDependencies("DependencyCycleB", { "DependencyCycleA" });
+	Asset::AssetPtr<Test::TestBlob> cycle(MakeBlobId("DependencyCycleA"));
+	assetManager.RequestLoad(cycle);
+	assetManager.WaitUntilAllRequestsFinished();
+	ZE_CHECK(cycle.IsFailed());
+
+	// callbacks added to a finished request are fired by the wait as well, even ones added by a callback fired within it
+	// the callbacks own what they touch, so one left queued by a faulty wait can not outlive the test
+	auto pNestedCallbackFired = std::make_shared<std::atomic<bool>>(false);
+	assetManager.RequestLoad(chain, [&assetManager, chain, pNestedCallbackFired](const Asset::AssetRequest&) mutable
+	{
+		assetManager.RequestLoad(chain, [pNestedCallbackFired](const Asset::AssetRequest& request) { *pNestedCallbackFired = request.IsLoaded(); });
+	});
+	assetManager.WaitUntilAllRequestsFinished();
+	ZE_CHECK(pNestedCallbackFired->load());
+
+	assetManager.SetMaxInFlightRequestCount(64u);
+
+	// a single unload also takes the dependencies which only the unloaded assets referenced, whichever shards they are in
+	chain.Reset();
+	other.Reset();
+	cycle.Reset();
+	assetManager.UnloadUnreferencedAssets();
+	ZE_CHECK(assetManager.GetResidentSizeInByte() == residentSizeBefore);
+}
+
+ZE_TEST(AssetManagerEvictsUnreferencedDependencies)
+{
+	constexpr uint32_t kLevelCount = 8u;
+
+	auto& assetManager = GetAssetManager();
+	const uint64_t residentSizeBefore = assetManager.GetResidentSizeInByte();
+	const uint64_t budgetBefore = assetManager.GetResidencyBudget();
+
+	Asset::AssetPtr<Test::TestBlob> chain(MakeBlobId(BuildDiamondChain("EvictionChain", kLevelCount)));
+	assetManager.RequestLoad(chain);
+	assetManager.WaitUntilAllRequestsFinished();
+	ZE_REQUIRE(chain.IsLoaded());
+
+	// nothing but the chain itself is over the budget, so its dependencies must go in the same update
+	chain.Reset();
+	assetManager.SetResidencyBudget(residentSizeBefore);
+	assetManager.Update();
+	ZE_CHECK(assetManager.GetResidentSizeInByte() == residentSizeBefore);
+
+	assetManager.SetResidencyBudget(budgetBefore);
+}
+
+ZE_TEST(AssetManagerDuplicatedDependencies)
+{
+	auto& assetManager = GetAssetManager();
+	const uint32_t loadCountBefore = gBlobLoadCount.load();
+	const uint64_t residentSizeBefore = assetManager.GetResidentSizeInByte();
+
+	// a dependency listed twice is one edge of the graph
+	SetBlobDependencies("DuplicatedDependencyTop", { "DuplicatedDependencyBottom", "DuplicatedDependencyBottom" });
+	Asset::AssetPtr<Test::TestBlob> top(MakeBlobId("DuplicatedDependencyTop"));
+	size_t topDependencyCount = 0;
+	assetManager.RequestLoad(top, [&topDependencyCount](const Asset::AssetRequest& request) { topDependencyCount = request.GetDependencies().size(); });
+	assetManager.WaitUntilAllRequestsFinished();
+	ZE_CHECK(top.IsLoaded());
+	ZE_CHECK(topDependencyCount == 1u);
+	ZE_CHECK(gBlobLoadCount.load() - loadCountBefore == 2u);
+
+	// its failure fails the dependent once
+	const auto failingPath = std::string(kFailingBlobPrefix) + "Dependency";
+	SetBlobDependencies("DuplicatedFailingDependencyTop", { failingPath, failingPath });
+	Asset::AssetPtr<Test::TestBlob> failingTop(MakeBlobId("DuplicatedFailingDependencyTop"));
+	uint32_t failedCallbackCount = 0;
+	assetManager.RequestLoad(failingTop, [&failedCallbackCount](const Asset::AssetRequest& request)
+	{
+		if (request.IsFailed())
+		{
+			++failedCallbackCount;
+		}
+	});
+	assetManager.WaitUntilAllRequestsFinished();
+	ZE_CHECK(failingTop.IsFailed());
+	ZE_CHECK(failedCallbackCount == 1u);
+
+	top.Reset();
+	failingTop.Reset();
+	assetManager.UnloadUnreferencedAssets();
+	ZE_CHECK(assetManager.GetResidentSizeInByte() == residentSizeBefore);
+}
+
+ZE_TEST(AssetManagerCancelsUnreferencedQueuedRequests)
+{
+	auto& assetManager = GetAssetManager();
+	const uint32_t loadCountBefore = gBlobLoadCount.load();
+	const uint64_t residentSizeBefore = assetManager.GetResidentSizeInByte();
+
+	// only the first request is dispatched by the update, the second one stays queued
+	assetManager.SetMaxInFlightRequestCount(1u);
+
+	Asset::AssetPtr<Test::TestBlob> dispatched(MakeBlobId("CancelDispatched"));
+	Asset::AssetPtr<Test::TestBlob> queued(MakeBlobId("CancelQueued"));
+	assetManager.RequestLoad(dispatched);
+	assetManager.RequestLoad(queued);
+	assetManager.Update();
+
+	queued.Reset();
+	assetManager.WaitUntilAllRequestsFinished();
+	ZE_CHECK(dispatched.IsLoaded());
+	ZE_CHECK(gBlobLoadCount.load() - loadCountBefore == 1u);
+	ZE_CHECK(assetManager.GetResidentSizeInByte() - residentSizeBefore == kBlobSizeInByte);
+
+	// the cancelled request is gone, requesting the asset again loads it
+	assetManager.RequestLoad(queued);
+	assetManager.WaitUntilAllRequestsFinished();
+	ZE_CHECK(queued.IsLoaded());
+	ZE_CHECK(gBlobLoadCount.load() - loadCountBefore == 2u);
+
+	assetManager.SetMaxInFlightRequestCount(64u);
+
+	dispatched.Reset();
+	queued.Reset();
+	assetManager.UnloadUnreferencedAssets();
+	ZE_CHECK(assetManager.GetResidentSizeInByte() == residentSizeBefore);
+}
@@ -0,0 +1,206 @@
+#include "Test.h"
+
+#include "Core/AsyncFileIO.h"
+#include "Log/Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace ZE;
+using namespace ZE::Core;
+
+namespace
+{
+	constexpr uint32_t kFileCount = 16u;
+	// not a multiple of any page or sector size, so the tail of every file is a partial one
+	constexpr uint32_t kFileSizeInByte = 64u * 1024u + 7u;
+
+	std::byte GetFileByte(uint32_t fileIndex, uint64_t offset)
+	{
+		return static_cast<std::byte>((fileIndex * 131u + offset * 7u + offset / 251u) & 0xFFu);
+	}
+
+	/* Files of known content in a temporary directory, the directory is removed with it. */
+	class ScopedTestFiles
+	{
+	public:
+
+		explicit ScopedTestFiles(std::string_view name)
+			: m_Directory(std::filesystem::temp_directory_path() / name)
+		{
+			std::filesystem::remove_all(m_Directory);
+			std::filesystem::create_directories(m_Directory);
+
+			std::vector<char> content(kFileSizeInByte);
+			for (uint32_t i = 0; i < kFileCount; ++i)
+			{
+				for (uint64_t offset = 0; offset < kFileSizeInByte; ++offset)
+				{
+					content[offset] = static_cast<char>(GetFileByte(i, offset));
+				}
+				std::ofstream file(GetPath(i), std::ios::binary);
+				file.write(content.data(), static_cast<std::streamsize>(content.size()));
+			}
+		}
+
+		~ScopedTestFiles()
+		{
+			std::error_code errorCode;
+			std::filesystem::remove_all(m_Directory, errorCode);
+		}
+
+		std::filesystem::path GetPath(uint32_t fileIndex) const { return m_Directory / ("file" + std::to_string(fileIndex)); }
+		std::filesystem::path GetMissingPath() const { return m_Directory / "missing"; }
+
+	private:
+
+		std::filesystem::path				m_Directory;
+	};
+
+	bool IsFileContent(uint32_t fileIndex, uint64_t offset, std::span<const std::byte> data)
+	{
+		for (uint64_t i = 0; i < data.size(); ++i)
+		{
+			if (data[i] != GetFileByte(fileIndex, offset + i))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	AsyncFileIO::Settings MakeSettings(bool bForceThreadPoolBackend)
+	{
+		AsyncFileIO::Settings settings;
+		// fewer slots than reads, so the batch queues up behind the reads in flight
+		settings.m_QueueDepth = 4u;
+		settings.m_FallbackThreadCount = 2u;
+		settings.m_ForceThreadPoolBackend = bForceThreadPoolBackend;
+		return settings;
+	}
+
+	void CheckBatchedReads(bool bForceThreadPoolBackend)
+	{
+		const ScopedTestFiles files("ZenithAsyncFileIOBatch");
+		AsyncFileIO fileIO(MakeSettings(bForceThreadPoolBackend));
+		ZE_LOG_INFO("Batched reads on {} backend", fileIO.GetBackendName());
+
+		// whole files and ranges, the last range crosses the end of its file and is cut short
+		std::vector<IOReadRequest> requests;
+		std::vector<uint64_t> expectedSizes;
+		std::atomic<uint32_t> callbackCount = 0;
+		for (uint32_t i = 0; i < kFileCount; ++i)
+		{
+			IOReadRequest request;
+			request.m_AbsolutePath = files.GetPath(i);
+			request.m_Priority = static_cast<EIOPriority>(i % static_cast<uint32_t>(EIOPriority::Count));
+			request.m_Callback = [&callbackCount](const IOReadResult&) { callbackCount.fetch_add(1, std::memory_order_relaxed); };
+			if (i % 2u == 1u)
+			{
+				request.m_Offset = 1000u * i;
+				request.m_SizeInByte = i + 1u == kFileCount ? kFileSizeInByte : 4096u;
+			}
+			expectedSizes.push_back(!request.m_SizeInByte ? kFileSizeInByte : std::min<uint64_t>(*request.m_SizeInByte, kFileSizeInByte - request.m_Offset));
+			requests.push_back(std::move(request));
+		}
+
+		const auto handles = fileIO.ReadBatch(requests);
+		ZE_REQUIRE(handles.size() == kFileCount);
+		for (uint32_t i = 0; i < kFileCount; ++i)
+		{
+			handles[i].Wait();
+			ZE_REQUIRE(handles[i].IsFinished());
+
+			const auto& result = handles[i].GetResult();
+			ZE_CHECK(result.IsSucceeded());
+			ZE_CHECK(result.m_Data.size() == expectedSizes[i]);
+			ZE_CHECK(IsFileContent(i, requests[i].m_Offset, result.m_Data));
+		}
+
+		fileIO.WaitUntilIdle();
+		ZE_CHECK(fileIO.GetOutstandingRequestCount() == 0u);
+		ZE_CHECK(callbackCount.load() == kFileCount);
+	}
+
+	void CheckMissingFile(bool bForceThreadPoolBackend)
+	{
+		const ScopedTestFiles files("ZenithAsyncFileIOMissing");
+		AsyncFileIO fileIO(MakeSettings(bForceThreadPoolBackend));
+
+		IOReadRequest missingRequest;
+		missingRequest.m_AbsolutePath = files.GetMissingPath();
+		IOReadRequest existingRequest;
+		existingRequest.m_AbsolutePath = files.GetPath(0);
+
+		// the failed read does not take the reads batched with it down
+		const auto handles = fileIO.ReadBatch({ missingRequest, existingRequest });
+		ZE_REQUIRE(handles.size() == 2u);
+		handles[0].Wait();
+		handles[1].Wait();
+
+		ZE_CHECK(!handles[0].GetResult().IsSucceeded());
+		ZE_CHECK(handles[0].GetResult().m_Data.empty());
+		ZE_CHECK(handles[1].GetResult().IsSucceeded());
+		ZE_CHECK(handles[1].GetResult().m_Data.size() == kFileSizeInByte);
+	}
+
+	void CheckRegisteredBufferReads(bool bForceThreadPoolBackend)
+	{
+		const ScopedTestFiles files("ZenithAsyncFileIORegistered");
+		AsyncFileIO fileIO(MakeSettings(bForceThreadPoolBackend));
+
+		// two buffers, every file is read into its own slot of one of them
+		constexpr uint32_t kSlotSizeInByte = kFileSizeInByte + 1u;
+		std::vector<std::byte> firstBuffer(kSlotSizeInByte * kFileCount / 2u);
+		std::vector<std::byte> secondBuffer(kSlotSizeInByte * kFileCount / 2u);
+		ZE_REQUIRE(fileIO.RegisterBuffers({ firstBuffer, secondBuffer }));
+
+		std::vector<IOReadRequest> requests;
+		for (uint32_t i = 0; i < kFileCount; ++i)
+		{
+			auto& buffer = i % 2u == 0 ? firstBuffer : secondBuffer;
+			IOReadRequest request;
+			request.m_AbsolutePath = files.GetPath(i);
+			request.m_Destination = std::span(buffer).subspan((i / 2u) * kSlotSizeInByte, kSlotSizeInByte);
+			requests.push_back(std::move(request));
+		}
+
+		const auto handles = fileIO.ReadBatch(requests);
+		for (uint32_t i = 0; i < kFileCount; ++i)
+		{
+			handles[i].Wait();
+
+			const auto& result = handles[i].GetResult();
+			ZE_CHECK(result.IsSucceeded());
+			// the data is the destination itself, nothing is copied
+			ZE_CHECK(result.m_Data.data() == requests[i].m_Destination.data());
+			ZE_CHECK(result.m_Data.size() == kFileSizeInByte);
+			ZE_CHECK(IsFileContent(i, 0, result.m_Data));
+		}
+
+		fileIO.WaitUntilIdle();
+		fileIO.UnregisterBuffers();
+	}
+}
+
+ZE_TEST(AsyncFileIOBatchedReads)
+{
+	CheckBatchedReads(false);
+	CheckBatchedReads(true);
+}
+
+ZE_TEST(AsyncFileIOMissingFile)
+{
+	CheckMissingFile(false);
+	CheckMissingFile(true);
+}
+
+ZE_TEST(AsyncFileIORegisteredBufferReads)
+{
+	CheckRegisteredBufferReads(false);
+	CheckRegisteredBufferReads(true);
+}
@@ -0,0 +1,152 @@
+#include "Test.h"
+
+#include "Core/Compression.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace ZE;
+using namespace ZE::Core;
+
+namespace
+{
+	std::vector<std::byte> MakeRandomData(std::size_t size, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::vector<std::byte> data(size);
+		for (auto& value : data)
+		{
+			value = static_cast<std::byte>(random() & 0xFFu);
+		}
+		return data;
+	}
+
+	// long runs, short repeats and random islands, so both literal and match lengths need extra length bytes
+	std::vector<std::byte> MakeCompressibleData(std::size_t size, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::vector<std::byte> data;
+		data.reserve(size);
+		while (data.size() < size)
+		{
+			const auto value = static_cast<std::byte>(random() & 0xFFu);
+			switch (random() % 3u)
+			{
+			case 0:
+				data.insert(data.end(), 300u + random() % 700u, value);
+				break;
+			case 1:
+				for (uint32_t i = 0, count = 8u + random() % 64u; i < count; ++i)
+				{
+					data.push_back(static_cast<std::byte>(i % 5u));
+				}
+				break;
+			default:
+				for (uint32_t i = 0, count = 16u + random() % 100u; i < count; ++i)
+				{
+					data.push_back(static_cast<std::byte>(random() & 0xFFu));
+				}
+				break;
+			}
+		}
+		data.resize(size);
+		return data;
+	}
+
+	std::vector<std::byte> CompressLz(std::span<const std::byte> source)
+	{
+		std::vector<std::byte> compressed;
+		const auto compressedSize = Compress(ECompressionMethod::Lz, source, compressed);
+		ZE_CHECK(compressedSize == compressed.size());
+		ZE_CHECK(compressedSize <= GetMaxCompressedSize(source.size()));
+		return compressed;
+	}
+
+	void CheckRoundTrip(std::span<const std::byte> source)
+	{
+		const auto compressed = CompressLz(source);
+
+		std::vector<std::byte> decompressed(source.size());
+		ZE_CHECK(Decompress(ECompressionMethod::Lz, compressed, decompressed));
+		ZE_CHECK(std::ranges::equal(decompressed, source));
+		ZE_CHECK(source.size() <= GetMaxDecompressedSize(ECompressionMethod::Lz, compressed.size()));
+	}
+}
+
+ZE_TEST(CompressionRoundTrip)
+{
+	// shorter than a match plus the trailing literals, stored as literals only
+	for (std::size_t size = 0; size < 16u; ++size)
+	{
+		CheckRoundTrip(MakeRandomData(size, static_cast<uint32_t>(size)));
+	}
+
+	CheckRoundTrip(MakeRandomData(256u * 1024u, 1u));
+	CheckRoundTrip(std::vector<std::byte>(256u * 1024u, std::byte{ 0x5a }));
+
+	const auto compressibleData = MakeCompressibleData(256u * 1024u, 2u);
+	CheckRoundTrip(compressibleData);
+	ZE_CHECK(CompressLz(compressibleData).size() < compressibleData.size() / 2u);
+
+	// None stores the bytes as they are
+	std::vector<std::byte> stored;
+	ZE_CHECK(Compress(ECompressionMethod::None, compressibleData, stored) == compressibleData.size());
+	std::vector<std::byte> restored(compressibleData.size());
+	ZE_CHECK(Decompress(ECompressionMethod::None, stored, restored));
+	ZE_CHECK(restored == compressibleData);
+	ZE_CHECK(!Decompress(ECompressionMethod::None, stored, std::span(restored).first(restored.size() - 1u)));
+}
+
+ZE_TEST(CompressionRejectsCorruptedData)
+{
+	const auto source = MakeCompressibleData(64u * 1024u, 3u);
+	const auto compressed = CompressLz(source);
+	std::vector<std::byte> decompressed(source.size());
+
+	// truncated anywhere
+	for (std::size_t size = 0; size < compressed.size(); size += 1u + size / 64u)
+	{
+		ZE_CHECK(!Decompress(ECompressionMethod::Lz, std::span(compressed).first(size), decompressed));
+	}
+
+	// a destination of another size than the data expands to
+	{
+		std::vector<std::byte> shorterDestination(source.size() - 1u);
+		std::vector<std::byte> longerDestination(source.size() + 1u);
+		ZE_CHECK(!Decompress(ECompressionMethod::Lz, compressed, shorterDestination));
+		ZE_CHECK(!Decompress(ECompressionMethod::Lz, compressed, longerDestination));
+	}
+
+	// a match pointing before the start of the output, the first token is 1 literal and a match of offset 2
+	{
+		const std::byte corrupted[] = { std::byte{ 0x10 }, std::byte{ 0xAB }, std::byte{ 0x02 }, std::byte{ 0x00 } };
+		std::vector<std::byte> destination(5u);
+		ZE_CHECK(!Decompress(ECompressionMethod::Lz, corrupted, destination));
+	}
+
+	// a match of offset 0
+	{
+		const std::byte corrupted[] = { std::byte{ 0x10 }, std::byte{ 0xAB }, std::byte{ 0x00 }, std::byte{ 0x00 } };
+		std::vector<std::byte> destination(5u);
+		ZE_CHECK(!Decompress(ECompressionMethod::Lz, corrupted, destination));
+	}
+
+	// random garbage is rejected without writing past the destination
+	for (uint32_t seed = 0; seed < 64u; ++seed)
+	{
+		const auto garbage = MakeRandomData(1024u, seed);
+		std::vector<std::byte> destination(4096u);
+		ZE_CHECK(!Decompress(ECompressionMethod::Lz, garbage, destination));
+	}
+
+	// values read from disk which are not a method
+	ZE_CHECK(IsValidCompressionMethod(ECompressionMethod::None));
+	ZE_CHECK(IsValidCompressionMethod(ECompressionMethod::Lz));
+	ZE_CHECK(!IsValidCompressionMethod(static_cast<ECompressionMethod>(7u)));
+	ZE_CHECK(GetMaxDecompressedSize(static_cast<ECompressionMethod>(7u), compressed.size()) == 0u);
+	ZE_CHECK(!Decompress(static_cast<ECompressionMethod>(7u), compressed, decompressed));
+}
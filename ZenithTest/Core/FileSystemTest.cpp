@@ -0,0 +1,202 @@
+#include "Test.h"
+
+#include "Core/FileSystem.h"
+#include "Core/Timer.h"
+#include "Log/Log.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#	include <unistd.h>
+#endif
+
+using namespace ZE;
+using namespace ZE::Core;
+
+namespace
+{
+	std::byte GetFileByte(uint64_t offset)
+	{
+		return static_cast<std::byte>((offset * 7u + offset / 4093u) & 0xFFu);
+	}
+
+	/* Files of known content in a temporary directory, the directory is removed with it. */
+	class ScopedTestDirectory
+	{
+	public:
+
+		explicit ScopedTestDirectory(std::string_view name)
+			: m_Directory(std::filesystem::temp_directory_path() / name)
+		{
+			// absolute paths are sanitized against the mount path
+			FileSystem::Mount();
+			std::filesystem::remove_all(m_Directory);
+			std::filesystem::create_directories(m_Directory);
+		}
+
+		~ScopedTestDirectory()
+		{
+			std::error_code errorCode;
+			std::filesystem::remove_all(m_Directory, errorCode);
+		}
+
+		std::filesystem::path GetPath(std::string_view fileName) const { return m_Directory / fileName; }
+
+		std::filesystem::path CreateTestFile(std::string_view fileName, std::size_t sizeInByte) const
+		{
+			const auto path = m_Directory / fileName;
+			std::vector<std::byte> content(sizeInByte);
+			for (std::size_t offset = 0; offset < sizeInByte; ++offset)
+			{
+				content[offset] = GetFileByte(offset);
+			}
+			std::ofstream file(path, std::ios::binary);
+			file.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+			return path;
+		}
+
+	private:
+
+		std::filesystem::path				m_Directory;
+	};
+
+	bool IsFileContent(std::span<const std::byte> data)
+	{
+		for (std::size_t offset = 0; offset < data.size(); ++offset)
+		{
+			if (data[offset] != GetFileByte(offset))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// resident memory owned by the process alone, mapped file pages are shared with the page cache and left out, 0 where it is not queried
+	std::size_t GetPrivateResidentSizeInByte()
+	{
+#if defined(__linux__)
+		std::ifstream statmStream("/proc/self/statm");
+		std::size_t virtualPageCount = 0;
+		std::size_t residentPageCount = 0;
+		std::size_t sharedPageCount = 0;
+		statmStream >> virtualPageCount >> residentPageCount >> sharedPageCount;
+		return (residentPageCount - std::min(sharedPageCount, residentPageCount)) * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+		return 0;
+#endif
+	}
+
+	// read the way FileSystem::Load did before large files were mapped
+	std::vector<std::byte> ReadWholeFile(const std::filesystem::path& path)
+	{
+		std::ifstream inFileStream(path, std::ios::binary);
+		std::vector<std::byte> data(std::filesystem::file_size(path));
+		inFileStream.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		return data;
+	}
+
+	// touch one byte of every stride, a stride of 1 consumes the whole file
+	uint64_t TouchData(std::span<const std::byte> data, std::size_t stride)
+	{
+		uint64_t sum = 0;
+		for (std::size_t offset = 0; offset < data.size(); offset += stride)
+		{
+			sum += static_cast<uint64_t>(data[offset]);
+		}
+		return sum;
+	}
+}
+
+ZE_TEST(FileSystemLoadsMappedAndReadFiles)
+{
+	const ScopedTestDirectory directory("ZenithFileSystemLoad");
+
+	// small files are read into a buffer, large ones are mapped
+	const auto smallPath = directory.CreateTestFile("Small.bin", FileSystem::kMinMappedFileSizeInByte - 1u);
+	const auto largePath = directory.CreateTestFile("Large.bin", FileSystem::kMinMappedFileSizeInByte * 4u + 7u);
+	const auto emptyPath = directory.CreateTestFile("Empty.bin", 0u);
+
+	{
+		const auto handle = FileSystem::Load(FilePath(smallPath));
+		ZE_CHECK(handle.IsValid());
+		ZE_CHECK(!handle.IsMapped());
+		ZE_CHECK(handle.GetData().size() == FileSystem::kMinMappedFileSizeInByte - 1u);
+		ZE_CHECK(IsFileContent(handle.GetData()));
+	}
+
+	for (const auto accessPattern : { EFileAccessPattern::Sequential, EFileAccessPattern::Random })
+	{
+		auto handle = FileSystem::Load(FilePath(largePath), accessPattern);
+		ZE_CHECK(handle.IsValid());
+		ZE_CHECK(handle.IsMapped());
+		ZE_CHECK(handle.GetData().size() == FileSystem::kMinMappedFileSizeInByte * 4u + 7u);
+		ZE_CHECK(IsFileContent(handle.GetData()));
+
+		// the mapping moves along with the handle
+		const auto* pData = handle.GetData().data();
+		FileHandle movedHandle = std::move(handle);
+		ZE_CHECK(!handle.IsValid());
+		ZE_CHECK(movedHandle.GetData().data() == pData);
+	}
+
+	{
+		const auto handle = FileSystem::Load(FilePath(emptyPath));
+		ZE_CHECK(handle.IsValid());
+		ZE_CHECK(handle.GetData().empty());
+	}
+
+	const auto missingHandle = FileSystem::Load(FilePath(directory.GetPath("Missing.bin")));
+	ZE_CHECK(!missingHandle.IsValid());
+	ZE_CHECK(missingHandle.GetData().empty());
+}
+
+ZE_BENCHMARK(FileSystemMappedAgainstReadLoads)
+{
+	constexpr std::size_t kFileSizeInByte = 64u * 1024u * 1024u;
+	// one byte of every MiB, e.g. an archive of which only a few entries are loaded, wider than the pages the kernel maps around a fault
+	constexpr std::size_t kSparseStride = 1024u * 1024u;
+
+	const ScopedTestDirectory directory("ZenithFileSystemBenchmark");
+	const auto path = directory.CreateTestFile("Large.bin", kFileSizeInByte);
+	// the file was just written, both loads are served by the page cache and measure copying and mapping only
+
+	for (const std::size_t stride : { std::size_t{ 1 }, kSparseStride })
+	{
+		double readTime = 0.0;
+		std::size_t readResidentSize = 0;
+		uint64_t readSum = 0;
+		{
+			const std::size_t baseResidentSize = GetPrivateResidentSizeInByte();
+			Core::ScopedTimer<Core::ETimeUnit::MilliSecond> scopedTimer(readTime);
+			const auto data = ReadWholeFile(path);
+			readSum = TouchData(data, stride);
+			readResidentSize = GetPrivateResidentSizeInByte();
+			readResidentSize = readResidentSize > baseResidentSize ? readResidentSize - baseResidentSize : 0;
+		}
+
+		double mappedTime = 0.0;
+		std::size_t mappedResidentSize = 0;
+		uint64_t mappedSum = 0;
+		{
+			const std::size_t baseResidentSize = GetPrivateResidentSizeInByte();
+			Core::ScopedTimer<Core::ETimeUnit::MilliSecond> scopedTimer(mappedTime);
+			const auto handle = FileSystem::Load(FilePath(path), stride == 1u ? EFileAccessPattern::Sequential : EFileAccessPattern::Random);
+			mappedSum = TouchData(handle.GetData(), stride);
+			mappedResidentSize = GetPrivateResidentSizeInByte();
+			mappedResidentSize = mappedResidentSize > baseResidentSize ? mappedResidentSize - baseResidentSize : 0;
+		}
+
+		ZE_LOG_INFO("{} MiB file, touching every {} byte(s), same data: {}, read: {:.3f} ms {:.1f} MiB/s private RSS +{:.1f} MiB, mapped: {:.3f} ms {:.1f} MiB/s private RSS +{:.1f} MiB",
+			kFileSizeInByte / (1024u * 1024u), stride, readSum == mappedSum,
+			readTime, kFileSizeInByte / (1024.0 * 1024.0) / (readTime / 1000.0), readResidentSize / (1024.0 * 1024.0),
+			mappedTime, kFileSizeInByte / (1024.0 * 1024.0) / (mappedTime / 1000.0), mappedResidentSize / (1024.0 * 1024.0));
+	}
+}
@@ -0,0 +1,362 @@
+#include "Test.h"
+
+#include "Core/AsyncFileIO.h"
+#include "Core/FileSystem.h"
+#include "Core/PackedArchive.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace ZE;
+using namespace ZE::Core;
+
+namespace
+{
+	std::vector<std::byte> MakeRandomData(std::size_t size, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::vector<std::byte> data(size);
+		for (auto& value : data)
+		{
+			value = static_cast<std::byte>(random() & 0xFFu);
+		}
+		return data;
+	}
+
+	std::vector<std::byte> MakeText(std::string_view line, uint32_t lineCount)
+	{
+		std::vector<std::byte> data;
+		for (uint32_t i = 0; i < lineCount; ++i)
+		{
+			const auto text = std::string(line) + std::to_string(i % 10u) + "\n";
+			const auto bytes = std::as_bytes(std::span(text));
+			data.insert(data.end(), bytes.begin(), bytes.end());
+		}
+		return data;
+	}
+
+	/* A temporary directory for archives, archives mounted meanwhile are unmounted and the directory is removed with it. */
+	class ScopedArchiveDirectory
+	{
+	public:
+
+		explicit ScopedArchiveDirectory(std::string_view name)
+			: m_Directory(std::filesystem::temp_directory_path() / name)
+		{
+			// absolute paths are sanitized against the mount path, as the core module does for archives at the mount root
+			FileSystem::Mount();
+			std::filesystem::remove_all(m_Directory);
+			std::filesystem::create_directories(m_Directory);
+		}
+
+		~ScopedArchiveDirectory()
+		{
+			FileSystem::UnmountArchives();
+			std::error_code errorCode;
+			std::filesystem::remove_all(m_Directory, errorCode);
+		}
+
+		std::filesystem::path GetPath(std::string_view fileName) const { return m_Directory / fileName; }
+
+	private:
+
+		std::filesystem::path				m_Directory;
+	};
+
+	std::vector<std::byte> ReadWholeFile(const std::filesystem::path& path)
+	{
+		std::ifstream inFileStream(path, std::ios::binary);
+		std::vector<std::byte> data(std::filesystem::file_size(path));
+		inFileStream.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		return data;
+	}
+
+	void WriteWholeFile(const std::filesystem::path& path, std::span<const std::byte> data)
+	{
+		std::ofstream outFileStream(path, std::ios::binary | std::ios::trunc);
+		outFileStream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	}
+
+	bool IsSameData(const FileHandle& handle, std::span<const std::byte> data)
+	{
+		return handle.IsValid() && std::ranges::equal(handle.GetData(), data);
+	}
+
+	PackedArchiveHeader ReadHeader(std::span<const std::byte> archive)
+	{
+		PackedArchiveHeader header;
+		std::memcpy(&header, archive.data(), sizeof(header));
+		return header;
+	}
+
+	PackedArchiveEntry ReadEntry(std::span<const std::byte> archive, uint32_t index)
+	{
+		PackedArchiveEntry entry;
+		std::memcpy(&entry, archive.data() + ReadHeader(archive).m_EntryTableOffset + index * sizeof(PackedArchiveEntry), sizeof(entry));
+		return entry;
+	}
+
+	void WriteEntry(std::vector<std::byte>& archive, uint32_t index, const PackedArchiveEntry& entry)
+	{
+		std::memcpy(archive.data() + ReadHeader(archive).m_EntryTableOffset + index * sizeof(PackedArchiveEntry), &entry, sizeof(entry));
+	}
+
+	uint32_t FindEntryIndex(std::span<const std::byte> archive, ECompressionMethod compression)
+	{
+		for (uint32_t i = 0; i < ReadHeader(archive).m_EntryCount; ++i)
+		{
+			if (ReadEntry(archive, i).m_Compression == compression && ReadEntry(archive, i).m_StoredSizeInByte != 0)
+			{
+				return i;
+			}
+		}
+		return ~0u;
+	}
+}
+
+ZE_TEST(PackedArchiveRoundTrip)
+{
+	const ScopedArchiveDirectory directory("ZenithPackedArchiveRoundTrip");
+
+	const auto textData = MakeText("compressible line of text ", 20000u);
+	const auto randomData = MakeRandomData(100u * 1024u, 1u);
+	const auto smallData = MakeText("small", 1u);
+	const auto rawData = MakeText("stored as it is ", 1000u);
+
+	PackedArchiveWriter writer;
+	ZE_CHECK(writer.AddFile("/Data/Text.txt", textData));
+	ZE_CHECK(writer.AddFile("/Data/Random.bin", randomData));
+	// paths are normalized, separators and the leading one
+	ZE_CHECK(writer.AddFile("Data\\Small.txt", smallData));
+	ZE_CHECK(writer.AddFile("/Data/Empty.bin", {}));
+	ZE_CHECK(writer.AddFile("/Data/Raw.txt", rawData, ECompressionMethod::None));
+	// already packed
+	ZE_CHECK(!writer.AddFile("/Data/Text.txt", randomData));
+	ZE_CHECK(writer.GetEntryCount() == 5u);
+
+	const auto archivePath = directory.GetPath("RoundTrip.zpak");
+	ZE_REQUIRE(writer.Write(archivePath));
+
+	// compressed only where it saves space
+	const auto archive = ReadWholeFile(archivePath);
+	ZE_CHECK(archive.size() < textData.size() + randomData.size());
+	const auto header = ReadHeader(archive);
+	ZE_CHECK(header.m_EntryCount == 5u);
+	ZE_CHECK(header.m_FileSizeInByte == archive.size());
+	for (uint32_t i = 0; i < header.m_EntryCount; ++i)
+	{
+		const auto entry = ReadEntry(archive, i);
+		if (entry.m_UncompressedSizeInByte == textData.size())
+		{
+			ZE_CHECK(entry.m_Compression == ECompressionMethod::Lz);
+			ZE_CHECK(entry.m_StoredSizeInByte < textData.size() / 2u);
+		}
+		if (entry.m_UncompressedSizeInByte == rawData.size())
+		{
+			ZE_CHECK(entry.m_Compression == ECompressionMethod::None);
+		}
+		if (entry.m_UncompressedSizeInByte == randomData.size())
+		{
+			ZE_CHECK(entry.m_Compression == ECompressionMethod::None);
+			// large entries start on a page
+			ZE_CHECK(entry.m_DataOffset % PackedArchiveWriter::kDefaultDataAlignment == 0u);
+		}
+		ZE_CHECK(entry.m_DataOffset % PackedArchiveWriter::kSmallEntryAlignment == 0u);
+	}
+
+	// looked up relative to the mount path, a leading '/' would be the root on linux
+	ZE_REQUIRE(FileSystem::MountArchive(FilePath(archivePath)));
+	ZE_CHECK(FileSystem::Exists(FilePath("Data/Text.txt")));
+	ZE_CHECK(FileSystem::Exists(FilePath("Data/Small.txt")));
+	ZE_CHECK(!FileSystem::Exists(FilePath("Data/Missing.txt")));
+
+	ZE_CHECK(IsSameData(FileSystem::Load(FilePath("Data/Text.txt")), textData));
+	ZE_CHECK(IsSameData(FileSystem::Load(FilePath("Data/Small.txt")), smallData));
+	ZE_CHECK(IsSameData(FileSystem::Load(FilePath("Data/Raw.txt")), rawData));
+	{
+		const auto handle = FileSystem::Load(FilePath("Data/Empty.bin"));
+		ZE_CHECK(handle.IsValid());
+		ZE_CHECK(handle.GetData().empty());
+	}
+	{
+		// raw entries are a view of the mapped archive, which outlives the unmount as long as the handle
+		auto handle = FileSystem::Load(FilePath("Data/Random.bin"), EFileAccessPattern::Random);
+		ZE_CHECK(handle.IsMapped());
+		FileSystem::UnmountArchives();
+		ZE_CHECK(IsSameData(handle, randomData));
+		ZE_CHECK(!FileSystem::Exists(FilePath("Data/Random.bin")));
+	}
+
+	// async loads read the range of the entry, empty entries read nothing rather than the rest of the archive
+	ZE_REQUIRE(FileSystem::MountArchive(FilePath(archivePath)));
+	{
+		AsyncFileIO fileIO(AsyncFileIO::Settings{});
+
+		const std::vector<std::pair<const char*, std::span<const std::byte>>> expectedFiles = {
+			{ "Data/Text.txt", textData }, { "Data/Random.bin", randomData }, { "Data/Small.txt", smallData }, { "Data/Empty.bin", {} } };
+		std::vector<IORequestHandle> handles;
+		for (const auto& [path, data] : expectedFiles)
+		{
+			handles.push_back(FileSystem::LoadAsync(FilePath(path), [](const IOReadResult&) {}));
+		}
+
+		for (size_t i = 0; i < handles.size(); ++i)
+		{
+			handles[i].Wait();
+			const auto& result = handles[i].GetResult();
+			ZE_CHECK(result.IsSucceeded());
+			ZE_CHECK(std::ranges::equal(result.m_Data, expectedFiles[i].second));
+		}
+		fileIO.WaitUntilIdle();
+	}
+}
+
+ZE_TEST(PackedArchiveDeduplicatesContent)
+{
+	const ScopedArchiveDirectory directory("ZenithPackedArchiveDeduplication");
+
+	const auto textData = MakeText("shared text ", 5000u);
+	const auto randomData = MakeRandomData(64u * 1024u, 2u);
+	auto almostSameData = randomData;
+	almostSameData.back() ^= std::byte{ 1u };
+
+	PackedArchiveWriter writer;
+	ZE_CHECK(writer.AddFile("/A/Text.txt", textData));
+	ZE_CHECK(writer.AddFile("/B/Text.txt", textData));
+	ZE_CHECK(writer.AddFile("/A/Random.bin", randomData));
+	ZE_CHECK(writer.AddFile("/B/Random.bin", randomData));
+	ZE_CHECK(writer.AddFile("/C/Random.bin", randomData));
+	// same size and mostly the same bytes is not the same content
+	ZE_CHECK(writer.AddFile("/D/Random.bin", almostSameData));
+	ZE_CHECK(writer.GetEntryCount() == 6u);
+	ZE_CHECK(writer.GetUniqueDataCount() == 3u);
+
+	const auto archivePath = directory.GetPath("Deduplication.zpak");
+	ZE_REQUIRE(writer.Write(archivePath));
+	ZE_CHECK(std::filesystem::file_size(archivePath) < textData.size() + 3u * randomData.size());
+	ZE_REQUIRE(FileSystem::MountArchive(FilePath(archivePath)));
+
+	// entries of the same content point to the same bytes of the archive
+	const auto firstHandle = FileSystem::Load(FilePath("A/Random.bin"));
+	const auto secondHandle = FileSystem::Load(FilePath("C/Random.bin"));
+	const auto otherHandle = FileSystem::Load(FilePath("D/Random.bin"));
+	ZE_CHECK(IsSameData(firstHandle, randomData));
+	ZE_CHECK(IsSameData(secondHandle, randomData));
+	ZE_CHECK(IsSameData(otherHandle, almostSameData));
+	ZE_CHECK(firstHandle.GetData().data() == secondHandle.GetData().data());
+	ZE_CHECK(firstHandle.GetData().data() != otherHandle.GetData().data());
+
+	ZE_CHECK(IsSameData(FileSystem::Load(FilePath("A/Text.txt")), textData));
+	ZE_CHECK(IsSameData(FileSystem::Load(FilePath("B/Text.txt")), textData));
+}
+
+ZE_TEST(PackedArchiveRejectsCorruptedArchives)
+{
+	const ScopedArchiveDirectory directory("ZenithPackedArchiveCorrupted");
+
+	const auto textData = MakeText("text ", 4000u);
+	PackedArchiveWriter writer;
+	ZE_CHECK(writer.AddFile("/Text.txt", textData));
+	ZE_CHECK(writer.AddFile("/Random.bin", MakeRandomData(8u * 1024u, 3u)));
+	ZE_CHECK(writer.AddFile("/Small.txt", MakeText("small", 2u)));
+
+	const auto validPath = directory.GetPath("Valid.zpak");
+	ZE_REQUIRE(writer.Write(validPath));
+	const auto archive = ReadWholeFile(validPath);
+	ZE_REQUIRE(FileSystem::MountArchive(FilePath(validPath)));
+	FileSystem::UnmountArchives();
+
+	const uint32_t compressedIndex = FindEntryIndex(archive, ECompressionMethod::Lz);
+	const uint32_t rawIndex = FindEntryIndex(archive, ECompressionMethod::None);
+	ZE_REQUIRE(compressedIndex != ~0u && rawIndex != ~0u);
+
+	const auto corruptedPath = directory.GetPath("Corrupted.zpak");
+	const auto isRejected = [&](const std::function<void(std::vector<std::byte>&)>& corrupt)
+	{
+		auto corrupted = archive;
+		corrupt(corrupted);
+		WriteWholeFile(corruptedPath, corrupted);
+		const bool bIsMounted = FileSystem::MountArchive(FilePath(corruptedPath));
+		FileSystem::UnmountArchives();
+		return !bIsMounted;
+	};
+	const auto corruptHeader = [&](const std::function<void(PackedArchiveHeader&)>& corrupt)
+	{
+		return isRejected([&](std::vector<std::byte>& data)
+		{
+			auto header = ReadHeader(data);
+			corrupt(header);
+			std::memcpy(data.data(), &header, sizeof(header));
+		});
+	};
+	const auto corruptEntry = [&](uint32_t index, const std::function<void(PackedArchiveEntry&)>& corrupt)
+	{
+		return isRejected([&](std::vector<std::byte>& data)
+		{
+			auto entry = ReadEntry(data, index);
+			corrupt(entry);
+			WriteEntry(data, index, entry);
+		});
+	};
+
+	// truncated, in the header, in the tables and in the data
+	for (const std::size_t size : { std::size_t{ 0 }, sizeof(PackedArchiveHeader) - 1u, sizeof(PackedArchiveHeader) + 10u, archive.size() / 2u, archive.size() - 1u })
+	{
+		ZE_CHECK(isRejected([size](std::vector<std::byte>& data) { data.resize(size); }));
+	}
+	// trailing bytes do not match the size in the header either
+	ZE_CHECK(isRejected([](std::vector<std::byte>& data) { data.push_back(std::byte{ 0 }); }));
+
+	// header
+	ZE_CHECK(corruptHeader([](PackedArchiveHeader& header) { header.m_Magic = 0x12345678u; }));
+	ZE_CHECK(corruptHeader([](PackedArchiveHeader& header) { header.m_Version = PackedArchiveHeader::kVersion + 1u; }));
+	ZE_CHECK(corruptHeader([](PackedArchiveHeader& header) { header.m_EntryCount = 0x10000000u; }));
+	ZE_CHECK(corruptHeader([](PackedArchiveHeader& header) { header.m_EntryTableOffset += 1u; }));
+	ZE_CHECK(corruptHeader([](PackedArchiveHeader& header) { header.m_EntryTableOffset = ~0ull - 8u; }));
+	ZE_CHECK(corruptHeader([](PackedArchiveHeader& header) { header.m_PathTableOffset = header.m_FileSizeInByte + 1u; }));
+	ZE_CHECK(corruptHeader([](PackedArchiveHeader& header) { header.m_PathTableSizeInByte = ~0ull; }));
+
+	// entries
+	ZE_CHECK(corruptEntry(rawIndex, [](PackedArchiveEntry& entry) { entry.m_DataOffset = ~0ull - 1u; }));
+	ZE_CHECK(corruptEntry(rawIndex, [](PackedArchiveEntry& entry) { entry.m_StoredSizeInByte += 1u << 20u; }));
+	ZE_CHECK(corruptEntry(rawIndex, [](PackedArchiveEntry& entry) { entry.m_UncompressedSizeInByte += 1u; }));
+	ZE_CHECK(corruptEntry(rawIndex, [](PackedArchiveEntry& entry) { entry.m_PathOffset = 0xFFFFFFF0u; }));
+	ZE_CHECK(corruptEntry(rawIndex, [](PackedArchiveEntry& entry) { entry.m_PathLength = 0xFFFFu; }));
+	ZE_CHECK(corruptEntry(rawIndex, [](PackedArchiveEntry& entry) { entry.m_Compression = static_cast<ECompressionMethod>(7u); }));
+	ZE_CHECK(corruptEntry(compressedIndex, [](PackedArchiveEntry& entry) { entry.m_UncompressedSizeInByte = ~0ull; }));
+	// entries are looked up by a binary search over their path hashes
+	ZE_CHECK(isRejected([](std::vector<std::byte>& data)
+	{
+		const auto firstEntry = ReadEntry(data, 0);
+		WriteEntry(data, 0, ReadEntry(data, 1));
+		WriteEntry(data, 1, firstEntry);
+	}));
+
+	// the data itself is only checked once it is loaded, corrupted compressed data fails that load alone
+	{
+		auto corrupted = archive;
+		const auto entry = ReadEntry(archive, compressedIndex);
+		std::fill_n(corrupted.begin() + static_cast<std::ptrdiff_t>(entry.m_DataOffset), entry.m_StoredSizeInByte, std::byte{ 0xFF });
+		WriteWholeFile(corruptedPath, corrupted);
+		ZE_REQUIRE(FileSystem::MountArchive(FilePath(corruptedPath)));
+
+		ZE_CHECK(!FileSystem::Load(FilePath("Text.txt")).IsValid());
+		ZE_CHECK(FileSystem::Load(FilePath("Small.txt")).IsValid());
+
+		AsyncFileIO fileIO(AsyncFileIO::Settings{});
+		const auto handle = FileSystem::LoadAsync(FilePath("Text.txt"), [](const IOReadResult&) {});
+		handle.Wait();
+		ZE_CHECK(!handle.GetResult().IsSucceeded());
+		ZE_CHECK(handle.GetResult().m_Data.empty());
+		fileIO.WaitUntilIdle();
+	}
+}
@@ -0,0 +1,288 @@
+#include "Test.h"
+
+#include "Core/Serialization.h"
+#include "Core/Timer.h"
+#include "Log/Log.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace ZE::Test
+{
+	struct SerializedBase
+	{
+		uint32_t						m_Id = 0;
+		std::string						m_Name;
+	};
+
+	struct SerializedDerived : public SerializedBase
+	{
+		std::vector<float>				m_Values;
+		std::vector<std::string>		m_Tags;
+		uint32_t						m_Transient = 0;
+	};
+
+	// the same type before and after a field is added, named apart so both can be reflected at once
+	struct SerializedSettingsV1
+	{
+		uint32_t						m_Width = 0;
+		uint32_t						m_Height = 0;
+	};
+
+	struct SerializedSettingsV2
+	{
+		uint32_t						m_Width = 0;
+		uint32_t						m_Height = 0;
+		float							m_Scale = 1.0f;
+		std::string						m_Title = "untitled";
+	};
+}
+
+REFL_AUTO(type(ZE::Test::SerializedBase), field(m_Id), field(m_Name))
+REFL_AUTO(type(ZE::Test::SerializedDerived, bases<ZE::Test::SerializedBase>), field(m_Values), field(m_Tags), field(m_Transient, ZE::Core::NonSerialized()))
+REFL_AUTO(type(ZE::Test::SerializedSettingsV1, ZE::Core::SerializedVersion(1)), field(m_Width), field(m_Height))
+REFL_AUTO(type(ZE::Test::SerializedSettingsV2, ZE::Core::SerializedVersion(2)), field(m_Width), field(m_Height),
+	field(m_Scale, ZE::Core::SinceVersion(2)), field(m_Title, ZE::Core::SinceVersion(2)))
+
+using namespace ZE;
+using namespace ZE::Core;
+
+namespace
+{
+	Test::SerializedDerived MakeDerived(uint32_t id)
+	{
+		Test::SerializedDerived value;
+		value.m_Id = id;
+		value.m_Name = "derived " + std::to_string(id);
+		value.m_Values = { 1.0f * id, 2.0f, 3.5f };
+		value.m_Tags = { "first", "second" };
+		value.m_Transient = 42u;
+		return value;
+	}
+
+	bool IsSameDerived(const Test::SerializedDerived& lhs, const Test::SerializedDerived& rhs)
+	{
+		return lhs.m_Id == rhs.m_Id && lhs.m_Name == rhs.m_Name && lhs.m_Values == rhs.m_Values && lhs.m_Tags == rhs.m_Tags;
+	}
+
+	// what the reflected serializer is compared against, the same layout written field by field by hand
+	void HandWrittenSerialize(BinaryWriter& writer, const Test::SerializedDerived& value)
+	{
+		writer.WriteValue(value.m_Id);
+		writer.WriteValue(static_cast<uint64_t>(value.m_Name.size()));
+		writer.Write(value.m_Name.data(), value.m_Name.size());
+		writer.WriteValue(static_cast<uint64_t>(value.m_Values.size()));
+		writer.Write(value.m_Values.data(), value.m_Values.size() * sizeof(float));
+		writer.WriteValue(static_cast<uint64_t>(value.m_Tags.size()));
+		for (const auto& tag : value.m_Tags)
+		{
+			writer.WriteValue(static_cast<uint64_t>(tag.size()));
+			writer.Write(tag.data(), tag.size());
+		}
+	}
+
+	bool HandWrittenReadString(BinaryReader& reader, std::string& value)
+	{
+		uint64_t size = 0;
+		if (!reader.ReadValue(size) || size > reader.GetRemainingSize())
+		{
+			reader.Fail();
+			return false;
+		}
+		value.resize(static_cast<std::size_t>(size));
+		return reader.Read(value.data(), value.size());
+	}
+
+	bool HandWrittenDeserialize(BinaryReader& reader, Test::SerializedDerived& value)
+	{
+		uint64_t count = 0;
+		if (!reader.ReadValue(value.m_Id) || !HandWrittenReadString(reader, value.m_Name) || !reader.ReadValue(count) || count > reader.GetRemainingSize() / sizeof(float))
+		{
+			return false;
+		}
+		value.m_Values.resize(static_cast<std::size_t>(count));
+		if (!reader.Read(value.m_Values.data(), value.m_Values.size() * sizeof(float)) || !reader.ReadValue(count))
+		{
+			return false;
+		}
+
+		value.m_Tags.clear();
+		for (uint64_t i = 0; i < count; ++i)
+		{
+			if (!HandWrittenReadString(reader, value.m_Tags.emplace_back()))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+ZE_TEST(SerializationInheritance)
+{
+	const auto value = MakeDerived(7u);
+
+	BinaryWriter writer;
+	Serialize(writer, value);
+
+	// members of the base are written once, in front of the derived ones, exactly as the hand-written layout
+	BinaryWriter handWrittenWriter;
+	HandWrittenSerialize(handWrittenWriter, value);
+	ZE_CHECK(writer.GetBuffer() == handWrittenWriter.GetBuffer());
+
+	Test::SerializedDerived loaded;
+	BinaryReader reader(writer.GetBuffer());
+	ZE_CHECK(Deserialize(reader, loaded));
+	ZE_CHECK(reader.GetRemainingSize() == 0u);
+	ZE_CHECK(IsSameDerived(loaded, value));
+	// never serialized
+	ZE_CHECK(loaded.m_Transient == 0u);
+}
+
+ZE_TEST(SerializationVersioning)
+{
+	Test::SerializedSettingsV1 settingsV1;
+	settingsV1.m_Width = 1920u;
+	settingsV1.m_Height = 1080u;
+
+	BinaryWriter writerV1;
+	Serialize(writerV1, settingsV1);
+
+	// fields added in version 2 keep their defaults when version 1 data is read
+	{
+		Test::SerializedSettingsV2 settingsV2;
+		BinaryReader reader(writerV1.GetBuffer());
+		ZE_CHECK(Deserialize(reader, settingsV2));
+		ZE_CHECK(reader.GetRemainingSize() == 0u);
+		ZE_CHECK(settingsV2.m_Width == 1920u && settingsV2.m_Height == 1080u);
+		ZE_CHECK(settingsV2.m_Scale == 1.0f);
+		ZE_CHECK(settingsV2.m_Title == "untitled");
+	}
+
+	Test::SerializedSettingsV2 settingsV2;
+	settingsV2.m_Width = 640u;
+	settingsV2.m_Height = 480u;
+	settingsV2.m_Scale = 2.0f;
+	settingsV2.m_Title = "scaled";
+
+	BinaryWriter writerV2;
+	Serialize(writerV2, settingsV2);
+	{
+		Test::SerializedSettingsV2 loaded;
+		BinaryReader reader(writerV2.GetBuffer());
+		ZE_CHECK(Deserialize(reader, loaded));
+		ZE_CHECK(loaded.m_Width == 640u && loaded.m_Height == 480u && loaded.m_Scale == 2.0f && loaded.m_Title == "scaled");
+	}
+
+	// version 1 code can NOT read what version 2 had added, so it rejects the data
+	{
+		Test::SerializedSettingsV1 loaded;
+		BinaryReader reader(writerV2.GetBuffer());
+		ZE_CHECK(!Deserialize(reader, loaded));
+		ZE_CHECK(reader.HasFailed());
+	}
+}
+
+ZE_TEST(SerializationRejectsInvalidData)
+{
+	const auto data = SaveToBinary(MakeDerived(3u));
+	{
+		Test::SerializedDerived loaded;
+		ZE_REQUIRE(LoadFromBinary(data, loaded));
+		ZE_CHECK(IsSameDerived(loaded, MakeDerived(3u)));
+	}
+
+	// truncated anywhere, even right after the header
+	for (std::size_t size = 0; size < data.size(); ++size)
+	{
+		Test::SerializedDerived loaded;
+		ZE_CHECK(!LoadFromBinary(std::span(data).first(size), loaded));
+	}
+
+	// data of another type
+	{
+		Test::SerializedBase loaded;
+		ZE_CHECK(!LoadFromBinary(data, loaded));
+	}
+
+	// a corrupted count larger than the data is rejected before anything is allocated for it
+	{
+		Test::SerializedBase value;
+		value.m_Name = "name";
+		BinaryWriter writer;
+		Serialize(writer, value);
+
+		auto corrupted = writer.ReleaseBuffer();
+		const uint64_t hugeSize = std::numeric_limits<uint64_t>::max() / 2u;
+		std::memcpy(corrupted.data() + sizeof(uint32_t), &hugeSize, sizeof(hugeSize));
+
+		Test::SerializedBase loaded;
+		BinaryReader reader(corrupted);
+		ZE_CHECK(!Deserialize(reader, loaded));
+		ZE_CHECK(loaded.m_Name.empty());
+	}
+}
+
+ZE_BENCHMARK(SerializationReflectedAgainstHandWritten)
+{
+	constexpr uint32_t kObjectCount = 200000u;
+
+	std::vector<Test::SerializedDerived> values;
+	values.reserve(kObjectCount);
+	for (uint32_t i = 0; i < kObjectCount; ++i)
+	{
+		values.push_back(MakeDerived(i));
+	}
+
+	double reflectedWriteTime = 0.0;
+	BinaryWriter reflectedWriter;
+	{
+		Core::ScopedTimer<Core::ETimeUnit::MilliSecond> scopedTimer(reflectedWriteTime);
+		Serialize(reflectedWriter, values);
+	}
+
+	double handWrittenWriteTime = 0.0;
+	BinaryWriter handWrittenWriter;
+	{
+		Core::ScopedTimer<Core::ETimeUnit::MilliSecond> scopedTimer(handWrittenWriteTime);
+		handWrittenWriter.WriteValue(static_cast<uint64_t>(values.size()));
+		for (const auto& value : values)
+		{
+			HandWrittenSerialize(handWrittenWriter, value);
+		}
+	}
+
+	double reflectedReadTime = 0.0;
+	std::vector<Test::SerializedDerived> reflectedValues;
+	{
+		Core::ScopedTimer<Core::ETimeUnit::MilliSecond> scopedTimer(reflectedReadTime);
+		BinaryReader reader(reflectedWriter.GetBuffer());
+		Deserialize(reader, reflectedValues);
+	}
+
+	double handWrittenReadTime = 0.0;
+	std::vector<Test::SerializedDerived> handWrittenValues;
+	{
+		Core::ScopedTimer<Core::ETimeUnit::MilliSecond> scopedTimer(handWrittenReadTime);
+		BinaryReader reader(handWrittenWriter.GetBuffer());
+		uint64_t count = 0;
+		reader.ReadValue(count);
+		handWrittenValues.reserve(static_cast<std::size_t>(count));
+		for (uint64_t i = 0; i < count; ++i)
+		{
+			HandWrittenDeserialize(reader, handWrittenValues.emplace_back());
+		}
+	}
+
+	const bool bSameBytes = reflectedWriter.GetBuffer() == handWrittenWriter.GetBuffer();
+	const bool bSameValues = reflectedValues.size() == kObjectCount && handWrittenValues.size() == kObjectCount
+		&& IsSameDerived(reflectedValues.back(), values.back()) && IsSameDerived(handWrittenValues.back(), values.back());
+	ZE_LOG_INFO("{} objects, {:.2f} MiB, same bytes: {}, same values: {}, reflected write: {:.3f} ms, read: {:.3f} ms, hand-written write: {:.3f} ms, read: {:.3f} ms",
+		kObjectCount, reflectedWriter.GetBuffer().size() / (1024.0 * 1024.0), bSameBytes, bSameValues,
+		reflectedWriteTime, reflectedReadTime, handWrittenWriteTime, handWrittenReadTime);
+}
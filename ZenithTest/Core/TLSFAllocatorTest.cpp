@@ -0,0 +1,113 @@
+#include "Test.h"
+
+#include "Core/TLSFAllocator.h"
+#include "Core/Timer.h"
+#include "Log/Log.h"
+
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace ZE;
+using namespace ZE::Core;
+
+namespace
+{
+	// sizes of the first level bin, so the tests go over every bin boundary of the second level
+	uint32_t GetBinSize(uint32_t firstLevelBit, uint32_t secondLevel)
+	{
+		return (1u << firstLevelBit) + (secondLevel << (firstLevelBit - TLSFAllocator::kSecondLevelBits));
+	}
+}
+
+ZE_TEST(TLSFAllocatorAllocateAndCoalesce)
+{
+	TLSFAllocator allocator(1024u, 16u);
+
+	const auto a = allocator.Allocate(100u);
+	const auto b = allocator.Allocate(200u, 256u);
+	const auto c = allocator.Allocate(300u);
+	ZE_REQUIRE(a.IsValid() && b.IsValid() && c.IsValid());
+	ZE_CHECK(a.m_Size == 112u && a.m_Offset % 16u == 0);
+	ZE_CHECK(b.m_Offset % 256u == 0);
+	ZE_CHECK(allocator.GetAllocationCount() == 3u);
+
+	// too large for what is left
+	ZE_CHECK(!allocator.Allocate(1024u).IsValid());
+
+	allocator.Free(b);
+	allocator.Free(a);
+	allocator.Free(c);
+	ZE_CHECK(allocator.IsEmpty());
+	ZE_CHECK(allocator.GetFreeSize() == allocator.GetCapacity());
+
+	// free ranges had been merged back into one
+	ZE_CHECK(allocator.Allocate(1024u).IsValid());
+}
+
+ZE_TEST(TLSFAllocatorRequiredCapacityAboveBinBoundary)
+{
+	for (const uint32_t granularity : { 16u, 64u, 256u })
+	{
+		for (const uint32_t alignment : { 0u, 256u, 4096u })
+		{
+			for (uint32_t firstLevelBit = TLSFAllocator::kSecondLevelBits; firstLevelBit < 30u; ++firstLevelBit)
+			{
+				for (uint32_t secondLevel = 0; secondLevel < TLSFAllocator::kSecondLevelCount; ++secondLevel)
+				{
+					for (const uint32_t extraSize : { 0u, 1u, 7u, 40u })
+					{
+						const uint32_t size = GetBinSize(firstLevelBit, secondLevel) + extraSize;
+						const uint64_t capacity = TLSFAllocator::GetRequiredCapacity(size, alignment, granularity);
+						ZE_REQUIRE(capacity <= std::numeric_limits<uint32_t>::max());
+
+						TLSFAllocator allocator(static_cast<uint32_t>(capacity), granularity);
+						const auto allocation = allocator.Allocate(size, alignment);
+						ZE_CHECK(allocation.IsValid() && allocation.m_Size >= size);
+					}
+				}
+			}
+		}
+	}
+
+	// sizes which used to overflow dedicated pages of buffer heaps
+	for (const uint32_t size : { 34603013u, 41944040u, 104857607u })
+	{
+		TLSFAllocator allocator(static_cast<uint32_t>(TLSFAllocator::GetRequiredCapacity(size, 0u, 256u)), 256u);
+		ZE_CHECK(allocator.Allocate(size).IsValid());
+	}
+}
+
+ZE_BENCHMARK(TLSFAllocatorAllocateFree)
+{
+	constexpr uint32_t kCycleCount = 4'000'000u;
+	constexpr uint32_t kLiveAllocationCount = 4096u;
+
+	TLSFAllocator allocator(256u * 1024u * 1024u, 16u);
+	std::vector<TLSFAllocation> liveAllocations(kLiveAllocationCount);
+
+	// small buffers dominate, e.g. uniform and per-mesh buffers
+	std::mt19937 random(42u);
+	std::uniform_int_distribution<uint32_t> sizeDistribution(16u, 64u * 1024u);
+	std::uniform_int_distribution<uint32_t> slotDistribution(0u, kLiveAllocationCount - 1u);
+
+	double elapsedTime = 0.0;
+	{
+		Core::ScopedTimer<Core::ETimeUnit::MilliSecond> scopedTimer(elapsedTime);
+		for (uint32_t i = 0; i < kCycleCount; ++i)
+		{
+			auto& allocation = liveAllocations[slotDistribution(random)];
+			allocator.Free(allocation);
+			allocation = allocator.Allocate(sizeDistribution(random), (i & 3u) == 0 ? 256u : 0u);
+		}
+	}
+
+	for (const auto& allocation : liveAllocations)
+	{
+		allocator.Free(allocation);
+	}
+	ZE_CHECK(allocator.IsEmpty());
+
+	ZE_LOG_INFO("{} allocate/free cycles with {} live allocations: {:.3f} ms, {:.1f} ns per cycle",
+		kCycleCount, kLiveAllocationCount, elapsedTime, elapsedTime * 1e6 / kCycleCount);
+}
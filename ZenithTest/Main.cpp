@@ -0,0 +1,60 @@
+#include "Test.h"
+
+#include "Core/Timer.h"
+#include "Log/Log.h"
+
+#include <string_view>
+
+// ZenithTest [--benchmark] [name filter]
+int main(int argc, char** argv)
+{
+	using namespace ZE;
+
+	bool bRunBenchmarks = false;
+	std::string_view filter;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view argument = argv[i];
+		if (argument == "--benchmark")
+		{
+			bRunBenchmarks = true;
+		}
+		else
+		{
+			filter = argument;
+		}
+	}
+
+	uint32_t runCount = 0;
+	uint32_t failedCount = 0;
+	for (const auto& testCase : Test::GetTestCases())
+	{
+		if (testCase.m_IsBenchmark != bRunBenchmarks || (!filter.empty() && testCase.m_Name.find(filter) == std::string_view::npos))
+		{
+			continue;
+		}
+
+		ZE_LOG_INFO("[ RUN    ] {}", testCase.m_Name);
+		const uint32_t failureCount = Test::GetFailureCount();
+
+		double elapsedTime = 0.0;
+		{
+			Core::ScopedTimer<Core::ETimeUnit::MilliSecond> scopedTimer(elapsedTime);
+			testCase.m_Function();
+		}
+
+		++runCount;
+		if (Test::GetFailureCount() != failureCount)
+		{
+			++failedCount;
+			ZE_LOG_ERROR("[ FAILED ] {} ({:.3f} ms)", testCase.m_Name, elapsedTime);
+		}
+		else
+		{
+			ZE_LOG_INFO("[     OK ] {} ({:.3f} ms)", testCase.m_Name, elapsedTime);
+		}
+	}
+
+	ZE_LOG_INFO("{} of {} {} passed", runCount - failedCount, runCount, bRunBenchmarks ? "benchmarks" : "tests");
+	return failedCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+#include "Test.h"
+#include "RenderBackend/NullRenderDevice.h"
+
+#include "Render/RenderGraph.h"
+#include "Render/Shader.h"
+#include "Render/ViewBatch.h"
+#include "RenderBackend/Null/NullVulkan.h"
+#include "RenderBackend/PipelineStateCache.h"
+#include "RenderBackend/RenderResource.h"
+#include "RenderBackend/UploadManager.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+using namespace ZE;
+using namespace ZE::RenderBackend;
+
+namespace
+{
+	std::shared_ptr<Buffer> CreateUploadedVertexBuffer(RenderDevice& device, UploadHandle& outUploadHandle)
+	{
+		constexpr std::array<float, 12> kVertices = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f };
+
+		BufferDesc desc("test uploaded vertex buffer");
+		desc.m_Size = static_cast<uint32_t>(sizeof(kVertices));
+		desc.m_Usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		return std::shared_ptr<Buffer>(Buffer::Create(device, desc, kVertices, outUploadHandle));
+	}
+
+	std::vector<std::unique_ptr<Buffer>> CreateStorageBuffers(RenderDevice& device, uint32_t count)
+	{
+		std::vector<std::unique_ptr<Buffer>> buffers;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			BufferDesc desc("test descriptor storage buffer");
+			desc.m_Size = 256u;
+			desc.m_Usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+			buffers.emplace_back(Buffer::Create(device, desc));
+		}
+		return buffers;
+	}
+
+	// vertex shader reading the storage buffer "data", the only binding of set 0
+	std::unique_ptr<Render::VertexShader> CreateStorageBufferShader(RenderDevice& device)
+	{
+		std::unique_ptr<Render::VertexShader> pShader(Render::VertexShader::Create(device));
+		Render::Shader::LayoutBuilder(pShader.get())
+			.BindResource(0, "data", Render::EShaderBindingResourceType::StorageBuffer)
+			.Build();
+		return pShader;
+	}
+
+	BufferRange MakeRange(const std::unique_ptr<Buffer>& pBuffer)
+	{
+		BufferRange range;
+		range.m_pBuffer = pBuffer.get();
+		range.m_Size = pBuffer->GetDesc().m_Size;
+		return range;
+	}
+
+	// first set of every submitted vkCmdBindDescriptorSets, in submission order
+	std::vector<VkDescriptorSet> GetSubmittedDescriptorSets()
+	{
+		std::vector<VkDescriptorSet> sets;
+		for (const auto& command : Null::GetSubmittedCommands())
+		{
+			if (command.m_Name == "BindDescriptorSets")
+			{
+				sets.push_back(reinterpret_cast<VkDescriptorSet>(command.m_Args[3]));
+			}
+		}
+		return sets;
+	}
+}
+
+ZE_TEST(RenderGraphWaitsForUploadOfBoundRange)
+{
+	Test::ScopedNullRenderDevice renderDevice;
+	ZE_REQUIRE(renderDevice.IsValid());
+
+	auto& device = renderDevice.Get();
+	PipelineStateCache pipelineStateCache(device);
+
+	device.WaitForFrame(device.GetFrameIndex());
+	device.BeginFrame();
+
+	UploadHandle uploadHandle;
+	const auto pBuffer = CreateUploadedVertexBuffer(device, uploadHandle);
+	ZE_REQUIRE(pBuffer && uploadHandle.IsValid());
+	ZE_CHECK(pBuffer->GetPendingUpload().m_TimelineValue == uploadHandle.m_TimelineValue);
+	// the upload is batched until somebody needs it
+	ZE_CHECK(!device.GetUploadManager().IsFinished(uploadHandle));
+
+	BufferRange vertexRange;
+	vertexRange.m_pBuffer = pBuffer.get();
+	vertexRange.m_Size = pBuffer->GetDesc().m_Size;
+
+	// binding the range is enough, nobody passes the upload handle to the graph
+	{
+		Render::RenderGraph renderGraph(device);
+		renderGraph.AddNode("Draw Uploaded").Execute([vertexRange](Render::GraphExecutionContext& context)
+		{
+			context.BindVertexInput(vertexRange);
+		});
+		renderGraph.Execute(pipelineStateCache);
+	}
+	ZE_CHECK(device.GetUploadManager().IsFinished(uploadHandle));
+
+	device.EndFrame();
+	device.WaitUntilIdle();
+}
+
+ZE_TEST(RenderGraphWaitsForUploadOfImportedBuffer)
+{
+	Test::ScopedNullRenderDevice renderDevice;
+	ZE_REQUIRE(renderDevice.IsValid());
+
+	auto& device = renderDevice.Get();
+	PipelineStateCache pipelineStateCache(device);
+
+	device.WaitForFrame(device.GetFrameIndex());
+	device.BeginFrame();
+
+	UploadHandle uploadHandle;
+	const auto pBuffer = CreateUploadedVertexBuffer(device, uploadHandle);
+	ZE_REQUIRE(pBuffer && uploadHandle.IsValid());
+	ZE_CHECK(!device.GetUploadManager().IsFinished(uploadHandle));
+
+	{
+		Render::RenderGraph renderGraph(device);
+		const auto vertexBufferHandle = renderGraph.ImportResource(pBuffer, ERenderResourceState::VertexBuffer);
+		renderGraph.AddNode("Draw Imported").Execute([vertexBufferHandle](Render::GraphExecutionContext& context)
+		{
+			context.BindVertexInput(vertexBufferHandle);
+		});
+		renderGraph.Execute(pipelineStateCache);
+	}
+	ZE_CHECK(device.GetUploadManager().IsFinished(uploadHandle));
+
+	device.EndFrame();
+	device.WaitUntilIdle();
+}
+
+ZE_TEST(RenderGraphWritesDescriptorsIntoSetsOfTheRecording)
+{
+	Test::ScopedNullRenderDevice renderDevice;
+	ZE_REQUIRE(renderDevice.IsValid());
+
+	auto& device = renderDevice.Get();
+	const auto pShader = CreateStorageBufferShader(device);
+	PipelineStateCache pipelineStateCache(device);
+
+	device.WaitForFrame(device.GetFrameIndex());
+	device.BeginFrame();
+
+	// more draws than one descriptor pool of the pipeline holds
+	constexpr uint32_t kDrawCount = 100u;
+	const auto buffers = CreateStorageBuffers(device, kDrawCount);
+
+	Render::ViewBatch viewBatch(device, {});
+	viewBatch.AddView(glm::mat4(1.0f), glm::mat4(1.0f));
+
+	std::vector<VkDescriptorSet> firstGraphSets;
+	{
+		Null::ClearSubmittedCommands();
+
+		Render::RenderGraph renderGraph(device);
+		viewBatch.Setup(renderGraph);
+		viewBatch.AddViewNode(renderGraph, "Draw Storage Buffers")
+			.BindVertexShader(pShader.get())
+			.Execute([&buffers](Render::GraphExecutionContext& context)
+			{
+				for (const auto& pBuffer : buffers)
+				{
+					context.BindResource("data", MakeRange(pBuffer));
+					context.BindPipeline();
+				}
+			});
+		viewBatch.Execute(renderGraph, pipelineStateCache);
+
+		// descriptors are written at replay, every draw keeps the buffer it had bound
+		firstGraphSets = GetSubmittedDescriptorSets();
+		ZE_REQUIRE(firstGraphSets.size() == kDrawCount);
+		for (uint32_t i = 0; i < kDrawCount; ++i)
+		{
+			ZE_CHECK(Null::GetDescriptorBufferInfo(firstGraphSets[i], 0).buffer == buffers[i]->GetNativeHandle());
+		}
+	}
+
+	// the second graph of the frame must NOT rewrite any set bound by the first one
+	{
+		Null::ClearSubmittedCommands();
+
+		Render::RenderGraph renderGraph(device);
+		viewBatch.Setup(renderGraph);
+		viewBatch.AddViewNode(renderGraph, "Draw Storage Buffer Again")
+			.BindVertexShader(pShader.get())
+			.Execute([&buffers](Render::GraphExecutionContext& context)
+			{
+				context.BindResource("data", MakeRange(buffers.back()));
+				context.BindPipeline();
+			});
+		viewBatch.Execute(renderGraph, pipelineStateCache);
+
+		const auto secondGraphSets = GetSubmittedDescriptorSets();
+		ZE_REQUIRE(secondGraphSets.size() == 1u);
+		ZE_CHECK(std::ranges::find(firstGraphSets, secondGraphSets[0]) == firstGraphSets.end());
+		ZE_CHECK(Null::GetDescriptorBufferInfo(firstGraphSets[0], 0).buffer == buffers[0]->GetNativeHandle());
+	}
+
+	device.EndFrame();
+	device.WaitUntilIdle();
+}
+
+ZE_TEST(RenderGraphBindsDescriptorsPerView)
+{
+	Test::ScopedNullRenderDevice renderDevice;
+	ZE_REQUIRE(renderDevice.IsValid());
+
+	auto& device = renderDevice.Get();
+	const auto pShader = CreateStorageBufferShader(device);
+	PipelineStateCache pipelineStateCache(device);
+
+	device.WaitForFrame(device.GetFrameIndex());
+	device.BeginFrame();
+
+	// views share the pipeline state, each of them binds its own buffer
+	constexpr uint32_t kViewCount = 2u;
+	const auto buffers = CreateStorageBuffers(device, kViewCount);
+
+	Render::ViewBatch viewBatch(device, {});
+	for (uint32_t i = 0; i < kViewCount; ++i)
+	{
+		viewBatch.AddView(glm::mat4(1.0f), glm::mat4(1.0f));
+	}
+
+	Null::ClearSubmittedCommands();
+	{
+		Render::RenderGraph renderGraph(device);
+		viewBatch.Setup(renderGraph);
+		viewBatch.AddViewNode(renderGraph, "Draw Views")
+			.BindVertexShader(pShader.get())
+			.Execute([&buffers](Render::GraphExecutionContext& context)
+			{
+				context.BindResource("data", MakeRange(buffers[context.GetViewIndex()]));
+				context.BindPipeline();
+			});
+		viewBatch.Execute(renderGraph, pipelineStateCache);
+	}
+
+	// the second view must NOT overwrite the set the first one had bound
+	const auto sets = GetSubmittedDescriptorSets();
+	ZE_REQUIRE(sets.size() == kViewCount);
+	ZE_CHECK(sets[0] != sets[1]);
+	for (uint32_t i = 0; i < kViewCount; ++i)
+	{
+		ZE_CHECK(Null::GetDescriptorBufferInfo(sets[i], 0).buffer == buffers[i]->GetNativeHandle());
+	}
+
+	device.EndFrame();
+	device.WaitUntilIdle();
+}
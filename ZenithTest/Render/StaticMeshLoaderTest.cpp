@@ -0,0 +1,117 @@
+#include "Test.h"
+
+#include "Asset/AssetManager.h"
+#include "Core/FileSystem.h"
+#include "Core/Timer.h"
+#include "Log/Log.h"
+#include "Render/Loader/StaticMeshLoader.h"
+#include "Render/StaticMesh.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace ZE;
+
+namespace
+{
+	/* A temporary directory for meshes, the directory is removed with it. */
+	class ScopedMeshDirectory
+	{
+	public:
+
+		explicit ScopedMeshDirectory(std::string_view name)
+			: m_Directory(std::filesystem::temp_directory_path() / name)
+		{
+			// absolute paths are sanitized against the mount path
+			Core::FileSystem::Mount();
+			std::filesystem::remove_all(m_Directory);
+			std::filesystem::create_directories(m_Directory);
+		}
+
+		~ScopedMeshDirectory()
+		{
+			std::error_code errorCode;
+			std::filesystem::remove_all(m_Directory, errorCode);
+		}
+
+		std::filesystem::path GetPath(std::string_view fileName) const { return m_Directory / fileName; }
+
+	private:
+
+		std::filesystem::path				m_Directory;
+	};
+
+	// a wavy grid of quads, large enough for the import to dominate the time rather than opening the file
+	void WriteGridObj(const std::filesystem::path& path, uint32_t gridSize)
+	{
+		std::ofstream outFileStream(path);
+		for (uint32_t y = 0; y <= gridSize; ++y)
+		{
+			for (uint32_t x = 0; x <= gridSize; ++x)
+			{
+				outFileStream << "v " << x << " " << ((x * 7u + y * 13u) % 17u) * 0.1f << " " << y << "\n";
+				outFileStream << "vt " << static_cast<float>(x) / gridSize << " " << static_cast<float>(y) / gridSize << "\n";
+			}
+		}
+
+		const auto GetIndex = [gridSize](uint32_t x, uint32_t y) { return y * (gridSize + 1u) + x + 1u; };
+		for (uint32_t y = 0; y < gridSize; ++y)
+		{
+			for (uint32_t x = 0; x < gridSize; ++x)
+			{
+				const uint32_t i0 = GetIndex(x, y);
+				const uint32_t i1 = GetIndex(x + 1u, y);
+				const uint32_t i2 = GetIndex(x + 1u, y + 1u);
+				const uint32_t i3 = GetIndex(x, y + 1u);
+				outFileStream << "f " << i0 << "/" << i0 << " " << i1 << "/" << i1 << " " << i2 << "/" << i2 << "\n";
+				outFileStream << "f " << i0 << "/" << i0 << " " << i2 << "/" << i2 << " " << i3 << "/" << i3 << "\n";
+			}
+		}
+	}
+}
+
+ZE_BENCHMARK(StaticMeshLoaderCookedAgainstAssimp)
+{
+	constexpr uint32_t kGridSize = 256u;
+	constexpr uint32_t kLoadCount = 8u;
+
+	const ScopedMeshDirectory directory("ZenithStaticMeshLoaderBenchmark");
+	const auto sourcePath = directory.GetPath("Grid.obj");
+	WriteGridObj(sourcePath, kGridSize);
+
+	// the import is timed together with writing its cooked mesh, which is a single write of the arrays
+	const auto cookedPath = Render::StaticMeshLoader::GetCookedPath(Core::FilePath(sourcePath));
+	double assimpTime = 0.0;
+	bool bIsCooked = false;
+	{
+		Core::ScopedTimer<Core::ETimeUnit::MilliSecond> scopedTimer(assimpTime);
+		bIsCooked = Render::StaticMeshLoader::Cook(Core::FilePath(sourcePath), cookedPath);
+	}
+
+	if (!bIsCooked)
+	{
+		ZE_LOG_WARNING("Failed to import [{}] through Assimp, there is nothing to measure the cooked load against", sourcePath.string());
+		return;
+	}
+
+	Render::StaticMeshLoader loader;
+	double cookedTime = 0.0;
+	uint32_t loadedCount = 0;
+	{
+		Core::ScopedTimer<Core::ETimeUnit::MilliSecond> scopedTimer(cookedTime);
+		for (uint32_t i = 0; i < kLoadCount; ++i)
+		{
+			Asset::AssetRequest request;
+			if (loader.Load(cookedPath, request))
+			{
+				++loadedCount;
+			}
+			delete request.GetAsset();
+		}
+	}
+
+	ZE_LOG_INFO("{}x{} grid, Assimp import and cook: {:.3f} ms, cooked load: {:.3f} ms on average of {} loads, {} succeeded, {:.1f}x faster",
+		kGridSize, kGridSize, assimpTime, cookedTime / kLoadCount, kLoadCount, loadedCount, assimpTime / (cookedTime / kLoadCount));
+}
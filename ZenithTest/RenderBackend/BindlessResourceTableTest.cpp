@@ -0,0 +1,129 @@
+#include "Test.h"
+#include "NullRenderDevice.h"
+
+#include "Render/RenderGraph.h"
+#include "RenderBackend/BindlessResourceTable.h"
+#include "RenderBackend/Null/NullVulkan.h"
+#include "RenderBackend/PipelineStateCache.h"
+#include "RenderBackend/RenderResource.h"
+
+#include <memory>
+#include <vector>
+
+using namespace ZE;
+using namespace ZE::RenderBackend;
+
+namespace
+{
+	RenderDevice::Settings MakeBindlessSettings()
+	{
+		RenderDevice::Settings settings;
+		settings.m_EnableBindless = true;
+		return settings;
+	}
+
+	std::unique_ptr<Buffer> CreateStorageBuffer(RenderDevice& device)
+	{
+		BufferDesc desc("test bindless storage buffer");
+		desc.m_Size = 256u;
+		desc.m_Usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+		return std::unique_ptr<Buffer>(Buffer::Create(device, desc));
+	}
+}
+
+ZE_TEST(BindlessResourceTableFitsDeviceLimits)
+{
+	{
+		Test::ScopedNullRenderDevice renderDevice(MakeBindlessSettings());
+		ZE_REQUIRE(renderDevice.IsValid());
+		ZE_REQUIRE(renderDevice.Get().IsBindlessEnabled());
+
+		// the default null device has desktop-like limits, the table gets its full size
+		const auto* pTable = renderDevice.Get().GetBindlessResourceTable();
+		ZE_CHECK(pTable->IsValid());
+		ZE_CHECK(pTable->GetCapacity(EBindlessResourceType::SampledImage) == BindlessResourceTable::kMaxSampledImageCount);
+		ZE_CHECK(pTable->GetCapacity(EBindlessResourceType::StorageBuffer) == BindlessResourceTable::kMaxStorageBufferCount);
+		ZE_CHECK(pTable->GetCapacity(EBindlessResourceType::Sampler) == BindlessResourceTable::kMaxSamplerCount);
+	}
+
+	VkPhysicalDeviceDescriptorIndexingProperties lowLimits = {};
+	lowLimits.maxPerStageDescriptorUpdateAfterBindSampledImages = 1024u;
+	lowLimits.maxDescriptorSetUpdateAfterBindSampledImages = 2048u;
+	lowLimits.maxPerStageDescriptorUpdateAfterBindStorageBuffers = 4096u;
+	lowLimits.maxDescriptorSetUpdateAfterBindStorageBuffers = 512u;
+	lowLimits.maxPerStageDescriptorUpdateAfterBindSamplers = 64u;
+	lowLimits.maxDescriptorSetUpdateAfterBindSamplers = 64u;
+	lowLimits.maxPerStageUpdateAfterBindResources = 1024u + 512u + 64u;
+	Null::SetDescriptorIndexingProperties(&lowLimits);
+	{
+		Test::ScopedNullRenderDevice renderDevice(MakeBindlessSettings());
+		ZE_REQUIRE(renderDevice.IsValid());
+		ZE_REQUIRE(renderDevice.Get().IsBindlessEnabled());
+
+		const auto* pTable = renderDevice.Get().GetBindlessResourceTable();
+		ZE_CHECK(pTable->IsValid());
+		ZE_CHECK(pTable->GetCapacity(EBindlessResourceType::SampledImage) == 1024u);
+		ZE_CHECK(pTable->GetCapacity(EBindlessResourceType::StorageBuffer) == 512u);
+		ZE_CHECK(pTable->GetCapacity(EBindlessResourceType::Sampler) == 64u);
+	}
+
+	// the clamped arrays together still exceed the per-stage resource limit, bindless is turned off, the device is not
+	lowLimits.maxPerStageUpdateAfterBindResources = 1024u;
+	Null::SetDescriptorIndexingProperties(&lowLimits);
+	{
+		Test::ScopedNullRenderDevice renderDevice(MakeBindlessSettings());
+		ZE_CHECK(renderDevice.IsValid());
+		ZE_CHECK(!renderDevice.Get().IsBindlessEnabled());
+		ZE_CHECK(!renderDevice.Get().GetBindlessResourceTable());
+	}
+	Null::SetDescriptorIndexingProperties(nullptr);
+}
+
+ZE_TEST(BindlessResourceTableRecyclesSlotsByTimeline)
+{
+	Test::ScopedNullRenderDevice renderDevice(MakeBindlessSettings());
+	ZE_REQUIRE(renderDevice.IsValid());
+
+	auto& device = renderDevice.Get();
+	ZE_REQUIRE(device.IsBindlessEnabled());
+
+	PipelineStateCache pipelineStateCache(device);
+
+	device.WaitForFrame(device.GetFrameIndex());
+	device.BeginFrame();
+
+	auto pBuffer = CreateStorageBuffer(device);
+	ZE_REQUIRE(pBuffer);
+	const uint32_t freedIndex = pBuffer->GetBindlessIndex();
+	ZE_REQUIRE(freedIndex != BindlessResourceTable::kInvalidIndex);
+	pBuffer.reset();
+
+	// commands recorded before the free may still be submitted, however many frames go by without a submission
+	std::vector<std::unique_ptr<Buffer>> liveBuffers;
+	for (uint32_t frame = 0; frame <= RenderDevice::kSwapBufferCount; ++frame)
+	{
+		device.EndFrame();
+		device.WaitForFrame(device.GetFrameIndex());
+		device.BeginFrame();
+
+		liveBuffers.push_back(CreateStorageBuffer(device));
+		ZE_CHECK(liveBuffers.back()->GetBindlessIndex() != freedIndex);
+	}
+
+	// an extra submission in the middle of the frame tags the slot, it is recycled once GPU had finished it
+	{
+		Render::RenderGraph renderGraph(device);
+		renderGraph.AddNode("Extra Submission").Execute([](Render::GraphExecutionContext&) {});
+		renderGraph.Execute(pipelineStateCache);
+	}
+	device.EndFrame();
+	device.WaitForFrame(device.GetFrameIndex());
+	device.BeginFrame();
+
+	const auto pRecycledBuffer = CreateStorageBuffer(device);
+	ZE_CHECK(pRecycledBuffer->GetBindlessIndex() == freedIndex);
+
+	liveBuffers.clear();
+	device.EndFrame();
+	device.WaitUntilIdle();
+}
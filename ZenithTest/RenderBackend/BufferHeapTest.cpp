@@ -0,0 +1,131 @@
+#include "Test.h"
+#include "NullRenderDevice.h"
+
+#include "Core/TLSFAllocator.h"
+#include "Core/Timer.h"
+#include "Log/Log.h"
+#include "RenderBackend/BufferHeap.h"
+#include "RenderBackend/RenderResource.h"
+
+#include <memory>
+#include <vector>
+
+using namespace ZE;
+using namespace ZE::RenderBackend;
+
+namespace
+{
+	BufferDesc MakeUniformPageDesc()
+	{
+		// uniform usage raises the granularity to the offset alignment of the device
+		BufferDesc pageDesc("test uniform buffer heap");
+		pageDesc.m_Size = BufferHeap::kDefaultPageSizeInByte;
+		pageDesc.m_Usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		pageDesc.m_MemoryUsage = BufferMemoryUsage::GpuOnly;
+		pageDesc.m_MemoryCategory = EMemoryCategory::Uniform;
+		return pageDesc;
+	}
+}
+
+ZE_TEST(BufferHeapSuballocate)
+{
+	Test::ScopedNullRenderDevice renderDevice;
+	ZE_REQUIRE(renderDevice.IsValid());
+
+	BufferHeap heap(renderDevice.Get(), MakeUniformPageDesc());
+
+	const auto a = heap.Allocate(192u);
+	const auto b = heap.Allocate(192u);
+	ZE_REQUIRE(a.IsValid() && b.IsValid());
+	ZE_CHECK(a.m_pBuffer == b.m_pBuffer);
+	ZE_CHECK(a.m_Offset != b.m_Offset);
+	ZE_CHECK(a.m_Size == 192u);
+	ZE_CHECK(heap.GetPageCount() == 1u && heap.GetAllocationCount() == 2u);
+
+	heap.Free(a);
+	heap.Free(b);
+	ZE_CHECK(heap.GetAllocationCount() == 0u);
+}
+
+ZE_TEST(BufferHeapDedicatedPageAboveBinBoundary)
+{
+	Test::ScopedNullRenderDevice renderDevice;
+	ZE_REQUIRE(renderDevice.IsValid());
+
+	BufferHeap heap(renderDevice.Get(), MakeUniformPageDesc());
+
+	// ranges larger than a page get a dedicated page, which must hold the bin the search rounds up to
+	for (const uint32_t size : { 34603013u, 41944040u, 104857607u })
+	{
+		const auto range = heap.Allocate(size);
+		ZE_CHECK(range.IsValid() && range.m_Size == size);
+		heap.Free(range);
+	}
+
+	for (uint32_t firstLevelBit = 25u; firstLevelBit < 28u; ++firstLevelBit)
+	{
+		for (uint32_t secondLevel = 0; secondLevel < Core::TLSFAllocator::kSecondLevelCount; ++secondLevel)
+		{
+			const uint32_t binSize = (1u << firstLevelBit) + (secondLevel << (firstLevelBit - Core::TLSFAllocator::kSecondLevelBits));
+			for (const uint32_t alignment : { 0u, 4096u })
+			{
+				const auto range = heap.Allocate(binSize + 1u, alignment);
+				ZE_CHECK(range.IsValid());
+				ZE_CHECK(alignment == 0 || range.m_Offset % alignment == 0);
+				heap.Free(range);
+			}
+		}
+	}
+
+	ZE_CHECK(heap.GetAllocationCount() == 0u);
+}
+
+ZE_BENCHMARK(BufferHeapVersusDedicatedBuffers)
+{
+	Test::ScopedNullRenderDevice renderDevice;
+	ZE_REQUIRE(renderDevice.IsValid());
+
+	// e.g. Matrices of TriangleRenderer
+	constexpr uint32_t kBufferSize = 192u;
+	constexpr uint32_t kBufferCount = 100'000u;
+
+	const BufferDesc pageDesc = MakeUniformPageDesc();
+	BufferDesc bufferDesc = pageDesc;
+	bufferDesc.m_Size = kBufferSize;
+
+	double dedicatedTime = 0.0;
+	{
+		std::vector<std::unique_ptr<Buffer>> buffers;
+		buffers.reserve(kBufferCount);
+
+		Core::ScopedTimer<Core::ETimeUnit::MilliSecond> scopedTimer(dedicatedTime);
+		for (uint32_t i = 0; i < kBufferCount; ++i)
+		{
+			buffers.emplace_back(Buffer::Create(renderDevice.Get(), bufferDesc));
+		}
+		buffers.clear();
+	}
+
+	double heapTime = 0.0;
+	{
+		BufferHeap heap(renderDevice.Get(), pageDesc);
+		std::vector<BufferRange> ranges;
+		ranges.reserve(kBufferCount);
+
+		{
+			Core::ScopedTimer<Core::ETimeUnit::MilliSecond> scopedTimer(heapTime);
+			for (uint32_t i = 0; i < kBufferCount; ++i)
+			{
+				ranges.emplace_back(heap.Allocate(kBufferSize));
+			}
+			for (const auto& range : ranges)
+			{
+				heap.Free(range);
+			}
+		}
+		ZE_CHECK(heap.GetAllocationCount() == 0u);
+	}
+
+	ZE_LOG_INFO("{} buffers of {} bytes created and destroyed on the null backend: dedicated {:.3f} ms, buffer heap {:.3f} ms",
+		kBufferCount, kBufferSize, dedicatedTime, heapTime);
+}
@@ -0,0 +1,64 @@
+#include "Test.h"
+
+#include "RenderBackend/DeferReleaseQueue.h"
+
+using namespace ZE;
+using namespace ZE::RenderBackend;
+
+namespace
+{
+	class CountedRelease : public IDeferReleaseResource
+	{
+	public:
+
+		explicit CountedRelease(uint32_t& releaseCount)
+			: m_ReleaseCount(releaseCount)
+		{}
+
+		virtual void Release() override
+		{
+			++m_ReleaseCount;
+			delete this;
+		}
+
+	private:
+
+		uint32_t&			m_ReleaseCount;
+	};
+}
+
+ZE_TEST(DeferReleaseQueueWaitsForBothTimelines)
+{
+	uint32_t releaseCount = 0;
+
+	DeferReleaseQueue queue;
+	queue.DeferRelease(new CountedRelease(releaseCount));
+	// used by graphic submission 5 and written by the upload signaling transfer value 3
+	queue.Seal(5u, 3u);
+
+	queue.ReleaseCompleted(4u, 3u);
+	ZE_CHECK(releaseCount == 0u);
+	queue.ReleaseCompleted(5u, 2u);
+	ZE_CHECK(releaseCount == 0u);
+	queue.ReleaseCompleted(5u, 3u);
+	ZE_CHECK(releaseCount == 1u);
+}
+
+ZE_TEST(DeferReleaseQueueKeepsTransferValuesOrdered)
+{
+	uint32_t releaseCount = 0;
+
+	DeferReleaseQueue queue;
+	queue.DeferRelease(new CountedRelease(releaseCount));
+	queue.Seal(1u, 7u);
+	// a concurrent submission had read an older transfer value, its batch must NOT be released before the earlier one
+	queue.DeferRelease(new CountedRelease(releaseCount));
+	queue.Seal(2u, 6u);
+
+	queue.ReleaseCompleted(2u, 6u);
+	ZE_CHECK(releaseCount == 0u);
+	queue.ReleaseCompleted(2u, 7u);
+	ZE_CHECK(releaseCount == 2u);
+
+	queue.ReleaseAllImmediately();
+}
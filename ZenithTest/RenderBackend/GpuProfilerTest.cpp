@@ -0,0 +1,87 @@
+#include "Test.h"
+#include "NullRenderDevice.h"
+
+#include "Render/RenderGraph.h"
+#include "RenderBackend/GpuProfiler.h"
+#include "RenderBackend/PipelineStateCache.h"
+
+#include <string>
+
+using namespace ZE;
+using namespace ZE::RenderBackend;
+
+ZE_TEST(GpuProfilerResolvesNodeTimings)
+{
+	RenderDevice::Settings settings;
+	settings.m_EnableGpuProfiler = true;
+	Test::ScopedNullRenderDevice renderDevice(settings);
+	ZE_REQUIRE(renderDevice.IsValid());
+
+	auto& device = renderDevice.Get();
+	const auto* pGpuProfiler = device.GetGpuProfiler();
+	ZE_REQUIRE(pGpuProfiler);
+
+	PipelineStateCache pipelineStateCache(device);
+
+	// a frame is resolved when its slot is reused kSwapBufferCount frames later
+	for (uint32_t frame = 0; frame <= RenderDevice::kSwapBufferCount; ++frame)
+	{
+		device.WaitForFrame(device.GetFrameIndex());
+		device.BeginFrame();
+
+		Render::RenderGraph renderGraph(device);
+		renderGraph.AddNode("Profiled Node").Execute([](Render::GraphExecutionContext&) {});
+		renderGraph.Execute(pipelineStateCache);
+
+		device.EndFrame();
+	}
+	device.WaitUntilIdle();
+
+	const auto* pTiming = pGpuProfiler->FindScopeTiming("Profiled Node");
+	ZE_REQUIRE(pTiming);
+	ZE_CHECK(pTiming->m_StartTimeInMs >= 0.0);
+	ZE_CHECK(pGpuProfiler->GetLatestFrameProfile().m_Scopes.size() == 1u);
+	ZE_CHECK(!pGpuProfiler->FindScopeTiming("Unknown Node"));
+}
+
+ZE_TEST(GpuProfilerSeveralGraphsPerFrame)
+{
+	RenderDevice::Settings settings;
+	settings.m_EnableGpuProfiler = true;
+	Test::ScopedNullRenderDevice renderDevice(settings);
+	ZE_REQUIRE(renderDevice.IsValid());
+
+	auto& device = renderDevice.Get();
+	const auto* pGpuProfiler = device.GetGpuProfiler();
+	ZE_REQUIRE(pGpuProfiler);
+
+	PipelineStateCache pipelineStateCache(device);
+
+	// a frame is resolved when its slot is reused kSwapBufferCount frames later
+	for (uint32_t frame = 0; frame <= RenderDevice::kSwapBufferCount; ++frame)
+	{
+		device.WaitForFrame(device.GetFrameIndex());
+		device.BeginFrame();
+
+		for (const std::string nodeName : { "First Graph Node", "Second Graph Node" })
+		{
+			const auto* pFrameCmdList = device.GetFrameCommandList();
+
+			Render::RenderGraph renderGraph(device);
+			renderGraph.AddNode(nodeName).Execute([](Render::GraphExecutionContext&) {});
+			renderGraph.Execute(pipelineStateCache);
+
+			// the submitted command list is pending, the next graph of the frame must NOT record into it again
+			ZE_CHECK(device.GetFrameCommandList() != pFrameCmdList);
+		}
+
+		device.EndFrame();
+	}
+	device.WaitUntilIdle();
+
+	const auto* pFirstTiming = pGpuProfiler->FindScopeTiming("First Graph Node");
+	const auto* pSecondTiming = pGpuProfiler->FindScopeTiming("Second Graph Node");
+	ZE_REQUIRE(pFirstTiming && pSecondTiming);
+	ZE_CHECK(pSecondTiming->m_StartTimeInMs >= pFirstTiming->m_StartTimeInMs);
+	ZE_CHECK(pGpuProfiler->GetLatestFrameProfile().m_Scopes.size() == 2u);
+}
@@ -0,0 +1,42 @@
+#include "NullRenderDevice.h"
+
+#include "Core/Assertion.h"
+
+static_assert(ZENITH_NULL_RENDER_BACKEND, "Tests run the render device on the null backend.");
+
+namespace ZE::Test
+{
+	namespace
+	{
+		Render::RenderSettings MakeRenderSettings(const RenderBackend::RenderDevice::Settings& settings)
+		{
+			Render::RenderSettings renderSettings;
+			renderSettings.m_Offscreen = true;
+			renderSettings.m_EnableGpuProfiler = settings.m_EnableGpuProfiler;
+			renderSettings.m_EnableGpuPipelineStatistics = settings.m_EnableGpuPipelineStatistics;
+			renderSettings.m_EnableBindless = settings.m_EnableBindless;
+			return renderSettings;
+		}
+
+		RenderBackend::RenderDevice::Settings MakeOffscreen(RenderBackend::RenderDevice::Settings settings)
+		{
+			settings.m_Offscreen = true;
+			return settings;
+		}
+	}
+
+	ScopedNullRenderDevice::ScopedNullRenderDevice(RenderBackend::RenderDevice::Settings settings)
+		: m_RenderModule(m_Engine, MakeRenderSettings(settings))
+		, m_RenderDevice(m_RenderModule, MakeOffscreen(settings))
+	{
+		m_IsInitialized = m_RenderDevice.Initialize();
+	}
+
+	ScopedNullRenderDevice::~ScopedNullRenderDevice()
+	{
+		if (m_IsInitialized)
+		{
+			m_RenderDevice.Shutdown();
+		}
+	}
+}
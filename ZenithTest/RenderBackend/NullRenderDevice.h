@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Core/Engine.h"
+#include "Render/Render.h"
+#include "RenderBackend/RenderDevice.h"
+
+namespace ZE::Test
+{
+	/* Offscreen render device on the null backend, for tests and benchmarks of render backend code without GPU.
+	 * The engine and render module only own it, neither of them is initialized.
+	 */
+	class ScopedNullRenderDevice
+	{
+	public:
+
+		explicit ScopedNullRenderDevice(RenderBackend::RenderDevice::Settings settings = {});
+		~ScopedNullRenderDevice();
+
+		ScopedNullRenderDevice(const ScopedNullRenderDevice&) = delete;
+		ScopedNullRenderDevice& operator=(const ScopedNullRenderDevice&) = delete;
+		ScopedNullRenderDevice(ScopedNullRenderDevice&&) = delete;
+		ScopedNullRenderDevice& operator=(ScopedNullRenderDevice&&) = delete;
+
+		bool IsValid() const { return m_IsInitialized; }
+		RenderBackend::RenderDevice& Get() { return m_RenderDevice; }
+
+	private:
+
+		Core::Engine							m_Engine;
+		Render::RenderModule					m_RenderModule;
+		RenderBackend::RenderDevice				m_RenderDevice;
+
+		bool									m_IsInitialized = false;
+	};
+}
@@ -0,0 +1,31 @@
+#include "Test.h"
+
+#include "Log/Log.h"
+
+#include <atomic>
+
+namespace ZE::Test
+{
+	namespace
+	{
+		std::atomic<uint32_t> gFailureCount = 0;
+	}
+
+	std::vector<TestCase>& GetTestCases()
+	{
+		// registered from static initializers of other translation units
+		static std::vector<TestCase> testCases;
+		return testCases;
+	}
+
+	void ReportFailure(const char* pFile, int line, const char* pExpression)
+	{
+		ZE_LOG_ERROR("{}({}): check failed: {}", pFile, line, pExpression);
+		gFailureCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	uint32_t GetFailureCount()
+	{
+		return gFailureCount.load(std::memory_order_relaxed);
+	}
+}
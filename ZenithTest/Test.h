@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace ZE::Test
+{
+	using TestFunction = void (*)();
+
+	struct TestCase
+	{
+		std::string_view				m_Name;
+		TestFunction					m_Function = nullptr;
+		// benchmarks only run with --benchmark, they log their timings instead of checking results
+		bool							m_IsBenchmark = false;
+	};
+
+	std::vector<TestCase>& GetTestCases();
+
+	/* Thread-safe, checks can fail on any thread of the test. */
+	void ReportFailure(const char* pFile, int line, const char* pExpression);
+	uint32_t GetFailureCount();
+
+	struct TestRegistrar
+	{
+		TestRegistrar(std::string_view name, TestFunction function, bool bIsBenchmark)
+		{
+			GetTestCases().push_back({ name, function, bIsBenchmark });
+		}
+	};
+}
+
+#define ZE_TEST_CASE(name, bIsBenchmark) \
+	static void ZE_TestFunction_##name(); \
+	static const ZE::Test::TestRegistrar gTestRegistrar_##name(#name, &ZE_TestFunction_##name, bIsBenchmark); \
+	static void ZE_TestFunction_##name()
+
+#define ZE_TEST(name) ZE_TEST_CASE(name, false)
+#define ZE_BENCHMARK(name) ZE_TEST_CASE(name, true)
+
+// ZE_ASSERT is compiled out in release, tests report failures on their own and go on
+#define ZE_CHECK(cond) do { if (!(cond)) { ZE::Test::ReportFailure(__FILE__, __LINE__, #cond); } } while(false)
+// return from the test on failure, for conditions the rest of the test relies on
+#define ZE_REQUIRE(cond) do { if (!(cond)) { ZE::Test::ReportFailure(__FILE__, __LINE__, #cond); return; } } while(false)
@@ -0,0 +1,43 @@
+set_version("0.0.1")
+
+set_objectdir("$(projectdir)/Intermediates")
+set_targetdir("$(projectdir)/Target")
+
+option("sanitizer")
+    set_default("")
+    set_showmenu(true)
+    set_description("Build ZenithTest with sanitizers on linux, e.g. \"xmake f -p linux --sanitizer=thread\" or \"--sanitizer=address,undefined\".")
+option_end()
+
+-- Unit tests and benchmarks, run with "xmake run ZenithTest" and "xmake run ZenithTest --benchmark".
+target("ZenithTest")
+    set_kind("binary")
+    set_default(false)
+
+    -- the engine only exports its entry points, so its sources are compiled in
+    -- render backend is the null one, tests run the render device without GPU
+    add_defines("ZENITH_ENGINE_DLL_EXPORT=1", "GLFW_VULKAN_STATIC", "ZENITH_NULL_RENDER_BACKEND=1")
+
+    add_packages("taskflow", "spdlog", "glm", "glfw", "assimp")
+
+    add_includedirs("$(projectdir)/ZenithEngine/")
+    add_includedirs("$(projectdir)/ZenithEngine/ThirdParty/refl-cpp/include")
+    add_includedirs("$(projectdir)/ZenithEngine/ThirdParty/vulkan/Include/")
+    add_includedirs("$(projectdir)/ZenithTest/")
+
+    add_files("$(projectdir)/ZenithEngine/**.cpp|ThirdParty/vulkan/**.cpp")
+    add_files("**.cpp")
+
+    local sanitizer = get_config("sanitizer")
+    if sanitizer and sanitizer ~= "" and not is_plat("windows") then
+        add_cxxflags("-fsanitize=" .. sanitizer, "-fno-omit-frame-pointer")
+        add_ldflags("-fsanitize=" .. sanitizer)
+    end
+
+    -- Debug
+    if is_mode("debug") then
+        add_defines("ZENITH_ENABLE_RUNTIME_CHECK=1")
+    else
+        add_defines("ZENITH_ENABLE_RUNTIME_CHECK=0")
+    end
+target_end()
@@ -4,15 +4,21 @@ add_rules("plugin.vsxmake.autoupdate")
 add_rules("mode.debug", "mode.release")
 
 set_languages("c++23")
-set_allowedplats("windows")
-set_allowedarchs("x64")
-set_defaultplat("windows")
-set_defaultarchs("x64")
+-- linux is only verified with the null render backend of ZenithTest, e.g. "xmake f -p linux && xmake build ZenithTest"
+set_allowedplats("windows", "linux")
+set_allowedarchs("windows|x64", "linux|x86_64")
+set_defaultarchs("windows|x64", "linux|x86_64")
 
--- Warning As Errors
-add_cxxflags("/WX")
--- Disable RTTI
-add_cxxflags("/GR-")
+if is_plat("windows") then
+    -- Warning As Errors
+    add_cxxflags("/WX")
+    -- Disable RTTI
+    add_cxxflags("/GR-")
+else
+    -- Disable RTTI
+    add_cxxflags("-fno-rtti")
+    add_syslinks("pthread")
+end
 
 -- Debug
 if is_mode("debug") then
@@ -29,4 +35,5 @@ if is_mode("release") then
 end
 
 includes("ZenithEngine/xmake.lua")
-includes("ZenithApp/xmake.lua")
\ No newline at end of file
+includes("ZenithApp/xmake.lua")
+includes("ZenithTest/xmake.lua")
\ No newline at end of file